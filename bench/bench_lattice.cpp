@@ -0,0 +1,80 @@
+/*
+ *  bench_lattice.cpp
+ *  =================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Benchmark of Lattice::advance_day() on a large lattice of mixed
+ *  strategies, with von Neumann and Moore neighbourhoods. Creatures
+ *  reproduce every day, so each day includes all four sweeps.
+ *
+ *  Usage: bench_lattice [size [threads [days]]]
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <iostream>
+#include "../pridil.h"
+#include "bench_timer.h"
+
+using pridil_bench::now_seconds;
+using pridil_bench::int_arg;
+
+
+namespace {
+
+    /*
+     *  Returns the average time per day over the specified number
+     *  of days, for a lattice with the specified settings.
+     */
+
+    double seconds_per_day(const pridil::WorldInfo& wInfo, const long size,
+                           const pridil::Neighbourhood neighbourhood,
+                           const long days) {
+        pridil::Lattice lattice(wInfo, size, size, neighbourhood);
+        lattice.advance_day();
+
+        const double start = now_seconds();
+        for ( long day = 1; day <= days; ++day ) {
+            lattice.advance_day();
+        }
+        return (now_seconds() - start) / days;
+    }
+
+}
+
+
+int main(int argc, char ** argv) {
+    const long size = int_arg(argc, argv, 1, 4096);
+    const long threads = int_arg(argc, argv, 2, 1);
+    const long days = int_arg(argc, argv, 3, 5);
+
+    pridil::WorldInfo wInfo;
+    wInfo.m_repro_cycle_days = 1;
+    wInfo.m_threads = threads;
+    wInfo.m_seed = 1;
+
+    std::cout << "Lattice benchmark: " << size << " x " << size
+              << " cells, " << threads << " thread(s), " << days
+              << " days" << std::endl;
+
+    try {
+        const double vn_time = seconds_per_day(wInfo, size,
+                                    pridil::von_neumann_neighbourhood, days);
+        const double moore_time = seconds_per_day(wInfo, size,
+                                    pridil::moore_neighbourhood, days);
+        const double cells = static_cast<double>(size) * size;
+
+        std::cout << "von Neumann: " << vn_time << " s/day ("
+                  << vn_time / cells * 1e9 << " ns/cell)" << std::endl
+                  << "Moore:       " << moore_time << " s/day ("
+                  << moore_time / cells * 1e9 << " ns/cell)" << std::endl;
+    } catch(pridil::PridilException& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
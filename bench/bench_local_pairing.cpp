@@ -0,0 +1,89 @@
+/*
+ *  bench_local_pairing.cpp
+ *  =======================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Benchmark of World::advance_day() with uniform pairing and with
+ *  local pairing, on a large stable population of mixed strategies.
+ *  Creatures neither die nor reproduce, so each day's time is taken up
+ *  by pairing and by playing the games.
+ *
+ *  Usage: bench_local_pairing [creatures [threads [days [block]]]]
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <iostream>
+#include "../pridil.h"
+#include "bench_timer.h"
+
+using pridil_bench::now_seconds;
+using pridil_bench::int_arg;
+
+
+namespace {
+
+    /*
+     *  Returns the average time per day over the specified number
+     *  of days, for a world with the specified settings.
+     */
+
+    double seconds_per_day(const pridil::WorldInfo& wInfo, const long days) {
+        pridil::World world(wInfo);
+        world.advance_day();
+
+        const double start = now_seconds();
+        for ( long day = 1; day <= days; ++day ) {
+            world.advance_day();
+        }
+        return (now_seconds() - start) / days;
+    }
+
+}
+
+
+int main(int argc, char ** argv) {
+    const long creatures = int_arg(argc, argv, 1, 1000000);
+    const long threads = int_arg(argc, argv, 2, 1);
+    const long days = int_arg(argc, argv, 3, 5);
+    const long block = int_arg(argc, argv, 4, 0);
+
+    pridil::WorldInfo wInfo;
+    wInfo.m_random_strategy = creatures / 7;
+    wInfo.m_tit_for_tat = creatures / 7;
+    wInfo.m_tit_for_two_tats = creatures / 7;
+    wInfo.m_susp_tit_for_tat = creatures / 7;
+    wInfo.m_naive_prober = creatures / 7;
+    wInfo.m_always_cooperate = creatures / 7;
+    wInfo.m_always_defect = creatures - 6 * (creatures / 7);
+    wInfo.m_default_life_expectancy = 100000;
+    wInfo.m_default_starting_resources = 1000000;
+    wInfo.m_repro_min_resources = 100000000;
+    wInfo.m_threads = threads;
+    wInfo.m_seed = 1;
+    wInfo.m_pairing_block = block;
+
+    std::cout << "Local pairing benchmark: " << creatures << " creatures, "
+              << threads << " thread(s), " << days << " days" << std::endl;
+
+    try {
+        wInfo.m_pairing_mode = pridil::uniform_pairing;
+        const double uniform_time = seconds_per_day(wInfo, days);
+
+        wInfo.m_pairing_mode = pridil::local_pairing;
+        const double local_time = seconds_per_day(wInfo, days);
+
+        std::cout << "Uniform pairing: " << uniform_time << " s/day"
+                  << std::endl
+                  << "Local pairing:   " << local_time << " s/day ("
+                  << uniform_time / local_time << "x)" << std::endl;
+    } catch(pridil::PridilException& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+/*
+ *  bench_mass_death.cpp
+ *  ====================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Benchmark of World::advance_day() on days with mass deaths.
+ *
+ *  The world starts with equal numbers of always-cooperators and
+ *  always-defectors holding just enough resources to survive one
+ *  mutual cooperation. On the first day every cooperator paired with a
+ *  defector starves, and every defector which exploited a cooperator
+ *  reproduces, so roughly a quarter of the population dies and an
+ *  eighth is born. Later days continue the collapse.
+ *
+ *  For comparison, the benchmark also times removing the same fraction
+ *  of a list one std::vector.erase() at a time, as advance_day() used
+ *  to, for populations small enough for that to finish.
+ *
+ *  Usage: bench_mass_death [creatures [threads [days [max_erase]]]]
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include "../pridil.h"
+#include "bench_timer.h"
+
+using pridil_bench::now_seconds;
+using pridil_bench::int_arg;
+
+
+namespace {
+
+    /*
+     *  Times removing a quarter of a list of num_items pointers, chosen
+     *  at random, with one std::vector.erase() per removal.
+     */
+
+    double erase_removal_seconds(const long num_items) {
+        std::vector<int *> items(num_items, static_cast<int *>(0));
+        std::srand(1);
+
+        const double start = now_seconds();
+        for ( std::vector<int *>::iterator itr = items.begin();
+              itr != items.end(); /* empty expression */ ) {
+            if ( std::rand() % 4 == 0 ) {
+                itr = items.erase(itr);
+            } else {
+                ++itr;
+            }
+        }
+        return now_seconds() - start;
+    }
+
+}
+
+
+int main(int argc, char ** argv) {
+    const long creatures = int_arg(argc, argv, 1, 1000000);
+    const long threads = int_arg(argc, argv, 2, 1);
+    const long days = int_arg(argc, argv, 3, 3);
+    const long max_erase = int_arg(argc, argv, 4, 200000);
+
+    pridil::WorldInfo wInfo;
+    wInfo.m_random_strategy = 0;
+    wInfo.m_tit_for_tat = 0;
+    wInfo.m_tit_for_two_tats = 0;
+    wInfo.m_susp_tit_for_tat = 0;
+    wInfo.m_naive_prober = 0;
+    wInfo.m_always_cooperate = creatures / 2;
+    wInfo.m_always_defect = creatures - creatures / 2;
+    wInfo.m_default_life_expectancy = 100000;
+    wInfo.m_default_starting_resources = 3;
+    wInfo.m_repro_cost = 4;
+    wInfo.m_repro_min_resources = 8;
+    wInfo.m_repro_cycle_days = 1;
+    wInfo.m_threads = threads;
+
+    std::cout << "Mass death benchmark: " << creatures << " creatures, "
+              << threads << " thread(s)" << std::endl;
+
+    try {
+        double start = now_seconds();
+        pridil::World world(wInfo);
+        std::cout << "Setup: " << now_seconds() - start << " s" << std::endl;
+
+        for ( long day = 1; day <= days; ++day ) {
+            start = now_seconds();
+            world.advance_day();
+            std::cout << "Day " << day << ": "
+                      << now_seconds() - start << " s" << std::endl;
+        }
+        world.output_world_stats(std::cout);
+    } catch(pridil::PridilException& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Per-death erase() removal of 25% of a list:" << std::endl;
+    for ( long n = 25000; n <= max_erase; n *= 2 ) {
+        std::cout << "  " << n << " items: "
+                  << erase_removal_seconds(n) << " s" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ *  bench_pairing.cpp
+ *  =================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Benchmark of daily pairing, comparing std::random_shuffle() of a
+ *  list of creature pointers, as World::advance_day() used to do, with
+ *  the parallel bucket shuffle of the Pairing class.
+ *
+ *  Usage: bench_pairing [creatures [threads [days]]]
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include "../pairing.h"
+#include "../thread_pool.h"
+#include "bench_timer.h"
+
+using pridil_bench::now_seconds;
+using pridil_bench::int_arg;
+
+
+int main(int argc, char ** argv) {
+    const long creatures = int_arg(argc, argv, 1, 4000000);
+    const long threads = int_arg(argc, argv, 2, 1);
+    const long days = int_arg(argc, argv, 3, 5);
+
+    std::cout << "Pairing benchmark: " << creatures << " creatures, "
+              << threads << " thread(s), " << days << " days" << std::endl;
+
+    //  std::random_shuffle() of a pointer list
+
+    std::vector<int *> pointers(creatures, static_cast<int *>(0));
+    std::srand(1);
+    double start = now_seconds();
+    for ( long day = 1; day <= days; ++day ) {
+        std::random_shuffle(pointers.begin(), pointers.end());
+    }
+    const double shuffle_time = (now_seconds() - start) / days;
+
+    //  Pairing bucket shuffle
+
+    pridil::ThreadPool pool(threads);
+    pridil::Pairing pairing(pool, 1);
+    start = now_seconds();
+    for ( long day = 1; day <= days; ++day ) {
+        pairing.pair(creatures, day);
+    }
+    const double pairing_time = (now_seconds() - start) / days;
+
+    std::cout << "random_shuffle: " << shuffle_time << " s/day" << std::endl
+              << "Pairing:        " << pairing_time << " s/day ("
+              << shuffle_time / pairing_time << "x)" << std::endl;
+
+    return 0;
+}
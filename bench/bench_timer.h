@@ -0,0 +1,46 @@
+/*
+ *  bench_timer.h
+ *  =============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Wall clock timer and argument helpers shared by the Pridil
+ *  benchmark programs.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#ifndef PG_PRIDIL_BENCH_TIMER_H
+#define PG_PRIDIL_BENCH_TIMER_H
+
+#include <cstdlib>
+#include <sys/time.h>
+
+namespace pridil_bench {
+
+/*
+ *  Returns the current wall clock time in seconds.
+ */
+
+inline double now_seconds() {
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+
+/*
+ *  Returns the integer value of positional argument n, or the
+ *  supplied default if there are not that many arguments.
+ */
+
+inline long int_arg(const int argc, char ** argv, const int n,
+                    const long default_value) {
+    return (argc > n) ? std::atol(argv[n]) : default_value;
+}
+
+}       //  namespace pridil_bench
+
+#endif      //  PG_PRIDIL_BENCH_TIMER_H
@@ -53,6 +53,15 @@ unsigned int Brain::num_memories(const CreatureID opponent) const {
 }
 
 
+/*
+ *  Returns the number of games played.
+ */
+
+unsigned int Brain::games_played() const {
+    return m_memory.games_played();
+}
+
+
 /*
  *  Remembers the specified opponent's last move.
  *  
@@ -68,6 +77,15 @@ GameMove Brain::remember_move(const CreatureID opponent,
 }
 
 
+/*
+ *  Returns the history of games with the specified opponent.
+ */
+
+MatchHistory Brain::match_history(const CreatureID opponent) const {
+    return m_memory.match_history(opponent);
+}
+
+
 /*
  *  Outputs the entire contents of memory.
  */
@@ -89,6 +107,28 @@ void Brain::store_memory(const GameInfo& g_info) {
 }
 
 
+/*
+ *  Stores memories of a series of games.
+ *
+ *  Arguments:
+ *    games -- pointer to the first of the GameInfo objects to store
+ *    count -- the number of GameInfo objects to store
+ */
+
+void Brain::store_memories(const GameInfo * games, const std::size_t count) {
+    m_memory.store_memories(games, count);
+}
+
+
+/*
+ *  Erases all memories of a particular creature.
+ */
+
+void Brain::forget(const CreatureID opponent) {
+    m_memory.forget(opponent);
+}
+
+
 /*
  *  Returns the name of the playing strategy contained in DNA
  */
@@ -125,6 +165,24 @@ Creature * Brain::reproduce(int& resources) const {
 }
 
 
+/*
+ *  Returns a reproduced creature with the specified ID.
+ */
+
+Creature * Brain::reproduce(int& resources, const CreatureID child_id) const {
+    return m_dna.reproduce(resources, child_id);
+}
+
+
+/*
+ *  Returns true if the specified resources are enough to reproduce.
+ */
+
+bool Brain::can_reproduce(const int resources) const {
+    return m_dna.can_reproduce(resources);
+}
+
+
 /*
  *  Gets a game move against the specified creature.
  *
@@ -136,3 +194,39 @@ Creature * Brain::reproduce(int& resources) const {
 GameMove Brain::get_game_move(const CreatureID opponent) const {
     return m_dna.get_game_move(opponent);
 }
+
+
+/*
+ *  Gets a game move given the history of games with an opponent.
+ */
+
+GameMove Brain::get_match_move(const MatchHistory& history) const {
+    return m_dna.get_match_move(history);
+}
+
+
+/*
+ *  Get game moves as above, with any random choice taken from the
+ *  specified draw.
+ */
+
+GameMove Brain::get_game_move(const CreatureID opponent,
+                              const uint32_t draw) const {
+    return m_dna.get_game_move(opponent, draw);
+}
+
+GameMove Brain::get_match_move(const MatchHistory& history,
+                               const uint32_t draw) const {
+    return m_dna.get_match_move(history, draw);
+}
+
+
+/*
+ *  Resets the Brain for a new creature, giving its DNA the new
+ *  creature's characteristics and erasing all its memories.
+ */
+
+void Brain::reset(const CreatureInit& c_init) {
+    m_dna.reset(c_init);
+    m_memory.clear();
+}
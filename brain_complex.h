@@ -35,8 +35,13 @@
 #ifndef PG_PRIDIL_BRAIN_COMPLEX_H
 #define PG_PRIDIL_BRAIN_COMPLEX_H
 
+#include <cstddef>
 #include <ostream>
 #include <memory>
+#include <vector>
+#include <deque>
+#include <utility>
+#include <stdint.h>
 #include "pridil_common.h"
 
 namespace pridil {
@@ -55,9 +60,29 @@ namespace pridil {
  *    num_memories() - returns how many times the specified opponent has
  *                     been encountered before.
  *
+ *    match_history() - returns the number of games with the specified
+ *                      opponent, up to two, and its last two moves.
+ *
+ *    games_played() - returns how many games have been stored in all,
+ *                     including games with forgotten opponents.
+ *
  *    show_detailed_memories() - outputs details of all stored memories.
  *
  *    store_memory() - stores a memory of the specified game.
+ *
+ *    store_memories() - stores memories of a series of games, such as
+ *                       the games of a match.
+ *
+ *    forget() - erases all memories of the specified opponent.
+ *
+ *    clear() - erases all memories, and the count of games played.
+ *
+ *  Each opponent's memories are kept in a slot, and a sorted index maps
+ *  opponents to slots. forget() and clear() empty slots without freeing
+ *  their storage, and later opponents reuse them, so a Memory which is
+ *  cleared for a recycled Brain (see brain_pool.h) stores its new
+ *  creature's memories without allocating, until it meets more
+ *  opponents, or plays more games with one, than before.
  */
 
 class Memory {
@@ -69,16 +94,34 @@ class Memory {
 
         bool recognize(const CreatureID opponent) const;
         unsigned int num_memories(const CreatureID opponent) const;
+        unsigned int games_played() const;
         GameMove remember_move(const CreatureID opponent,
                                const unsigned int past = 1) const;
+        MatchHistory match_history(const CreatureID opponent) const;
         void show_detailed_memories(std::ostream& out) const;
 
-        //  Member function for storing memories
+        //  Member functions for storing and erasing memories
 
         void store_memory(const GameInfo& g_info);
+        void store_memories(const GameInfo * games, const std::size_t count);
+        void forget(const CreatureID opponent);
+        void clear();
 
     private:
-        GameInfoMap m_memories;
+        typedef std::pair<CreatureID, std::size_t> IndexEntry;
+
+        //  The opponents, sorted by ID, with their slots, the memories
+        //  in each slot and the opponent whose memories they are. Slots
+        //  from m_slots_used onwards are empty and kept for reuse.
+
+        std::vector<IndexEntry> m_index;
+        std::deque<GameInfoList> m_slots;
+        std::vector<CreatureID> m_slot_opponents;
+        std::size_t m_slots_used;
+        unsigned int m_games_played;
+
+        const GameInfoList * find_memories(const CreatureID opponent) const;
+        GameInfoList& opponent_memories(const CreatureID opponent);
 
         Memory(const Memory&);                  // Prevent copying
         Memory& operator=(const Memory&);       // Prevent assignment
@@ -110,16 +153,30 @@ class Brain;
  *    is_dead() - returns true if the specified age exceeds the life
  *                expectancy contained within the DNA.
  *
+ *    can_reproduce() - returns true if the specified amount of resources
+ *                      is enough to reproduce.
+ *
  *    reproduce() - returns a pointer to a newly created offspring if
  *                  the specified amount of resources exceeds the
  *                  cost of reproduction contained within the DNA. The
  *                  function modifies and deducts the cost of reproduction
- *                  from the resources provided.
+ *                  from the resources provided. The offspring may
+ *                  optionally be given a specific ID.
  *
  *    get_game_move() - returns a game move against the specified opponent.
  *                      Depending on the strategy contained within the DNA,
  *                      this move may or may not be influenced by memories
  *                      of previous interactions with that opponent.
+ *
+ *    get_match_move() - returns a game move given the history of games
+ *                       with an opponent, rather than looking it up.
+ *
+ *    Both may be given a draw from which to take any random choice
+ *    (see strategy_gene.h), instead of taking one from std::rand().
+ *
+ *    reset() - gives the DNA the characteristics of a new creature,
+ *              replacing the strategy gene only if the strategy
+ *              changes.
  */
 
 class DNA {
@@ -135,12 +192,22 @@ class DNA {
         const std::string strategy() const;
         Strategy strategy_value() const;
         bool is_dead(Day age) const;
+        bool can_reproduce(const int resources) const;
         Creature * reproduce(int& resources) const;
+        Creature * reproduce(int& resources, const CreatureID child_id) const;
 
         //  Genetic action methods
 
         GameMove get_game_move(const CreatureID opponent) const;
+        GameMove get_game_move(const CreatureID opponent,
+                               const uint32_t draw) const;
+        GameMove get_match_move(const MatchHistory& history) const;
+        GameMove get_match_move(const MatchHistory& history,
+                                const uint32_t draw) const;
+
+        //  Method to reuse the DNA for a new creature
 
+        void reset(const CreatureInit& c_init);
 
     private:
         const Brain& m_brain;
@@ -160,7 +227,9 @@ class DNA {
  *  and the DNA.
  *
  *  The public member functions merely call the Memory and DNA member
- *  functions of the same name.
+ *  functions of the same name, apart from reset(), which resets the DNA
+ *  and clears the Memory, so that a Brain can be reused for a newborn
+ *  creature (see brain_pool.h).
  */
 
 class Brain {
@@ -175,18 +244,33 @@ class Brain {
 
         bool recognize(const CreatureID opponent) const;
         unsigned int num_memories(const CreatureID opponent) const;
+        unsigned int games_played() const;
         GameMove remember_move(const CreatureID opponent,
                                const unsigned int past = 1) const;
+        MatchHistory match_history(const CreatureID opponent) const;
         void show_detailed_memories(std::ostream& out) const;
         void store_memory(const GameInfo& g_info);
+        void store_memories(const GameInfo * games, const std::size_t count);
+        void forget(const CreatureID opponent);
 
         //  DNA interface member functions
 
         const std::string strategy() const;
         Strategy strategy_value() const;
         bool is_dead(Day age) const;
+        bool can_reproduce(const int resources) const;
         Creature * reproduce(int& resources) const;
+        Creature * reproduce(int& resources, const CreatureID child_id) const;
         GameMove get_game_move(const CreatureID opponent) const;
+        GameMove get_game_move(const CreatureID opponent,
+                               const uint32_t draw) const;
+        GameMove get_match_move(const MatchHistory& history) const;
+        GameMove get_match_move(const MatchHistory& history,
+                                const uint32_t draw) const;
+
+        //  Method to reuse the Brain for a new creature
+
+        void reset(const CreatureInit& c_init);
 
     private:
         DNA m_dna;
@@ -0,0 +1,153 @@
+/*
+ *  brain_pool.cpp
+ *  ==============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Implementation of BrainPool class for Prisoners' Dilemma simulation.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <cstddef>
+#include <new>
+#include <string>
+#include <vector>
+#include "pridil_common.h"
+#include "brain_pool.h"
+#include "brain_complex.h"
+
+using namespace pridil;
+
+
+/*
+ *  Number of Brains in each block, and number of strategies, for the
+ *  free lists kept by strategy.
+ */
+
+namespace {
+    const std::size_t c_brains_per_block = 1024;
+    const std::size_t c_num_strategies = always_defect + 1;
+}
+
+
+/*
+ *  Constructor.
+ */
+
+BrainPool::BrainPool() :
+        m_blocks(), m_last_block_used(c_brains_per_block),
+        m_free(c_num_strategies), m_names(c_num_strategies) {}
+
+
+/*
+ *  Destructor. Destroys every Brain constructed, whether free or not,
+ *  and frees the blocks.
+ */
+
+BrainPool::~BrainPool() {
+    for ( std::size_t b = 0; b < m_blocks.size(); ++b ) {
+        Brain * brains = static_cast<Brain *>(m_blocks[b]);
+        const std::size_t used = (b + 1 == m_blocks.size()) ?
+                                 m_last_block_used : c_brains_per_block;
+        for ( std::size_t i = 0; i < used; ++i ) {
+            brains[i].~Brain();
+        }
+        ::operator delete(m_blocks[b]);
+    }
+}
+
+
+/*
+ *  Returns a Brain for a creature. The most recently released Brain of
+ *  the creature's strategy is returned as it was released, and must be
+ *  reset before use; if there is none, a new Brain is constructed.
+ *
+ *  Arguments:
+ *    c_init -- the creature's characteristics, used to construct a new
+ *              Brain
+ */
+
+Brain * BrainPool::acquire(const CreatureInit& c_init) {
+    BrainList& free_brains = m_free[c_init.strategy];
+    if ( free_brains.empty() ) {
+        return construct(c_init);
+    }
+
+    Brain * brain = free_brains.back();
+    free_brains.pop_back();
+    return brain;
+}
+
+
+/*
+ *  Gives back a Brain which is no longer needed, keeping it for a
+ *  newborn of the same strategy, and remembering the strategy's name.
+ */
+
+void BrainPool::release(Brain * brain) {
+    const Strategy strategy = brain->strategy_value();
+    if ( m_names[strategy].empty() ) {
+        m_names[strategy] = brain->strategy();
+    }
+    m_free[strategy].push_back(brain);
+}
+
+
+/*
+ *  Returns the name of a strategy, or an empty string if no Brain of
+ *  that strategy has ever been given back to the pool.
+ */
+
+const std::string& BrainPool::strategy_name(const Strategy strategy) const {
+    return m_names[strategy];
+}
+
+
+/*
+ *  Returns the number of Brains constructed.
+ */
+
+std::size_t BrainPool::num_brains() const {
+    return m_blocks.empty() ? 0 : (m_blocks.size() - 1) * c_brains_per_block +
+                                  m_last_block_used;
+}
+
+
+/*
+ *  Returns the number of Brains on the free lists.
+ */
+
+std::size_t BrainPool::num_free() const {
+    std::size_t total = 0;
+    for ( std::size_t s = 0; s < c_num_strategies; ++s ) {
+        total += m_free[s].size();
+    }
+    return total;
+}
+
+
+/*
+ *  Constructs a new Brain in the last block, starting a new block if
+ *  it is full.
+ */
+
+Brain * BrainPool::construct(const CreatureInit& c_init) {
+    if ( m_last_block_used == c_brains_per_block ) {
+        void * block = ::operator new(c_brains_per_block * sizeof(Brain));
+        try {
+            m_blocks.push_back(block);
+        } catch(...) {
+            ::operator delete(block);
+            throw;
+        }
+        m_last_block_used = 0;
+    }
+
+    Brain * brains = static_cast<Brain *>(m_blocks.back());
+    Brain * brain = new (brains + m_last_block_used) Brain(c_init);
+    ++m_last_block_used;
+    return brain;
+}
@@ -0,0 +1,97 @@
+/*
+ *  brain_pool.h
+ *  ============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Interface to BrainPool class for Prisoner's Dilemma simulation.
+ *
+ *  A BrainPool is an arena from which a World's populations take the
+ *  Brains of their creatures, and to which they give them back when
+ *  the creatures die. Brains are constructed in large blocks, and a
+ *  Brain given back is kept on a free list, one list per strategy, to
+ *  be handed out again for a newborn of the same strategy. Population
+ *  resets each Brain it is handed, which erases its memories and gives
+ *  its DNA the newborn's characteristics without replacing any genes,
+ *  so once the number of creatures has levelled off, births and deaths
+ *  construct no Brains and allocate no genes. Destroying the pool
+ *  destroys every Brain it has constructed and frees its blocks whole.
+ *
+ *  The pool also remembers the name of the strategy of each Brain given
+ *  back to it, so the strategies of dead creatures can still be named
+ *  once their Brains have been reused.
+ *
+ *  A pool is not thread-safe, so a World takes the Brains for each
+ *  day's newborns, and gives back those of the day's dead, between the
+ *  parallel phases of the day. Populations using a pool must be
+ *  destroyed before it.
+ *
+ *  Public member functions:
+ *    acquire() - returns a free Brain of the specified strategy, or
+ *                constructs a new one if there is none.
+ *
+ *    release() - gives back a Brain which is no longer needed.
+ *
+ *    strategy_name() - returns the name of a strategy.
+ *
+ *    num_brains() - returns the number of Brains constructed.
+ *
+ *    num_free() - returns the number of Brains on the free lists.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#ifndef PG_PRIDIL_BRAIN_POOL_H
+#define PG_PRIDIL_BRAIN_POOL_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "pridil_common.h"
+#include "brain_complex.h"
+
+namespace pridil {
+
+typedef std::vector<Brain *> BrainList;
+
+
+/*
+ *  BrainPool class.
+ */
+
+class BrainPool {
+    public:
+
+        //  Constructor and destructor
+
+        BrainPool();
+        ~BrainPool();
+
+        //  Methods to hand out and give back Brains
+
+        Brain * acquire(const CreatureInit& c_init);
+        void release(Brain * brain);
+
+        //  Methods to access the pool
+
+        const std::string& strategy_name(const Strategy strategy) const;
+        std::size_t num_brains() const;
+        std::size_t num_free() const;
+
+    private:
+        std::vector<void *> m_blocks;
+        std::size_t m_last_block_used;
+        std::vector<BrainList> m_free;
+        std::vector<std::string> m_names;
+
+        Brain * construct(const CreatureInit& c_init);
+
+        BrainPool(const BrainPool&);                // Prevent copying
+        BrainPool& operator=(const BrainPool&);     // Prevent assignment
+};
+
+}       //  namespace pridil
+
+#endif      // PG_PRIDIL_BRAIN_POOL_H
@@ -0,0 +1,114 @@
+/*
+ *  calendar.cpp
+ *  ============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Implementation of Calendar class for Prisoners' Dilemma simulation.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include "pridil_common.h"
+#include "calendar.h"
+#include "slot_map.h"
+
+using std::vector;
+
+using namespace pridil;
+
+
+/*
+ *  Constructor. The calendar starts with a single bucket, and no
+ *  handles.
+ *
+ *  Arguments:
+ *    first_day -- the first day to be taken
+ */
+
+Calendar::Calendar(const Day first_day) :
+        m_first_day(first_day), m_size(0), m_buckets(1) {}
+
+
+/*
+ *  Adds a handle to a day's bucket, growing the ring first if the day
+ *  is beyond the last day it covers. A day already taken is moved to
+ *  the next day to be taken.
+ */
+
+void Calendar::schedule(const Day day, const CreatureHandle handle) {
+    const Day due = day > m_first_day ? day : m_first_day;
+    const std::size_t days = static_cast<std::size_t>(due - m_first_day) + 1;
+    if ( days > m_buckets.size() ) {
+        grow(days);
+    }
+    bucket(due).push_back(handle);
+    ++m_size;
+}
+
+
+/*
+ *  Appends the handles due on a day, and on any earlier days not yet
+ *  taken, to a list, and empties their buckets.
+ */
+
+void Calendar::take(const Day day, HandleList& due) {
+    if ( day < m_first_day ) {
+        return;
+    }
+
+    const std::size_t days = std::min(
+        static_cast<std::size_t>(day - m_first_day) + 1, m_buckets.size());
+    for ( std::size_t i = 0; i < days; ++i ) {
+        HandleList& handles = bucket(day - static_cast<Day>(i));
+        due.insert(due.end(), handles.begin(), handles.end());
+        m_size -= handles.size();
+        handles.clear();
+    }
+    m_first_day = day + 1;
+}
+
+
+/*
+ *  Returns the number of handles scheduled and not yet taken.
+ */
+
+std::size_t Calendar::size() const {
+    return m_size;
+}
+
+
+/*
+ *  Returns the bucket for a day.
+ */
+
+HandleList& Calendar::bucket(const Day day) {
+    return m_buckets[static_cast<std::size_t>(day) & (m_buckets.size() - 1)];
+}
+
+
+/*
+ *  Grows the ring to the next power of two which covers the specified
+ *  number of days from the first day to be taken, moving each bucket
+ *  to its place in the larger ring.
+ */
+
+void Calendar::grow(const std::size_t days) {
+    std::size_t num_buckets = m_buckets.size();
+    while ( num_buckets < days ) {
+        num_buckets *= 2;
+    }
+
+    vector<HandleList> buckets(num_buckets);
+    for ( std::size_t i = 0; i < m_buckets.size(); ++i ) {
+        const Day day = m_first_day + static_cast<Day>(i);
+        buckets[static_cast<std::size_t>(day) & (num_buckets - 1)].swap(
+            bucket(day));
+    }
+    m_buckets.swap(buckets);
+}
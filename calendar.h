@@ -0,0 +1,74 @@
+/*
+ *  calendar.h
+ *  ==========
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Interface to Calendar class for Prisoner's Dilemma simulation.
+ *
+ *  A Calendar is a calendar queue of creature handles (see slot_map.h)
+ *  bucketed by day, e.g. by the day on which each creature will die of
+ *  old age, so a region can find the creatures due on a day without
+ *  checking every creature it holds.
+ *
+ *  The buckets form a ring, one bucket per day, with the bucket for a
+ *  day found from the day modulo the number of buckets. The ring grows,
+ *  to the next power of two, whenever a day is scheduled beyond the
+ *  last day it covers, so each bucket only ever holds the handles due
+ *  on a single day, and taking a day's handles costs only as much as
+ *  there are handles due.
+ *
+ *  Taking a day also takes any earlier days not yet taken, and a day
+ *  scheduled which has already been taken is moved to the next day to
+ *  be taken. A handle may go stale, or its creature move away, before
+ *  its day comes, so the handles taken must be checked before they are
+ *  used.
+ *
+ *  Public member functions:
+ *    schedule() - adds a handle to a day's bucket.
+ *
+ *    take() - appends the handles due on a day, and on any earlier days
+ *             not yet taken, to a list, and empties their buckets.
+ *
+ *    size() - returns the number of handles scheduled and not taken.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#ifndef PG_PRIDIL_CALENDAR_H
+#define PG_PRIDIL_CALENDAR_H
+
+#include <cstddef>
+#include <vector>
+#include "pridil_common.h"
+#include "slot_map.h"
+
+namespace pridil {
+
+class Calendar {
+    public:
+
+        //  Constructor
+
+        explicit Calendar(const Day first_day = 1);
+
+        //  Methods to schedule and take handles
+
+        void schedule(const Day day, const CreatureHandle handle);
+        void take(const Day day, HandleList& due);
+        std::size_t size() const;
+
+    private:
+        Day m_first_day;
+        std::size_t m_size;
+        std::vector<HandleList> m_buckets;
+
+        HandleList& bucket(const Day day);
+        void grow(const std::size_t days);
+};
+
+}       //  namespace pridil
+
+#endif      // PG_PRIDIL_CALENDAR_H
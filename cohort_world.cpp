@@ -0,0 +1,725 @@
+/*
+ *  cohort_world.cpp
+ *  ================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Implementation of CohortWorld class for Prisoners' Dilemma
+ *  simulation.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <ctime>
+#include "pridil_common.h"
+#include "cohort_world.h"
+#include "creature.h"
+#include "game.h"
+
+using std::endl;
+using std::map;
+using std::ostream;
+using std::pair;
+using std::string;
+using std::vector;
+
+using namespace pridil;
+
+
+/*
+ *  Number of strategies, and the mean below which binomial counts are
+ *  drawn exactly rather than from a normal approximation.
+ */
+
+namespace {
+    const std::size_t c_num_strategies = always_defect + 1;
+    const double c_exact_binomial_mean = 30.0;
+    const double c_two_pi = 6.283185307179586;
+
+
+    /*
+     *  Returns true if the moves of a strategy depend on its memories,
+     *  following the strategy genes' get_game_move() functions.
+     */
+
+    bool uses_memory(const Strategy strategy) {
+        switch ( strategy ) {
+            case random_strategy:
+            case always_cooperate:
+            case always_defect:
+                return false;
+
+            default:
+                return true;
+        }
+    }
+
+
+    /*
+     *  Returns the chance of a creature of a strategy which does not use
+     *  its memories defecting.
+     */
+
+    double defect_chance(const Strategy strategy) {
+        switch ( strategy ) {
+            case random_strategy:
+                return 0.5;
+
+            case always_defect:
+                return 1.0;
+
+            default:
+                return 0.0;
+        }
+    }
+
+
+    /*
+     *  Returns a random number drawn from the standard normal
+     *  distribution, by the Box-Muller transform.
+     */
+
+    double standard_normal(Rng& rng) {
+        const double radius = std::sqrt(-2.0 * std::log(1.0 - rng.uniform()));
+        return radius * std::cos(c_two_pi * rng.uniform());
+    }
+
+
+    /*
+     *  Returns the number of successes in a number of trials, each with
+     *  the specified chance of success. Small means are drawn exactly,
+     *  by inversion, and large ones from a normal approximation.
+     */
+
+    unsigned long binomial(Rng& rng, const unsigned long trials,
+                           const double chance) {
+        if ( trials == 0 || chance <= 0.0 ) {
+            return 0;
+        } else if ( chance >= 1.0 ) {
+            return trials;
+        } else if ( chance > 0.5 ) {
+            return trials - binomial(rng, trials, 1.0 - chance);
+        }
+
+        const double mean = trials * chance;
+        const double q = 1.0 - chance;
+        if ( mean < c_exact_binomial_mean ) {
+            const double ratio = chance / q;
+            const double factor = (static_cast<double>(trials) + 1) * ratio;
+            double prob = std::pow(q, static_cast<double>(trials));
+            double u = rng.uniform();
+            unsigned long successes = 0;
+            while ( u > prob && prob > 0.0 && successes < trials ) {
+                u -= prob;
+                ++successes;
+                prob *= factor / successes - ratio;
+            }
+            return successes;
+        }
+
+        const double drawn = std::floor(mean + std::sqrt(mean * q) *
+                                        standard_normal(rng) + 0.5);
+        if ( drawn <= 0.0 ) {
+            return 0;
+        } else if ( drawn >= static_cast<double>(trials) ) {
+            return trials;
+        }
+        return static_cast<unsigned long>(drawn);
+    }
+
+
+    /*
+     *  Shares a number of players among groups of the specified sizes,
+     *  each group's share drawn from the binomial distribution given
+     *  the players not yet shared out, and kept within what the group
+     *  and the groups after it can take.
+     *
+     *  Arguments:
+     *    rng -- the random number generator
+     *    players -- the number of players to share out, which must not
+     *               be more than the total size of the groups
+     *    sizes -- the size of each group
+     *    shares -- set to the number of players in each group
+     */
+
+    void share_out(Rng& rng, unsigned long players,
+                   const vector<unsigned long>& sizes,
+                   vector<unsigned long>& shares) {
+        unsigned long rest = 0;
+        for ( std::size_t k = 0; k < sizes.size(); ++k ) {
+            rest += sizes[k];
+        }
+
+        shares.assign(sizes.size(), 0);
+        for ( std::size_t k = 0; k < sizes.size() && players > 0; ++k ) {
+            rest -= sizes[k];
+            if ( sizes[k] == 0 ) {
+                continue;
+            }
+
+            const unsigned long low = (players > rest) ? players - rest : 0;
+            const unsigned long high = std::min(sizes[k], players);
+            const double chance = static_cast<double>(sizes[k]) /
+                                  (static_cast<double>(sizes[k]) + rest);
+            const unsigned long share = std::max(low,
+                    std::min(high, binomial(rng, players, chance)));
+            shares[k] = share;
+            players -= share;
+        }
+    }
+}
+
+
+/*
+ *  Constructor.
+ *
+ *  Arguments:
+ *    wInfo -- the starting population, life expectancy, starting
+ *             resources, reproduction characteristics and seed, as
+ *             for a World
+ */
+
+CohortWorld::CohortWorld(const WorldInfo& wInfo) :
+        m_life_expectancy(wInfo.m_default_life_expectancy),
+        m_repro_cycle_days(wInfo.m_repro_cycle_days > 0 ?
+                           wInfo.m_repro_cycle_days : 1),
+        m_repro_cost(wInfo.m_repro_cost),
+        m_repro_min_resources(wInfo.m_repro_min_resources),
+        m_disable_deaths(wInfo.m_disable_deaths),
+        m_disable_repro(wInfo.m_disable_repro),
+        m_day(1),
+        m_rng(seed_or_time(wInfo.m_seed)),
+        m_starting_creatures(0),
+        m_born_creatures(0),
+        m_dead_creatures(0),
+        m_games_played(0),
+        m_deaths(c_num_strategies, 0),
+        m_cohorts(),
+        m_brains(),
+        m_individuals(&m_brains),
+        m_payoffs(),
+        m_strategy_names(strategy_names()) {
+
+    seed_strategy_genes(wInfo.m_seed);
+
+    //  Start each strategy's creatures as one cohort, born on day 0
+
+    const vector<Strategy> strategies = gene_strategies();
+    for ( std::size_t s = 0; s < strategies.size(); ++s ) {
+        const int count = starting_count(wInfo, strategies[s]);
+        if ( count > 0 ) {
+            m_cohorts.push_back(Cohort(count,
+                                       wInfo.m_default_starting_resources,
+                                       0, strategies[s]));
+            m_starting_creatures += count;
+        }
+    }
+    merge_cohorts(m_cohorts);
+
+    payoff_table(m_payoffs);
+}
+
+
+/*
+ *  Destructor.
+ */
+
+CohortWorld::~CohortWorld() {}
+
+
+/*
+ *  Advances the population by one day. Every creature plays at most
+ *  one game, and then, as in a World, creatures which have run out of
+ *  resources or outlived their life expectancy die, and on
+ *  reproduction days the survivors with enough resources reproduce.
+ */
+
+void CohortWorld::advance_day() {
+    split_diverging();
+    play_games();
+    process_life_cycle();
+    ++m_day;
+}
+
+
+/*
+ *  Returns the current day.
+ */
+
+Day CohortWorld::day() const {
+    return m_day;
+}
+
+
+/*
+ *  Returns the number of live creatures of a strategy.
+ */
+
+unsigned long CohortWorld::count(const Strategy strategy) const {
+    unsigned long total = 0;
+    for ( std::size_t k = 0; k < m_cohorts.size(); ++k ) {
+        if ( m_cohorts[k].strategy == strategy ) {
+            total += m_cohorts[k].count;
+        }
+    }
+    for ( std::size_t i = 0; i < m_individuals.size(); ++i ) {
+        if ( m_individuals.strategy_value(i) == strategy ) {
+            ++total;
+        }
+    }
+    return total;
+}
+
+
+/*
+ *  Return the number of live creatures, and running totals.
+ */
+
+unsigned long CohortWorld::num_live() const {
+    unsigned long total = m_individuals.size();
+    for ( std::size_t k = 0; k < m_cohorts.size(); ++k ) {
+        total += m_cohorts[k].count;
+    }
+    return total;
+}
+
+unsigned long CohortWorld::born_creatures() const {
+    return m_born_creatures;
+}
+
+unsigned long CohortWorld::dead_creatures() const {
+    return m_dead_creatures;
+}
+
+unsigned long CohortWorld::games_played() const {
+    return m_games_played;
+}
+
+
+/*
+ *  Return the number of cohorts, and of individual creatures.
+ */
+
+std::size_t CohortWorld::num_cohorts() const {
+    return m_cohorts.size();
+}
+
+std::size_t CohortWorld::num_individuals() const {
+    return m_individuals.size();
+}
+
+
+/*
+ *  Member function outputs summary statistics, as for a World.
+ *
+ *  Arguments: reference to a ostream object to which to output.
+ */
+
+void CohortWorld::output_world_stats(ostream& out) const {
+    out << "Summary world statistics:" << endl
+        << "Days passed: " << m_day - 1 << endl
+        << "Games played: " << m_games_played << endl
+        << "Starting creatures: " << m_starting_creatures << endl
+        << "Living creatures: " << num_live() << endl
+        << "Creatures born: " << m_born_creatures << endl
+        << "Creatures died: " << m_dead_creatures << endl
+        << endl;
+}
+
+
+/*
+ *  Member function outputs summary statistics for the creatures of
+ *  each strategy, as for a World, ranked by average resources.
+ *
+ *  Arguments: reference to a ostream object to which to output.
+ */
+
+void CohortWorld::output_summary_resources_by_strategy(ostream& out) const {
+    StrategyStatsList strategy_stats(c_num_strategies);
+    for ( std::size_t k = 0; k < m_cohorts.size(); ++k ) {
+        strategy_stats[m_cohorts[k].strategy].add(
+                m_cohorts[k].resources,
+                static_cast<double>(m_cohorts[k].count));
+    }
+    for ( std::size_t i = 0; i < m_individuals.size(); ++i ) {
+        strategy_stats[m_individuals.strategy_value(i)].add(
+                m_individuals.resources(i));
+    }
+    output_resources_by_strategy(out, strategy_stats);
+}
+
+
+/*
+ *  Member function outputs the number of creatures of each strategy
+ *  that have died, as for a World.
+ *
+ *  Arguments: reference to a ostream object to which to output.
+ */
+
+void CohortWorld::output_summary_dead_by_strategy(ostream& out) const {
+    if ( m_disable_deaths ) {
+        return;
+    }
+
+    output_deaths_by_strategy(out, vector<double>(m_deaths.begin(),
+                                                  m_deaths.end()));
+}
+
+
+/*
+ *  Splits off the members of cohorts whose strategies use their
+ *  memories, which are about to play their first game, into
+ *  individuals with Brains of their own.
+ */
+
+void CohortWorld::split_diverging() {
+    CreatureInit c_init(m_life_expectancy, 0, random_strategy, 0,
+                        m_repro_cost, m_repro_min_resources);
+
+    std::size_t kept = 0;
+    for ( std::size_t k = 0; k < m_cohorts.size(); ++k ) {
+        const Cohort& cohort = m_cohorts[k];
+        const Strategy strategy = static_cast<Strategy>(cohort.strategy);
+        if ( !uses_memory(strategy) ) {
+            m_cohorts[kept++] = cohort;
+            continue;
+        }
+
+        c_init.strategy = strategy;
+        c_init.starting_resources = cohort.resources;
+        for ( unsigned long n = 0; n < cohort.count; ++n ) {
+            m_individuals.add(c_init, Creature::reserve_ids(1),
+                              cohort.birth_day);
+        }
+    }
+    m_cohorts.resize(kept, Cohort(0, 0, 0, random_strategy));
+}
+
+
+/*
+ *  Plays the day's games. The individuals are taken in a random order,
+ *  and each one not yet matched is matched either with the next
+ *  individual, or with a member of a cohort, in proportion to the
+ *  numbers of each not yet matched, so that every creature is equally
+ *  likely to be the partner. The cohort members left over are then
+ *  matched among themselves, in aggregate. If the number of creatures
+ *  is odd, one sits the day out, as in a World.
+ */
+
+void CohortWorld::play_games() {
+    const std::size_t num_cohorts = m_cohorts.size();
+    CountList sizes(num_cohorts);
+    CountList coop_left(num_cohorts);
+    CountList defect_left(num_cohorts);
+    CountList outcomes(4 * num_cohorts, 0);
+    vector<double> cumulative(num_cohorts);
+
+    //  Decide each cohort's moves
+
+    unsigned long members_left = 0;
+    double total = 0.0;
+    for ( std::size_t k = 0; k < num_cohorts; ++k ) {
+        const Cohort& cohort = m_cohorts[k];
+        const double chance =
+            defect_chance(static_cast<Strategy>(cohort.strategy));
+        sizes[k] = cohort.count;
+        defect_left[k] = binomial(m_rng, cohort.count, chance);
+        coop_left[k] = cohort.count - defect_left[k];
+        members_left += cohort.count;
+        total += cohort.count;
+        cumulative[k] = total;
+    }
+
+    //  Shuffle the individuals, and match each in turn
+
+    const std::size_t num_individuals = m_individuals.size();
+    vector<std::size_t> order(num_individuals);
+    for ( std::size_t i = 0; i < num_individuals; ++i ) {
+        const std::size_t j = m_rng.below(static_cast<uint32_t>(i + 1));
+        order[i] = order[j];
+        order[j] = i;
+    }
+
+    std::size_t next = 0;
+    while ( next < num_individuals ) {
+        const double others = static_cast<double>(num_individuals - next) +
+                              members_left - 1;
+        if ( others < 1.0 ) {
+            break;
+        }
+
+        const std::size_t individuals_left = num_individuals - next - 1;
+        if ( m_rng.uniform() * others < individuals_left ) {
+            play_game(m_individuals, order[next], order[next + 1]);
+            next += 2;
+        } else {
+            play_stranger(order[next], sizes, cumulative,
+                          coop_left, defect_left, outcomes);
+            --members_left;
+            ++next;
+        }
+        ++m_games_played;
+    }
+
+    pair_cohorts(coop_left, defect_left, outcomes);
+    apply_outcomes(outcomes);
+}
+
+
+/*
+ *  Plays a game between an individual and a member of a cohort, chosen
+ *  uniformly from the members not yet matched. The member is a
+ *  stranger, with an ID of its own which the individual never meets
+ *  again.
+ *
+ *  Arguments:
+ *    row -- the individual's row
+ *    sizes, cumulative -- the size of each cohort, and the running
+ *                         total of the sizes
+ *    coop_left, defect_left -- the numbers of each cohort's members
+ *                              which cooperate and defect, not yet
+ *                              matched
+ *    outcomes -- the numbers of each cohort's members by their own and
+ *                their partners' moves, updated for the member
+ */
+
+void CohortWorld::play_stranger(const std::size_t row,
+                                const CountList& sizes,
+                                const vector<double>& cumulative,
+                                CountList& coop_left,
+                                CountList& defect_left,
+                                CountList& outcomes) {
+
+    //  Choose a cohort in proportion to its size, and keep it in
+    //  proportion to the fraction of its members not yet matched.
+
+    std::size_t k = 0;
+    do {
+        const double target = m_rng.uniform() * cumulative.back();
+        k = std::upper_bound(cumulative.begin(), cumulative.end(), target) -
+            cumulative.begin();
+    } while ( m_rng.uniform() * sizes[k] >= coop_left[k] + defect_left[k] );
+
+    int member_defects = 0;
+    if ( m_rng.uniform() * (coop_left[k] + defect_left[k]) <
+            defect_left[k] ) {
+        member_defects = 1;
+        --defect_left[k];
+    } else {
+        --coop_left[k];
+    }
+
+    const CreatureID stranger = Creature::reserve_ids(1);
+    const GameMove member_move = member_defects ? defect : coop;
+    const GameMove own_move = m_individuals.get_game_move(row, stranger);
+    const GameMove simple_move = simplify_game_move(own_move);
+
+    GameInfo own_info(stranger, own_move, member_move, 0);
+    GameInfo member_info(m_individuals.id(row), member_move,
+                         simple_move, 0);
+    game_result(own_info, member_info);
+    m_individuals.give_game_result(row, own_info);
+
+    ++outcomes[4 * k + 2 * member_defects + (simple_move == defect)];
+}
+
+
+/*
+ *  Matches the cohort members not matched with individuals among
+ *  themselves. The number of pairs of a cooperator and a defector is
+ *  drawn first, and then the cooperators and defectors in those pairs
+ *  are shared among the cohorts.
+ *
+ *  Arguments:
+ *    coop_left, defect_left -- the numbers of each cohort's members
+ *                              which cooperate and defect, not yet
+ *                              matched
+ *    outcomes -- the numbers of each cohort's members by their own and
+ *                their partners' moves, updated for the games played
+ */
+
+void CohortWorld::pair_cohorts(CountList& coop_left, CountList& defect_left,
+                               CountList& outcomes) {
+    unsigned long coops = 0;
+    unsigned long defects = 0;
+    for ( std::size_t k = 0; k < coop_left.size(); ++k ) {
+        coops += coop_left[k];
+        defects += defect_left[k];
+    }
+
+    //  Sit one member out if the number left is odd
+
+    if ( (coops + defects) % 2 == 1 ) {
+        CountList& left = (m_rng.uniform() * (coops + defects) < defects) ?
+                          defect_left : coop_left;
+        unsigned long& total = (&left == &defect_left) ? defects : coops;
+        unsigned long target = std::min(total - 1,
+                static_cast<unsigned long>(m_rng.uniform() * total));
+        std::size_t k = 0;
+        while ( target >= left[k] ) {
+            target -= left[k++];
+        }
+        --left[k];
+        --total;
+    }
+    if ( coops + defects == 0 ) {
+        return;
+    }
+
+    //  Draw the number of mixed pairs, with the right parity for the
+    //  cooperators and the defectors left to pair among themselves
+
+    const unsigned long most_mixed = std::min(coops, defects);
+    const double chance = static_cast<double>(defects) /
+                          (static_cast<double>(coops + defects) - 1);
+    unsigned long mixed = std::min(most_mixed,
+                                   binomial(m_rng, coops, chance));
+    if ( (coops - mixed) % 2 == 1 ) {
+        if ( mixed < most_mixed ) {
+            ++mixed;
+        } else {
+            --mixed;
+        }
+    }
+
+    CountList coop_mixed;
+    CountList defect_mixed;
+    share_out(m_rng, mixed, coop_left, coop_mixed);
+    share_out(m_rng, mixed, defect_left, defect_mixed);
+    for ( std::size_t k = 0; k < coop_left.size(); ++k ) {
+        outcomes[4 * k] += coop_left[k] - coop_mixed[k];
+        outcomes[4 * k + 1] += coop_mixed[k];
+        outcomes[4 * k + 2] += defect_mixed[k];
+        outcomes[4 * k + 3] += defect_left[k] - defect_mixed[k];
+    }
+    m_games_played += (coops + defects) / 2;
+}
+
+
+/*
+ *  Splits each cohort by the outcomes of its members' games, and
+ *  merges the cohorts which end up with the same characteristics.
+ *  Members which did not play stay as they were.
+ *
+ *  Arguments:
+ *    outcomes -- the numbers of each cohort's members by their own and
+ *                their partners' moves
+ */
+
+void CohortWorld::apply_outcomes(const CountList& outcomes) {
+    CohortList next;
+    next.reserve(4 * m_cohorts.size());
+    for ( std::size_t k = 0; k < m_cohorts.size(); ++k ) {
+        const Cohort& cohort = m_cohorts[k];
+        unsigned long unplayed = cohort.count;
+        for ( int own = 0; own < 2; ++own ) {
+            for ( int other = 0; other < 2; ++other ) {
+                const unsigned long number = outcomes[4 * k + 2 * own + other];
+                if ( number > 0 ) {
+                    next.push_back(Cohort(number,
+                                cohort.resources + m_payoffs[own][other],
+                                cohort.birth_day, cohort.strategy));
+                    unplayed -= number;
+                }
+            }
+        }
+        if ( unplayed > 0 ) {
+            next.push_back(Cohort(unplayed, cohort.resources,
+                                  cohort.birth_day, cohort.strategy));
+        }
+    }
+
+    merge_cohorts(next);
+    m_cohorts.swap(next);
+}
+
+
+/*
+ *  Ages the creatures, and processes the day's deaths and births, as
+ *  in a World. Newborns start out in cohorts, one per strategy.
+ */
+
+void CohortWorld::process_life_cycle() {
+    const bool deaths_enabled = !m_disable_deaths;
+    const bool repro_day = !m_disable_repro &&
+                           (m_day % m_repro_cycle_days) == 0;
+    CountList newborns(c_num_strategies, 0);
+
+    std::size_t kept = 0;
+    for ( std::size_t k = 0; k < m_cohorts.size(); ++k ) {
+        Cohort& cohort = m_cohorts[k];
+        const bool dead = m_day - cohort.birth_day > m_life_expectancy ||
+                          cohort.resources <= 0;
+        if ( deaths_enabled && dead ) {
+            m_deaths[cohort.strategy] += cohort.count;
+            m_dead_creatures += cohort.count;
+            continue;
+        }
+        if ( repro_day && cohort.resources >= m_repro_min_resources ) {
+            newborns[cohort.strategy] += cohort.count;
+            cohort.resources -= m_repro_cost;
+        }
+        m_cohorts[kept++] = cohort;
+    }
+    m_cohorts.resize(kept, Cohort(0, 0, 0, random_strategy));
+
+    kept = 0;
+    for ( std::size_t i = 0; i < m_individuals.size(); ++i ) {
+        if ( deaths_enabled && m_individuals.is_dead(i, m_day) ) {
+            ++m_deaths[m_individuals.strategy_value(i)];
+            ++m_dead_creatures;
+            m_individuals.release_brain(i);
+            continue;
+        }
+        if ( repro_day &&
+             m_individuals.resources(i) >= m_repro_min_resources ) {
+            ++newborns[m_individuals.strategy_value(i)];
+            m_individuals.spend_resources(i, m_repro_cost);
+        }
+        m_individuals.move(m_individuals, i, kept++);
+    }
+    m_individuals.resize(kept);
+
+    for ( std::size_t s = 0; s < c_num_strategies; ++s ) {
+        if ( newborns[s] > 0 ) {
+            m_cohorts.push_back(Cohort(newborns[s], m_repro_cost, m_day,
+                                       static_cast<unsigned char>(s)));
+            m_born_creatures += newborns[s];
+        }
+    }
+    merge_cohorts(m_cohorts);
+}
+
+
+/*
+ *  Sorts a list of cohorts, merging those with the same
+ *  characteristics and dropping any which are empty.
+ */
+
+void CohortWorld::merge_cohorts(CohortList& cohorts) {
+    std::sort(cohorts.begin(), cohorts.end());
+
+    std::size_t kept = 0;
+    for ( std::size_t k = 0; k < cohorts.size(); ++k ) {
+        if ( cohorts[k].count == 0 ) {
+            continue;
+        }
+        if ( kept > 0 && !(cohorts[kept - 1] < cohorts[k]) ) {
+            cohorts[kept - 1].count += cohorts[k].count;
+        } else {
+            cohorts[kept++] = cohorts[k];
+        }
+    }
+    cohorts.resize(kept, Cohort(0, 0, 0, random_strategy));
+}
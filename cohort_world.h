@@ -0,0 +1,185 @@
+/*
+ *  cohort_world.h
+ *  ==============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Interface to CohortWorld class for Prisoner's Dilemma simulation.
+ *
+ *  A CohortWorld is an alternative to a World for populations in which
+ *  many creatures are indistinguishable. Creatures of the same
+ *  strategy, with the same resources, born on the same day and with no
+ *  memories, behave in just the same way, so instead of a row each
+ *  they are kept together as a cohort, which is a count of creatures
+ *  with those characteristics. Creatures whose strategies never
+ *  consult their memories, i.e. always cooperate, always defect and
+ *  random, stay in cohorts all their lives, and a population made up
+ *  mostly of them takes orders of magnitude less memory and time than
+ *  it would in a World.
+ *
+ *  A cohort splits lazily, when its members' states diverge. Each day
+ *  the members of a cohort are split by their moves and by their
+ *  partners' moves, which take them to up to four new levels of
+ *  resources, and cohorts which end the day with the same
+ *  characteristics are merged again. A creature whose strategy does
+ *  consult its memories starts its first game with a memory of no one,
+ *  and so leaves its cohort, and from then on is an individual, with a
+ *  row and a Brain of its own in a Population (see population.h).
+ *  Newborns of every strategy start out in cohorts.
+ *
+ *  Every creature plays at most one game a day, against a partner
+ *  drawn at random from the whole population, as in a World with
+ *  uniform pairing. Individuals are matched one by one, against each
+ *  other or against members of cohorts, each of which is a stranger the
+ *  individual never meets again. The cohort members left over are
+ *  matched in aggregate, cooperators against defectors, by drawing the
+ *  number of mixed pairs, and sharing the players of each kind among
+ *  the cohorts by multinomial sampling. Large counts are drawn from a
+ *  normal approximation to the binomial distribution, so a cohort
+ *  world's games are random in the same way as a World's, but not
+ *  identical to them for a given seed.
+ *
+ *  Deaths and births follow the same rules as in a World. Regions,
+ *  migration, partner choice and local pairing are not supported.
+ *
+ *  Public member functions:
+ *    advance_day() - plays the day's games, and processes the day's
+ *                    deaths and births.
+ *
+ *    day() - returns the current day.
+ *
+ *    count() - returns the number of live creatures of a strategy.
+ *
+ *    num_live(), born_creatures(), dead_creatures(), games_played()
+ *        - return the number of live creatures, and running totals
+ *          since the start.
+ *
+ *    num_cohorts(), num_individuals() - return the number of cohorts,
+ *                                       and of individual creatures.
+ *
+ *    output_world_stats(), output_summary_resources_by_strategy(),
+ *    output_summary_dead_by_strategy()
+ *        - output statistics in the same formats as the World functions
+ *          of the same names.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#ifndef PG_PRIDIL_COHORT_WORLD_H
+#define PG_PRIDIL_COHORT_WORLD_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "pridil_common.h"
+#include "population.h"
+#include "brain_pool.h"
+#include "rng.h"
+
+namespace pridil {
+
+class CohortWorld {
+    public:
+
+        //  Constructor and destructor
+
+        explicit CohortWorld(const WorldInfo& wInfo);
+        ~CohortWorld();
+
+        //  Methods to advance and access the population
+
+        void advance_day();
+        Day day() const;
+        unsigned long count(const Strategy strategy) const;
+        unsigned long num_live() const;
+        unsigned long born_creatures() const;
+        unsigned long dead_creatures() const;
+        unsigned long games_played() const;
+        std::size_t num_cohorts() const;
+        std::size_t num_individuals() const;
+
+        //  Methods to output statistics
+
+        void output_world_stats(std::ostream& out) const;
+        void output_summary_resources_by_strategy(std::ostream& out) const;
+        void output_summary_dead_by_strategy(std::ostream& out) const;
+
+    private:
+
+        //  Number of creatures of one strategy, with the same
+        //  resources and birth day, and no memories, ordered by
+        //  those characteristics
+
+        struct Cohort {
+            unsigned long count;
+            int resources;
+            Day birth_day;
+            unsigned char strategy;
+
+            Cohort(const unsigned long n, const int res, const Day bd,
+                   const unsigned char stgy) :
+                count(n), resources(res), birth_day(bd), strategy(stgy) {}
+
+            bool operator<(const Cohort& other) const {
+                if ( strategy != other.strategy ) {
+                    return strategy < other.strategy;
+                } else if ( birth_day != other.birth_day ) {
+                    return birth_day < other.birth_day;
+                }
+                return resources < other.resources;
+            }
+        };
+
+        typedef std::vector<Cohort> CohortList;
+        typedef std::vector<unsigned long> CountList;
+
+        const Day m_life_expectancy;
+        const Day m_repro_cycle_days;
+        const int m_repro_cost;
+        const int m_repro_min_resources;
+        const bool m_disable_deaths;
+        const bool m_disable_repro;
+        Day m_day;
+        Rng m_rng;
+
+        unsigned long m_starting_creatures;
+        unsigned long m_born_creatures;
+        unsigned long m_dead_creatures;
+        unsigned long m_games_played;
+        CountList m_deaths;
+
+        //  The cohorts, in order, and the individuals, whose Brains
+        //  come from the pool, which must outlive them
+
+        CohortList m_cohorts;
+        BrainPool m_brains;
+        Population m_individuals;
+
+        //  Result of a game for each pair of moves, from game_result(),
+        //  and strategy names, indexed by Strategy value.
+
+        int m_payoffs[2][2];
+        std::vector<std::string> m_strategy_names;
+
+        void split_diverging();
+        void play_games();
+        void play_stranger(const std::size_t row, const CountList& sizes,
+                           const std::vector<double>& cumulative,
+                           CountList& coop_left, CountList& defect_left,
+                           CountList& outcomes);
+        void pair_cohorts(CountList& coop_left, CountList& defect_left,
+                          CountList& outcomes);
+        void apply_outcomes(const CountList& outcomes);
+        void process_life_cycle();
+        void merge_cohorts(CohortList& cohorts);
+
+        CohortWorld(const CohortWorld&);                // Prevent copying
+        CohortWorld& operator=(const CohortWorld&);     // Prevent assignment
+};
+
+}       //  namespace pridil
+
+#endif      // PG_PRIDIL_COHORT_WORLD_H
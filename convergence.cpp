@@ -0,0 +1,97 @@
+/*
+ *  convergence.cpp
+ *  ===============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Implementation of ConvergenceMonitor class for Prisoners' Dilemma
+ *  simulation.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include "convergence.h"
+
+using namespace pridil;
+
+
+/*
+ *  Constructor.
+ *
+ *  Arguments:
+ *    num_statistics -- the number of statistics in each sample
+ *    window -- the number of samples to keep, at least two
+ *    tolerance -- the largest standard deviation, relative to the mean
+ *                 or absolute, at which a statistic has converged
+ */
+
+ConvergenceMonitor::ConvergenceMonitor(const std::size_t num_statistics,
+                                       const std::size_t window,
+                                       const double tolerance) :
+        m_num_statistics(num_statistics),
+        m_window(std::max(window, static_cast<std::size_t>(2))),
+        m_tolerance(tolerance),
+        m_samples(0),
+        m_converged(false),
+        m_values(m_num_statistics * m_window, 0.0) {}
+
+
+/*
+ *  Adds a sample to the window, in place of the oldest sample once the
+ *  window is full, and returns true if every statistic has converged,
+ *  as described in convergence.h. Samples with the wrong number of
+ *  statistics are padded with zeroes or cut short.
+ */
+
+bool ConvergenceMonitor::add_sample(const std::vector<double>& sample) {
+    const std::size_t slot = (m_samples % m_window) * m_num_statistics;
+    for ( std::size_t s = 0; s < m_num_statistics; ++s ) {
+        m_values[slot + s] = (s < sample.size()) ? sample[s] : 0.0;
+    }
+    ++m_samples;
+
+    m_converged = (m_samples >= m_window);
+    for ( std::size_t s = 0; m_converged && s < m_num_statistics; ++s ) {
+        double mean = 0.0;
+        for ( std::size_t w = 0; w < m_window; ++w ) {
+            mean += m_values[w * m_num_statistics + s];
+        }
+        mean /= m_window;
+
+        double variance = 0.0;
+        for ( std::size_t w = 0; w < m_window; ++w ) {
+            const double deviation = m_values[w * m_num_statistics + s] -
+                                     mean;
+            variance += deviation * deviation;
+        }
+        variance /= m_window - 1;
+
+        const double scale = std::max(std::fabs(mean), 1.0);
+        m_converged = std::sqrt(variance) <= m_tolerance * scale;
+    }
+    return m_converged;
+}
+
+
+/*
+ *  Returns true if the statistics had converged as of the last sample.
+ */
+
+bool ConvergenceMonitor::converged() const {
+    return m_converged;
+}
+
+
+/*
+ *  Returns the number of samples added so far.
+ */
+
+unsigned long ConvergenceMonitor::samples() const {
+    return m_samples;
+}
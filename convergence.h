@@ -0,0 +1,79 @@
+/*
+ *  convergence.h
+ *  =============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Interface to ConvergenceMonitor class for Prisoner's Dilemma
+ *  simulation.
+ *
+ *  A ConvergenceMonitor decides when a run has settled down, e.g. when
+ *  the share of the population and the average resources of each
+ *  strategy in a World have stopped changing, so that the run can be
+ *  stopped early. It is given a sample of a fixed number of statistics
+ *  from time to time, and keeps the last few samples, a window of
+ *  them, in a ring.
+ *
+ *  The statistics have converged once the window is full and, for
+ *  every statistic, the standard deviation of its values in the window
+ *  is no more than the tolerance times the mean of those values, or
+ *  than the tolerance itself for a mean between -1 and 1. Shares of
+ *  the population, which lie between 0 and 1, are therefore held to
+ *  an absolute tolerance, and larger statistics such as resources to a
+ *  relative one. The variances are worked out afresh from the window
+ *  for each sample, so no rounding errors build up over a long run.
+ *
+ *  Public member functions:
+ *    add_sample() - adds a sample of the statistics to the window,
+ *                   dropping the oldest sample if the window is full,
+ *                   and returns true if the statistics have converged.
+ *
+ *    converged() - returns true if the statistics had converged as of
+ *                  the last sample.
+ *
+ *    samples() - returns the number of samples added so far.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#ifndef PG_PRIDIL_CONVERGENCE_H
+#define PG_PRIDIL_CONVERGENCE_H
+
+#include <cstddef>
+#include <vector>
+
+namespace pridil {
+
+class ConvergenceMonitor {
+    public:
+
+        //  Constructor
+
+        ConvergenceMonitor(const std::size_t num_statistics,
+                           const std::size_t window,
+                           const double tolerance);
+
+        //  Methods to add samples and test for convergence
+
+        bool add_sample(const std::vector<double>& sample);
+        bool converged() const;
+        unsigned long samples() const;
+
+    private:
+        const std::size_t m_num_statistics;
+        const std::size_t m_window;
+        const double m_tolerance;
+        unsigned long m_samples;
+        bool m_converged;
+
+        //  The samples in the window, one after another, with the next
+        //  to be replaced at position m_samples % m_window
+
+        std::vector<double> m_values;
+};
+
+}       //  namespace pridil
+
+#endif      // PG_PRIDIL_CONVERGENCE_H
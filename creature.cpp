@@ -12,14 +12,41 @@
 
 
 #include <ostream>
+#include <sstream>
+#include <iomanip>
+#include <cstddef>
 #include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <algorithm>
+#include <limits>
+#include <cmath>
 #include <cstdlib>
+#include <ctime>
 #include <cassert>
 #include "creature.h"
 
 using namespace pridil;
 
 
+/*
+ *  Number of strategies, for statistics kept by strategy, and the
+ *  strategies which have genes, in the order in which the starting
+ *  population places them.
+ */
+
+namespace {
+    const std::size_t c_num_strategies = always_defect + 1;
+    const Strategy c_gene_strategies[] = { random_strategy, tit_for_tat,
+                                           tit_for_two_tats,
+                                           susp_tit_for_tat, naive_prober,
+                                           always_cooperate, always_defect };
+    const std::size_t c_num_gene_strategies =
+            sizeof(c_gene_strategies) / sizeof(c_gene_strategies[0]);
+}
+
+
 /*
  *  Initialize static class variable used to calculate the
  *  ID of a newly created creature.
@@ -39,6 +66,18 @@ Creature::Creature(const CreatureInit& c_init)
         m_resources(c_init.starting_resources) {}
 
 
+/*
+ *  Constructor for a creature with an ID previously obtained
+ *  from reserve_ids().
+ */
+
+Creature::Creature(const CreatureInit& c_init, const CreatureID id)
+      : m_id(id),
+        m_brain(c_init),
+        m_age(0),
+        m_resources(c_init.starting_resources) {}
+
+
 /*
  *  Destructor.
  */
@@ -102,6 +141,26 @@ Strategy Creature::strategy_value() const {
 }
 
 
+/*
+ *  Returns the number of games the creature has played.
+ */
+
+unsigned int Creature::games_played() const {
+    return m_brain.games_played();
+}
+
+
+/*
+ *  Returns a tombstone recording the creature, which died on the
+ *  specified day.
+ */
+
+Tombstone Creature::tombstone(const Day death_day) const {
+    return Tombstone(m_id, death_day - m_age, death_day, m_resources,
+                     m_brain.games_played(), m_brain.strategy_value());
+}
+
+
 /*
  *  Outputs the creature's detailed memories.
  */
@@ -123,6 +182,11 @@ GameMove Creature::get_game_move(const CreatureID opponent) const {
     return m_brain.get_game_move(opponent);
 }
 
+GameMove Creature::get_game_move(const CreatureID opponent,
+                                 const uint32_t draw) const {
+    return m_brain.get_game_move(opponent, draw);
+}
+
 
 /*
  *  Stores the detailed results of a game in memory.
@@ -134,6 +198,26 @@ void Creature::give_game_result(const GameInfo& g_info) {
 }
 
 
+/*
+ *  Erases all memories of games with the specified opponent.
+ */
+
+void Creature::forget(const CreatureID opponent) {
+    m_brain.forget(opponent);
+}
+
+
+/*
+ *  Returns true if the opponent defected in the last game the creature
+ *  remembers playing against it.
+ */
+
+bool Creature::refuses(const CreatureID opponent) const {
+    return m_brain.num_memories(opponent) > 0 &&
+           m_brain.remember_move(opponent) == defect;
+}
+
+
 /*
  *  Member function ages the creature by one day.
  */
@@ -157,3 +241,369 @@ void Creature::age_day() {
 Creature * Creature::reproduce() {
     return m_brain.reproduce(m_resources);
 }
+
+
+/*
+ *  Member function reproduces, if desired, giving the offspring the
+ *  specified ID, which should have been obtained from reserve_ids().
+ *
+ *  Returns:
+ *    A pointer to the newly created creature, if successful, or to
+ *    0 (NULL) if reproduction did not take place.
+ */
+
+Creature * Creature::reproduce(const CreatureID child_id) {
+    return m_brain.reproduce(m_resources, child_id);
+}
+
+
+/*
+ *  Returns true if the creature has sufficient resources to reproduce.
+ */
+
+bool Creature::can_reproduce() const {
+    return m_brain.can_reproduce(m_resources);
+}
+
+
+/*
+ *  Reserves a block of consecutive creature IDs.
+ *
+ *  Arguments:
+ *    count -- the number of IDs to reserve
+ *
+ *  Returns:
+ *    The first reserved ID. The IDs from the returned value up to
+ *    but not including the returned value plus count will not be
+ *    given to any creature created without a specified ID.
+ */
+
+CreatureID Creature::reserve_ids(const unsigned int count) {
+    const CreatureID first_id = c_next_id;
+    c_next_id += count;
+    return first_id;
+}
+
+
+/*
+ *  Describes the starting population of creatures described by a
+ *  WorldInfo structure, with the creatures of each strategy together.
+ *
+ *  Arguments:
+ *    wInfo -- the number of creatures of each strategy, and their
+ *             life expectancies, starting resources and reproduction
+ *             characteristics
+ *    strategies -- set to the strategy of each creature, in order
+ *
+ *  Returns:
+ *    A CreatureInit structure describing every creature, apart from
+ *    its strategy.
+ */
+
+CreatureInit pridil::starting_population(const WorldInfo& wInfo,
+                                         std::vector<Strategy>& strategies) {
+    strategies.clear();
+    for ( std::size_t s = 0; s < c_num_gene_strategies; ++s ) {
+        const int count = starting_count(wInfo, c_gene_strategies[s]);
+        for ( int i = 0; i < count; ++i ) {
+            strategies.push_back(c_gene_strategies[s]);
+        }
+    }
+
+    CreatureInit c_init;
+    c_init.life_expectancy = wInfo.m_default_life_expectancy;
+    c_init.life_expectancy_range = wInfo.m_default_life_expectancy_range;
+    c_init.starting_resources = wInfo.m_default_starting_resources;
+    c_init.repro_cost = wInfo.m_repro_cost;
+    c_init.repro_min_resources = wInfo.m_repro_min_resources;
+    return c_init;
+}
+
+
+/*
+ *  Creates the starting population of creatures described by a
+ *  WorldInfo structure, with the creatures of each strategy together,
+ *  and appends them to a list.
+ *
+ *  Arguments:
+ *    wInfo -- the number of creatures of each strategy, and their
+ *             life expectancies, starting resources and reproduction
+ *             characteristics
+ *    creatures -- the list to which the new creatures are appended
+ *
+ *  Returns:
+ *    The number of creatures created.
+ *
+ *  If there is any problem with construction, the creatures created
+ *  so far are deleted and removed from the list, and the exception is
+ *  re-thrown.
+ */
+
+unsigned int pridil::create_creatures(const WorldInfo& wInfo,
+                                      CreatureList& creatures) {
+    std::vector<Strategy> strategies;
+    CreatureInit c_init = starting_population(wInfo, strategies);
+
+    const std::size_t first_new = creatures.size();
+    try {
+        for ( std::size_t i = 0; i < strategies.size(); ++i ) {
+            c_init.strategy = strategies[i];
+            creatures.push_back(new Creature(c_init));
+        }
+    } catch(...) {
+
+        //  Free allocated creatures if there was any problem
+        //  with construction
+
+        for ( std::size_t i = first_new; i < creatures.size(); ++i ) {
+            delete creatures[i];
+        }
+        creatures.resize(first_new);
+
+        throw;                      // Re-throw exception to caller
+    }
+
+    return creatures.size() - first_new;
+}
+
+
+
+/*
+ *  Returns the strategies which have genes, in the order in which the
+ *  starting population places them.
+ */
+
+std::vector<Strategy> pridil::gene_strategies() {
+    return std::vector<Strategy>(c_gene_strategies,
+                                 c_gene_strategies + c_num_gene_strategies);
+}
+
+
+/*
+ *  Returns the number of creatures of a strategy in the starting
+ *  population described by a WorldInfo structure, or zero for a
+ *  strategy without a gene.
+ */
+
+int pridil::starting_count(const WorldInfo& wInfo, const Strategy strategy) {
+    int count = 0;
+    switch ( strategy ) {
+        case random_strategy:
+            count = wInfo.m_random_strategy;
+            break;
+
+        case tit_for_tat:
+            count = wInfo.m_tit_for_tat;
+            break;
+
+        case tit_for_two_tats:
+            count = wInfo.m_tit_for_two_tats;
+            break;
+
+        case susp_tit_for_tat:
+            count = wInfo.m_susp_tit_for_tat;
+            break;
+
+        case naive_prober:
+            count = wInfo.m_naive_prober;
+            break;
+
+        case always_cooperate:
+            count = wInfo.m_always_cooperate;
+            break;
+
+        case always_defect:
+            count = wInfo.m_always_defect;
+            break;
+
+        default:
+            break;
+    }
+    return (count > 0) ? count : 0;
+}
+
+
+/*
+ *  Returns the characteristics given to every newborn, apart from its
+ *  strategy, which it takes from its parent. As in ReproGene, a newborn
+ *  starts with the resources its parent spent on it.
+ */
+
+CreatureInit pridil::offspring_init(const WorldInfo& wInfo) {
+    return CreatureInit(wInfo.m_default_life_expectancy,
+                        wInfo.m_default_life_expectancy_range,
+                        random_strategy, wInfo.m_repro_cost,
+                        wInfo.m_repro_cost, wInfo.m_repro_min_resources);
+}
+
+
+/*
+ *  Returns a seed, or a seed chosen from the current time if it is
+ *  zero.
+ */
+
+unsigned long pridil::seed_or_time(const unsigned long seed) {
+    return (seed != 0) ? seed : static_cast<unsigned long>(std::time(0));
+}
+
+
+/*
+ *  Seeds std::rand(), from which the random strategy and naive prober
+ *  genes draw their random moves, so that an engine's creatures follow
+ *  its seed.
+ */
+
+void pridil::seed_strategy_genes(const unsigned long seed) {
+    std::srand(static_cast<unsigned int>(seed_or_time(seed)));
+}
+
+/*
+ *  Constructor for StrategyStats, with no creatures.
+ */
+
+StrategyStats::StrategyStats() :
+        num_creatures(0),
+        max_res(std::numeric_limits<int>().min()),
+        min_res(std::numeric_limits<int>().max()),
+        avg_res(0) {}
+
+
+/*
+ *  Adds a number of creatures with the same resources to the
+ *  statistics.
+ *
+ *  Arguments:
+ *    resources -- the resources of each of the creatures
+ *    number -- the number of creatures
+ */
+
+void StrategyStats::add(const int resources, const double number) {
+    num_creatures += number;
+    min_res = std::min(min_res, resources);
+    max_res = std::max(max_res, resources);
+    avg_res = (avg_res * (num_creatures - number) + resources * number) /
+              num_creatures;
+}
+
+
+/*
+ *  Returns the name of every strategy, indexed by its Strategy value,
+ *  as given by the strategy genes. Strategies without genes have
+ *  empty names.
+ */
+
+std::vector<std::string> pridil::strategy_names() {
+    std::vector<std::string> names(c_num_strategies);
+    for ( std::size_t s = 0; s < c_num_gene_strategies; ++s ) {
+        CreatureInit c_init;
+        c_init.strategy = c_gene_strategies[s];
+        const Creature probe(c_init, 0);
+        names[c_gene_strategies[s]] = probe.strategy();
+    }
+    return names;
+}
+
+
+/*
+ *  Returns an expected number of creatures rounded to the nearest
+ *  whole creature, as a string, since it may be too large for any
+ *  integer type.
+ */
+
+std::string pridil::whole_creatures(const double creatures) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(0)
+        << std::floor(creatures + 0.5);
+    return out.str();
+}
+
+
+/*
+ *  Outputs summary resources statistics for the strategies of all
+ *  living creatures, ranked by average resources from high to low.
+ *  Strategies with less than half a creature are left out.
+ *
+ *  Arguments:
+ *    out -- the ostream object to which to output
+ *    stats -- the statistics for each strategy, indexed by its
+ *             Strategy value
+ */
+
+void pridil::output_resources_by_strategy(std::ostream& out,
+                                          const StrategyStatsList& stats) {
+    typedef std::vector<std::pair<double, std::string> > VPDS;
+    typedef std::map<std::string, std::size_t> MSS;
+
+    const std::vector<std::string> names = strategy_names();
+    MSS strategy_map;
+    VPDS srtd_strgy;
+
+    //  Sort strategies by average resources, low to high, and by name
+    //  where the averages are equal
+
+    for ( std::size_t s = 0; s < stats.size(); ++s ) {
+        if ( stats[s].num_creatures >= 0.5 ) {
+            strategy_map[names[s]] = s;
+            srtd_strgy.push_back(std::make_pair(stats[s].avg_res, names[s]));
+        }
+    }
+    std::sort(srtd_strgy.begin(), srtd_strgy.end());
+
+
+    //  Output summary resource statistcs from high to low, using
+    //  a reverse iterator
+
+    int ranking = 1;
+    out << "Summary resource statistics by strategy:" << std::endl;
+    for ( VPDS::reverse_iterator itr = srtd_strgy.rbegin();
+            itr != srtd_strgy.rend(); ++itr ) {
+        const std::string& strategy = itr->second;
+        const StrategyStats& s_stats = stats[strategy_map[strategy]];
+
+        out << ranking++ << ", "
+            << strategy << " ("
+            << whole_creatures(s_stats.num_creatures) << "): "
+            << "max " << s_stats.max_res
+            << ", min " << s_stats.min_res
+            << ", sprd " << s_stats.max_res - s_stats.min_res
+            << ", avg " << s_stats.avg_res
+            << std::endl;
+    }
+    out << std::endl;
+}
+
+
+/*
+ *  Outputs summary statistics for the number of creatures by strategy
+ *  that have died, in order of strategy name. Strategies with less than
+ *  half a creature dead are left out.
+ *
+ *  Arguments:
+ *    out -- the ostream object to which to output
+ *    deaths -- the number of creatures of each strategy that have
+ *              died, indexed by its Strategy value
+ */
+
+void pridil::output_deaths_by_strategy(std::ostream& out,
+                                       const std::vector<double>& deaths) {
+    typedef std::map<std::string, double> MSD;
+
+    const std::vector<std::string> names = strategy_names();
+    MSD strategy_map;
+    for ( std::size_t s = 0; s < deaths.size(); ++s ) {
+        if ( deaths[s] >= 0.5 ) {
+            strategy_map[names[s]] = deaths[s];
+        }
+    }
+
+    out << "Summary deaths by strategy:" << std::endl;
+    for ( MSD::const_iterator itr = strategy_map.begin();
+            itr != strategy_map.end(); ++itr ) {
+        const double number_dead = itr->second;
+        out << whole_creatures(number_dead) << " "
+            << itr->first << " creature"
+            << (number_dead >= 1.5 ? "s" : "") << " died."
+            << std::endl;
+    }
+    out << std::endl;
+}
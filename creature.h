@@ -37,9 +37,17 @@
  *    strategy_value() - returns a Strategy enumeration representation of
  *                       the creature's game-playing strategy.
  *
+ *    games_played() - returns the number of games the creature has
+ *                     played.
+ *
+ *    tombstone() - returns a record of the creature once it has died,
+ *                  to be kept after the creature itself is deleted.
+ *
  *    detailed_memories() - outputs all of the creature's memories.
  *
- *    get_game_move() - returns a game move against a specified opponent.
+ *    get_game_move() - returns a game move against a specified opponent,
+ *                      optionally taking any random choice from a draw
+ *                      (see strategy_gene.h).
  *                      The move will be calculated based on the creature's
  *                      game-playing strategy which, depending on the
  *                      individual strategy, may or may not consult memories
@@ -47,10 +55,68 @@
  *
  *    give_game_result() - stores the provided game result in memory.
  *
+ *    forget() - erases all memories of games with a specified opponent.
+ *
+ *    refuses() - returns true if the creature remembers the specified
+ *                opponent defecting in their last game, and so would
+ *                refuse to play it again when partners may be chosen.
+ *
  *    age_day() - ages the creature by one day.
  *
+ *    can_reproduce() - returns true if the creature's resources are
+ *                      sufficient to reproduce.
+ *
  *    reproduce() - returns a pointer to a newly created creature if the
  *                  creature's resources are sufficient to reproduce.
+ *                  The offspring may optionally be given a specific ID,
+ *                  previously obtained from reserve_ids().
+ *
+ *  Static member functions:
+ *    reserve_ids() - reserves a block of consecutive IDs for creatures
+ *                    to be created later, and returns the first of them.
+ *                    Used to give offspring the same IDs they would have
+ *                    had if they had been created one at a time, when
+ *                    they are in fact created in parallel.
+ *
+ *  Creatures in a World are not Creature objects, but rows of a
+ *  Population (see population.h), which keeps the same state in dense
+ *  arrays and shares the Brain class with Creature. Creature objects
+ *  are used wherever creatures are not held in a Population.
+ *
+ *  Non-member functions:
+ *    starting_population() - describes the starting population of
+ *                            creatures given by a WorldInfo structure.
+ *
+ *    create_creatures() - creates the starting population of creatures
+ *                         described by a WorldInfo structure.
+ *
+ *    gene_strategies() - returns the strategies which have genes, in
+ *                        the order in which the starting population
+ *                        places them.
+ *
+ *    starting_count() - returns the number of creatures of a strategy
+ *                       in the starting population.
+ *
+ *    offspring_init() - returns the characteristics given to every
+ *                       newborn, apart from its strategy.
+ *
+ *    seed_or_time() - returns a seed, or the time if the seed is zero.
+ *
+ *    seed_strategy_genes() - seeds std::rand(), which the random
+ *                            strategies use.
+ *
+ *    strategy_names() - returns the name of every strategy, indexed
+ *                       by its Strategy value.
+ *
+ *    whole_creatures() - returns an expected number of creatures
+ *                        rounded to the nearest whole creature.
+ *
+ *    output_resources_by_strategy() - outputs resources statistics for
+ *                                     the creatures of each strategy,
+ *                                     ranked by average resources.
+ *
+ *    output_deaths_by_strategy() - outputs the number of creatures of
+ *                                  each strategy that have died.
  *
  *  Distributed under the terms of the GNU General Public License.
  *  http://www.gnu.org/licenses/
@@ -62,6 +128,8 @@
 
 #include <ostream>
 #include <string>
+#include <vector>
+#include <stdint.h>
 #include "pridil_common.h"
 #include "brain_complex.h"
 
@@ -78,6 +146,7 @@ class Creature {
         //  Constructor and destructor
 
         explicit Creature(const CreatureInit& cInit);
+        Creature(const CreatureInit& cInit, const CreatureID id);
         ~Creature();
 
         //  Getter methods
@@ -88,17 +157,26 @@ class Creature {
         bool is_dead() const;
         const std::string strategy() const;
         Strategy strategy_value() const;
+        unsigned int games_played() const;
+        Tombstone tombstone(const Day death_day) const;
         void detailed_memories(std::ostream& out) const;
 
         //  Gaming and aging methods
 
         GameMove get_game_move(const CreatureID opponent) const;
+        GameMove get_game_move(const CreatureID opponent,
+                               const uint32_t draw) const;
         void give_game_result(const GameInfo& g_info);
+        void forget(const CreatureID opponent);
+        bool refuses(const CreatureID opponent) const;
         void age_day();
 
-        //  Reproduction member function
+        //  Reproduction member functions
 
+        bool can_reproduce() const;
         Creature * reproduce();
+        Creature * reproduce(const CreatureID child_id);
+        static CreatureID reserve_ids(const unsigned int count);
 
     private:
         static int c_next_id;
@@ -122,6 +200,52 @@ class Creature {
 typedef std::vector<Creature *> CreatureList;
 
 
+/*
+ *  Functions to describe and create a starting population
+ */
+
+CreatureInit starting_population(const WorldInfo& wInfo,
+                                 std::vector<Strategy>& strategies);
+unsigned int create_creatures(const WorldInfo& wInfo,
+                              CreatureList& creatures);
+std::vector<Strategy> gene_strategies();
+int starting_count(const WorldInfo& wInfo, const Strategy strategy);
+CreatureInit offspring_init(const WorldInfo& wInfo);
+unsigned long seed_or_time(const unsigned long seed);
+void seed_strategy_genes(const unsigned long seed);
+
+
+/*
+ *  Resources statistics for the creatures of one strategy. The number
+ *  of creatures need not be whole, for engines which follow expected
+ *  numbers of creatures.
+ */
+
+struct StrategyStats {
+    double num_creatures;
+    int max_res;
+    int min_res;
+    double avg_res;
+
+    StrategyStats();
+    void add(const int resources, const double number = 1);
+};
+
+typedef std::vector<StrategyStats> StrategyStatsList;
+
+
+/*
+ *  Functions to output summary statistics by strategy, as for a World
+ */
+
+std::vector<std::string> strategy_names();
+std::string whole_creatures(const double creatures);
+void output_resources_by_strategy(std::ostream& out,
+                                  const StrategyStatsList& stats);
+void output_deaths_by_strategy(std::ostream& out,
+                               const std::vector<double>& deaths);
+
+
 /*
  *  Function object used for sorting CreatureLists
  */
@@ -82,6 +82,25 @@ Creature * DNA::reproduce(int& resources) const {
 }
 
 
+/*
+ *  Returns a reproduced creature with the specified ID if the
+ *  specified resources are adequate.
+ */
+
+Creature * DNA::reproduce(int& resources, const CreatureID child_id) const {
+    return m_repro_gene->reproduce(resources, child_id);
+}
+
+
+/*
+ *  Returns true if the specified resources are adequate to reproduce.
+ */
+
+bool DNA::can_reproduce(const int resources) const {
+    return m_repro_gene->can_reproduce(resources);
+}
+
+
 /*
  *  Gets a game move against a particular opponent.
  *
@@ -92,3 +111,45 @@ Creature * DNA::reproduce(int& resources) const {
 GameMove DNA::get_game_move(const CreatureID opponent) const {
     return m_strategy_gene->get_game_move(opponent);
 }
+
+
+/*
+ *  Gets a game move given the history of games with an opponent, as
+ *  kept during a match, without consulting memory.
+ */
+
+GameMove DNA::get_match_move(const MatchHistory& history) const {
+    return m_strategy_gene->get_match_move(history);
+}
+
+
+/*
+ *  Get game moves as above, with any random choice taken from the
+ *  specified draw rather than from std::rand().
+ */
+
+GameMove DNA::get_game_move(const CreatureID opponent,
+                            const uint32_t draw) const {
+    return m_strategy_gene->get_game_move(opponent, draw);
+}
+
+GameMove DNA::get_match_move(const MatchHistory& history,
+                             const uint32_t draw) const {
+    return m_strategy_gene->get_match_move(history, draw);
+}
+
+
+/*
+ *  Gives the DNA the characteristics of a new creature. The strategy
+ *  gene is only replaced if the strategy changes, and the other genes
+ *  are reset in place, so reusing the DNA of a creature with the same
+ *  strategy allocates nothing.
+ */
+
+void DNA::reset(const CreatureInit& c_init) {
+    if ( c_init.strategy != m_strategy_gene->strategy() ) {
+        m_strategy_gene = StrategyGeneFactory(m_brain, c_init);
+    }
+    m_death_gene->reset(c_init);
+    m_repro_gene->reset(c_init);
+}
@@ -0,0 +1,106 @@
+/*
+ *  fenwick_tree.cpp
+ *  ================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Implementation of FenwickTree class for Prisoners' Dilemma
+ *  simulation.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <cstddef>
+#include <vector>
+#include "fenwick_tree.h"
+
+using namespace pridil;
+
+
+/*
+ *  Constructor. All the weights start at zero.
+ *
+ *  Arguments:
+ *    size -- the number of items
+ */
+
+FenwickTree::FenwickTree(const std::size_t size) :
+        m_weights(size, 0), m_nodes(size + 1, 0), m_top_step(1) {
+    while ( m_top_step * 2 <= size ) {
+        m_top_step *= 2;
+    }
+}
+
+
+/*
+ *  Sets the weight of an item, updating each node whose range includes
+ *  the item.
+ */
+
+void FenwickTree::set(const std::size_t index, const unsigned long weight) {
+    const unsigned long change = weight - m_weights[index];
+    m_weights[index] = weight;
+    for ( std::size_t node = index + 1; node < m_nodes.size();
+          node += node & (~node + 1) ) {
+        m_nodes[node] += change;
+    }
+}
+
+
+/*
+ *  Returns the weight of an item.
+ */
+
+unsigned long FenwickTree::weight(const std::size_t index) const {
+    return m_weights[index];
+}
+
+
+/*
+ *  Returns the total weight of all the items.
+ */
+
+unsigned long FenwickTree::total() const {
+    unsigned long sum = 0;
+    for ( std::size_t node = m_weights.size(); node > 0;
+          node -= node & (~node + 1) ) {
+        sum += m_nodes[node];
+    }
+    return sum;
+}
+
+
+/*
+ *  Returns the item at a point of the running total of weights, i.e.
+ *  the first item for which the total weight of the items up to and
+ *  including it is greater than the point. Descends the tree from the
+ *  largest range down, skipping each range whose total does not reach
+ *  the point.
+ *
+ *  Arguments:
+ *    point -- the point, which must be less than the total weight
+ */
+
+std::size_t FenwickTree::find(const unsigned long point) const {
+    std::size_t node = 0;
+    unsigned long remaining = point;
+    for ( std::size_t step = m_top_step; step > 0; step /= 2 ) {
+        const std::size_t next = node + step;
+        if ( next < m_nodes.size() && m_nodes[next] <= remaining ) {
+            node = next;
+            remaining -= m_nodes[next];
+        }
+    }
+    return node;
+}
+
+
+/*
+ *  Returns the number of items.
+ */
+
+std::size_t FenwickTree::size() const {
+    return m_weights.size();
+}
@@ -0,0 +1,73 @@
+/*
+ *  fenwick_tree.h
+ *  ==============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Interface to FenwickTree class for Prisoner's Dilemma simulation.
+ *
+ *  A FenwickTree (or binary indexed tree) holds a non-negative weight
+ *  for each of a fixed number of items, e.g. the fitness of each
+ *  creature in a Moran process (see moran.h), and picks an item with
+ *  probability proportional to its weight. Changing one weight, and
+ *  finding the item at a given point of the running total of weights,
+ *  each take O(log n) time, so a weight can be updated after every
+ *  game, and an item picked at every step, without an O(n) scan of
+ *  all the weights.
+ *
+ *  Each node of the tree holds the total weight of a range of items
+ *  whose length is the lowest set bit of the node's number. Weights
+ *  are unsigned integers, so totals are exact however many updates
+ *  are made, and an update adds the difference between the new and
+ *  old weights, relying on unsigned arithmetic wrapping around.
+ *
+ *  Public member functions:
+ *    set() - sets the weight of an item.
+ *
+ *    weight() - returns the weight of an item.
+ *
+ *    total() - returns the total weight of all the items.
+ *
+ *    find() - returns the item at a point of the running total of
+ *             weights, such that an item is found for a number of
+ *             points equal to its weight.
+ *
+ *    size() - returns the number of items.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#ifndef PG_PRIDIL_FENWICK_TREE_H
+#define PG_PRIDIL_FENWICK_TREE_H
+
+#include <cstddef>
+#include <vector>
+
+namespace pridil {
+
+class FenwickTree {
+    public:
+
+        //  Constructor
+
+        explicit FenwickTree(const std::size_t size);
+
+        //  Methods to change and access the weights
+
+        void set(const std::size_t index, const unsigned long weight);
+        unsigned long weight(const std::size_t index) const;
+        unsigned long total() const;
+        std::size_t find(const unsigned long point) const;
+        std::size_t size() const;
+
+    private:
+        std::vector<unsigned long> m_weights;
+        std::vector<unsigned long> m_nodes;
+        std::size_t m_top_step;
+};
+
+}       //  namespace pridil
+
+#endif      // PG_PRIDIL_FENWICK_TREE_H
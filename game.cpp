@@ -12,7 +12,13 @@
 
 
 #include <string>
+#include <cstddef>
+#include <cmath>
+#include <stdint.h>
 #include "game.h"
+#include "creature.h"
+#include "population.h"
+#include "rng.h"
 
 using namespace pridil;
 
@@ -154,3 +160,377 @@ void pridil::game_result(GameInfo& own_ginfo, GameInfo& opp_ginfo) {
         throw BadGameMove();
     }
 }
+
+
+
+/*
+ *  Fills a table of the results calculated by game_result(), indexed
+ *  by a player's own move and its opponent's move, 0 to cooperate and
+ *  1 to defect.
+ *
+ *  Arguments: the table to fill.
+ */
+
+void pridil::payoff_table(int payoffs[2][2]) {
+    for ( int own = 0; own < 2; ++own ) {
+        for ( int other = 0; other < 2; ++other ) {
+            GameInfo own_info;
+            GameInfo other_info;
+            own_info.opponent_move = other ? defect : coop;
+            other_info.opponent_move = own ? defect : coop;
+            game_result(own_info, other_info);
+            payoffs[own][other] = own_info.result;
+        }
+    }
+}
+
+
+namespace {
+
+    /*
+     *  Number of games of a match given to the creatures at a time.
+     */
+
+    const std::size_t c_match_batch = 64;
+
+
+    /*
+     *  Longest match drawn by match_length(), which keeps a
+     *  continuation probability very close to 1 from drawing more
+     *  games than an unsigned int holds.
+     */
+
+    const unsigned int c_max_match_length = 1000000;
+
+
+    /*
+     *  Adds an opponent's move to the history of a match.
+     */
+
+    void remember(MatchHistory& history, const GameMove opponent_move) {
+        history.second_last_move = history.last_move;
+        history.last_move = opponent_move;
+        if ( history.games < 2 ) {
+            ++history.games;
+        }
+    }
+
+
+    /*
+     *  Works out the result of a game between two creatures from their
+     *  moves, leaving the result for each of them in a GameInfo
+     *  structure.
+     */
+
+    void record_game(Creature * creature1, Creature * creature2,
+                     const GameMove c1move, const GameMove c2move,
+                     GameInfo& c1info, GameInfo& c2info) {
+
+        //  Populate GameInfo objects for each creature, and
+        //  populate with the game result. Simplify the opponent's move
+        //  each time, to avoid giving a creature an indication of its
+        //  opponent's internal state with regards to game-playing
+        //  strategy.
+
+        c1info = GameInfo(creature2->id(), c1move,
+                          simplify_game_move(c2move), 0);
+        c2info = GameInfo(creature1->id(), c2move,
+                          simplify_game_move(c1move), 0);
+        game_result(c1info, c2info);
+
+        //  Communicate results of the game to each creature
+
+        creature1->give_game_result(c1info);
+        creature2->give_game_result(c2info);
+    }
+
+
+    /*
+     *  Plays a game between two creatures, leaving the result for
+     *  each of them in a GameInfo structure.
+     */
+
+    void play_and_record(Creature * creature1, Creature * creature2,
+                         GameInfo& c1info, GameInfo& c2info) {
+        const GameMove c1move = creature1->get_game_move(creature2->id());
+        const GameMove c2move = creature2->get_game_move(creature1->id());
+        record_game(creature1, creature2, c1move, c2move, c1info, c2info);
+    }
+
+
+    /*
+     *  Plays a game between two creatures as above, with any random
+     *  move taken from a draw, of which the first creature takes the
+     *  high 32 bits, and the second the low.
+     */
+
+    void play_and_record(Creature * creature1, Creature * creature2,
+                         const uint64_t draw,
+                         GameInfo& c1info, GameInfo& c2info) {
+        const GameMove c1move = creature1->get_game_move(creature2->id(),
+                                    static_cast<uint32_t>(draw >> 32));
+        const GameMove c2move = creature2->get_game_move(creature1->id(),
+                                    static_cast<uint32_t>(draw));
+        record_game(creature1, creature2, c1move, c2move, c1info, c2info);
+    }
+
+
+    /*
+     *  Plays a match of consecutive games between two creatures in a
+     *  population, as described for play_match() below, with the
+     *  moves' random choices taken from std::rand() if move_seed is
+     *  null, or else from draws hashed from the seed and the game.
+     */
+
+    void play_population_match(Population& population,
+                               const std::size_t first,
+                               const std::size_t second,
+                               const unsigned int rounds,
+                               const uint64_t * move_seed) {
+        const CreatureID id1 = population.id(first);
+        const CreatureID id2 = population.id(second);
+        MatchHistory history1 = population.match_history(first, id2);
+        MatchHistory history2 = population.match_history(second, id1);
+
+        GameInfo games1[c_match_batch];
+        GameInfo games2[c_match_batch];
+        std::size_t batched = 0;
+        int total1 = 0;
+        int total2 = 0;
+        for ( unsigned int round = 0; round < rounds; ++round ) {
+            GameMove c1move;
+            GameMove c2move;
+            if ( move_seed == 0 ) {
+                c1move = population.get_match_move(first, history1);
+                c2move = population.get_match_move(second, history2);
+            } else {
+                const uint64_t draw = mix_seed(*move_seed, round);
+                c1move = population.get_match_move(first, history1,
+                                        static_cast<uint32_t>(draw >> 32));
+                c2move = population.get_match_move(second, history2,
+                                        static_cast<uint32_t>(draw));
+            }
+
+            GameInfo& c1info = games1[batched];
+            GameInfo& c2info = games2[batched];
+            c1info = GameInfo(id2, c1move, simplify_game_move(c2move), 0);
+            c2info = GameInfo(id1, c2move, simplify_game_move(c1move), 0);
+            game_result(c1info, c2info);
+            total1 += c1info.result;
+            total2 += c2info.result;
+            remember(history1, c1info.opponent_move);
+            remember(history2, c2info.opponent_move);
+
+            if ( ++batched == c_match_batch || round + 1 == rounds ) {
+                population.give_match_result(first, games1, batched, total1);
+                population.give_match_result(second, games2, batched, total2);
+                batched = 0;
+                total1 = 0;
+                total2 = 0;
+            }
+        }
+    }
+
+}
+
+
+/*
+ *  Plays a game between two creatures.
+ *
+ *  Each creature is asked for a move, and told the ID of their
+ *  opponent so that they can remember previous games with that
+ *  opponent. The result of the game is calculated, and each
+ *  creature is informed of the result so that they can update
+ *  their memories.
+ *
+ *  Arguments: a pointer to each of the two creatures playing.
+ */
+
+void pridil::play_game(Creature * creature1, Creature * creature2) {
+    GameInfo c1info;
+    GameInfo c2info;
+    play_and_record(creature1, creature2, c1info, c2info);
+}
+
+
+/*
+ *  Plays a game between two creatures as above, with any random move
+ *  taken from a draw rather than from std::rand(), so that the game
+ *  follows the draw alone.
+ *
+ *  Arguments:
+ *    creature1, creature2 -- pointers to the two creatures playing
+ *    draw -- a random 64-bit number, of which the first creature's
+ *            move takes the high 32 bits, and the second's the low
+ */
+
+void pridil::play_game(Creature * creature1, Creature * creature2,
+                       const uint64_t draw) {
+    GameInfo c1info;
+    GameInfo c2info;
+    play_and_record(creature1, creature2, draw, c1info, c2info);
+}
+
+
+/*
+ *  Plays a game between two creatures in a population, in just the
+ *  same way as between two Creature objects.
+ *
+ *  Arguments:
+ *    population -- the population holding both creatures
+ *    first, second -- the rows of the two creatures playing
+ */
+
+void pridil::play_game(Population& population, const std::size_t first,
+                       const std::size_t second) {
+    const CreatureID id1 = population.id(first);
+    const CreatureID id2 = population.id(second);
+    const GameMove c1move = population.get_game_move(first, id2);
+    const GameMove c2move = population.get_game_move(second, id1);
+
+    GameInfo c1info(id2, c1move, simplify_game_move(c2move), 0);
+    GameInfo c2info(id1, c2move, simplify_game_move(c1move), 0);
+    game_result(c1info, c2info);
+
+    population.give_game_result(first, c1info);
+    population.give_game_result(second, c2info);
+}
+
+
+/*
+ *  Plays a match of consecutive games between two creatures, each
+ *  game played as by play_game(), so each creature remembers the
+ *  earlier games of the match when choosing its moves.
+ *
+ *  Arguments:
+ *    creature1, creature2 -- pointers to the two creatures playing
+ *    rounds -- the number of games in the match
+ *    score1, score2 -- set to the total result of the match's games
+ *                      for each of the creatures
+ */
+
+void pridil::play_match(Creature * creature1, Creature * creature2,
+                        const int rounds, int& score1, int& score2) {
+    GameInfo c1info;
+    GameInfo c2info;
+
+    score1 = 0;
+    score2 = 0;
+    for ( int round = 0; round < rounds; ++round ) {
+        play_and_record(creature1, creature2, c1info, c2info);
+        score1 += c1info.result;
+        score2 += c2info.result;
+    }
+}
+
+
+/*
+ *  Plays a match as above, with any random move in the match's n-th
+ *  game, counting from 0, taken from a draw hashed from a seed and n,
+ *  as by play_game() with that draw, so the match follows the seed
+ *  alone whichever thread plays it.
+ *
+ *  Arguments:
+ *    creature1, creature2 -- pointers to the two creatures playing
+ *    rounds -- the number of games in the match
+ *    score1, score2 -- set to the total result of the match's games
+ *                      for each of the creatures
+ *    move_seed -- the seed from which the draws are hashed
+ */
+
+void pridil::play_match(Creature * creature1, Creature * creature2,
+                        const int rounds, int& score1, int& score2,
+                        const uint64_t move_seed) {
+    GameInfo c1info;
+    GameInfo c2info;
+
+    score1 = 0;
+    score2 = 0;
+    for ( int round = 0; round < rounds; ++round ) {
+        play_and_record(creature1, creature2, mix_seed(move_seed, round),
+                        c1info, c2info);
+        score1 += c1info.result;
+        score2 += c2info.result;
+    }
+}
+
+
+/*
+ *  Plays a match of consecutive games between two creatures in a
+ *  population, with the same moves and results as calling play_game()
+ *  for each game.
+ *
+ *  Each creature's history of games with the other is looked up once,
+ *  kept up to date during the match, and handed to its strategy gene
+ *  for each move. The games are gathered for each creature, and given
+ *  to it with their total result in a single update at the end of the
+ *  match, or every c_match_batch games in a longer match.
+ *
+ *  Arguments:
+ *    population -- the population holding both creatures
+ *    first, second -- the rows of the two creatures playing
+ *    rounds -- the number of games in the match
+ */
+
+void pridil::play_match(Population& population, const std::size_t first,
+                        const std::size_t second, const unsigned int rounds) {
+    play_population_match(population, first, second, rounds, 0);
+}
+
+
+/*
+ *  Plays a match as above, with any random move in the match's n-th
+ *  game, counting from 0, taken from a draw hashed from a seed and n,
+ *  rather than from std::rand(), so the match follows the seed alone
+ *  whichever thread plays it.
+ *
+ *  Arguments:
+ *    population -- the population holding both creatures
+ *    first, second -- the rows of the two creatures playing
+ *    rounds -- the number of games in the match
+ *    move_seed -- the seed from which the draws are hashed, the first
+ *                 creature's move taking the high 32 bits of each
+ *                 draw, and the second's the low
+ */
+
+void pridil::play_match(Population& population, const std::size_t first,
+                        const std::size_t second, const unsigned int rounds,
+                        const uint64_t move_seed) {
+    play_population_match(population, first, second, rounds, &move_seed);
+}
+
+
+/*
+ *  Returns the number of games in a match, either a fixed number, or a
+ *  number drawn from a geometric distribution, as if another game were
+ *  played after each with a fixed probability. Drawn numbers are
+ *  capped at c_max_match_length, a million games.
+ *
+ *  Arguments:
+ *    rounds -- the fixed number of games, used if continuation_prob
+ *              is not between 0 and 1
+ *    continuation_prob -- the probability of playing another game
+ *    draw -- a random 64-bit number, from which the number of games
+ *            is drawn with a single inversion of the distribution
+ */
+
+unsigned int pridil::match_length(const unsigned int rounds,
+                                  const double continuation_prob,
+                                  const uint64_t draw) {
+    if ( continuation_prob <= 0.0 || continuation_prob >= 1.0 ) {
+        return rounds;
+    }
+
+    //  A uniform number in (0, 1], from the top 53 bits of the draw
+
+    const double uniform = ((draw >> 11) + 1) / 9007199254740992.0;
+    const double extra = std::log(uniform) / std::log(continuation_prob);
+
+    //  Cap the number before the cast, which is undefined for numbers
+    //  an unsigned int cannot hold
+
+    if ( extra >= c_max_match_length - 1 ) {
+        return c_max_match_length;
+    }
+    return 1 + static_cast<unsigned int>(extra);
+}
@@ -7,7 +7,15 @@
  *  Interface to Game functionality for Prisoners' Dilemma simulation.
  *
  *  The provided functions allow for the calculation of game results,
- *  and for the simplication and naming of game moves.
+ *  for the simplication and naming of game moves, and for playing
+ *  games and matches of several games between two creatures.
+ *
+ *  A match between two creatures in a Population keeps each creature's
+ *  recent history of the match in a MatchHistory, from which the
+ *  strategy genes choose their moves, rather than searching memory
+ *  before every game, and gives each creature its games and their total
+ *  result in one update at the end, or every so many games in a long
+ *  match, rather than one update per game.
  *
  *  Distributed under the terms of the GNU General Public License.
  *  http://www.gnu.org/licenses/
@@ -17,13 +25,37 @@
 #ifndef PG_PRIDIL_GAME_H
 #define PG_PRIDIL_GAME_H
 
+#include <cstddef>
 #include <string>
+#include <stdint.h>
 #include "pridil_common.h"
 
 namespace pridil {
+    class Creature;
+    class Population;
+
     std::string game_move_name(const GameMove& move);
     GameMove simplify_game_move(const GameMove& move);
     void game_result(GameInfo& own_ginfo, GameInfo& opp_ginfo);
+    void payoff_table(int payoffs[2][2]);
+    void play_game(Creature * creature1, Creature * creature2);
+    void play_game(Creature * creature1, Creature * creature2,
+                   const uint64_t draw);
+    void play_game(Population& population, const std::size_t first,
+                   const std::size_t second);
+    void play_match(Creature * creature1, Creature * creature2,
+                    const int rounds, int& score1, int& score2);
+    void play_match(Creature * creature1, Creature * creature2,
+                    const int rounds, int& score1, int& score2,
+                    const uint64_t move_seed);
+    void play_match(Population& population, const std::size_t first,
+                    const std::size_t second, const unsigned int rounds);
+    void play_match(Population& population, const std::size_t first,
+                    const std::size_t second, const unsigned int rounds,
+                    const uint64_t move_seed);
+    unsigned int match_length(const unsigned int rounds,
+                              const double continuation_prob,
+                              const uint64_t draw);
 }
 
 #endif      // PG_PRIDIL_GAME_H
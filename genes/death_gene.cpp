@@ -34,3 +34,12 @@ std::string DeathGene::name() const {
     return "death gene";
 }
 
+
+/*
+ *  Resets the gene with the life expectancy of a new creature.
+ */
+
+void DeathGene::reset(const CreatureInit& c_init) {
+    m_life_expectancy = c_init.life_expectancy;
+    m_life_expectancy_range = c_init.life_expectancy_range;
+}
@@ -30,6 +30,7 @@ class DeathGene : public Gene {
             m_life_expectancy_range(c_init.life_expectancy_range) {}
         virtual std::string name() const;
         bool is_dead(Day age) const;
+        void reset(const CreatureInit& c_init);
 
     private:
         Day m_life_expectancy;
@@ -42,10 +42,47 @@ std::string ReproGene::name() const {
 Creature * ReproGene::reproduce(int& resources) const {
     Creature * new_creature = 0;
 
-    if ( resources >= m_offspring_init.repro_min_resources ) {
+    if ( can_reproduce(resources) ) {
         new_creature = new Creature(m_offspring_init);
         resources -= m_offspring_init.repro_cost;
     }
 
     return new_creature;
 }
+
+
+/*
+ *  Returns an offspring with the specified ID
+ */
+
+Creature * ReproGene::reproduce(int& resources,
+                                const CreatureID child_id) const {
+    Creature * new_creature = 0;
+
+    if ( can_reproduce(resources) ) {
+        new_creature = new Creature(m_offspring_init, child_id);
+        resources -= m_offspring_init.repro_cost;
+    }
+
+    return new_creature;
+}
+
+
+/*
+ *  Returns true if the provided resources are enough to reproduce.
+ */
+
+bool ReproGene::can_reproduce(const int resources) const {
+    return resources >= m_offspring_init.repro_min_resources;
+}
+
+
+/*
+ *  Resets the gene with the reproduction characteristics of a new
+ *  creature.
+ */
+
+void ReproGene::reset(const CreatureInit& c_init) {
+    m_offspring_init = c_init;
+    m_offspring_init.starting_resources = c_init.repro_cost;
+}
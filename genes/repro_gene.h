@@ -27,7 +27,10 @@ class ReproGene : public Gene {
     public:
         explicit ReproGene(const Brain& brain, const CreatureInit& c_init);
         virtual std::string name() const;
+        bool can_reproduce(const int resources) const;
         Creature * reproduce(int& resources) const;
+        Creature * reproduce(int& resources, const CreatureID child_id) const;
+        void reset(const CreatureInit& c_init);
 
     private:
         CreatureInit m_offspring_init;
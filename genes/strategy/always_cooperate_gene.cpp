@@ -29,7 +29,7 @@ std::string AlwaysCooperateGene::name() const {
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 
 /*
- *  Disable GCC unused-parameter warnings for the following function, which
+ *  Disable GCC unused-parameter warnings for the following functions, which
  *  is virtual. The parameter is needed for this function in other gene
  *  classes, and are deliberately ignored for this where the strategy
  *  is independent of any memories of previous interactions with the
@@ -46,4 +46,9 @@ GameMove AlwaysCooperateGene::get_game_move(const CreatureID opponent) const {
     return coop;
 }
 
+GameMove AlwaysCooperateGene::get_match_move(const MatchHistory& history)
+        const {
+    return coop;
+}
+
 #pragma GCC diagnostic pop
@@ -28,6 +28,7 @@ class AlwaysCooperateGene : public StrategyGene {
             StrategyGene(brain, always_cooperate) {}
         virtual std::string name() const;
         virtual GameMove get_game_move(const CreatureID opponent) const;
+        virtual GameMove get_match_move(const MatchHistory& history) const;
 };
 
 
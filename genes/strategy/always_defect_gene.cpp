@@ -30,8 +30,8 @@ std::string AlwaysDefectGene::name() const {
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 
 /*
- *  Disable GCC unused-parameter warnings for the following function, which
- *  is virtual. The parameter is needed for this function in other
+ *  Disable GCC unused-parameter warnings for the following functions, which
+ *  are virtual. The parameters are needed for these functions in other
  *  classes, and are deliberately ignored for these where the strategy
  *  is independent of any memories of previous interactions with the
  *  opponent creature.
@@ -47,4 +47,8 @@ GameMove AlwaysDefectGene::get_game_move(const CreatureID opponent) const {
     return defect;
 }
 
+GameMove AlwaysDefectGene::get_match_move(const MatchHistory& history) const {
+    return defect;
+}
+
 #pragma GCC diagnostic pop
@@ -28,6 +28,7 @@ class AlwaysDefectGene : public StrategyGene {
             StrategyGene(brain, always_defect) {}
         virtual std::string name() const;
         virtual GameMove get_game_move(const CreatureID opponent) const;
+        virtual GameMove get_match_move(const MatchHistory& history) const;
 };
 
 
@@ -12,7 +12,7 @@
 
 
 #include <string>
-#include <cstdlib>
+#include <stdint.h>
 #include "../../pridil_common.h"
 #include "naive_prober_gene.h"
 
@@ -32,20 +32,34 @@ std::string NaiveProberGene::name() const {
  *  NaiveProberGene works in the same way as TitForTatGene, except on
  *  each move there is a random probability (such probability
  *  represented by the m_prob_random_defect member) of it defecting.
- *  It is therefore nastier than TitForTatGene.
+ *  It is therefore nastier than TitForTatGene. The random defection is
+ *  taken from a draw, from std::rand() if none is given.
  */
 
 GameMove NaiveProberGene::get_game_move(const CreatureID opponent) const {
+    return get_game_move(opponent, random_draw());
+}
+
+GameMove NaiveProberGene::get_game_move(const CreatureID opponent,
+                                        const uint32_t draw) const {
+    return get_match_move(m_brain.match_history(opponent), draw);
+}
+
+GameMove NaiveProberGene::get_match_move(const MatchHistory& history) const {
+    return get_match_move(history, random_draw());
+}
+
+GameMove NaiveProberGene::get_match_move(const MatchHistory& history,
+                                         const uint32_t draw) const {
     GameMove my_move;
 
-    if ( m_brain.recognize(opponent) == false ) {
+    if ( history.games == 0 ) {
         my_move = coop;
     } else {
-        if ( m_brain.remember_move(opponent) == defect ) {
+        if ( history.last_move == defect ) {
             my_move = defect_retal;
         } else {
-            if ( ((static_cast<double> (rand())) / RAND_MAX) <
-                  m_prob_random_defect ) {
+            if ( drawn(draw, m_prob_random_defect) ) {
                 my_move = defect_random;
             } else {
                 my_move = coop_recip;
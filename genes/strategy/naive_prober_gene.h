@@ -15,6 +15,7 @@
 #define PG_PRIDIL_NAIVE_PROBER_GENE_H
 
 #include <string>
+#include <stdint.h>
 #include "../../pridil_common.h"
 #include "../strategy_gene.h"
 
@@ -32,6 +33,11 @@ class NaiveProberGene : public StrategyGene {
             m_prob_random_defect(0.2) {}
         virtual std::string name() const;
         virtual GameMove get_game_move(const CreatureID opponent) const;
+        virtual GameMove get_game_move(const CreatureID opponent,
+                                       const uint32_t draw) const;
+        virtual GameMove get_match_move(const MatchHistory& history) const;
+        virtual GameMove get_match_move(const MatchHistory& history,
+                                        const uint32_t draw) const;
 };
 
 
@@ -12,7 +12,7 @@
 
 
 #include <string>
-#include <cstdlib>
+#include <stdint.h>
 #include "../../pridil_common.h"
 #include "random_strategy_gene.h"
 
@@ -31,8 +31,8 @@ std::string RandomStrategyGene::name() const {
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 
 /*
- *  Disable GCC unused-parameter warnings for the following function, which
- *  is virtual. The parameter is needed for this function in other
+ *  Disable GCC unused-parameter warnings for the following functions, which
+ *  are virtual. The parameters are needed for these functions in other
  *  classes, and are deliberately ignored for these where the strategy
  *  is independent of any memories of previous interactions with the
  *  opponent creature.
@@ -45,7 +45,22 @@ std::string RandomStrategyGene::name() const {
  */
 
 GameMove RandomStrategyGene::get_game_move(const CreatureID opponent) const {
-    return ( (rand() % 2) ? coop : defect );
+    return get_match_move(MatchHistory(), random_draw());
+}
+
+GameMove RandomStrategyGene::get_game_move(const CreatureID opponent,
+                                           const uint32_t draw) const {
+    return get_match_move(MatchHistory(), draw);
+}
+
+GameMove RandomStrategyGene::get_match_move(const MatchHistory& history)
+        const {
+    return get_match_move(history, random_draw());
+}
+
+GameMove RandomStrategyGene::get_match_move(const MatchHistory& history,
+                                            const uint32_t draw) const {
+    return drawn(draw, 0.5) ? defect : coop;
 }
 
 #pragma GCC diagnostic pop
@@ -15,6 +15,7 @@
 #define PG_PRIDIL_RANDOM_STRATEGY_GENE_H
 
 #include <string>
+#include <stdint.h>
 #include "../../pridil_common.h"
 #include "../strategy_gene.h"
 
@@ -28,6 +29,11 @@ class RandomStrategyGene : public StrategyGene {
             StrategyGene(brain, random_strategy) {}
         virtual std::string name() const;
         virtual GameMove get_game_move(const CreatureID opponent) const;
+        virtual GameMove get_game_move(const CreatureID opponent,
+                                       const uint32_t draw) const;
+        virtual GameMove get_match_move(const MatchHistory& history) const;
+        virtual GameMove get_match_move(const MatchHistory& history,
+                                        const uint32_t draw) const;
 };
 
 
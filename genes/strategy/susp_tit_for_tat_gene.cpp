@@ -34,13 +34,14 @@ std::string SuspTitForTatGene::name() const {
  *  TitForTatGene.
  */
 
-GameMove SuspTitForTatGene::get_game_move(const CreatureID opponent) const {
+GameMove SuspTitForTatGene::get_match_move(const MatchHistory& history)
+        const {
     GameMove my_move;
 
-    if ( m_brain.recognize(opponent) == false ) {
+    if ( history.games == 0 ) {
         my_move = defect;
     } else {
-        if ( m_brain.remember_move(opponent) == defect ) {
+        if ( history.last_move == defect ) {
             my_move = defect_retal;
         } else {
             my_move = coop_recip;
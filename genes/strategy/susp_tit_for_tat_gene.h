@@ -27,7 +27,7 @@ class SuspTitForTatGene : public StrategyGene {
         explicit SuspTitForTatGene(const Brain& brain) :
             StrategyGene(brain, susp_tit_for_tat) {}
         virtual std::string name() const;
-        virtual GameMove get_game_move(const CreatureID opponent) const;
+        virtual GameMove get_match_move(const MatchHistory& history) const;
 };
 
 
@@ -34,13 +34,13 @@ std::string TitForTatGene::name() const {
  *  if that opponent defected during the preceding game.
  */
 
-GameMove TitForTatGene::get_game_move(const CreatureID opponent) const {
+GameMove TitForTatGene::get_match_move(const MatchHistory& history) const {
     GameMove my_move;
 
-    if ( m_brain.recognize(opponent) == false ) {
+    if ( history.games == 0 ) {
         my_move = coop;
     } else {
-        if ( m_brain.remember_move(opponent) == defect ) {
+        if ( history.last_move == defect ) {
             my_move = defect_retal;
         } else {
             my_move = coop_recip;
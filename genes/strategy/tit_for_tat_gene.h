@@ -27,7 +27,7 @@ class TitForTatGene : public StrategyGene {
         explicit TitForTatGene(const Brain& brain) :
             StrategyGene(brain, tit_for_tat) {}
         virtual std::string name() const;
-        virtual GameMove get_game_move(const CreatureID opponent) const;
+        virtual GameMove get_match_move(const MatchHistory& history) const;
 };
 
 
@@ -42,26 +42,25 @@ std::string TitForTwoTatsGene::name() const {
  *  SuspTitForTatGene).
  */
 
-GameMove TitForTwoTatsGene::get_game_move(const CreatureID opponent) const {
+GameMove TitForTwoTatsGene::get_match_move(const MatchHistory& history)
+        const {
     GameMove my_move;
 
-    if ( m_brain.recognize(opponent) == false ) {
+    if ( history.games == 0 ) {
         my_move = coop;
     } else {
-        unsigned int n_moves = m_brain.num_memories(opponent);
-
-        if ( n_moves < 2 ) {
-            if ( m_brain.remember_move(opponent) == coop ) {
+        if ( history.games < 2 ) {
+            if ( history.last_move == coop ) {
                 my_move = coop_recip;
             } else {
                 my_move = coop;
             }
         } else {
-            if ( m_brain.remember_move(opponent) == defect &&
-                 m_brain.remember_move(opponent, 2) == defect ) {
+            if ( history.last_move == defect &&
+                 history.second_last_move == defect ) {
                 my_move = defect_retal;
-            } else if ( m_brain.remember_move(opponent) == defect &&
-                        m_brain.remember_move(opponent, 2) == coop ) {
+            } else if ( history.last_move == defect &&
+                        history.second_last_move == coop ) {
                 my_move = coop;
             } else {
                 my_move = coop_recip;
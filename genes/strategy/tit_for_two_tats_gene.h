@@ -27,7 +27,7 @@ class TitForTwoTatsGene : public StrategyGene {
         explicit TitForTwoTatsGene(const Brain& brain) :
             StrategyGene(brain, tit_for_two_tats) {}
         virtual std::string name() const;
-        virtual GameMove get_game_move(const CreatureID opponent) const;
+        virtual GameMove get_match_move(const MatchHistory& history) const;
 };
 
 
@@ -12,6 +12,8 @@
 
 
 #include <memory>
+#include <cstdlib>
+#include <stdint.h>
 #include "../pridil_common.h"
 #include "strategy_gene.h"
 #include "strategy/strategy_genes.h"
@@ -19,6 +21,60 @@
 using namespace pridil;
 
 
+/*
+ *  Returns a game move against the specified opponent, given the
+ *  history of games with that opponent held in memory. Genes whose
+ *  moves do not depend on memory override this to save searching it.
+ */
+
+GameMove StrategyGene::get_game_move(const CreatureID opponent) const {
+    return get_match_move(m_brain.match_history(opponent));
+}
+
+
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+/*
+ *  Return a game move against the specified opponent, or given the
+ *  history of games with an opponent, taking any random choice from a
+ *  draw. Genes whose moves are not random ignore the draw, so these
+ *  are the same as the overloads without one. Genes which move at
+ *  random override them.
+ */
+
+GameMove StrategyGene::get_game_move(const CreatureID opponent,
+                                     const uint32_t draw) const {
+    return get_game_move(opponent);
+}
+
+GameMove StrategyGene::get_match_move(const MatchHistory& history,
+                                      const uint32_t draw) const {
+    return get_match_move(history);
+}
+
+#pragma GCC diagnostic pop
+
+
+/*
+ *  Returns a draw taken from std::rand(), for moves made without one.
+ */
+
+uint32_t StrategyGene::random_draw() {
+    return static_cast<uint32_t>(std::rand() / (RAND_MAX + 1.0) *
+                                 4294967296.0);
+}
+
+
+/*
+ *  Returns true if a choice with the specified chance is taken on a
+ *  draw, i.e. if the draw is below the chance out of 2^32.
+ */
+
+bool StrategyGene::drawn(const uint32_t draw, const double chance) {
+    return draw < chance * 4294967296.0;
+}
+
+
 /*
  *  Returns a strategy gene's strategy.
  */
@@ -6,6 +6,17 @@
  *
  *  Interface to StrategyGene
  *
+ *  A strategy gene chooses a creature's moves. Genes which choose at
+ *  random may be given a draw, a 32-bit number drawn uniformly by the
+ *  caller, from which to take their random choices, so that engines
+ *  which play games on several threads can hash a draw for each game
+ *  instead of sharing std::rand(). A gene takes a choice with a given
+ *  chance when the draw is below that chance out of 2^32 (see
+ *  drawn()), so its chance of defecting can be found by searching for
+ *  the lowest draw on which it cooperates. The overloads without a
+ *  draw take one from std::rand(). Genes whose moves are not random
+ *  ignore the draw.
+ *
  *  Distributed under the terms of the GNU General Public License.
  *  http://www.gnu.org/licenses/
  */
@@ -16,6 +27,7 @@
 
 #include <string>
 #include <memory>
+#include <stdint.h>
 #include "../pridil_common.h"
 #include "gene.h"
 
@@ -27,9 +39,19 @@ class StrategyGene : public Gene {
         explicit StrategyGene(const Brain& brain,
                               const Strategy strategy) :
             Gene(brain), m_strategy(strategy) {}
-        virtual GameMove get_game_move(const CreatureID opponent) const = 0;
+        virtual GameMove get_game_move(const CreatureID opponent) const;
+        virtual GameMove get_game_move(const CreatureID opponent,
+                                       const uint32_t draw) const;
+        virtual GameMove get_match_move(const MatchHistory& history)
+            const = 0;
+        virtual GameMove get_match_move(const MatchHistory& history,
+                                        const uint32_t draw) const;
         virtual Strategy strategy() const;
 
+    protected:
+        static uint32_t random_draw();
+        static bool drawn(const uint32_t draw, const double chance);
+
     private:
         Strategy m_strategy;
 };
@@ -0,0 +1,435 @@
+/*
+ *  gillespie.cpp
+ *  =============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Implementation of Gillespie class for Prisoners' Dilemma simulation.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <ctime>
+#include "pridil_common.h"
+#include "gillespie.h"
+#include "creature.h"
+#include "game.h"
+
+using std::endl;
+using std::map;
+using std::ostream;
+using std::pair;
+using std::string;
+using std::vector;
+
+using namespace pridil;
+
+
+/*
+ *  Number of strategies, for statistics kept by strategy, and the
+ *  position of a row which is not in the list of creatures able to
+ *  reproduce.
+ */
+
+namespace {
+    const std::size_t c_num_strategies = always_defect + 1;
+    const std::size_t c_not_listed = static_cast<std::size_t>(-1);
+
+
+    /*
+     *  Returns the rate at which each creature able to reproduce does
+     *  so, or zero if reproduction is disabled.
+     */
+
+    double repro_rate(const WorldInfo& wInfo) {
+        if ( wInfo.m_disable_repro ) {
+            return 0;
+        }
+        return 1.0 / (wInfo.m_repro_cycle_days > 0 ?
+                      wInfo.m_repro_cycle_days : 1);
+    }
+
+
+    /*
+     *  Returns the slot map location of a row.
+     */
+
+    SlotLocation slot_location(const std::size_t row) {
+        return SlotLocation(0, static_cast<uint32_t>(row));
+    }
+}
+
+
+/*
+ *  Constructor. Creates the starting population as a World does, and
+ *  schedules each creature's death of old age.
+ *
+ *  Arguments:
+ *    wInfo -- the starting population, starting resources, life
+ *             expectancy, reproduction characteristics and seed, as
+ *             for a World
+ */
+
+Gillespie::Gillespie(const WorldInfo& wInfo) :
+        m_deaths_enabled(!wInfo.m_disable_deaths),
+        m_repro_rate(repro_rate(wInfo)),
+        m_offspring_init(offspring_init(wInfo)),
+        m_day(1),
+        m_time(0),
+        m_rng(seed_or_time(wInfo.m_seed)),
+        m_starting_creatures(0),
+        m_games_played(0),
+        m_born_creatures(0),
+        m_dead_creatures(0),
+        m_events(0),
+        m_brains(),
+        m_creatures(&m_brains),
+        m_slots(),
+        m_deaths_due(),
+        m_repro_rows(),
+        m_repro_positions(),
+        m_counts(c_num_strategies, 0),
+        m_deaths(c_num_strategies, 0),
+        m_strategy_names(strategy_names()) {
+
+    seed_strategy_genes(wInfo.m_seed);
+
+    m_starting_creatures = create_creatures(wInfo, m_creatures);
+    for ( std::size_t i = 0; i < m_creatures.size(); ++i ) {
+        m_creatures.set_handle(i, m_slots.insert(slot_location(i)));
+        track(i);
+    }
+}
+
+
+/*
+ *  Destructor.
+ */
+
+Gillespie::~Gillespie() {}
+
+
+/*
+ *  Processes the events falling in the next day, up to and including
+ *  its end. At each step, the time to the next encounter or birth is
+ *  drawn from the exponential distribution with their total rate, and
+ *  a death of old age falling due first happens instead.
+ */
+
+void Gillespie::advance_day() {
+    const double day_end = m_day;
+
+    while ( true ) {
+        const double encounter_rate = m_creatures.size() > 1 ?
+                                      m_creatures.size() / 2.0 : 0;
+        const double birth_rate = m_repro_rate * m_repro_rows.size();
+        const double total_rate = encounter_rate + birth_rate;
+
+        double next_time = std::numeric_limits<double>::max();
+        if ( total_rate > 0 ) {
+            next_time = m_time - std::log(1.0 - m_rng.uniform()) / total_rate;
+        }
+
+        const double death_time = next_death_time();
+        if ( death_time <= next_time && death_time <= day_end ) {
+            m_time = death_time;
+            const CreatureHandle handle = m_deaths_due.front().handle;
+            std::pop_heap(m_deaths_due.begin(), m_deaths_due.end());
+            m_deaths_due.pop_back();
+            die(m_slots.location(handle).row);
+        } else if ( next_time <= day_end ) {
+            m_time = next_time;
+            if ( m_rng.uniform() * total_rate < encounter_rate ) {
+                encounter();
+            } else {
+                reproduce();
+            }
+        } else {
+            m_time = day_end;
+            break;
+        }
+        ++m_events;
+    }
+    ++m_day;
+}
+
+
+/*
+ *  Returns the current day.
+ */
+
+Day Gillespie::day() const {
+    return m_day;
+}
+
+
+/*
+ *  Returns the time of the last event, or of the end of the last day.
+ */
+
+double Gillespie::time() const {
+    return m_time;
+}
+
+
+/*
+ *  Returns the number of creatures.
+ */
+
+std::size_t Gillespie::size() const {
+    return m_creatures.size();
+}
+
+
+/*
+ *  Returns the number of creatures of a strategy.
+ */
+
+std::size_t Gillespie::count(const Strategy strategy) const {
+    return m_counts[strategy];
+}
+
+
+/*
+ *  Returns the creatures.
+ */
+
+const Population& Gillespie::creatures() const {
+    return m_creatures;
+}
+
+
+/*
+ *  Return running totals.
+ */
+
+unsigned long Gillespie::games_played() const {
+    return m_games_played;
+}
+
+unsigned long Gillespie::born_creatures() const {
+    return m_born_creatures;
+}
+
+unsigned long Gillespie::dead_creatures() const {
+    return m_dead_creatures;
+}
+
+
+/*
+ *  Member function outputs summary statistics, as for a World, with
+ *  the number of events processed.
+ *
+ *  Arguments: reference to a ostream object to which to output.
+ */
+
+void Gillespie::output_world_stats(ostream& out) const {
+    out << "Summary world statistics:" << endl
+        << "Days passed: " << m_day - 1 << endl
+        << "Games played: " << m_games_played << endl
+        << "Starting creatures: " << m_starting_creatures << endl
+        << "Living creatures: " << m_creatures.size() << endl
+        << "Creatures born: " << m_born_creatures << endl
+        << "Creatures died: " << m_dead_creatures << endl
+        << "Events processed: " << m_events << endl
+        << endl;
+}
+
+
+/*
+ *  Member function outputs summary statistics for the creatures of
+ *  each strategy, as for a World, ranked by average resources.
+ *
+ *  Arguments: reference to a ostream object to which to output.
+ */
+
+void Gillespie::output_summary_resources_by_strategy(ostream& out) const {
+    StrategyStatsList strategy_stats(c_num_strategies);
+    for ( std::size_t i = 0; i < m_creatures.size(); ++i ) {
+        strategy_stats[m_creatures.strategy_value(i)].add(
+                m_creatures.resources(i));
+    }
+    output_resources_by_strategy(out, strategy_stats);
+}
+
+
+/*
+ *  Member function outputs the number of creatures of each strategy
+ *  that have died, as for a World.
+ *
+ *  Arguments: reference to a ostream object to which to output.
+ */
+
+void Gillespie::output_summary_dead_by_strategy(ostream& out) const {
+    output_deaths_by_strategy(out, vector<double>(m_deaths.begin(),
+                                                  m_deaths.end()));
+}
+
+
+/*
+ *  Starts keeping track of a creature in a new row: counts it,
+ *  schedules its death of old age, at the same age as in a World, and
+ *  lists it if it is able to reproduce.
+ */
+
+void Gillespie::track(const std::size_t row) {
+    ++m_counts[m_creatures.strategy_value(row)];
+    m_repro_positions.push_back(c_not_listed);
+    update_repro(row);
+
+    if ( m_deaths_enabled ) {
+        const double age_at_death = m_creatures.life_expectancy(row) + 1.0;
+        m_deaths_due.push_back(DeathEvent(m_time + age_at_death,
+                                          m_creatures.handle(row)));
+        std::push_heap(m_deaths_due.begin(), m_deaths_due.end());
+    }
+}
+
+
+/*
+ *  Plays a game between two different, uniformly chosen creatures.
+ *  A creature left with no resources dies at once.
+ */
+
+void Gillespie::encounter() {
+    const uint32_t num_creatures =
+        static_cast<uint32_t>(m_creatures.size());
+    const std::size_t first = m_rng.below(num_creatures);
+    std::size_t second = m_rng.below(num_creatures - 1);
+    if ( second >= first ) {
+        ++second;
+    }
+
+    play_game(m_creatures, first, second);
+    ++m_games_played;
+
+    //  Deal with the later row first, since a death moves the last row
+
+    const std::size_t later = std::max(first, second);
+    const std::size_t earlier = std::min(first, second);
+    const std::size_t rows[] = { later, earlier };
+    for ( int i = 0; i < 2; ++i ) {
+        if ( m_deaths_enabled && m_creatures.resources(rows[i]) <= 0 ) {
+            die(rows[i]);
+        } else {
+            update_repro(rows[i]);
+        }
+    }
+}
+
+
+/*
+ *  A uniformly chosen creature of those able to reproduce pays the
+ *  cost of reproducing, and its newborn is added to the end of the
+ *  creatures, with the parent's strategy and the cost as its
+ *  resources. A parent left with no resources dies at once.
+ */
+
+void Gillespie::reproduce() {
+    const std::size_t parent = m_repro_rows[
+        m_rng.below(static_cast<uint32_t>(m_repro_rows.size()))];
+
+    CreatureInit child_init = m_offspring_init;
+    child_init.strategy = m_creatures.strategy_value(parent);
+    m_creatures.spend_resources(parent, child_init.repro_cost);
+
+    const std::size_t child = m_creatures.add(child_init,
+                                              Creature::reserve_ids(1),
+                                              m_day);
+    m_creatures.set_handle(child, m_slots.insert(slot_location(child)));
+    track(child);
+    ++m_born_creatures;
+
+    if ( m_deaths_enabled && m_creatures.resources(parent) <= 0 ) {
+        die(parent);
+    } else {
+        update_repro(parent);
+    }
+}
+
+
+/*
+ *  Removes a creature which has died, freeing its handle and giving its
+ *  Brain back to the pool, and moves the last row into its place.
+ */
+
+void Gillespie::die(const std::size_t row) {
+    const Strategy strategy = m_creatures.strategy_value(row);
+    --m_counts[strategy];
+    ++m_deaths[strategy];
+    ++m_dead_creatures;
+
+    m_slots.erase(m_creatures.handle(row));
+    m_creatures.release_brain(row);
+    m_creatures.set_handle(row, SlotMap::null_handle);
+    update_repro(row);
+
+    const std::size_t last = m_creatures.size() - 1;
+    if ( row != last ) {
+        m_creatures.move(m_creatures, last, row);
+        m_slots.relocate(m_creatures.handle(row), slot_location(row));
+
+        const std::size_t position = m_repro_positions[last];
+        m_repro_positions[row] = position;
+        if ( position != c_not_listed ) {
+            m_repro_rows[position] = row;
+        }
+    }
+    m_creatures.resize(last);
+    m_repro_positions.resize(last);
+}
+
+
+/*
+ *  Adds a row to the list of creatures able to reproduce if it has at
+ *  least the minimum resources, or removes it if it has not, or if it
+ *  has died. A row is removed by moving the last row of the list into
+ *  its place.
+ */
+
+void Gillespie::update_repro(const std::size_t row) {
+    const bool able = m_repro_rate > 0 &&
+                      m_creatures.handle(row) != SlotMap::null_handle &&
+                      m_creatures.resources(row) >=
+                          m_offspring_init.repro_min_resources;
+    const std::size_t position = m_repro_positions[row];
+
+    if ( able && position == c_not_listed ) {
+        m_repro_positions[row] = m_repro_rows.size();
+        m_repro_rows.push_back(row);
+    } else if ( !able && position != c_not_listed ) {
+        const std::size_t moved = m_repro_rows.back();
+        m_repro_rows[position] = moved;
+        m_repro_positions[moved] = position;
+        m_repro_rows.pop_back();
+        m_repro_positions[row] = c_not_listed;
+    }
+}
+
+
+/*
+ *  Returns the time of the next death of old age, dropping any deaths
+ *  due for creatures which have already starved, or the largest double
+ *  if there are none.
+ */
+
+double Gillespie::next_death_time() {
+    while ( !m_deaths_due.empty() &&
+            !m_slots.contains(m_deaths_due.front().handle) ) {
+        std::pop_heap(m_deaths_due.begin(), m_deaths_due.end());
+        m_deaths_due.pop_back();
+    }
+    return m_deaths_due.empty() ? std::numeric_limits<double>::max() :
+                                  m_deaths_due.front().time;
+}
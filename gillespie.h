@@ -0,0 +1,179 @@
+/*
+ *  gillespie.h
+ *  ===========
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Interface to Gillespie class for Prisoner's Dilemma simulation.
+ *
+ *  A Gillespie is an alternative to a World which runs in continuous
+ *  time. Instead of every creature playing exactly one game a day, and
+ *  dying and reproducing only at the end of a day, encounters, deaths
+ *  and births happen one at a time, as events, at times drawn with
+ *  Gillespie's stochastic simulation algorithm.
+ *
+ *  The rates of the events follow from the same settings as a World,
+ *  with a day as the unit of time:
+ *
+ *   - encounters between two uniformly chosen creatures happen at a
+ *     rate of half the number of creatures a day, so each creature
+ *     plays one game a day on average, as in a World;
+ *
+ *   - each creature with at least the minimum resources to reproduce
+ *     reproduces at a rate of once per reproduction cycle, paying the
+ *     cost of reproducing, and its newborn starts with that cost as its
+ *     resources, as in a World;
+ *
+ *   - each creature dies of old age when its age passes its life
+ *     expectancy, at the same age as in a World, and dies of starvation
+ *     as soon as a game leaves it with no resources.
+ *
+ *  The time to the next encounter or birth is drawn from an exponential
+ *  distribution with the total rate of both, and which of them happens
+ *  is then chosen in proportion to their rates. Deaths of old age
+ *  happen at fixed times, kept in a binary heap, and if one falls due
+ *  before the next encounter or birth, it happens first, and the time
+ *  to the next encounter or birth is drawn again, which the memoryless
+ *  exponential distribution allows. The creatures able to reproduce are
+ *  kept in a list, so each event takes O(log n) time at most, and none
+ *  of the creatures not involved in an event is touched.
+ *
+ *  Creatures are held in a Population (see population.h), whose Brains
+ *  come from a BrainPool (see brain_pool.h), with handles in a SlotMap
+ *  (see slot_map.h), so the heap refers to creatures by handles, which
+ *  go stale if the creature starves first. A creature which dies is
+ *  replaced by the last row. Deaths and reproduction can be disabled,
+ *  as for a World. Regions, migration, partner choice and local pairing
+ *  are not supported.
+ *
+ *  Public member functions:
+ *    advance_day() - processes the events falling in the next day.
+ *
+ *    day() - returns the current day.
+ *
+ *    time() - returns the time of the last event, or of the end of the
+ *             last day.
+ *
+ *    size() - returns the number of creatures.
+ *
+ *    count() - returns the number of creatures of a strategy.
+ *
+ *    creatures() - returns the creatures.
+ *
+ *    games_played(), born_creatures(), dead_creatures() - return
+ *                                running totals since the start.
+ *
+ *    output_world_stats(), output_summary_resources_by_strategy(),
+ *    output_summary_dead_by_strategy()
+ *        - output statistics in the same formats as the World functions
+ *          of the same names, with the number of events processed.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#ifndef PG_PRIDIL_GILLESPIE_H
+#define PG_PRIDIL_GILLESPIE_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "pridil_common.h"
+#include "population.h"
+#include "brain_pool.h"
+#include "slot_map.h"
+#include "rng.h"
+
+namespace pridil {
+
+class Gillespie {
+    public:
+
+        //  Constructor and destructor
+
+        explicit Gillespie(const WorldInfo& wInfo);
+        ~Gillespie();
+
+        //  Methods to advance and access the population
+
+        void advance_day();
+        Day day() const;
+        double time() const;
+        std::size_t size() const;
+        std::size_t count(const Strategy strategy) const;
+        const Population& creatures() const;
+        unsigned long games_played() const;
+        unsigned long born_creatures() const;
+        unsigned long dead_creatures() const;
+
+        //  Methods to output statistics
+
+        void output_world_stats(std::ostream& out) const;
+        void output_summary_resources_by_strategy(std::ostream& out) const;
+        void output_summary_dead_by_strategy(std::ostream& out) const;
+
+    private:
+
+        //  A death of old age due at a fixed time
+
+        struct DeathEvent {
+            double time;
+            CreatureHandle handle;
+
+            DeathEvent(const double due, const CreatureHandle creature) :
+                time(due), handle(creature) {}
+
+            bool operator<(const DeathEvent& other) const {
+                return time > other.time;       // Earliest at the top
+            }
+        };
+
+        const bool m_deaths_enabled;
+        const double m_repro_rate;
+        CreatureInit m_offspring_init;
+        Day m_day;
+        double m_time;
+        Rng m_rng;
+        unsigned int m_starting_creatures;
+        unsigned long m_games_played;
+        unsigned long m_born_creatures;
+        unsigned long m_dead_creatures;
+        unsigned long m_events;
+
+        //  The creatures, whose Brains come from the pool, which must
+        //  outlive them, and their handles
+
+        BrainPool m_brains;
+        Population m_creatures;
+        SlotMap m_slots;
+
+        //  Deaths of old age, as a heap, and the rows of the creatures
+        //  able to reproduce, with each row's position in the list
+
+        std::vector<DeathEvent> m_deaths_due;
+        std::vector<std::size_t> m_repro_rows;
+        std::vector<std::size_t> m_repro_positions;
+
+        //  Live creatures and deaths, and strategy names, indexed by
+        //  Strategy value
+
+        std::vector<std::size_t> m_counts;
+        std::vector<unsigned long> m_deaths;
+        std::vector<std::string> m_strategy_names;
+
+        void track(const std::size_t row);
+        void encounter();
+        void reproduce();
+        void die(const std::size_t row);
+        void update_repro(const std::size_t row);
+        double next_death_time();
+
+        Gillespie(const Gillespie&);                // Prevent copying
+        Gillespie& operator=(const Gillespie&);     // Prevent assignment
+};
+
+}       //  namespace pridil
+
+#endif      // PG_PRIDIL_GILLESPIE_H
@@ -0,0 +1,850 @@
+/*
+ *  graph.cpp
+ *  =========
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Implementation of Graph class for Prisoners' Dilemma simulation.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <cstddef>
+#include <istream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <stdint.h>
+#include "pridil_exceptions.h"
+#include "graph.h"
+#include "thread_pool.h"
+#include "rng.h"
+
+using std::vector;
+
+using namespace pridil;
+
+
+/*
+ *  Sizes of the chunks into which edges and slots are divided for the
+ *  parallel passes. Generators also draw each chunk's random numbers
+ *  from a stream of its own, so these also fix the networks generated
+ *  from a given seed, and should not be changed lightly.
+ */
+
+namespace {
+    const std::size_t c_edges_per_chunk = 16384;
+    const std::size_t c_slots_per_chunk = 4096;
+    const uint64_t c_small_world_stream = 0x736D616C6CUL;
+    const uint64_t c_scale_free_stream = 0x7363616C65UL;
+}
+
+
+const std::size_t Graph::no_half_edge;
+
+
+/*
+ *  Parallel task to build the CSR arrays from a list of edges.
+ *
+ *  The task runs in five passes, with prefix sums over the slots in
+ *  between:
+ *
+ *   - count_pass: over chunks of edges, counts each slot's half-edges
+ *     with atomic increments, ignoring edges from a slot to itself.
+ *
+ *   - scatter_pass: over chunks of edges, writes both half-edges of
+ *     each edge to the next free position in their rows, claimed with
+ *     atomic increments.
+ *
+ *   - sort_pass: over chunks of slots, sorts each row and moves any
+ *     duplicates to its end, recording how many distinct neighbours
+ *     remain.
+ *
+ *   - compact_pass: over chunks of slots, copies the distinct
+ *     neighbours of each row to the final targets array.
+ *
+ *   - opposite_pass: over chunks of slots, finds the opposite of each
+ *     half-edge by a binary search of its target's row.
+ */
+
+class Graph::CsrTask : public ParallelTask {
+    public:
+        enum Pass { count_pass, scatter_pass, sort_pass, compact_pass,
+                    opposite_pass };
+
+        CsrTask(const std::size_t num_slots, const EdgeList& edges,
+                vector<std::size_t>& offsets, vector<Slot>& targets,
+                vector<std::size_t>& opposites) :
+            m_num_slots(num_slots), m_edges(edges),
+            m_offsets(offsets), m_targets(targets),
+            m_opposites(opposites), m_pass(count_pass),
+            m_edge_chunks(num_chunks_for(edges.size(), c_edges_per_chunk)),
+            m_slot_chunks(num_chunks_for(num_slots, c_slots_per_chunk)),
+            m_counts(num_slots, 0), m_raw_offsets(num_slots + 1, 0),
+            m_raw_targets() {}
+
+        virtual void run_chunk(const std::size_t chunk,
+                               const unsigned int thread);
+        void run(ThreadPool& pool);
+
+    private:
+        const std::size_t m_num_slots;
+        const EdgeList& m_edges;
+        vector<std::size_t>& m_offsets;
+        vector<Slot>& m_targets;
+        vector<std::size_t>& m_opposites;
+        Pass m_pass;
+        const std::size_t m_edge_chunks;
+        const std::size_t m_slot_chunks;
+
+        //  Half-edge counts or write positions per slot, and the rows
+        //  before sorting and compaction
+
+        vector<std::size_t> m_counts;
+        vector<std::size_t> m_raw_offsets;
+        vector<Slot> m_raw_targets;
+
+        void count(const std::size_t begin, const std::size_t end);
+        void scatter(const std::size_t begin, const std::size_t end);
+        void sort_rows(const std::size_t begin, const std::size_t end);
+        void compact(const std::size_t begin, const std::size_t end);
+        void find_opposites(const std::size_t begin, const std::size_t end);
+        static void exclusive_sum(const vector<std::size_t>& counts,
+                                  vector<std::size_t>& offsets);
+
+        CsrTask(const CsrTask&);
+        CsrTask& operator=(const CsrTask&);
+};
+
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+/*
+ *  Runs the current pass over one chunk of edges or slots. The thread
+ *  number is not needed, since the task keeps no per-thread scratch
+ *  space.
+ */
+
+void Graph::CsrTask::run_chunk(const std::size_t chunk,
+                               const unsigned int thread) {
+    std::size_t begin;
+    std::size_t end;
+    if ( m_pass == count_pass || m_pass == scatter_pass ) {
+        chunk_range(m_edges.size(), m_edge_chunks, chunk, begin, end);
+    } else {
+        chunk_range(m_num_slots, m_slot_chunks, chunk, begin, end);
+    }
+
+    switch ( m_pass ) {
+        case count_pass:
+            count(begin, end);
+            break;
+        case scatter_pass:
+            scatter(begin, end);
+            break;
+        case sort_pass:
+            sort_rows(begin, end);
+            break;
+        case compact_pass:
+            compact(begin, end);
+            break;
+        case opposite_pass:
+            find_opposites(begin, end);
+            break;
+    }
+}
+
+#pragma GCC diagnostic pop
+
+
+/*
+ *  Runs all five passes, leaving the finished CSR arrays in the
+ *  vectors passed to the constructor.
+ */
+
+void Graph::CsrTask::run(ThreadPool& pool) {
+    m_pass = count_pass;
+    pool.run(*this, m_edge_chunks);
+
+    exclusive_sum(m_counts, m_raw_offsets);
+    m_raw_targets.resize(m_raw_offsets.back());
+    std::copy(m_raw_offsets.begin(), m_raw_offsets.end() - 1,
+              m_counts.begin());
+    m_pass = scatter_pass;
+    pool.run(*this, m_edge_chunks);
+
+    m_pass = sort_pass;
+    pool.run(*this, m_slot_chunks);
+
+    exclusive_sum(m_counts, m_offsets);
+    m_targets.resize(m_offsets.back());
+    m_opposites.resize(m_offsets.back());
+    m_pass = compact_pass;
+    pool.run(*this, m_slot_chunks);
+
+    m_pass = opposite_pass;
+    pool.run(*this, m_slot_chunks);
+}
+
+
+/*
+ *  Counts the half-edges of each slot in a range of edges.
+ */
+
+void Graph::CsrTask::count(const std::size_t begin, const std::size_t end) {
+    for ( std::size_t e = begin; e < end; ++e ) {
+        const Slot first = m_edges[e].first;
+        const Slot second = m_edges[e].second;
+        if ( first != second ) {
+            __sync_fetch_and_add(&m_counts[first], 1);
+            __sync_fetch_and_add(&m_counts[second], 1);
+        }
+    }
+}
+
+
+/*
+ *  Writes both half-edges of each edge in a range to their rows.
+ */
+
+void Graph::CsrTask::scatter(const std::size_t begin,
+                             const std::size_t end) {
+    for ( std::size_t e = begin; e < end; ++e ) {
+        const Slot first = m_edges[e].first;
+        const Slot second = m_edges[e].second;
+        if ( first != second ) {
+            m_raw_targets[__sync_fetch_and_add(&m_counts[first], 1)] =
+                second;
+            m_raw_targets[__sync_fetch_and_add(&m_counts[second], 1)] =
+                first;
+        }
+    }
+}
+
+
+/*
+ *  Sorts each row in a range of slots, and records the number of
+ *  distinct neighbours of each slot.
+ */
+
+void Graph::CsrTask::sort_rows(const std::size_t begin,
+                               const std::size_t end) {
+    for ( std::size_t slot = begin; slot < end; ++slot ) {
+        const vector<Slot>::iterator row_begin =
+            m_raw_targets.begin() + m_raw_offsets[slot];
+        const vector<Slot>::iterator row_end =
+            m_raw_targets.begin() + m_raw_offsets[slot + 1];
+        std::sort(row_begin, row_end);
+        m_counts[slot] = std::unique(row_begin, row_end) - row_begin;
+    }
+}
+
+
+/*
+ *  Copies the distinct neighbours of each row in a range of slots to
+ *  the final targets array.
+ */
+
+void Graph::CsrTask::compact(const std::size_t begin,
+                             const std::size_t end) {
+    for ( std::size_t slot = begin; slot < end; ++slot ) {
+        std::copy(m_raw_targets.begin() + m_raw_offsets[slot],
+                  m_raw_targets.begin() + m_raw_offsets[slot] +
+                        m_counts[slot],
+                  m_targets.begin() + m_offsets[slot]);
+    }
+}
+
+
+/*
+ *  Finds the opposite of each half-edge in a range of slots' rows.
+ */
+
+void Graph::CsrTask::find_opposites(const std::size_t begin,
+                                    const std::size_t end) {
+    for ( std::size_t slot = begin; slot < end; ++slot ) {
+        for ( std::size_t pos = m_offsets[slot];
+              pos < m_offsets[slot + 1]; ++pos ) {
+            const Slot target = m_targets[pos];
+            m_opposites[pos] = std::lower_bound(
+                    m_targets.begin() + m_offsets[target],
+                    m_targets.begin() + m_offsets[target + 1],
+                    static_cast<Slot>(slot)) - m_targets.begin();
+        }
+    }
+}
+
+
+/*
+ *  Sets offsets to the exclusive prefix sum of counts, with the total
+ *  as a final extra entry.
+ */
+
+void Graph::CsrTask::exclusive_sum(const vector<std::size_t>& counts,
+                                   vector<std::size_t>& offsets) {
+    offsets.resize(counts.size() + 1);
+    std::size_t total = 0;
+    for ( std::size_t i = 0; i < counts.size(); ++i ) {
+        offsets[i] = total;
+        total += counts[i];
+    }
+    offsets[counts.size()] = total;
+}
+
+
+/*
+ *  Parallel task to gather the edges between live slots, renumbered,
+ *  for rebuild().
+ *
+ *  Each edge is gathered once, from the end with the lower slot
+ *  number. A first pass counts each chunk's edges, and a second pass
+ *  writes them from the chunk's offset in the edge list, so the edges
+ *  come out in slot order whatever the number of threads.
+ */
+
+class Graph::GatherTask : public ParallelTask {
+    public:
+        enum Pass { count_pass, fill_pass };
+
+        GatherTask(const Graph& graph, const vector<Slot>& new_slots,
+                   EdgeList& edges) :
+            m_graph(graph), m_new_slots(new_slots), m_edges(edges),
+            m_pass(count_pass),
+            m_num_chunks(num_chunks_for(graph.num_slots(),
+                                        c_slots_per_chunk)),
+            m_chunk_edges(m_num_chunks + 1, 0) {}
+
+        virtual void run_chunk(const std::size_t chunk,
+                               const unsigned int thread);
+        void run(ThreadPool& pool);
+
+    private:
+        const Graph& m_graph;
+        const vector<Slot>& m_new_slots;
+        EdgeList& m_edges;
+        Pass m_pass;
+        const std::size_t m_num_chunks;
+        vector<std::size_t> m_chunk_edges;
+
+        GatherTask(const GatherTask&);
+        GatherTask& operator=(const GatherTask&);
+};
+
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+/*
+ *  Counts or writes the edges gathered from one chunk of slots.
+ */
+
+void Graph::GatherTask::run_chunk(const std::size_t chunk,
+                                  const unsigned int thread) {
+    std::size_t begin;
+    std::size_t end;
+    chunk_range(m_graph.num_slots(), m_num_chunks, chunk, begin, end);
+
+    std::size_t pos = m_chunk_edges[chunk];
+    for ( std::size_t slot = begin; slot < end; ++slot ) {
+        if ( !m_graph.is_live(slot) ) {
+            continue;
+        }
+        for ( std::size_t h = m_graph.first_half_edge(slot);
+              h != no_half_edge; h = m_graph.next_half_edge(slot, h) ) {
+            const Slot target = m_graph.target(h);
+            if ( target > slot && m_graph.is_live(target) ) {
+                if ( m_pass == fill_pass ) {
+                    m_edges[pos] = std::make_pair(m_new_slots[slot],
+                                                  m_new_slots[target]);
+                }
+                ++pos;
+            }
+        }
+    }
+
+    if ( m_pass == count_pass ) {
+        m_chunk_edges[chunk] = pos;
+    }
+}
+
+#pragma GCC diagnostic pop
+
+
+/*
+ *  Runs both passes, leaving the gathered edges in the edge list
+ *  passed to the constructor.
+ */
+
+void Graph::GatherTask::run(ThreadPool& pool) {
+    m_pass = count_pass;
+    pool.run(*this, m_num_chunks);
+
+    std::size_t total = 0;
+    for ( std::size_t chunk = 0; chunk < m_num_chunks; ++chunk ) {
+        const std::size_t chunk_edges = m_chunk_edges[chunk];
+        m_chunk_edges[chunk] = total;
+        total += chunk_edges;
+    }
+    m_edges.resize(total);
+
+    m_pass = fill_pass;
+    pool.run(*this, m_num_chunks);
+}
+
+
+/*
+ *  Constructor. Creates an empty graph with no slots.
+ */
+
+Graph::Graph() :
+        m_csr_slots(0), m_num_live(0), m_live(),
+        m_offsets(1, 0), m_targets(), m_opposites(),
+        m_patch_heads(), m_patch_targets(), m_patch_next() {}
+
+
+/*
+ *  Destructor.
+ */
+
+Graph::~Graph() {}
+
+
+/*
+ *  Replaces the graph with a graph of live slots joined by the
+ *  specified edges, without patches. Edges from a slot to itself are
+ *  ignored, and edges listed more than once are merged.
+ *
+ *  Arguments:
+ *    num_slots -- the number of slots in the graph
+ *    edges -- the edges between slots, each listed once, in either
+ *             direction
+ *    pool -- the thread pool with which to build the graph
+ *
+ *  Throws BadEdgeList if an edge refers to a slot outside the graph.
+ */
+
+void Graph::build(const std::size_t num_slots, const EdgeList& edges,
+                  ThreadPool& pool) {
+    for ( EdgeList::const_iterator itr = edges.begin();
+          itr != edges.end(); ++itr ) {
+        if ( itr->first >= num_slots || itr->second >= num_slots ) {
+            throw BadEdgeList();
+        }
+    }
+
+    CsrTask task(num_slots, edges, m_offsets, m_targets, m_opposites);
+    task.run(pool);
+
+    m_csr_slots = num_slots;
+    m_num_live = num_slots;
+    m_live.assign(num_slots, 1);
+    m_patch_heads.assign(num_slots, no_half_edge);
+    m_patch_targets.clear();
+    m_patch_next.clear();
+}
+
+
+/*
+ *  Folds the patches into the CSR arrays, drops vacated slots and
+ *  renumbers the live slots consecutively, in their existing order.
+ */
+
+void Graph::rebuild(ThreadPool& pool) {
+    vector<Slot> new_slots(num_slots(), 0);
+    Slot next_slot = 0;
+    for ( std::size_t slot = 0; slot < num_slots(); ++slot ) {
+        new_slots[slot] = next_slot;
+        next_slot += m_live[slot];
+    }
+
+    EdgeList edges;
+    GatherTask gather(*this, new_slots, edges);
+    gather.run(pool);
+    build(m_num_live, edges, pool);
+}
+
+
+/*
+ *  Appends a new live slot with no neighbours, and returns it.
+ */
+
+Slot Graph::add_slot() {
+    m_live.push_back(1);
+    m_patch_heads.push_back(no_half_edge);
+    ++m_num_live;
+    return static_cast<Slot>(m_live.size() - 1);
+}
+
+
+/*
+ *  Marks a slot as no longer live. Its edges are ignored from now on,
+ *  and dropped at the next rebuild.
+ */
+
+void Graph::vacate(const Slot slot) {
+    if ( m_live[slot] ) {
+        m_live[slot] = 0;
+        --m_num_live;
+    }
+}
+
+
+/*
+ *  Adds an edge between two slots as a pair of patch half-edges. The
+ *  caller should not add an edge which already exists, or an edge
+ *  from a slot to itself.
+ */
+
+void Graph::add_edge(const Slot first, const Slot second) {
+    const std::size_t half_edge = num_half_edges();
+
+    m_patch_targets.push_back(second);
+    m_patch_next.push_back(m_patch_heads[first]);
+    m_patch_heads[first] = half_edge;
+
+    m_patch_targets.push_back(first);
+    m_patch_next.push_back(m_patch_heads[second]);
+    m_patch_heads[second] = half_edge + 1;
+}
+
+
+/*
+ *  Return the number of slots, live or not, and the number of live
+ *  slots.
+ */
+
+std::size_t Graph::num_slots() const {
+    return m_live.size();
+}
+
+std::size_t Graph::num_live() const {
+    return m_num_live;
+}
+
+
+/*
+ *  Returns true if a slot is live.
+ */
+
+bool Graph::is_live(const Slot slot) const {
+    return m_live[slot] != 0;
+}
+
+
+/*
+ *  Returns the number of edges between live slots.
+ */
+
+std::size_t Graph::num_edges() const {
+    std::size_t half_edges = 0;
+    for ( std::size_t slot = 0; slot < num_slots(); ++slot ) {
+        if ( m_live[slot] ) {
+            half_edges += degree(slot);
+        }
+    }
+    return half_edges / 2;
+}
+
+
+/*
+ *  Returns the number of live neighbours of a slot.
+ */
+
+std::size_t Graph::degree(const Slot slot) const {
+    std::size_t live_neighbours = 0;
+    for ( std::size_t h = first_half_edge(slot); h != no_half_edge;
+          h = next_half_edge(slot, h) ) {
+        live_neighbours += m_live[target(h)];
+    }
+    return live_neighbours;
+}
+
+
+/*
+ *  Returns the highest degree of any live slot.
+ */
+
+std::size_t Graph::max_degree() const {
+    std::size_t highest = 0;
+    for ( std::size_t slot = 0; slot < num_slots(); ++slot ) {
+        if ( m_live[slot] ) {
+            highest = std::max(highest, degree(slot));
+        }
+    }
+    return highest;
+}
+
+
+/*
+ *  Gets the live neighbours of a slot, in sorted order.
+ */
+
+void Graph::neighbours(const Slot slot, vector<Slot>& slots) const {
+    slots.clear();
+    for ( std::size_t h = first_half_edge(slot); h != no_half_edge;
+          h = next_half_edge(slot, h) ) {
+        if ( m_live[target(h)] ) {
+            slots.push_back(target(h));
+        }
+    }
+    std::sort(slots.begin(), slots.end());
+}
+
+
+/*
+ *  Returns the number of edges added since the last build or rebuild.
+ */
+
+std::size_t Graph::num_patch_edges() const {
+    return m_patch_targets.size() / 2;
+}
+
+
+namespace {
+
+    /*
+     *  Parallel task to generate the edges of a small-world network,
+     *  one chunk of slots at a time. Slot s's edges to the slots after
+     *  it on the ring are written to positions s * half_degree onwards.
+     */
+
+    class SmallWorldTask : public ParallelTask {
+        public:
+            SmallWorldTask(const std::size_t num_slots,
+                           const std::size_t half_degree,
+                           const double rewire_prob, const uint64_t seed,
+                           EdgeList& edges) :
+                m_num_slots(num_slots), m_half_degree(half_degree),
+                m_rewire_prob(rewire_prob), m_seed(seed),
+                m_num_chunks(num_chunks_for(num_slots, c_slots_per_chunk)),
+                m_edges(edges) {}
+
+            virtual void run_chunk(const std::size_t chunk,
+                                   const unsigned int thread);
+            std::size_t num_chunks() const { return m_num_chunks; }
+
+        private:
+            const std::size_t m_num_slots;
+            const std::size_t m_half_degree;
+            const double m_rewire_prob;
+            const uint64_t m_seed;
+            const std::size_t m_num_chunks;
+            EdgeList& m_edges;
+
+            SmallWorldTask(const SmallWorldTask&);
+            SmallWorldTask& operator=(const SmallWorldTask&);
+    };
+
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+    /*
+     *  Generates the edges of one chunk of slots. Rewired edges are
+     *  moved to a uniformly chosen other slot.
+     */
+
+    void SmallWorldTask::run_chunk(const std::size_t chunk,
+                                   const unsigned int thread) {
+        std::size_t begin;
+        std::size_t end;
+        chunk_range(m_num_slots, m_num_chunks, chunk, begin, end);
+
+        Rng rng(mix_seed(m_seed, c_small_world_stream), chunk);
+        const uint32_t other_slots = static_cast<uint32_t>(m_num_slots - 1);
+
+        for ( std::size_t slot = begin; slot < end; ++slot ) {
+            for ( std::size_t step = 1; step <= m_half_degree; ++step ) {
+                Slot target = static_cast<Slot>((slot + step) % m_num_slots);
+                if ( rng.uniform() < m_rewire_prob ) {
+                    target = rng.below(other_slots);
+                    if ( target >= slot ) {
+                        ++target;
+                    }
+                }
+                m_edges[slot * m_half_degree + step - 1] =
+                    std::make_pair(static_cast<Slot>(slot), target);
+            }
+        }
+    }
+
+#pragma GCC diagnostic pop
+
+
+    /*
+     *  Parallel task to draw the edges of a scale-free network, one
+     *  chunk of edges at a time. Each end of each edge is drawn in
+     *  proportion to the slots' weights, by a binary search of their
+     *  running totals, and redrawn if it would join a slot to itself.
+     */
+
+    class ScaleFreeTask : public ParallelTask {
+        public:
+            ScaleFreeTask(const vector<double>& cumulative_weights,
+                          const uint64_t seed, EdgeList& edges) :
+                m_cumulative_weights(cumulative_weights), m_seed(seed),
+                m_num_chunks(num_chunks_for(edges.size(),
+                                            c_edges_per_chunk)),
+                m_edges(edges) {}
+
+            virtual void run_chunk(const std::size_t chunk,
+                                   const unsigned int thread);
+            std::size_t num_chunks() const { return m_num_chunks; }
+
+        private:
+            const vector<double>& m_cumulative_weights;
+            const uint64_t m_seed;
+            const std::size_t m_num_chunks;
+            EdgeList& m_edges;
+
+            Slot draw_slot(Rng& rng) const;
+
+            ScaleFreeTask(const ScaleFreeTask&);
+            ScaleFreeTask& operator=(const ScaleFreeTask&);
+    };
+
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+    /*
+     *  Draws the edges of one chunk.
+     */
+
+    void ScaleFreeTask::run_chunk(const std::size_t chunk,
+                                  const unsigned int thread) {
+        std::size_t begin;
+        std::size_t end;
+        chunk_range(m_edges.size(), m_num_chunks, chunk, begin, end);
+
+        Rng rng(mix_seed(m_seed, c_scale_free_stream), chunk);
+        for ( std::size_t e = begin; e < end; ++e ) {
+            const Slot first = draw_slot(rng);
+            Slot second = draw_slot(rng);
+            while ( second == first ) {
+                second = draw_slot(rng);
+            }
+            m_edges[e] = std::make_pair(first, second);
+        }
+    }
+
+#pragma GCC diagnostic pop
+
+
+    /*
+     *  Returns a slot drawn in proportion to its weight.
+     */
+
+    Slot ScaleFreeTask::draw_slot(Rng& rng) const {
+        const double point = rng.uniform() * m_cumulative_weights.back();
+        const std::size_t slot = std::upper_bound(
+                m_cumulative_weights.begin(), m_cumulative_weights.end(),
+                point) - m_cumulative_weights.begin();
+        return static_cast<Slot>(std::min(slot,
+                                 m_cumulative_weights.size() - 1));
+    }
+
+}
+
+
+/*
+ *  Generates the edges of a Watts-Strogatz small-world network.
+ *
+ *  Arguments:
+ *    num_slots -- the number of slots in the network
+ *    degree -- the number of neighbours of each slot on the ring
+ *              before rewiring, rounded down to an even number
+ *    rewire_prob -- the probability that each edge is rewired
+ *    seed -- the seed from which to draw random numbers
+ *    pool -- the thread pool with which to generate the edges
+ *    edges -- set to the generated edges
+ */
+
+void pridil::small_world_edges(const std::size_t num_slots,
+                               const std::size_t degree,
+                               const double rewire_prob,
+                               const uint64_t seed, ThreadPool& pool,
+                               EdgeList& edges) {
+    const std::size_t half_degree = (num_slots > 1) ?
+                                    std::min(degree / 2, num_slots - 1) : 0;
+    edges.resize(num_slots * half_degree);
+    if ( edges.empty() ) {
+        return;
+    }
+
+    SmallWorldTask task(num_slots, half_degree, rewire_prob, seed, edges);
+    pool.run(task, task.num_chunks());
+}
+
+
+/*
+ *  Generates the edges of a scale-free network. Slot s is given weight
+ *  1 / sqrt(s + 1), which gives a degree distribution with a power law
+ *  tail of exponent 3.
+ *
+ *  Arguments:
+ *    num_slots -- the number of slots in the network
+ *    degree -- the mean number of neighbours of each slot, before
+ *              duplicate edges are merged
+ *    seed -- the seed from which to draw random numbers
+ *    pool -- the thread pool with which to generate the edges
+ *    edges -- set to the generated edges
+ */
+
+void pridil::scale_free_edges(const std::size_t num_slots,
+                              const std::size_t degree,
+                              const uint64_t seed, ThreadPool& pool,
+                              EdgeList& edges) {
+    edges.resize((num_slots > 1) ? num_slots * degree / 2 : 0);
+    if ( edges.empty() ) {
+        return;
+    }
+
+    vector<double> cumulative_weights(num_slots);
+    double total = 0.0;
+    for ( std::size_t slot = 0; slot < num_slots; ++slot ) {
+        total += 1.0 / std::sqrt(static_cast<double>(slot + 1));
+        cumulative_weights[slot] = total;
+    }
+
+    ScaleFreeTask task(cumulative_weights, seed, edges);
+    pool.run(task, task.num_chunks());
+}
+
+
+/*
+ *  Reads edges from a stream, one per line, as two slot numbers
+ *  separated by whitespace. Blank lines and lines starting with '#'
+ *  are ignored.
+ *
+ *  Throws BadEdgeList if a line does not hold two slot numbers.
+ */
+
+void pridil::read_edge_list(std::istream& in, EdgeList& edges) {
+    edges.clear();
+
+    std::string line;
+    while ( std::getline(in, line) ) {
+        const std::string::size_type start = line.find_first_not_of(" \t\r");
+        if ( start == std::string::npos || line[start] == '#' ) {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        long first;
+        long second;
+        std::string rest;
+        if ( !(fields >> first >> second) || (fields >> rest) ||
+             first < 0 || second < 0 ||
+             first >= 0xFFFFFFFFL || second >= 0xFFFFFFFFL ) {
+            throw BadEdgeList();
+        }
+        edges.push_back(std::make_pair(static_cast<Slot>(first),
+                                       static_cast<Slot>(second)));
+    }
+}
@@ -0,0 +1,221 @@
+/*
+ *  graph.h
+ *  =======
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Interface to Graph class for Prisoner's Dilemma simulation.
+ *
+ *  A Graph is an undirected interaction network between creatures,
+ *  which are identified by slots numbered from zero. The network is
+ *  held in compressed sparse row (CSR) form: the neighbours of every
+ *  slot are stored sorted and without duplicates in one array of
+ *  targets, with the neighbours of slot s at positions offsets[s] to
+ *  offsets[s + 1]. Each position is a half-edge, i.e. one direction of
+ *  an edge, and the position of the opposite half-edge is stored
+ *  alongside it, so the two ends of an edge can exchange information
+ *  without searching.
+ *
+ *  Building a CSR network is a number of passes over the whole graph,
+ *  so births and deaths patch the network instead:
+ *
+ *   - vacate() marks a slot as no longer live. Its half-edges stay in
+ *     place, but are skipped by everything which walks the network.
+ *
+ *   - add_slot() appends a new, live slot with no neighbours.
+ *
+ *   - add_edge() appends a pair of patch half-edges, numbered after
+ *     the CSR half-edges, and chains each of them onto its slot's list
+ *     of patch half-edges. Patch half-edges are appended in pairs, so
+ *     the opposite of patch half-edge h is simply h ^ 1, counting from
+ *     the first patch half-edge.
+ *
+ *  rebuild() then folds the patches back into the CSR arrays and
+ *  renumbers the live slots consecutively, keeping them in order, so
+ *  the owner of the graph can compact anything it keeps per slot in a
+ *  single pass. It is meant to be called periodically, not after every
+ *  change.
+ *
+ *  The CSR arrays are built from a list of edges in parallel passes
+ *  over chunks of edges and chunks of slots. Slot degrees are counted
+ *  and half-edges are scattered using atomic increments, so their
+ *  order within each row depends on the threads, but every row is then
+ *  sorted and stripped of duplicates, so the finished graph does not.
+ *
+ *  Non-member functions generate edge lists, in parallel where the
+ *  model allows it, or read them from a stream:
+ *
+ *   - small_world_edges() generates a Watts-Strogatz small-world
+ *     network: a ring in which each slot is joined to its nearest
+ *     neighbours on each side, with each edge rewired to a random
+ *     slot with a fixed probability.
+ *
+ *   - scale_free_edges() generates a Chung-Lu network with weights
+ *     which give a power law degree distribution with exponent 3, as
+ *     does Barabasi-Albert preferential attachment. Unlike preferential
+ *     attachment, every edge is drawn independently, so the edges can
+ *     be generated in parallel. Edges drawn twice are merged, so the
+ *     mean degree falls a little short of the one requested.
+ *
+ *   - read_edge_list() reads edges as pairs of slot numbers, one pair
+ *     per line, ignoring blank lines and lines starting with '#'.
+ *
+ *  Generators draw their random numbers from streams derived from the
+ *  seed and fixed-size blocks of slots or edges, so a network with a
+ *  given seed is the same whatever the number of threads.
+ *
+ *  Public member functions:
+ *    build() - replaces the graph with one built from a list of edges.
+ *
+ *    rebuild() - folds patches into the CSR arrays and renumbers the
+ *                live slots consecutively.
+ *
+ *    add_slot(), vacate(), add_edge() - patch the graph.
+ *
+ *    num_slots(), num_live(), is_live() - return the number of slots,
+ *                                         the number of live slots,
+ *                                         and whether a slot is live.
+ *
+ *    num_edges(), degree(), max_degree() - return the number of edges
+ *                                          and degrees, counting only
+ *                                          live slots.
+ *
+ *    neighbours() - gets the live neighbours of a slot.
+ *
+ *    num_patch_edges() - returns the number of edges added since the
+ *                        last build or rebuild.
+ *
+ *    num_half_edges(), first_half_edge(), next_half_edge(), target(),
+ *    opposite() - walk the half-edges of each slot, including patch
+ *                 half-edges, and return their targets and opposite
+ *                 half-edges, for code which keeps data per half-edge.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#ifndef PG_PRIDIL_GRAPH_H
+#define PG_PRIDIL_GRAPH_H
+
+#include <cstddef>
+#include <istream>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+#include "thread_pool.h"
+
+namespace pridil {
+
+typedef uint32_t Slot;
+typedef std::vector<std::pair<Slot, Slot> > EdgeList;
+
+class Graph {
+    public:
+        static const std::size_t no_half_edge = static_cast<std::size_t>(-1);
+
+        //  Constructor and destructor
+
+        Graph();
+        ~Graph();
+
+        //  Methods to build and patch the graph
+
+        void build(const std::size_t num_slots, const EdgeList& edges,
+                   ThreadPool& pool);
+        void rebuild(ThreadPool& pool);
+        Slot add_slot();
+        void vacate(const Slot slot);
+        void add_edge(const Slot first, const Slot second);
+
+        //  Methods to access slots and edges
+
+        std::size_t num_slots() const;
+        std::size_t num_live() const;
+        bool is_live(const Slot slot) const;
+        std::size_t num_edges() const;
+        std::size_t degree(const Slot slot) const;
+        std::size_t max_degree() const;
+        void neighbours(const Slot slot, std::vector<Slot>& slots) const;
+        std::size_t num_patch_edges() const;
+
+        //  Methods to walk the half-edges of a slot
+
+        std::size_t num_half_edges() const {
+            return m_targets.size() + m_patch_targets.size();
+        }
+
+        std::size_t first_half_edge(const Slot slot) const {
+            if ( slot < m_csr_slots &&
+                 m_offsets[slot] != m_offsets[slot + 1] ) {
+                return m_offsets[slot];
+            }
+            return m_patch_heads[slot];
+        }
+
+        std::size_t next_half_edge(const Slot slot,
+                                   const std::size_t half_edge) const {
+            if ( half_edge < m_targets.size() ) {
+                if ( half_edge + 1 != m_offsets[slot + 1] ) {
+                    return half_edge + 1;
+                }
+                return m_patch_heads[slot];
+            }
+            return m_patch_next[half_edge - m_targets.size()];
+        }
+
+        Slot target(const std::size_t half_edge) const {
+            if ( half_edge < m_targets.size() ) {
+                return m_targets[half_edge];
+            }
+            return m_patch_targets[half_edge - m_targets.size()];
+        }
+
+        std::size_t opposite(const std::size_t half_edge) const {
+            if ( half_edge < m_targets.size() ) {
+                return m_opposites[half_edge];
+            }
+            return m_targets.size() + ((half_edge - m_targets.size()) ^ 1);
+        }
+
+    private:
+        std::size_t m_csr_slots;
+        std::size_t m_num_live;
+        std::vector<unsigned char> m_live;
+
+        //  CSR arrays
+
+        std::vector<std::size_t> m_offsets;
+        std::vector<Slot> m_targets;
+        std::vector<std::size_t> m_opposites;
+
+        //  Patch half-edges, chained from each slot's head
+
+        std::vector<std::size_t> m_patch_heads;
+        std::vector<Slot> m_patch_targets;
+        std::vector<std::size_t> m_patch_next;
+
+        //  Parallel tasks used by build() and rebuild()
+
+        class CsrTask;
+        class GatherTask;
+
+        Graph(const Graph&);                // Prevent copying
+        Graph& operator=(const Graph&);     // Prevent assignment
+};
+
+
+/*  Edge list functions  */
+
+void small_world_edges(const std::size_t num_slots,
+                       const std::size_t degree,
+                       const double rewire_prob, const uint64_t seed,
+                       ThreadPool& pool, EdgeList& edges);
+void scale_free_edges(const std::size_t num_slots,
+                      const std::size_t degree, const uint64_t seed,
+                      ThreadPool& pool, EdgeList& edges);
+void read_edge_list(std::istream& in, EdgeList& edges);
+
+}       //  namespace pridil
+
+#endif      // PG_PRIDIL_GRAPH_H
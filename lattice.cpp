@@ -0,0 +1,825 @@
+/*
+ *  lattice.cpp
+ *  ===========
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Implementation of Lattice class for Prisoners' Dilemma simulation.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <map>
+#include <cstddef>
+#include <ctime>
+#include <stdint.h>
+#include "pridil_common.h"
+#include "lattice.h"
+#include "creature.h"
+#include "brain_complex.h"
+#include "game.h"
+#include "thread_pool.h"
+#include "rng.h"
+
+using std::endl;
+using std::ostream;
+using std::vector;
+
+using namespace pridil;
+
+
+/*
+ *  Directions to a cell's neighbours, as x and y offsets. Direction
+ *  2f is the f-th forward direction, whose pair is kept by this cell,
+ *  and direction 2f + 1 is its opposite, whose pair is kept by the
+ *  neighbour. A von Neumann neighbourhood uses the first four
+ *  directions, and a Moore neighbourhood all eight.
+ *
+ *  Each pair's history byte holds the number of games played, up to
+ *  two, in bits 0 and 1, then the last and second last moves of the
+ *  keeping cell, and then those of its neighbour, with bits set for
+ *  defections.
+ */
+
+namespace {
+    const int c_dx[] = { 1, -1, 0, 0, 1, -1, -1, 1 };
+    const int c_dy[] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+    const std::size_t c_rows_per_chunk = 8;
+    const std::size_t c_num_strategies = always_defect + 1;
+    const uint64_t c_lattice_stream = 0xFFFFFFFEUL;
+
+    const uint64_t c_never = 0;
+    const uint64_t c_always = static_cast<uint64_t>(1) << 32;
+
+    const char c_map_chars[] = "rtswgnpcd";
+
+
+    /*
+     *  Returns the chance, out of 2^32, of a creature with the specified
+     *  Brain defecting, given the number of games it has played against
+     *  its opponent and the opponent's last two moves. The chance is
+     *  the number of draws on which the creature's strategy gene
+     *  defects, found by searching for the lowest draw on which it
+     *  cooperates, since genes take random choices on draws below
+     *  their chances (see strategy_gene.h).
+     */
+
+    uint64_t defect_threshold(const Brain& brain, const unsigned int games,
+                              const bool last_defect,
+                              const bool second_defect) {
+        MatchHistory history;
+        history.games = games;
+        history.last_move = last_defect ? defect : coop;
+        history.second_last_move = second_defect ? defect : coop;
+
+        uint64_t low = c_never;
+        uint64_t high = c_always;
+        while ( low < high ) {
+            const uint64_t middle = low + (high - low) / 2;
+            const GameMove move = brain.get_match_move(history,
+                    static_cast<uint32_t>(middle));
+            if ( simplify_game_move(move) == defect ) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return low;
+    }
+}
+
+
+/*
+ *  Parallel task to run one sweep of a day over the lattice, one band
+ *  of rows per chunk.
+ *
+ *  The play pass plays each cell's games against its forward
+ *  neighbours, and updates the history bytes kept by that cell. The
+ *  score pass adds up each cell's results from its forward and
+ *  backward pairs. The worst pass picks each cell's worst-off
+ *  neighbour, and the replace pass picks the offspring, if any, which
+ *  takes over each cell. Each pass reads its neighbours' state but
+ *  only writes to the cells in its own band, so no locking is needed.
+ *
+ *  Each row is swept in three segments: the first cell, the cells in
+ *  between, and the last cell. Within a segment, each neighbour is at
+ *  a fixed offset from the cell, so the sweeps are simple stencils
+ *  over the arrays, with the number of directions fixed at compile
+ *  time, and the choices made with masks rather than branches.
+ */
+
+class Lattice::SweepTask : public ParallelTask {
+    public:
+        enum Pass { play_pass, score_pass, worst_pass, replace_pass };
+
+        SweepTask(Lattice& lattice);
+
+        virtual void run_chunk(const std::size_t chunk,
+                               const unsigned int thread);
+        void set_pass(const Pass pass);
+
+    private:
+        const std::size_t m_width;
+        const std::size_t m_height;
+        const std::size_t m_forward;
+        const uint64_t m_day_seed;
+        const bool m_new_cycle;
+        Pass m_pass;
+
+        unsigned char * const m_strategies;
+        unsigned char * const m_next_strategies;
+        int * const m_resources;
+        unsigned char * const m_worst;
+        unsigned char * const m_born;
+        unsigned char * const m_history;
+        const uint64_t (* const m_thresholds)[16];
+        int m_own_results[4];
+        int m_kept_results[4];
+
+        void offsets_for(const std::size_t x, const std::size_t y,
+                         std::ptrdiff_t * offsets) const;
+
+        template <std::size_t Directions>
+        void sweep(const std::size_t begin, const std::size_t end,
+                   const std::ptrdiff_t * offsets);
+        template <std::size_t Directions>
+        void play(const std::size_t begin, const std::size_t end,
+                  const std::ptrdiff_t * offsets);
+        template <std::size_t Directions>
+        void score(const std::size_t begin, const std::size_t end,
+                   const std::ptrdiff_t * offsets);
+        template <std::size_t Directions>
+        void worst(const std::size_t begin, const std::size_t end,
+                   const std::ptrdiff_t * offsets);
+        template <std::size_t Directions>
+        void replace(const std::size_t begin, const std::size_t end,
+                     const std::ptrdiff_t * offsets);
+
+        SweepTask(const SweepTask&);
+        SweepTask& operator=(const SweepTask&);
+};
+
+
+/*
+ *  Constructor. Takes the lattice's arrays, and the results of a game
+ *  indexed by the two last-move bits of a pair's history byte, for the
+ *  keeping cell and for its neighbour.
+ */
+
+Lattice::SweepTask::SweepTask(Lattice& lattice) :
+        m_width(lattice.m_width),
+        m_height(lattice.m_height),
+        m_forward(lattice.m_forward),
+        m_day_seed(mix_seed(lattice.m_seed, lattice.m_day)),
+        m_new_cycle(lattice.m_new_cycle),
+        m_pass(play_pass),
+        m_strategies(&lattice.m_strategies[0]),
+        m_next_strategies(&lattice.m_next_strategies[0]),
+        m_resources(&lattice.m_resources[0]),
+        m_worst(&lattice.m_worst[0]),
+        m_born(&lattice.m_born[0]),
+        m_history(&lattice.m_history[0]),
+        m_thresholds(lattice.m_thresholds),
+        m_own_results(),
+        m_kept_results() {
+    for ( int own = 0; own < 2; ++own ) {
+        for ( int other = 0; other < 2; ++other ) {
+            m_own_results[own | (other << 1)] = lattice.m_payoffs[own][other];
+            m_kept_results[own | (other << 1)] =
+                    lattice.m_payoffs[other][own];
+        }
+    }
+}
+
+
+/*
+ *  Runs the current pass over the band of rows belonging to one chunk,
+ *  one segment of each row at a time.
+ */
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+void Lattice::SweepTask::run_chunk(const std::size_t chunk,
+                                   const unsigned int thread) {
+    const std::size_t first = chunk * c_rows_per_chunk;
+    const std::size_t last = std::min(first + c_rows_per_chunk, m_height);
+
+    std::ptrdiff_t offsets[8];
+    for ( std::size_t y = first; y < last; ++y ) {
+        const std::size_t row = y * m_width;
+        const std::size_t segments[4] = { row, row + 1,
+                                          row + m_width - 1, row + m_width };
+        const std::size_t xs[3] = { 0, 1, m_width - 1 };
+
+        for ( int segment = 0; segment < 3; ++segment ) {
+            offsets_for(xs[segment], y, offsets);
+            if ( m_forward == 2 ) {
+                sweep<4>(segments[segment], segments[segment + 1], offsets);
+            } else {
+                sweep<8>(segments[segment], segments[segment + 1], offsets);
+            }
+        }
+    }
+}
+
+#pragma GCC diagnostic pop
+
+
+/*
+ *  Sets the pass to run on the next call to ThreadPool::run().
+ */
+
+void Lattice::SweepTask::set_pass(const Pass pass) {
+    m_pass = pass;
+}
+
+
+/*
+ *  Fills in the offsets from cell x in row y to its neighbours, in
+ *  direction order, wrapping around the edges of the lattice.
+ */
+
+void Lattice::SweepTask::offsets_for(const std::size_t x,
+                                     const std::size_t y,
+                                     std::ptrdiff_t * offsets) const {
+    const std::ptrdiff_t width = m_width;
+    const std::ptrdiff_t height = m_height;
+    const std::ptrdiff_t rows[3] = {
+        (y == 0) ? (height - 1) * width : -width, 0,
+        (y + 1 == m_height) ? -(height - 1) * width : width };
+    const std::ptrdiff_t cols[3] = {
+        (x == 0) ? width - 1 : -1, 0,
+        (x + 1 == m_width) ? -(width - 1) : 1 };
+
+    for ( std::size_t d = 0; d < 2 * m_forward; ++d ) {
+        offsets[d] = rows[c_dy[d] + 1] + cols[c_dx[d] + 1];
+    }
+}
+
+
+/*
+ *  Runs the current pass over the cells from begin to end.
+ */
+
+template <std::size_t Directions>
+void Lattice::SweepTask::sweep(const std::size_t begin,
+                               const std::size_t end,
+                               const std::ptrdiff_t * offsets) {
+    switch ( m_pass ) {
+        case play_pass:
+            play<Directions>(begin, end, offsets);
+            break;
+        case score_pass:
+            score<Directions>(begin, end, offsets);
+            break;
+        case worst_pass:
+            worst<Directions>(begin, end, offsets);
+            break;
+        case replace_pass:
+            replace<Directions>(begin, end, offsets);
+            break;
+    }
+}
+
+
+/*
+ *  Plays the games between each cell and its forward neighbours. A
+ *  pair's history is cleared first if either creature is newborn.
+ *  Random moves are taken from a hash of the day's seed and the pair,
+ *  the upper half for the keeping cell and the lower half for its
+ *  neighbour, so each pair gets the same moves however the rows are
+ *  shared out.
+ */
+
+template <std::size_t Directions>
+void Lattice::SweepTask::play(const std::size_t begin,
+                              const std::size_t end,
+                              const std::ptrdiff_t * offsets) {
+    const std::size_t forward = Directions / 2;
+    const unsigned char * strategies = m_strategies;
+    const unsigned char * born = m_born;
+    unsigned char * history = m_history;
+    const uint64_t (* thresholds)[16] = m_thresholds;
+    const uint64_t day_seed = m_day_seed;
+
+    for ( std::size_t cell = begin; cell < end; ++cell ) {
+        const uint64_t * own_thresholds = thresholds[strategies[cell]];
+        for ( std::size_t f = 0; f < forward; ++f ) {
+            const std::size_t other = cell + offsets[2 * f];
+            const std::size_t pair = cell * forward + f;
+            const unsigned int h = history[pair] &
+                                   ((born[cell] | born[other]) - 1u);
+
+            const unsigned int games = h & 3;
+            const uint64_t own_threshold = own_thresholds[games |
+                                                          ((h >> 2) & 12)];
+            const uint64_t other_threshold =
+                    thresholds[strategies[other]][games | (h & 12)];
+
+            const uint64_t r = mix_seed(day_seed, pair);
+            const unsigned int own_move = (r >> 32) < own_threshold;
+            const unsigned int other_move = (r & 0xFFFFFFFFUL) <
+                                            other_threshold;
+
+            history[pair] = static_cast<unsigned char>(
+                    (games + (games < 2)) |
+                    (own_move << 2) | ((h << 1) & 8) |
+                    (other_move << 4) | ((h << 1) & 32));
+        }
+    }
+}
+
+
+/*
+ *  Adds up the results of the day's games for each cell, from the
+ *  pairs it keeps and the pairs kept by its backward neighbours.
+ *  Resources are restarted from zero on the first day of a cycle.
+ */
+
+template <std::size_t Directions>
+void Lattice::SweepTask::score(const std::size_t begin,
+                               const std::size_t end,
+                               const std::ptrdiff_t * offsets) {
+    const std::size_t forward = Directions / 2;
+    const unsigned char * history = m_history;
+    int * resources = m_resources;
+    unsigned char * born = m_born;
+    const int keep = m_new_cycle ? 0 : -1;
+
+    int own_results[4];
+    int kept_results[4];
+    for ( int i = 0; i < 4; ++i ) {
+        own_results[i] = m_own_results[i];
+        kept_results[i] = m_kept_results[i];
+    }
+
+    for ( std::size_t cell = begin; cell < end; ++cell ) {
+        int total = resources[cell] & keep;
+        for ( std::size_t f = 0; f < forward; ++f ) {
+            const unsigned int own = history[cell * forward + f];
+            total += own_results[((own >> 2) & 1) | ((own >> 3) & 2)];
+
+            const unsigned int kept =
+                    history[(cell + offsets[2 * f + 1]) * forward + f];
+            total += kept_results[((kept >> 2) & 1) | ((kept >> 3) & 2)];
+        }
+
+        resources[cell] = total;
+        born[cell] = 0;
+    }
+}
+
+
+/*
+ *  Picks the worst-off neighbour of each cell, taking the first in
+ *  direction order if several are equally badly off.
+ */
+
+template <std::size_t Directions>
+void Lattice::SweepTask::worst(const std::size_t begin,
+                               const std::size_t end,
+                               const std::ptrdiff_t * offsets) {
+    const int * resources = m_resources;
+    unsigned char * worst = m_worst;
+
+    for ( std::size_t cell = begin; cell < end; ++cell ) {
+        unsigned int worst_direction = 0;
+        int worst_resources = resources[cell + offsets[0]];
+        for ( std::size_t d = 1; d < Directions; ++d ) {
+            const int other_resources = resources[cell + offsets[d]];
+            const int lower = -(other_resources < worst_resources);
+            worst_direction ^= (worst_direction ^ d) & lower;
+            worst_resources ^= (worst_resources ^ other_resources) & lower;
+        }
+        worst[cell] = static_cast<unsigned char>(worst_direction);
+    }
+}
+
+
+/*
+ *  Replaces each cell which was picked as worst-off by a better-off
+ *  neighbour with the offspring of the best-off such neighbour, taking
+ *  the first in direction order if several are equally well off.
+ *  Neighbour d picked this cell if its worst-off neighbour is in the
+ *  opposite direction, d ^ 1.
+ */
+
+template <std::size_t Directions>
+void Lattice::SweepTask::replace(const std::size_t begin,
+                                 const std::size_t end,
+                                 const std::ptrdiff_t * offsets) {
+    const int * resources = m_resources;
+    const unsigned char * worst = m_worst;
+    const unsigned char * strategies = m_strategies;
+    unsigned char * next_strategies = m_next_strategies;
+    unsigned char * born = m_born;
+
+    for ( std::size_t cell = begin; cell < end; ++cell ) {
+        unsigned int strategy = strategies[cell];
+        int parent_resources = resources[cell];
+        int picked_any = 0;
+        for ( std::size_t d = 0; d < Directions; ++d ) {
+            const std::size_t other = cell + offsets[d];
+            const int other_resources = resources[other];
+            const int picked = -((worst[other] == (d ^ 1)) &
+                                 (other_resources > parent_resources));
+            strategy ^= (strategy ^ strategies[other]) & picked;
+            parent_resources ^= (parent_resources ^ other_resources) &
+                                picked;
+            picked_any |= picked;
+        }
+        next_strategies[cell] = static_cast<unsigned char>(strategy);
+        born[cell] = static_cast<unsigned char>(picked_any & 1);
+    }
+}
+
+
+/*
+ *  Constructor.
+ *
+ *  The cells are filled at random with creatures of the strategies in
+ *  the WorldInfo structure, in proportion to the numbers of each, so
+ *  only the proportions matter.
+ *
+ *  Arguments:
+ *    wInfo -- the starting population, reproduction cycle, number of
+ *             threads and random number seed, as for a World
+ *    width, height -- the dimensions of the lattice, at least 3 each
+ *    neighbourhood -- von_neumann_neighbourhood or moore_neighbourhood
+ *
+ *  Exceptions thrown:
+ *    BadLatticeSize if the lattice is too small, or if there are no
+ *    creatures in the WorldInfo structure.
+ */
+
+Lattice::Lattice(const WorldInfo& wInfo, const std::size_t width,
+                 const std::size_t height,
+                 const Neighbourhood neighbourhood) :
+        m_width(width),
+        m_height(height),
+        m_forward(neighbourhood == moore_neighbourhood ? 4 : 2),
+        m_seed(seed_or_time(wInfo.m_seed)),
+        m_repro_cycle_days(wInfo.m_repro_cycle_days > 0 ?
+                           wInfo.m_repro_cycle_days : 1),
+        m_disable_repro(wInfo.m_disable_repro),
+        m_day(1),
+        m_days_skipped(0),
+        m_new_cycle(true),
+        m_pool(wInfo.m_threads),
+        m_strategies(width * height),
+        m_next_strategies(width * height),
+        m_resources(width * height, 0),
+        m_worst(width * height, 0),
+        m_born(width * height, 0),
+        m_history(width * height * m_forward, 0),
+        m_payoffs(),
+        m_thresholds(),
+        m_strategy_names(strategy_names()) {
+
+    if ( width < 3 || height < 3 ) {
+        throw BadLatticeSize();
+    }
+
+    //  Check the starting population
+
+    const vector<Strategy> strategies = gene_strategies();
+    vector<uint32_t> counts(strategies.size());
+    uint32_t total = 0;
+    for ( std::size_t s = 0; s < strategies.size(); ++s ) {
+        counts[s] = static_cast<uint32_t>(starting_count(wInfo,
+                                                         strategies[s]));
+        total += counts[s];
+    }
+    if ( total == 0 ) {
+        throw BadLatticeSize();
+    }
+
+    //  Take game results from game_result(), and build the table of
+    //  each strategy's chance of defecting, asked of its strategy gene,
+    //  indexed by the history byte as seen by the player.
+
+    payoff_table(m_payoffs);
+    for ( std::size_t s = 0; s < strategies.size(); ++s ) {
+        CreatureInit c_init;
+        c_init.strategy = strategies[s];
+        const Brain brain(c_init);
+        for ( unsigned int key = 0; key < 16; ++key ) {
+            m_thresholds[strategies[s]][key] = defect_threshold(brain,
+                    key & 3, (key & 4) != 0, (key & 8) != 0);
+        }
+    }
+
+    //  Fill the cells
+
+    Rng rng(m_seed, c_lattice_stream);
+    for ( std::size_t cell = 0; cell < m_strategies.size(); ++cell ) {
+        uint32_t pick = rng.below(total);
+        std::size_t s = 0;
+        while ( pick >= counts[s] ) {
+            pick -= counts[s];
+            ++s;
+        }
+        m_strategies[cell] = static_cast<unsigned char>(strategies[s]);
+    }
+}
+
+
+/*
+ *  Destructor.
+ */
+
+Lattice::~Lattice() {}
+
+
+/*
+ *  Completes a lattice day, playing the games between every pair of
+ *  neighbours and, at the end of a reproduction cycle, replacing the
+ *  worst-off creatures with the offspring of their neighbours.
+ */
+
+void Lattice::advance_day() {
+    const std::size_t num_chunks = num_chunks_for(m_height,
+                                                  c_rows_per_chunk);
+    SweepTask task(*this);
+    m_pool.run(task, num_chunks);
+
+    task.set_pass(SweepTask::score_pass);
+    m_pool.run(task, num_chunks);
+
+    m_new_cycle = (m_disable_repro != true) &&
+                  (m_day % m_repro_cycle_days) == 0;
+    if ( m_new_cycle ) {
+        task.set_pass(SweepTask::worst_pass);
+        m_pool.run(task, num_chunks);
+
+        task.set_pass(SweepTask::replace_pass);
+        m_pool.run(task, num_chunks);
+        m_strategies.swap(m_next_strategies);
+    }
+
+    ++m_day;
+}
+
+
+/*
+ *  Advances the lattice by the specified number of days, with the same
+ *  results as calling advance_day() that many times.
+ *
+ *  Where the lattice is deterministic, as described in lattice.h, the
+ *  day on which the history bytes were last seen with each signature is
+ *  kept. When a signature repeats, the lattice is played for one more
+ *  cycle of that length, and if the history bytes come back to where
+ *  they were, as they will unless two signatures collide, the whole
+ *  cycles left are skipped. A collision just starts the search again.
+ *  Resources are added up in unsigned arithmetic, so that they wrap
+ *  around just as adding them up day by day does.
+ */
+
+void Lattice::advance_days(const Day days) {
+    Day remaining = days;
+    if ( remaining <= 0 ) {
+        return;
+    }
+
+    //  After the first day, no creature is newborn and resources are
+    //  not restarted, so the history bytes are the whole state.
+
+    advance_day();
+    --remaining;
+
+    const bool skip_cycles = m_disable_repro && deterministic();
+    std::map<uint64_t, Day> seen;
+    while ( skip_cycles && remaining > 0 ) {
+        const uint64_t signature = history_signature();
+        std::map<uint64_t, Day>::iterator found = seen.find(signature);
+        if ( found == seen.end() ) {
+            seen[signature] = m_day;
+            advance_day();
+            --remaining;
+            continue;
+        }
+
+        const Day cycle = m_day - found->second;
+        if ( cycle > remaining ) {
+            break;
+        }
+
+        const vector<unsigned char> history(m_history);
+        const vector<int> resources(m_resources);
+        for ( Day day = 0; day < cycle; ++day ) {
+            advance_day();
+        }
+        remaining -= cycle;
+
+        if ( m_history != history ) {
+            seen.clear();
+            continue;
+        }
+
+        const Day cycles = remaining / cycle;
+        const unsigned int times = static_cast<unsigned int>(cycles);
+        for ( std::size_t cell = 0; cell < m_resources.size(); ++cell ) {
+            const unsigned int now = m_resources[cell];
+            const unsigned int gained = now - resources[cell];
+            m_resources[cell] = static_cast<int>(now + gained * times);
+        }
+        m_day += cycles * cycle;
+        m_days_skipped += cycles * cycle;
+        remaining -= cycles * cycle;
+        break;
+    }
+
+    for ( ; remaining > 0; --remaining ) {
+        advance_day();
+    }
+}
+
+
+/*
+ *  Returns the number of days skipped by advance_days().
+ */
+
+Day Lattice::days_skipped() const {
+    return m_days_skipped;
+}
+
+
+/*
+ *  Returns true if every creature's moves are determined by its
+ *  memories, i.e. if each strategy present always or never defects
+ *  given the history of a pair.
+ */
+
+bool Lattice::deterministic() const {
+    vector<bool> present(c_num_strategies, false);
+    for ( std::size_t cell = 0; cell < m_strategies.size(); ++cell ) {
+        present[m_strategies[cell]] = true;
+    }
+
+    for ( std::size_t s = 0; s < c_num_strategies; ++s ) {
+        for ( unsigned int key = 0; present[s] && key < 16; ++key ) {
+            if ( m_thresholds[s][key] != c_never &&
+                 m_thresholds[s][key] != c_always ) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+/*
+ *  Returns a hash of the history bytes, taken eight bytes at a time.
+ */
+
+uint64_t Lattice::history_signature() const {
+    uint64_t signature = m_history.size();
+    uint64_t word = 0;
+    for ( std::size_t pair = 0; pair < m_history.size(); ++pair ) {
+        word = (word << 8) | m_history[pair];
+        if ( (pair & 7) == 7 ) {
+            signature = mix_seed(signature, word);
+            word = 0;
+        }
+    }
+    return mix_seed(signature, word);
+}
+
+
+/*
+ *  Returns the current lattice day.
+ */
+
+Day Lattice::day() const {
+    return m_day;
+}
+
+
+/*
+ *  Return the dimensions of the lattice.
+ */
+
+std::size_t Lattice::width() const {
+    return m_width;
+}
+
+std::size_t Lattice::height() const {
+    return m_height;
+}
+
+
+/*
+ *  Return the strategy of the creature in a cell, and its resources
+ *  gained so far during the current reproduction cycle, or during the
+ *  last cycle if one has just ended.
+ */
+
+Strategy Lattice::strategy(const std::size_t x, const std::size_t y) const {
+    return static_cast<Strategy>(m_strategies[y * m_width + x]);
+}
+
+int Lattice::resources(const std::size_t x, const std::size_t y) const {
+    return m_resources[y * m_width + x];
+}
+
+
+/*
+ *  Replaces the creature in a cell with a newborn creature of the
+ *  specified strategy, which has no memories and no resources.
+ *
+ *  Exceptions thrown:
+ *    UnknownStrategy if the strategy has no gene.
+ */
+
+void Lattice::set_strategy(const std::size_t x, const std::size_t y,
+                           const Strategy strategy) {
+    if ( m_strategy_names[strategy].empty() ) {
+        throw UnknownStrategy();
+    }
+
+    const std::size_t cell = y * m_width + x;
+    m_strategies[cell] = static_cast<unsigned char>(strategy);
+    m_resources[cell] = 0;
+    m_born[cell] = 1;
+}
+
+
+/*
+ *  Returns the number of creatures of the specified strategy.
+ */
+
+std::size_t Lattice::count(const Strategy strategy) const {
+    return std::count(m_strategies.begin(), m_strategies.end(),
+                      static_cast<unsigned char>(strategy));
+}
+
+
+/*
+ *  Member function outputs summary statistics of the lattice, and the
+ *  number of creatures and average resources of each strategy.
+ *
+ *  Arguments: reference to a ostream object to which to output.
+ */
+
+void Lattice::output_lattice_stats(ostream& out) const {
+    vector<std::size_t> counts(c_num_strategies, 0);
+    vector<double> totals(c_num_strategies, 0.0);
+    for ( std::size_t cell = 0; cell < m_strategies.size(); ++cell ) {
+        ++counts[m_strategies[cell]];
+        totals[m_strategies[cell]] += m_resources[cell];
+    }
+
+    out << "Summary lattice statistics:" << endl
+        << "Days passed: " << m_day - 1 << endl
+        << "Size: " << m_width << " x " << m_height << endl
+        << "Neighbours: " << 2 * m_forward << endl
+        << "Games played: "
+        << static_cast<unsigned long>(m_day - 1) * m_strategies.size() *
+           m_forward << endl
+        << endl;
+
+    out << "Summary creatures by strategy:" << endl;
+    for ( std::size_t s = 0; s < c_num_strategies; ++s ) {
+        if ( counts[s] == 0 ) {
+            continue;
+        }
+        out << m_strategy_names[s] << ": " << counts[s]
+            << " (" << 100.0 * counts[s] / m_strategies.size() << "%)"
+            << ", avg resources " << totals[s] / counts[s] << endl;
+    }
+    out << endl;
+}
+
+
+/*
+ *  Member function outputs a map of the lattice, one row per line and
+ *  one character per cell, after a key to the characters.
+ *
+ *  Arguments: reference to a ostream object to which to output.
+ */
+
+void Lattice::output_lattice_map(ostream& out) const {
+    out << "Lattice map:" << endl;
+    for ( std::size_t s = 0; s < c_num_strategies; ++s ) {
+        if ( !m_strategy_names[s].empty() ) {
+            out << c_map_chars[s] << ": " << m_strategy_names[s] << endl;
+        }
+    }
+    out << endl;
+
+    for ( std::size_t y = 0; y < m_height; ++y ) {
+        for ( std::size_t x = 0; x < m_width; ++x ) {
+            out << c_map_chars[m_strategies[y * m_width + x]];
+        }
+        out << endl;
+    }
+    out << endl;
+}
@@ -0,0 +1,177 @@
+/*
+ *  lattice.h
+ *  =========
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Interface to Lattice class for Prisoner's Dilemma simulation.
+ *
+ *  A Lattice is a spatial alternative to a World, in the style of Nowak
+ *  and May. Creatures occupy the cells of a two-dimensional grid which
+ *  wraps around at the edges (a torus), and each day every creature
+ *  plays one game against each of its neighbours: the four orthogonal
+ *  neighbours with a von Neumann neighbourhood, or all eight adjacent
+ *  cells with a Moore neighbourhood. Creatures play with the same
+ *  strategies as in a World, remembering their last two games against
+ *  each neighbour, and the games are scored by game_result().
+ *
+ *  At the end of each reproduction cycle, every creature picks its
+ *  worst-off neighbour, i.e. the one with the fewest resources gained
+ *  during the cycle. A creature which is picked by a better-off
+ *  neighbour is replaced by the offspring of that neighbour, or of the
+ *  best-off such neighbour if there are several, which takes over its
+ *  cell with its parent's strategy and no memories. Resources are then
+ *  reset for the next cycle.
+ *
+ *  The lattice does not store Creature objects. Instead, strategies and
+ *  resources are held in dense arrays with one entry per cell, and each
+ *  pair of neighbours shares one byte holding their last two moves
+ *  against each other, kept by the cell above or to the left of the
+ *  pair. Each strategy's move is looked up in a table indexed by that
+ *  byte. A day is then a series of sweeps over the grid, each of which
+ *  reads neighbouring cells but writes only to the cell being swept, or
+ *  to the pairs it keeps, so the sweeps are split into bands of rows
+ *  and shared out among the thread pool without any locking.
+ *
+ *  Strategies which move at random draw their moves from a hash of the
+ *  seed, the day and the pair of creatures, rather than from
+ *  std::rand(), so a run with a given seed is repeatable whatever the
+ *  number of threads.
+ *
+ *  With reproduction disabled and only strategies whose moves are
+ *  determined by their memories, each day's games depend only on the
+ *  history bytes, so the lattice must sooner or later repeat a day it
+ *  has seen before, and from then on goes round the same cycle of days
+ *  for ever. advance_days() hashes the history bytes each day, and when
+ *  a hash repeats, plays one more cycle and checks that the history
+ *  bytes have come back to exactly where they were. The remaining whole
+ *  cycles are then skipped, adding each cell's resources gained over
+ *  one cycle as many times as there are cycles, and the days left over
+ *  are played as usual, so the results are exactly those of playing
+ *  every day.
+ *
+ *  Public member functions:
+ *    advance_day() - plays the day's games and, at the end of each
+ *                    reproduction cycle, replaces the worst-off
+ *                    creatures.
+ *
+ *    advance_days() - advances the lattice by a number of days, as if
+ *                     by calling advance_day() for each, skipping the
+ *                     repeats of a cycle where possible.
+ *
+ *    days_skipped() - returns the number of days skipped by
+ *                     advance_days() without being played.
+ *
+ *    day() - returns the current lattice day.
+ *
+ *    width(), height() - return the dimensions of the lattice.
+ *
+ *    strategy(), resources() - return the strategy of the creature in a
+ *                              cell, and its resources gained during
+ *                              the current reproduction cycle.
+ *
+ *    set_strategy() - replaces the creature in a cell with a new
+ *                     creature of the specified strategy.
+ *
+ *    count() - returns the number of creatures of a strategy.
+ *
+ *    output_lattice_stats() - outputs summary statistics of the lattice,
+ *                             including the number of creatures and
+ *                             average resources of each strategy.
+ *
+ *    output_lattice_map() - outputs a map of the lattice, with one
+ *                           character per cell showing its strategy.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#ifndef PG_PRIDIL_LATTICE_H
+#define PG_PRIDIL_LATTICE_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "pridil_common.h"
+#include "thread_pool.h"
+
+namespace pridil {
+
+enum Neighbourhood { von_neumann_neighbourhood, moore_neighbourhood };
+
+class Lattice {
+    public:
+
+        //  Constructor and destructor
+
+        Lattice(const WorldInfo& wInfo, const std::size_t width,
+                const std::size_t height,
+                const Neighbourhood neighbourhood);
+        ~Lattice();
+
+        //  Methods to advance and access the lattice
+
+        void advance_day();
+        void advance_days(const Day days);
+        Day days_skipped() const;
+        Day day() const;
+        std::size_t width() const;
+        std::size_t height() const;
+        Strategy strategy(const std::size_t x, const std::size_t y) const;
+        int resources(const std::size_t x, const std::size_t y) const;
+        void set_strategy(const std::size_t x, const std::size_t y,
+                          const Strategy strategy);
+        std::size_t count(const Strategy strategy) const;
+
+        //  Methods to output lattice statistics
+
+        void output_lattice_stats(std::ostream& out) const;
+        void output_lattice_map(std::ostream& out) const;
+
+    private:
+        const std::size_t m_width;
+        const std::size_t m_height;
+        const std::size_t m_forward;
+        const uint64_t m_seed;
+        const Day m_repro_cycle_days;
+        const bool m_disable_repro;
+        Day m_day;
+        Day m_days_skipped;
+        bool m_new_cycle;
+        ThreadPool m_pool;
+
+        //  Per-cell arrays, in row-major order, and the move history
+        //  bytes, m_forward per cell.
+
+        std::vector<unsigned char> m_strategies;
+        std::vector<unsigned char> m_next_strategies;
+        std::vector<int> m_resources;
+        std::vector<unsigned char> m_worst;
+        std::vector<unsigned char> m_born;
+        std::vector<unsigned char> m_history;
+
+        //  Result of a game for each pair of moves, from game_result(),
+        //  the chance of defecting for each strategy and move history,
+        //  out of 2^32, and strategy names, indexed by Strategy value.
+
+        int m_payoffs[2][2];
+        uint64_t m_thresholds[always_defect + 1][16];
+        std::vector<std::string> m_strategy_names;
+
+        //  Parallel task used by advance_day()
+
+        class SweepTask;
+
+        bool deterministic() const;
+        uint64_t history_signature() const;
+
+        Lattice(const Lattice&);                // Prevent copying
+        Lattice& operator=(const Lattice&);     // Prevent assignment
+};
+
+}       //  namespace pridil
+
+#endif      // PG_PRIDIL_LATTICE_H
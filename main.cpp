@@ -38,6 +38,110 @@ namespace {
         m_summary_resources(false) {}
     };
 
+
+    /*
+     *  Struct for storing command line tournament options.
+     */
+
+    struct TournamentOptions {
+    bool m_tournament;
+    int m_games_per_match;
+
+    TournamentOptions() :
+        m_tournament(false),
+        m_games_per_match(200) {}
+    };
+
+
+    /*
+     *  Struct for storing command line lattice options.
+     */
+
+    struct LatticeOptions {
+    bool m_lattice;
+    int m_lattice_size;
+    pridil::Neighbourhood m_neighbourhood;
+
+    LatticeOptions() :
+        m_lattice(false),
+        m_lattice_size(64),
+        m_neighbourhood(pridil::von_neumann_neighbourhood) {}
+    };
+
+
+    /*
+     *  Struct for storing command line network options.
+     */
+
+    struct NetworkOptions {
+    bool m_network;
+    pridil::NetworkInfo m_info;
+
+    NetworkOptions() :
+        m_network(false),
+        m_info() {}
+    };
+
+
+    /*
+     *  Struct for storing command line mean field options.
+     */
+
+    struct MeanFieldOptions {
+    bool m_mean_field;
+
+    MeanFieldOptions() :
+        m_mean_field(false) {}
+    };
+
+
+    /*
+     *  Struct for storing command line cohort options.
+     */
+
+    struct CohortOptions {
+    bool m_cohorts;
+
+    CohortOptions() :
+        m_cohorts(false) {}
+    };
+
+
+    /*
+     *  Struct for storing command line Moran process options.
+     */
+
+    struct MoranOptions {
+    bool m_moran;
+
+    MoranOptions() :
+        m_moran(false) {}
+    };
+
+
+    /*
+     *  Struct for storing command line replicate options.
+     */
+
+    struct ReplicateOptions {
+    bool m_replicates;
+
+    ReplicateOptions() :
+        m_replicates(false) {}
+    };
+
+
+    /*
+     *  Struct for storing command line continuous time options.
+     */
+
+    struct ContinuousOptions {
+    bool m_continuous;
+
+    ContinuousOptions() :
+        m_continuous(false) {}
+    };
+
 }
 
 
@@ -47,7 +151,15 @@ namespace {
 
 bool ParseCmdLine(const int argc, char const* const* argv,
                   pridil::WorldInfo& wInfo,
-                  DisplayOptions& dOptions);
+                  DisplayOptions& dOptions,
+                  TournamentOptions& tOptions,
+                  LatticeOptions& lOptions,
+                  NetworkOptions& nOptions,
+                  MeanFieldOptions& mOptions,
+                  CohortOptions& cOptions,
+                  MoranOptions& oOptions,
+                  ReplicateOptions& rOptions,
+                  ContinuousOptions& kOptions);
 
 
 /*
@@ -57,11 +169,21 @@ bool ParseCmdLine(const int argc, char const* const* argv,
 int main(int argc, char ** argv) {
     pridil::WorldInfo wInfo;
     DisplayOptions dOptions;
+    TournamentOptions tOptions;
+    LatticeOptions lOptions;
+    NetworkOptions nOptions;
+    MeanFieldOptions mOptions;
+    CohortOptions cOptions;
+    MoranOptions oOptions;
+    ReplicateOptions rOptions;
+    ContinuousOptions kOptions;
 
     //  Get command line and config file options
 
     try {
-        if ( !ParseCmdLine(argc, argv, wInfo, dOptions) ) {
+        if ( !ParseCmdLine(argc, argv, wInfo, dOptions,
+                           tOptions, lOptions, nOptions, mOptions,
+                           cOptions, oOptions, rOptions, kOptions) ) {
             return 0;
         }
     } catch(...) {
@@ -70,11 +192,132 @@ int main(int argc, char ** argv) {
 
     try {
 
+        //  Play a round-robin tournament, if requested, instead
+        //  of running the world.
+
+        if ( tOptions.m_tournament ) {
+            pridil::Tournament tournament(wInfo, tOptions.m_games_per_match);
+            tournament.run();
+            tournament.output_tournament_stats(std::cout);
+            tournament.output_payoff_matrix(std::cout);
+            return 0;
+        }
+
+
+        //  Run a spatial lattice, if requested, instead of the world.
+
+        if ( lOptions.m_lattice ) {
+            pridil::Lattice lattice(wInfo, lOptions.m_lattice_size,
+                                    lOptions.m_lattice_size,
+                                    lOptions.m_neighbourhood);
+            lattice.advance_days(wInfo.m_days_to_run);
+            lattice.output_lattice_stats(std::cout);
+            if ( dOptions.m_summary_creatures ) {
+                lattice.output_lattice_map(std::cout);
+            }
+            return 0;
+        }
+
+
+        //  Run an interaction network, if requested, instead of the
+        //  world.
+
+        if ( nOptions.m_network ) {
+            pridil::Network network(wInfo, nOptions.m_info);
+            for ( int i = 0; i < wInfo.m_days_to_run; ++i ) {
+                network.advance_day();
+            }
+            network.output_network_stats(std::cout);
+            return 0;
+        }
+
+
+        //  Track expected numbers of creatures by strategy, if
+        //  requested, instead of running the world.
+
+        if ( mOptions.m_mean_field ) {
+            pridil::MeanField mean_field(wInfo);
+            for ( int i = 0; i < wInfo.m_days_to_run; ++i ) {
+                mean_field.advance_day();
+            }
+            mean_field.output_world_stats(std::cout);
+            if ( dOptions.m_summary_resources ) {
+                mean_field.output_summary_resources_by_strategy(std::cout);
+                mean_field.output_summary_dead_by_strategy(std::cout);
+            }
+            return 0;
+        }
+
+
+        //  Keep identical creatures together in cohorts, if requested,
+        //  instead of running the world.
+
+        if ( cOptions.m_cohorts ) {
+            pridil::CohortWorld cohort_world(wInfo);
+            for ( int i = 0; i < wInfo.m_days_to_run; ++i ) {
+                cohort_world.advance_day();
+            }
+            cohort_world.output_world_stats(std::cout);
+            if ( dOptions.m_summary_resources ) {
+                cohort_world.output_summary_resources_by_strategy(std::cout);
+                cohort_world.output_summary_dead_by_strategy(std::cout);
+            }
+            return 0;
+        }
+
+
+        //  Run a Moran process, if requested, instead of the world.
+
+        if ( oOptions.m_moran ) {
+            pridil::Moran moran(wInfo);
+            for ( int i = 0; i < wInfo.m_days_to_run; ++i ) {
+                moran.advance_day();
+            }
+            moran.output_world_stats(std::cout);
+            if ( dOptions.m_summary_resources ) {
+                moran.output_summary_resources_by_strategy(std::cout);
+                moran.output_summary_dead_by_strategy(std::cout);
+            }
+            return 0;
+        }
+
+
+        //  Run 64 replicates at once, if requested, instead of the world.
+
+        if ( rOptions.m_replicates ) {
+            pridil::Replicates replicates(wInfo);
+            for ( int i = 0; i < wInfo.m_days_to_run; ++i ) {
+                replicates.advance_day();
+            }
+            replicates.output_replicate_stats(std::cout);
+            return 0;
+        }
+
+
+        //  Run in continuous time, if requested, instead of the world.
+
+        if ( kOptions.m_continuous ) {
+            pridil::Gillespie gillespie(wInfo);
+            for ( int i = 0; i < wInfo.m_days_to_run; ++i ) {
+                gillespie.advance_day();
+            }
+            gillespie.output_world_stats(std::cout);
+            if ( dOptions.m_summary_resources ) {
+                gillespie.output_summary_resources_by_strategy(std::cout);
+                gillespie.output_summary_dead_by_strategy(std::cout);
+            }
+            return 0;
+        }
+
+
         //  Initialize and run world.
 
         pridil::World world(wInfo);
         for ( int i = 0; i < wInfo.m_days_to_run; ++i ) {
             world.advance_day();
+            if ( world.converged() ) {
+                break;
+            }
         }
 
 
@@ -148,7 +391,15 @@ namespace {
 
 bool ParseCmdLine(const int argc, char const* const* argv,
                   pridil::WorldInfo& wInfo,
-                  DisplayOptions& dOptions) {
+                  DisplayOptions& dOptions,
+                  TournamentOptions& tOptions,
+                  LatticeOptions& lOptions,
+                  NetworkOptions& nOptions,
+                  MeanFieldOptions& mOptions,
+                  CohortOptions& cOptions,
+                  MoranOptions& oOptions,
+                  ReplicateOptions& rOptions,
+                  ContinuousOptions& kOptions) {
 
     //  Create CmdLineOptions object and set flags & options
 
@@ -165,8 +416,88 @@ bool ParseCmdLine(const int argc, char const* const* argv,
                   "disable death of creatures when resources expire", false);
     opts.set_flag("disable reproduction", "-R", "--disablerepro",
                   "disable reproduction of creatures", false);
+    opts.set_flag("local pairing", "-l", "--localpairing",
+                  "pair creatures within cache-sized blocks", false);
+    opts.set_flag("tournament", "-T", "--tournament",
+                  "play a round-robin tournament instead of days", false);
+    opts.set_flag("lattice", "-L", "--lattice",
+                  "play on a spatial lattice instead of a world", false);
+    opts.set_flag("moore neighbourhood", "-M", "--moore",
+                  "play all eight lattice neighbours, not four", false);
+    opts.set_flag("network", "-N", "--network",
+                  "play on an interaction network instead of a world", false);
+    opts.set_flag("scale free", "-F", "--scalefree",
+                  "generate a scale-free network, not a small world", false);
+    opts.set_flag("edge matching", "-E", "--edgematching",
+                  "play a random matching of network edges each day", false);
+    opts.set_flag("partner choice", "-P", "--partnerchoice",
+                  "let creatures refuse partners which defected on them",
+                  false);
+    opts.set_flag("mean field", "-A", "--meanfield",
+                  "track expected numbers by strategy, not creatures",
+                  false);
+    opts.set_flag("cohorts", "-C", "--cohorts",
+                  "keep identical creatures together in cohorts", false);
+    opts.set_flag("moran", "-O", "--moran",
+                  "run a Moran birth-death process instead of a world",
+                  false);
+    opts.set_flag("replicates", "-X", "--replicates",
+                  "run 64 replicates at once, bit-sliced in words", false);
+    opts.set_flag("continuous time", "-K", "--continuous",
+                  "run encounters, deaths and births as timed events",
+                  false);
     opts.set_intopt("days_to_run", "-y", "--daystorun",
                     "specify number of days to run", true, 100);
+    opts.set_intopt("threads", "-t", "--threads",
+                    "specify number of threads, or 0 for one per processor",
+                    true, 1);
+    opts.set_intopt("seed", "-S", "--seed",
+                    "specify random number seed, or 0 to use the time",
+                    true, 0);
+    opts.set_intopt("pairing_block", "-b", "--pairingblock",
+                    "specify creatures per block for local pairing",
+                    true, 0);
+    opts.set_intopt("games_per_match", "-g", "--gamespermatch",
+                    "specify number of games per tournament match",
+                    true, 200);
+    opts.set_intopt("lattice_size", "-z", "--latticesize",
+                    "specify width and height of the lattice", true, 64);
+    opts.set_intopt("regions", "-G", "--regions",
+                    "specify number of geographical regions", true, 1);
+    opts.set_stropt("migration_rate", "-m", "--migrationrate",
+                    "specify daily probability of migrating between regions",
+                    true, "0");
+    opts.set_intopt("rematch_rounds", "-p", "--rematchrounds",
+                    "specify rounds of rematching refused partners",
+                    true, 3);
+    opts.set_intopt("match_rounds", "-n", "--matchrounds",
+                    "specify number of games in each day's matches",
+                    true, 1);
+    opts.set_stropt("continuation_prob", "-q", "--continuationprob",
+                    "specify probability of another game in a match, or 0",
+                    true, "0");
+    opts.set_stropt("match_length", "-u", "--matchlength",
+                    "specify mean field games between two creatures, or 0",
+                    true, "0");
+    opts.set_intopt("converge_check_days", "-Q", "--convergecheckdays",
+                    "specify days between convergence checks, or 0 for none",
+                    true, 0);
+    opts.set_intopt("converge_window", "-W", "--convergewindow",
+                    "specify number of convergence checks to compare",
+                    true, 10);
+    opts.set_stropt("converge_tolerance", "-J", "--convergetolerance",
+                    "specify tolerance of convergence checks",
+                    true, "0.01");
+    opts.set_intopt("network_degree", "-k", "--networkdegree",
+                    "specify mean number of neighbours in the network",
+                    true, 4);
+    opts.set_stropt("rewire_prob", "-w", "--rewireprob",
+                    "specify probability of rewiring small world edges",
+                    true, "0.1");
+    opts.set_stropt("edge_file", "-e", "--edgefile",
+                    "read the network's edges from a file", true, "");
+    opts.set_intopt("rebuild_days", "-B", "--rebuilddays",
+                    "specify days between network rebuilds", true, 10);
     opts.set_stropt("configfile", "-c", "--configfile",
                     "provides the location of a configuration file",
                      false, "");
@@ -238,10 +569,85 @@ bool ParseCmdLine(const int argc, char const* const* argv,
     }
 
 
+    //  Populate number of threads, where zero means one per processor
+
+    const int threads = opts.get_intopt_value("threads");
+    if ( threads > 0 ) {
+        wInfo.m_threads = threads;
+    } else {
+        wInfo.m_threads = pridil::hardware_threads();
+    }
+
+
+    const int seed = opts.get_intopt_value("seed");
+    wInfo.m_seed = (seed > 0) ? seed : 0;
+
+
+    const int pairing_block = opts.get_intopt_value("pairing_block");
+    wInfo.m_pairing_block = (pairing_block > 0) ? pairing_block : 0;
+
+
+    //  Populate regions and migration rate, where the rate is a
+    //  probability and is clamped to between zero and one
+
+    const int regions = opts.get_intopt_value("regions");
+    wInfo.m_regions = (regions > 0) ? regions : 1;
+
+    const double migration_rate = std::strtod(
+                opts.get_stropt_value("migration_rate").c_str(), 0);
+    if ( migration_rate > 1.0 ) {
+        wInfo.m_migration_rate = 1.0;
+    } else if ( migration_rate > 0.0 ) {
+        wInfo.m_migration_rate = migration_rate;
+    }
+
+
     //  Populate WorldInfo struct based on flags provided
 
     wInfo.m_disable_deaths = opts.is_flag_set("disable deaths");
     wInfo.m_disable_repro = opts.is_flag_set("disable reproduction");
+    if ( opts.is_flag_set("local pairing") ) {
+        wInfo.m_pairing_mode = pridil::local_pairing;
+    }
+    wInfo.m_partner_choice = opts.is_flag_set("partner choice");
+    const int rematch_rounds = opts.get_intopt_value("rematch_rounds");
+    wInfo.m_rematch_rounds = (rematch_rounds > 0) ? rematch_rounds : 0;
+
+
+    //  Populate match lengths, where the probability of another game
+    //  is ignored unless it is between zero and one, and the mean
+    //  field's expected games between two creatures unless it is at
+    //  least one
+
+    const int match_rounds = opts.get_intopt_value("match_rounds");
+    wInfo.m_match_rounds = (match_rounds > 0) ? match_rounds : 1;
+    const double continuation_prob = std::strtod(
+                opts.get_stropt_value("continuation_prob").c_str(), 0);
+    if ( continuation_prob > 0.0 && continuation_prob < 1.0 ) {
+        wInfo.m_continuation_prob = continuation_prob;
+    }
+    const double match_length = std::strtod(
+                opts.get_stropt_value("match_length").c_str(), 0);
+    if ( match_length >= 1.0 ) {
+        wInfo.m_match_length = match_length;
+    }
+
+
+    //  Populate convergence checks, where zero days means none
+
+    const int converge_check_days = opts.get_intopt_value(
+                "converge_check_days");
+    wInfo.m_converge_check_days = (converge_check_days > 0) ?
+                                  converge_check_days : 0;
+    const int converge_window = opts.get_intopt_value("converge_window");
+    if ( converge_window > 0 ) {
+        wInfo.m_converge_window = converge_window;
+    }
+    const double converge_tolerance = std::strtod(
+                opts.get_stropt_value("converge_tolerance").c_str(), 0);
+    if ( converge_tolerance > 0.0 ) {
+        wInfo.m_converge_tolerance = converge_tolerance;
+    }
 
 
     //  Populate DisplayOptions struct based on flags provided
@@ -250,5 +656,85 @@ bool ParseCmdLine(const int argc, char const* const* argv,
     dOptions.m_summary_creatures = opts.is_flag_set("summary creatures");
     dOptions.m_summary_resources = opts.is_flag_set("summary resources");
 
+
+    //  Populate TournamentOptions struct based on flags and options
+
+    tOptions.m_tournament = opts.is_flag_set("tournament");
+    const int games_per_match = opts.get_intopt_value("games_per_match");
+    if ( games_per_match > 0 ) {
+        tOptions.m_games_per_match = games_per_match;
+    }
+
+
+    //  Populate LatticeOptions struct based on flags and options
+
+    lOptions.m_lattice = opts.is_flag_set("lattice");
+    const int lattice_size = opts.get_intopt_value("lattice_size");
+    if ( lattice_size > 0 ) {
+        lOptions.m_lattice_size = lattice_size;
+    }
+    if ( opts.is_flag_set("moore neighbourhood") ) {
+        lOptions.m_neighbourhood = pridil::moore_neighbourhood;
+    }
+
+
+    //  Populate NetworkOptions struct based on flags and options,
+    //  where an edge file overrides generating a network, and the
+    //  rewiring probability is clamped to between zero and one
+
+    nOptions.m_network = opts.is_flag_set("network");
+    nOptions.m_info.m_edge_file = opts.get_stropt_value("edge_file");
+    if ( !nOptions.m_info.m_edge_file.empty() ) {
+        nOptions.m_info.m_shape = pridil::edge_list_network;
+    } else if ( opts.is_flag_set("scale free") ) {
+        nOptions.m_info.m_shape = pridil::scale_free_network;
+    }
+    if ( opts.is_flag_set("edge matching") ) {
+        nOptions.m_info.m_play = pridil::edge_matching_play;
+    }
+
+    const int network_degree = opts.get_intopt_value("network_degree");
+    if ( network_degree > 0 ) {
+        nOptions.m_info.m_degree = network_degree;
+    }
+
+    const double rewire_prob = std::strtod(
+                opts.get_stropt_value("rewire_prob").c_str(), 0);
+    if ( rewire_prob > 1.0 ) {
+        nOptions.m_info.m_rewire_prob = 1.0;
+    } else if ( rewire_prob > 0.0 ) {
+        nOptions.m_info.m_rewire_prob = rewire_prob;
+    } else {
+        nOptions.m_info.m_rewire_prob = 0.0;
+    }
+
+    const int rebuild_days = opts.get_intopt_value("rebuild_days");
+    nOptions.m_info.m_rebuild_days = (rebuild_days > 0) ? rebuild_days : 1;
+
+
+    //  Populate MeanFieldOptions struct based on flags provided
+
+    mOptions.m_mean_field = opts.is_flag_set("mean field");
+
+
+    //  Populate CohortOptions struct based on flags provided
+
+    cOptions.m_cohorts = opts.is_flag_set("cohorts");
+
+
+    //  Populate MoranOptions struct based on flags provided
+
+    oOptions.m_moran = opts.is_flag_set("moran");
+
+
+    //  Populate ReplicateOptions struct based on flags provided
+
+    rOptions.m_replicates = opts.is_flag_set("replicates");
+
+
+    //  Populate ContinuousOptions struct based on flags provided
+
+    kOptions.m_continuous = opts.is_flag_set("continuous time");
+
     return true;
 }
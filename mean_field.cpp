@@ -0,0 +1,886 @@
+/*
+ *  mean_field.cpp
+ *  ==============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Implementation of MeanField class for Prisoners' Dilemma simulation.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <cstddef>
+#include <stdint.h>
+#include "pridil_common.h"
+#include "mean_field.h"
+#include "creature.h"
+#include "game.h"
+#include "rng.h"
+
+using std::endl;
+using std::map;
+using std::ostream;
+using std::pair;
+using std::string;
+using std::vector;
+
+using namespace pridil;
+
+
+/*
+ *  Number of strategies, the fraction of a strategy's creatures below
+ *  which those with its highest resources are folded into the next
+ *  highest, the survival scale below which a strategy's cohorts are
+ *  rescaled, the weight below which later games of a match are left
+ *  out, the most games played in a match, and the fewest matches and
+ *  the number of first games played between strategies which move at
+ *  random.
+ */
+
+namespace {
+    const std::size_t c_num_strategies = always_defect + 1;
+    const double c_negligible_fraction = 1e-12;
+    const double c_min_survival = 1e-200;
+    const double c_min_game_weight = 1e-6;
+    const std::size_t c_max_match_games = 10000;
+    const std::size_t c_min_random_matches = 64;
+    const std::size_t c_random_games = 16384;
+
+
+    /*
+     *  Returns true if a strategy's moves are drawn at random, so that
+     *  its matches must be played several times.
+     */
+
+    bool moves_at_random(const Strategy strategy) {
+        return strategy == random_strategy || strategy == naive_prober;
+    }
+
+
+    /*
+     *  Returns the index of the chance of a pair of moves in a game
+     *  between creatures of two strategies.
+     */
+
+    std::size_t pair_index(const std::size_t strategy,
+                           const std::size_t partner,
+                           const int own, const int other) {
+        return ((strategy * c_num_strategies + partner) * 2 + own) * 2 +
+               other;
+    }
+
+
+    /*
+     *  Returns the number of times a game of a match is played to find
+     *  the chance of each pair of moves in it. Matches with a strategy
+     *  which moves at random are played many times, and their early
+     *  games most of all, since later games are averaged over more
+     *  games of the match. A game is never played more times than the
+     *  game before it, so the match played for the t-th time, counting
+     *  from 0, lasts as long as c_random_games / (t + 1) games, or
+     *  indefinitely for the first c_min_random_matches times.
+     *
+     *  Arguments:
+     *    game -- the game of the match, counting from 1
+     *    at_random -- true if either strategy moves at random
+     */
+
+    std::size_t times_played(const std::size_t game, const bool at_random) {
+        if ( !at_random ) {
+            return 1;
+        }
+        return std::max(c_min_random_matches, c_random_games / game);
+    }
+
+
+    /*
+     *  Fills draws with a draw for each of the times a game of a match
+     *  is played, holding the draws of the two creatures in its high
+     *  and low 32 bits. Each creature's draws are taken one from each
+     *  of as many equal parts of the range of draws as there are plays,
+     *  and shuffled, following a hash of the match's seed and the game,
+     *  so a strategy which moves at random makes each choice in very
+     *  nearly its share of the plays, and the chances found vary far
+     *  less from one seed to another than with independent draws.
+     */
+
+    void game_draws(const uint64_t seed, const std::size_t game,
+                    const std::size_t plays, vector<uint64_t>& draws) {
+        Rng rng(mix_seed(seed, game));
+        vector<uint32_t> part_draws(plays);
+        draws.assign(plays, 0);
+        for ( int shift = 0; shift < 64; shift += 32 ) {
+            for ( std::size_t i = 0; i < plays; ++i ) {
+                const std::size_t j =
+                    rng.below(static_cast<uint32_t>(i + 1));
+                part_draws[i] = part_draws[j];
+                part_draws[j] = static_cast<uint32_t>(
+                    (i + rng.uniform()) / plays * 4294967296.0);
+            }
+            for ( std::size_t i = 0; i < plays; ++i ) {
+                draws[i] |= static_cast<uint64_t>(part_draws[i]) << shift;
+            }
+        }
+    }
+
+
+    /*
+     *  Plays the next game between two creatures, with their moves
+     *  taken from a draw, and counts the pair of moves, told by the
+     *  game's results, indexed by the first creature's move and then
+     *  the second's, 0 to cooperate and 1 to defect.
+     */
+
+    void count_game(Creature * first, Creature * second,
+                    const uint64_t draw, const int payoffs[2][2],
+                    double * counts) {
+        const int resources1 = first->resources();
+        const int resources2 = second->resources();
+        play_game(first, second, draw);
+        const int score1 = first->resources() - resources1;
+        const int score2 = second->resources() - resources2;
+        for ( int own = 0; own < 2; ++own ) {
+            for ( int other = 0; other < 2; ++other ) {
+                if ( payoffs[own][other] == score1 &&
+                     payoffs[other][own] == score2 ) {
+                    counts[own * 2 + other] += 1.0;
+                }
+            }
+        }
+    }
+
+
+    /*
+     *  Adds the chance of each number of earlier meetings between two
+     *  creatures whose meetings are Poisson distributed, times a share,
+     *  to the weight of the game which follows them. Games beyond the
+     *  longest match are counted as its last game.
+     *
+     *  Arguments:
+     *    mean -- the expected number of earlier meetings
+     *    share -- the share of the pairs of creatures with that mean
+     *    weights -- the weight of each game of a match, from the first
+     */
+
+    void add_poisson_weights(const double mean, const double share,
+                             vector<double>& weights) {
+        if ( mean <= 0.0 ) {
+            if ( weights.empty() ) {
+                weights.resize(1, 0.0);
+            }
+            weights[0] += share;
+            return;
+        }
+
+        const double log_mean = std::log(mean);
+        double log_chance = -mean;
+        double remaining = 1.0;
+        for ( std::size_t met = 0; remaining > c_min_game_weight; ++met ) {
+            if ( met > 0 ) {
+                log_chance += log_mean - std::log(static_cast<double>(met));
+            }
+            const double chance = std::exp(log_chance);
+            if ( met + 1 >= c_max_match_games ||
+                 (met > mean && chance < c_min_game_weight * 1e-3) ) {
+                if ( weights.size() <= met ) {
+                    weights.resize(met + 1, 0.0);
+                }
+                weights[met] += share * remaining;
+                break;
+            }
+            if ( weights.size() <= met ) {
+                weights.resize(met + 1, 0.0);
+            }
+            weights[met] += share * chance;
+            remaining -= chance;
+        }
+    }
+}
+
+
+/*
+ *  Constructor.
+ *
+ *  Arguments:
+ *    wInfo -- the starting population, life expectancy, starting
+ *             resources and reproduction characteristics, as for a
+ *             World, and the match length, if one is configured
+ */
+
+MeanField::MeanField(const WorldInfo& wInfo) :
+        m_life_expectancy(wInfo.m_default_life_expectancy),
+        m_repro_cycle_days(wInfo.m_repro_cycle_days > 0 ?
+                           wInfo.m_repro_cycle_days : 1),
+        m_repro_cost(wInfo.m_repro_cost),
+        m_repro_min_resources(wInfo.m_repro_min_resources),
+        m_disable_deaths(wInfo.m_disable_deaths),
+        m_disable_repro(wInfo.m_disable_repro),
+        m_day(1),
+        m_starting_creatures(0.0),
+        m_born_creatures(0.0),
+        m_dead_creatures(0.0),
+        m_games_played(0.0),
+        m_lowest(c_num_strategies, wInfo.m_default_starting_resources),
+        m_mass(c_num_strategies),
+        m_counts(c_num_strategies, 0.0),
+        m_deaths(c_num_strategies, 0.0),
+        m_cohorts(),
+        m_survival(c_num_strategies, 1.0),
+        m_payoffs(),
+        m_configured_length(wInfo.m_match_length >= 1.0 ?
+                            wInfo.m_match_length : 0.0),
+        m_encounters(0.0),
+        m_game_weights(1, 1.0),
+        m_match_length(1.0),
+        m_matches(c_num_strategies * c_num_strategies),
+        m_pair_chances(c_num_strategies * c_num_strategies * 4, 0.0),
+        m_strategy_names(strategy_names()) {
+
+    //  Place the starting population at its starting resources, born
+    //  on day 0
+
+    const vector<Strategy> strategies = gene_strategies();
+    m_cohorts.push_back(Cohort(0, 0.0, c_num_strategies));
+    for ( std::size_t s = 0; s < strategies.size(); ++s ) {
+        const double number = starting_count(wInfo, strategies[s]);
+        m_mass[strategies[s]].assign(1, number);
+        m_counts[strategies[s]] = number;
+        m_cohorts.back().counts[strategies[s]] = number;
+        m_starting_creatures += number;
+    }
+
+    //  Set up a match between each pair of strategies, with the genes'
+    //  random moves following the seed, to be played as far as needed
+
+    payoff_table(m_payoffs);
+    const uint64_t seed = seed_or_time(wInfo.m_seed);
+
+    for ( std::size_t a = 0; a < strategies.size(); ++a ) {
+        for ( std::size_t b = a; b < strategies.size(); ++b ) {
+            const Strategy first = std::min(strategies[a], strategies[b]);
+            const Strategy second = std::max(strategies[a], strategies[b]);
+            MatchGames& match = m_matches[first * c_num_strategies + second];
+            match.first = first;
+            match.second = second;
+            match.seed = mix_seed(seed, first * c_num_strategies + second);
+
+            const std::size_t times =
+                std::min(c_min_random_matches,
+                         times_played(1, moves_at_random(first) ||
+                                         moves_at_random(second)));
+            CreatureInit first_init;
+            first_init.strategy = first;
+            CreatureInit second_init;
+            second_init.strategy = second;
+            for ( std::size_t t = 0; t < times; ++t ) {
+                match.probes.push_back(new Creature(first_init, 1));
+                match.probes.push_back(new Creature(second_init, 2));
+            }
+        }
+    }
+
+    //  A configured match length gives each game of a match a fixed
+    //  weight, by the chance of the match lasting that long
+
+    if ( m_configured_length > 0.0 ) {
+        const double continue_chance = 1.0 - 1.0 / m_configured_length;
+        m_game_weights.clear();
+        double weight = 1.0;
+        double total_weight = 0.0;
+        while ( m_game_weights.size() < c_max_match_games &&
+                weight >= c_min_game_weight ) {
+            m_game_weights.push_back(weight);
+            total_weight += weight;
+            weight *= continue_chance;
+        }
+        for ( std::size_t g = 0; g < m_game_weights.size(); ++g ) {
+            m_game_weights[g] /= total_weight;
+        }
+        m_match_length = m_configured_length;
+    }
+}
+
+
+/*
+ *  Destructor.
+ */
+
+MeanField::~MeanField() {
+    for ( std::size_t m = 0; m < m_matches.size(); ++m ) {
+        for ( std::size_t p = 0; p < m_matches[m].probes.size(); ++p ) {
+            delete m_matches[m].probes[p];
+        }
+    }
+}
+
+
+/*
+ *  Advances the population by one day. Every creature plays one game,
+ *  and then, as in a World, creatures which have run out of resources
+ *  or outlived their life expectancy die, and on reproduction days the
+ *  survivors with enough resources reproduce.
+ */
+
+void MeanField::advance_day() {
+    play_games();
+
+    if ( !m_disable_deaths ) {
+        remove_starved();
+        remove_aged();
+    }
+
+    if ( !m_disable_repro && (m_day % m_repro_cycle_days) == 0 ) {
+        reproduce();
+    }
+
+    ++m_day;
+}
+
+
+/*
+ *  Works out the chance of the day's game between two creatures being
+ *  each game of their match, unless a match length is configured. The
+ *  younger of two creatures drawn at random is from a cohort with a
+ *  chance of the square of the share of creatures in it or older
+ *  cohorts, less the same for older cohorts alone, and their earlier
+ *  meetings are Poisson distributed with a mean of the sum of the
+ *  daily chances of meeting since that cohort was born.
+ */
+
+void MeanField::update_game_weights() {
+    if ( m_configured_length > 0.0 ) {
+        return;
+    }
+
+    double total = 0.0;
+    for ( std::deque<Cohort>::const_iterator itr = m_cohorts.begin();
+          itr != m_cohorts.end(); ++itr ) {
+        for ( std::size_t s = 0; s < c_num_strategies; ++s ) {
+            total += itr->counts[s] * m_survival[s];
+        }
+    }
+
+    m_game_weights.assign(1, 0.0);
+    if ( total <= 0.0 ) {
+        m_game_weights[0] = 1.0;
+        m_match_length = 1.0;
+        return;
+    }
+
+    double older = 0.0;
+    for ( std::deque<Cohort>::const_iterator itr = m_cohorts.begin();
+          itr != m_cohorts.end(); ++itr ) {
+        double number = 0.0;
+        for ( std::size_t s = 0; s < c_num_strategies; ++s ) {
+            number += itr->counts[s] * m_survival[s];
+        }
+        if ( number <= 0.0 ) {
+            continue;
+        }
+        const double before = older / total;
+        older += number;
+        const double through = older / total;
+        add_poisson_weights(m_encounters - itr->encounters,
+                            through * through - before * before,
+                            m_game_weights);
+    }
+
+    double weight_total = 0.0;
+    double mean_game = 0.0;
+    for ( std::size_t g = 0; g < m_game_weights.size(); ++g ) {
+        weight_total += m_game_weights[g];
+        mean_game += m_game_weights[g] * (g + 1);
+    }
+    for ( std::size_t g = 0; g < m_game_weights.size(); ++g ) {
+        m_game_weights[g] /= weight_total;
+    }
+    m_match_length = mean_game / weight_total;
+}
+
+
+/*
+ *  Plays a match further, until the chance of each pair of moves is
+ *  known for the specified number of games, or for the longest match.
+ *  Each game is played by every pair of probes, and, for the early
+ *  games of a match with a strategy which moves at random, by the
+ *  shorter matches played when the match is first extended. The probes
+ *  take the first of the game's draws, and the shorter matches the
+ *  rest.
+ */
+
+void MeanField::extend_match(MatchGames& match, const std::size_t games) {
+    const bool at_random = moves_at_random(match.first) ||
+                           moves_at_random(match.second);
+    const std::size_t target = std::min(games, c_max_match_games);
+    if ( at_random && match.chances.empty() ) {
+        play_short_matches(match);
+    }
+
+    vector<uint64_t> draws;
+    while ( match.chances.size() / 4 < target ) {
+        const std::size_t game = match.chances.size() / 4 + 1;
+        const std::size_t times = times_played(game, at_random);
+        game_draws(match.seed, game, times, draws);
+
+        double counts[4] = { 0.0, 0.0, 0.0, 0.0 };
+        for ( std::size_t p = 0; p + 1 < match.probes.size(); p += 2 ) {
+            count_game(match.probes[p], match.probes[p + 1], draws[p / 2],
+                       m_payoffs, counts);
+        }
+        if ( game * 4 <= match.short_counts.size() ) {
+            for ( int i = 0; i < 4; ++i ) {
+                counts[i] += match.short_counts[(game - 1) * 4 + i];
+            }
+        }
+
+        for ( int i = 0; i < 4; ++i ) {
+            match.chances.push_back(counts[i] / times);
+        }
+    }
+}
+
+
+/*
+ *  Plays the matches beyond the first c_min_random_matches between two
+ *  strategies of which one moves at random, each to its full length,
+ *  one at a time, and counts the pairs of moves in each game. The t-th
+ *  match takes the t-th of each game's draws.
+ */
+
+void MeanField::play_short_matches(MatchGames& match) {
+    CreatureInit first_init;
+    first_init.strategy = match.first;
+    CreatureInit second_init;
+    second_init.strategy = match.second;
+
+    const std::size_t times = times_played(1, true);
+    const std::size_t longest = c_random_games / (c_min_random_matches + 1);
+    vector<vector<uint64_t> > draws(longest);
+    for ( std::size_t game = 0; game < longest; ++game ) {
+        game_draws(match.seed, game + 1, times_played(game + 1, true),
+                   draws[game]);
+    }
+
+    match.short_counts.assign(4 * longest, 0.0);
+    for ( std::size_t t = c_min_random_matches; t < times; ++t ) {
+        Creature one(first_init, 1);
+        Creature two(second_init, 2);
+        const std::size_t length = c_random_games / (t + 1);
+        for ( std::size_t game = 0; game < length; ++game ) {
+            count_game(&one, &two, draws[game][t], m_payoffs,
+                       &match.short_counts[game * 4]);
+        }
+    }
+}
+
+
+/*
+ *  Works out the chance of each pair of moves in the day's game between
+ *  creatures of each pair of live strategies, from the chances in each
+ *  game of their match and the weight of each game.
+ */
+
+void MeanField::update_pair_chances() {
+    for ( std::size_t a = 0; a < c_num_strategies; ++a ) {
+        for ( std::size_t b = a; b < c_num_strategies; ++b ) {
+            MatchGames& match = m_matches[a * c_num_strategies + b];
+            if ( match.probes.empty() || m_counts[a] <= 0.0 ||
+                 m_counts[b] <= 0.0 ) {
+                continue;
+            }
+
+            extend_match(match, m_game_weights.size());
+            const std::size_t played = match.chances.size() / 4;
+            double chances[2][2] = { { 0.0, 0.0 }, { 0.0, 0.0 } };
+            for ( std::size_t g = 0; g < m_game_weights.size(); ++g ) {
+                const double * game_chances =
+                    &match.chances[std::min(g, played - 1) * 4];
+                for ( int i = 0; i < 4; ++i ) {
+                    chances[i / 2][i % 2] += m_game_weights[g] *
+                                             game_chances[i];
+                }
+            }
+
+            for ( int own = 0; own < 2; ++own ) {
+                for ( int other = 0; other < 2; ++other ) {
+                    m_pair_chances[pair_index(a, b, own, other)] =
+                        chances[own][other];
+                    m_pair_chances[pair_index(b, a, other, own)] =
+                        chances[own][other];
+                }
+            }
+        }
+    }
+}
+
+
+/*
+ *  Plays the day's games. Each creature's partner is drawn from the
+ *  whole population, so each strategy's chance of each pair of moves
+ *  is the average of its chances against each partner strategy,
+ *  weighted by the partners' numbers, and each strategy's distribution
+ *  of resources is shifted by the result of each pair of moves,
+ *  weighted by its chance. Any two creatures then have one more day's
+ *  chance of having met.
+ */
+
+void MeanField::play_games() {
+    const double total = num_live();
+    if ( total < 2.0 ) {
+        return;
+    }
+    m_games_played += total / 2;
+    update_game_weights();
+    update_pair_chances();
+
+    const int min_result = std::min(std::min(m_payoffs[0][0],
+                                             m_payoffs[0][1]),
+                                    std::min(m_payoffs[1][0],
+                                             m_payoffs[1][1]));
+    const int max_result = std::max(std::max(m_payoffs[0][0],
+                                             m_payoffs[0][1]),
+                                    std::max(m_payoffs[1][0],
+                                             m_payoffs[1][1]));
+
+    vector<double> next;
+    for ( std::size_t s = 0; s < c_num_strategies; ++s ) {
+        if ( m_counts[s] <= 0.0 ) {
+            continue;
+        }
+
+        double chances[2][2] = { { 0.0, 0.0 }, { 0.0, 0.0 } };
+        for ( std::size_t p = 0; p < c_num_strategies; ++p ) {
+            const double share = m_counts[p] / total;
+            if ( share <= 0.0 ) {
+                continue;
+            }
+            for ( int own = 0; own < 2; ++own ) {
+                for ( int other = 0; other < 2; ++other ) {
+                    chances[own][other] += share *
+                        m_pair_chances[pair_index(s, p, own, other)];
+                }
+            }
+        }
+
+        const vector<double>& mass = m_mass[s];
+        next.assign(mass.size() + max_result - min_result, 0.0);
+
+        for ( int own = 0; own < 2; ++own ) {
+            for ( int other = 0; other < 2; ++other ) {
+                const double chance = chances[own][other];
+                if ( chance <= 0.0 ) {
+                    continue;
+                }
+                double * out = &next[m_payoffs[own][other] - min_result];
+                for ( std::size_t r = 0; r < mass.size(); ++r ) {
+                    out[r] += mass[r] * chance;
+                }
+            }
+        }
+
+        //  Fold negligible masses at the top into the highest level
+        //  which remains, so the distribution does not keep widening
+
+        const double negligible = m_counts[s] * c_negligible_fraction;
+        while ( next.size() > 1 && next.back() < negligible ) {
+            const double folded = next.back();
+            next.pop_back();
+            next.back() += folded;
+        }
+        m_mass[s].swap(next);
+        m_lowest[s] += min_result;
+    }
+
+    m_encounters += 1.0 / (total - 1.0);
+}
+
+
+/*
+ *  Removes the creatures which have run out of resources, and reduces
+ *  the strategy's cohorts in proportion.
+ */
+
+void MeanField::remove_starved() {
+    for ( std::size_t s = 0; s < c_num_strategies; ++s ) {
+        if ( m_counts[s] <= 0.0 || m_lowest[s] > 0 ) {
+            continue;
+        }
+
+        vector<double>& mass = m_mass[s];
+        const std::size_t dead_levels =
+            std::min(static_cast<std::size_t>(1 - m_lowest[s]),
+                     mass.size());
+        double starved = 0.0;
+        for ( std::size_t r = 0; r < dead_levels; ++r ) {
+            starved += mass[r];
+        }
+        mass.erase(mass.begin(), mass.begin() + dead_levels);
+        m_lowest[s] += static_cast<int>(dead_levels);
+
+        const double before = m_counts[s];
+        m_counts[s] = std::max(before - starved, 0.0);
+        m_deaths[s] += starved;
+        m_dead_creatures += starved;
+        m_survival[s] *= m_counts[s] / before;
+
+        if ( m_survival[s] < c_min_survival ) {
+            for ( std::deque<Cohort>::iterator itr = m_cohorts.begin();
+                  itr != m_cohorts.end(); ++itr ) {
+                itr->counts[s] *= m_survival[s];
+            }
+            m_survival[s] = 1.0;
+        }
+    }
+}
+
+
+/*
+ *  Removes the creatures which have outlived their life expectancy,
+ *  taking them evenly from all levels of resources.
+ */
+
+void MeanField::remove_aged() {
+    while ( !m_cohorts.empty() &&
+            m_day - m_cohorts.front().birth_day > m_life_expectancy ) {
+        const Cohort& cohort = m_cohorts.front();
+        for ( std::size_t s = 0; s < c_num_strategies; ++s ) {
+            const double aged = std::min(cohort.counts[s] * m_survival[s],
+                                         m_counts[s]);
+            if ( aged <= 0.0 ) {
+                continue;
+            }
+            remove_fraction(s, aged / m_counts[s]);
+            m_counts[s] -= aged;
+            m_deaths[s] += aged;
+            m_dead_creatures += aged;
+        }
+        m_cohorts.pop_front();
+    }
+}
+
+
+/*
+ *  Has the creatures with enough resources reproduce, paying the cost
+ *  of reproducing, and adds the newborns with that cost as their
+ *  resources, in a new cohort.
+ */
+
+void MeanField::reproduce() {
+    m_cohorts.push_back(Cohort(m_day, m_encounters, c_num_strategies));
+    Cohort& cohort = m_cohorts.back();
+
+    for ( std::size_t s = 0; s < c_num_strategies; ++s ) {
+        if ( m_counts[s] <= 0.0 ) {
+            continue;
+        }
+
+        //  Move the parents down by the cost, highest first if the
+        //  cost is negative, so no creature reproduces twice
+
+        const int top = m_lowest[s] + static_cast<int>(m_mass[s].size());
+        const int first = std::max(m_repro_min_resources, m_lowest[s]);
+        double births = 0.0;
+        if ( m_repro_cost > 0 ) {
+            for ( int r = first; r < top; ++r ) {
+                const double parents = m_mass[s][r - m_lowest[s]];
+                m_mass[s][r - m_lowest[s]] = 0.0;
+                add_mass(s, r - m_repro_cost, parents);
+                births += parents;
+            }
+        } else {
+            for ( int r = top - 1; r >= first; --r ) {
+                const double parents = m_mass[s][r - m_lowest[s]];
+                m_mass[s][r - m_lowest[s]] = 0.0;
+                add_mass(s, r - m_repro_cost, parents);
+                births += parents;
+            }
+        }
+        if ( births <= 0.0 ) {
+            continue;
+        }
+
+        add_mass(s, m_repro_cost, births);
+        m_counts[s] += births;
+        m_born_creatures += births;
+        cohort.counts[s] = births / m_survival[s];
+    }
+}
+
+
+/*
+ *  Removes a fraction of a strategy's creatures from every level of
+ *  resources.
+ */
+
+void MeanField::remove_fraction(const std::size_t strategy,
+                                const double fraction) {
+    const double keep = std::max(1.0 - fraction, 0.0);
+    vector<double>& mass = m_mass[strategy];
+    for ( std::size_t r = 0; r < mass.size(); ++r ) {
+        mass[r] *= keep;
+    }
+}
+
+
+/*
+ *  Adds creatures of a strategy at the specified resources, widening
+ *  its distribution if needed.
+ */
+
+void MeanField::add_mass(const std::size_t strategy, const int resources,
+                         const double mass) {
+    vector<double>& levels = m_mass[strategy];
+    if ( resources < m_lowest[strategy] ) {
+        levels.insert(levels.begin(), m_lowest[strategy] - resources, 0.0);
+        m_lowest[strategy] = resources;
+    }
+    const std::size_t level = resources - m_lowest[strategy];
+    if ( level >= levels.size() ) {
+        levels.resize(level + 1, 0.0);
+    }
+    levels[level] += mass;
+}
+
+
+/*
+ *  Return the current day, the expected or mean number of games between
+ *  two creatures, and the expected number and mean resources of the
+ *  creatures of a strategy.
+ */
+
+Day MeanField::day() const {
+    return m_day;
+}
+
+double MeanField::match_length() const {
+    return m_match_length;
+}
+
+double MeanField::count(const Strategy strategy) const {
+    return m_counts[strategy];
+}
+
+double MeanField::mean_resources(const Strategy strategy) const {
+    const vector<double>& mass = m_mass[strategy];
+    double total = 0.0;
+    double weighted = 0.0;
+    for ( std::size_t r = 0; r < mass.size(); ++r ) {
+        total += mass[r];
+        weighted += mass[r] * (m_lowest[strategy] + static_cast<int>(r));
+    }
+    return (total > 0.0) ? weighted / total : 0.0;
+}
+
+
+/*
+ *  Return the expected number of live creatures, and running totals.
+ */
+
+double MeanField::num_live() const {
+    double total = 0.0;
+    for ( std::size_t s = 0; s < c_num_strategies; ++s ) {
+        total += m_counts[s];
+    }
+    return total;
+}
+
+double MeanField::born_creatures() const {
+    return m_born_creatures;
+}
+
+double MeanField::dead_creatures() const {
+    return m_dead_creatures;
+}
+
+double MeanField::games_played() const {
+    return m_games_played;
+}
+
+
+/*
+ *  Member function outputs summary statistics, as for a World.
+ *
+ *  Arguments: reference to a ostream object to which to output.
+ */
+
+void MeanField::output_world_stats(ostream& out) const {
+    out << "Summary world statistics:" << endl
+        << "Days passed: " << m_day - 1 << endl
+        << "Games played: " << whole_creatures(m_games_played) << endl
+        << "Starting creatures: "
+        << whole_creatures(m_starting_creatures) << endl
+        << "Living creatures: " << whole_creatures(num_live()) << endl
+        << "Creatures born: " << whole_creatures(m_born_creatures) << endl
+        << "Creatures died: " << whole_creatures(m_dead_creatures) << endl
+        << endl;
+}
+
+
+/*
+ *  Member function outputs summary statistics for the creatures of
+ *  each strategy, as for a World, ranked by average resources. The
+ *  minimum and maximum are the lowest and highest resources held by
+ *  more than a negligible fraction of the strategy's creatures, so a
+ *  strategy spread thinly over many levels still shows its whole
+ *  range. The average, which counts every level, is kept within that
+ *  range, which it can leave only by negligible masses or rounding.
+ *
+ *  Arguments: reference to a ostream object to which to output.
+ */
+
+void MeanField::output_summary_resources_by_strategy(ostream& out) const {
+    StrategyStatsList strategy_stats(c_num_strategies);
+    for ( std::size_t s = 0; s < c_num_strategies; ++s ) {
+        if ( m_counts[s] < 0.5 ) {
+            continue;
+        }
+
+        const vector<double>& mass = m_mass[s];
+        const double negligible = m_counts[s] * c_negligible_fraction;
+        std::size_t low = 0;
+        while ( low + 1 < mass.size() && mass[low] <= negligible ) {
+            ++low;
+        }
+        std::size_t high = mass.size() - 1;
+        while ( high > low && mass[high] <= negligible ) {
+            --high;
+        }
+
+        StrategyStats& stats = strategy_stats[s];
+        stats.num_creatures = m_counts[s];
+        stats.min_res = m_lowest[s] + static_cast<int>(low);
+        stats.max_res = m_lowest[s] + static_cast<int>(high);
+        stats.avg_res = std::min(std::max(
+                mean_resources(static_cast<Strategy>(s)),
+                static_cast<double>(stats.min_res)),
+                static_cast<double>(stats.max_res));
+    }
+    output_resources_by_strategy(out, strategy_stats);
+}
+
+
+/*
+ *  Member function outputs the number of creatures of each strategy
+ *  that have died, as for a World.
+ *
+ *  Arguments: reference to a ostream object to which to output.
+ */
+
+void MeanField::output_summary_dead_by_strategy(ostream& out) const {
+    if ( m_disable_deaths ) {
+        return;
+    }
+
+    output_deaths_by_strategy(out, m_deaths);
+}
@@ -0,0 +1,231 @@
+/*
+ *  mean_field.h
+ *  ============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Interface to MeanField class for Prisoner's Dilemma simulation.
+ *
+ *  A MeanField is an alternative to a World for questions about a
+ *  whole population, such as whether tit for tat takes over from a
+ *  given starting mix. Instead of individual creatures, it tracks the
+ *  expected number of creatures of each strategy at each level of
+ *  resources, and advances them each day by the expected results of
+ *  the day's games, deaths and births. The cost of a day depends on
+ *  the spread of resources, not on the number of creatures, so a
+ *  population of billions costs no more than one of hundreds.
+ *
+ *  The population is taken to be well mixed, as a World's is with
+ *  uniform pairing, so that every creature plays one game a day
+ *  against a partner drawn at random from the whole population. Two
+ *  creatures may meet again, and remember their earlier games when
+ *  they do, so a creature's game may be any game of a match between
+ *  the two. The chance of each pair of moves in each game of a match
+ *  between two strategies is found by playing the match with
+ *  play_game(), game by game, as far as the day's games need, so the
+ *  moves follow the strategy genes over repeated play. Random moves
+ *  are taken from draws spread evenly over each game's plays, rather
+ *  than from std::rand(), so that the chances found depend little on
+ *  the seed.
+ *
+ *  If a match length is configured, each game of the match is weighted
+ *  by the chance of a match of that expected length lasting that long.
+ *  Otherwise the weights follow the encounters of a World: two
+ *  creatures meet on any day with a chance of one in the number of
+ *  other creatures, so the number of times they have met before is
+ *  Poisson distributed, with a mean which is the sum of that chance
+ *  over the days since the younger was born. The sum is kept up to
+ *  date as the population grows and shrinks, and each cohort of
+ *  newborns starts its own. A day then shifts each strategy's
+ *  distribution of resources by the result of each pair of moves,
+ *  weighted by the chance of that pair against the day's mix of
+ *  partners, which is a short convolution.
+ *
+ *  Creatures which run out of resources die, as in a World. Creatures
+ *  die of old age the day after reaching their life expectancy, so
+ *  the number of creatures of each strategy born on each day is kept,
+ *  and is reduced in proportion as the strategy's creatures starve.
+ *  Creatures of each age are taken to have the same distribution of
+ *  resources. On reproduction days, creatures with enough resources
+ *  pay the cost of reproducing, and newborns start with that cost as
+ *  their resources, again as in a World.
+ *
+ *  Regions, migration, partner choice and local pairing have no
+ *  meaning for a well-mixed population, and are ignored.
+ *
+ *  Public member functions:
+ *    advance_day() - plays the day's games, and processes the day's
+ *                    deaths and births.
+ *
+ *    day() - returns the current day.
+ *
+ *    match_length() - returns the configured expected number of games
+ *                     between two creatures, or else the mean number
+ *                     of the game they played in the day's match,
+ *                     counting their earlier meetings.
+ *
+ *    count() - returns the expected number of creatures of a strategy.
+ *
+ *    mean_resources() - returns the mean resources of the creatures of
+ *                       a strategy.
+ *
+ *    num_live(), born_creatures(), dead_creatures(), games_played()
+ *        - return the expected number of live creatures, and running
+ *          totals since the start.
+ *
+ *    output_world_stats(), output_summary_resources_by_strategy(),
+ *    output_summary_dead_by_strategy()
+ *        - output statistics in the same formats as the World functions
+ *          of the same names, with expected numbers of creatures
+ *          rounded to the nearest whole creature.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#ifndef PG_PRIDIL_MEAN_FIELD_H
+#define PG_PRIDIL_MEAN_FIELD_H
+
+#include <cstddef>
+#include <stdint.h>
+#include <deque>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "pridil_common.h"
+
+namespace pridil {
+
+class Creature;
+
+class MeanField {
+    public:
+
+        //  Constructor and destructor
+
+        explicit MeanField(const WorldInfo& wInfo);
+        ~MeanField();
+
+        //  Methods to advance and access the population
+
+        void advance_day();
+        Day day() const;
+        double match_length() const;
+        double count(const Strategy strategy) const;
+        double mean_resources(const Strategy strategy) const;
+        double num_live() const;
+        double born_creatures() const;
+        double dead_creatures() const;
+        double games_played() const;
+
+        //  Methods to output statistics
+
+        void output_world_stats(std::ostream& out) const;
+        void output_summary_resources_by_strategy(std::ostream& out) const;
+        void output_summary_dead_by_strategy(std::ostream& out) const;
+
+    private:
+
+        //  Expected numbers of creatures of each strategy born on a
+        //  given day, divided by the strategy's survival scale, and
+        //  the sum of the daily chances of two creatures meeting before
+        //  they were born
+
+        struct Cohort {
+            Day birth_day;
+            double encounters;
+            std::vector<double> counts;
+
+            Cohort(const Day day, const double encounters_before,
+                   const std::size_t num_strategies) :
+                birth_day(day), encounters(encounters_before),
+                counts(num_strategies, 0.0) {}
+        };
+
+        //  The chance of each pair of moves in each game of a match
+        //  between two strategies, four to a game, indexed by the
+        //  first strategy's move and then the second's, the pairs of
+        //  probe creatures which keep playing the match, the pairs of
+        //  moves counted in the early games of shorter matches, and the
+        //  seed from which the creatures' moves are drawn
+
+        struct MatchGames {
+            Strategy first;
+            Strategy second;
+            std::vector<double> chances;
+            std::vector<Creature *> probes;
+            std::vector<double> short_counts;
+            uint64_t seed;
+
+            MatchGames() : first(random_strategy), second(random_strategy),
+                           chances(), probes(), short_counts(), seed(0) {}
+        };
+
+        const Day m_life_expectancy;
+        const Day m_repro_cycle_days;
+        const int m_repro_cost;
+        const int m_repro_min_resources;
+        const bool m_disable_deaths;
+        const bool m_disable_repro;
+        Day m_day;
+
+        double m_starting_creatures;
+        double m_born_creatures;
+        double m_dead_creatures;
+        double m_games_played;
+
+        //  Expected numbers of creatures of each strategy by resources,
+        //  from the strategy's lowest resources upwards, and the
+        //  expected number of each strategy's creatures and deaths
+
+        std::vector<int> m_lowest;
+        std::vector<std::vector<double> > m_mass;
+        std::vector<double> m_counts;
+        std::vector<double> m_deaths;
+
+        //  Creatures by birth day, oldest first, and the fraction of
+        //  each strategy's cohorts surviving starvation, by which the
+        //  stored counts are multiplied
+
+        std::deque<Cohort> m_cohorts;
+        std::vector<double> m_survival;
+
+        //  Result of a game for each pair of moves, from game_result(),
+        //  the configured match length, or 0, the sum of the daily
+        //  chances of two creatures meeting, the chance of the day's
+        //  game being each game of a match and the mean game, the games
+        //  of the match between each pair of strategies, the chance of
+        //  each pair of moves in the day's game between creatures of
+        //  each pair of strategies, and strategy names, indexed by
+        //  Strategy value.
+
+        int m_payoffs[2][2];
+        const double m_configured_length;
+        double m_encounters;
+        std::vector<double> m_game_weights;
+        double m_match_length;
+        std::vector<MatchGames> m_matches;
+        std::vector<double> m_pair_chances;
+        std::vector<std::string> m_strategy_names;
+
+        void update_game_weights();
+        void extend_match(MatchGames& match, const std::size_t games);
+        void play_short_matches(MatchGames& match);
+        void update_pair_chances();
+        void play_games();
+        void remove_starved();
+        void remove_aged();
+        void reproduce();
+        void remove_fraction(const std::size_t strategy,
+                             const double fraction);
+        void add_mass(const std::size_t strategy, const int resources,
+                      const double mass);
+
+        MeanField(const MeanField&);                // Prevent copying
+        MeanField& operator=(const MeanField&);     // Prevent assignment
+};
+
+}       //  namespace pridil
+
+#endif      // PG_PRIDIL_MEAN_FIELD_H
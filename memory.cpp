@@ -12,19 +12,36 @@
 
 
 #include <iostream>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
 #include "brain_complex.h"
 #include "game.h"
 
 using namespace pridil;
 
 
+/*
+ *  Orders index entries by opponent ID.
+ */
+
+namespace {
+    bool precedes(const std::pair<CreatureID, std::size_t>& entry,
+                  const CreatureID opponent) {
+        return entry.first < opponent;
+    }
+}
+
+
 /*
  *  Constructor.
  *
- *  No initialization needed, except to set up empty memories map.
+ *  No initialization needed, except to set up empty memories.
  */
 
-Memory::Memory() : m_memories() {}
+Memory::Memory() :
+        m_index(), m_slots(), m_slot_opponents(), m_slots_used(0),
+        m_games_played(0) {}
 
 
 /*
@@ -40,14 +57,7 @@ Memory::~Memory() {}
  */
 
 bool Memory::recognize(const CreatureID opponent) const {
-    bool recognized_opponent;
-    GameInfoMap::const_iterator itr = m_memories.find(opponent);
-    if ( itr == m_memories.end() ) {
-        recognized_opponent = false;
-    } else {
-        recognized_opponent = true;
-    }
-    return recognized_opponent;
+    return find_memories(opponent) != 0;
 }
 
 
@@ -56,12 +66,11 @@ bool Memory::recognize(const CreatureID opponent) const {
  */
 
 unsigned int Memory::num_memories(const CreatureID opponent) const {
-    GameInfoMap::const_iterator map_itr = m_memories.find(opponent);
-    if ( map_itr == m_memories.end() ) {
+    const GameInfoList * memories = find_memories(opponent);
+    if ( memories == 0 ) {
         return 0;
     }
-    const GameInfoList& opponent_memories = (*map_itr).second;
-    return opponent_memories.size();
+    return memories->size();
 }
 
 
@@ -81,27 +90,42 @@ GameMove Memory::remember_move(const CreatureID opponent,
     //  Throw exception if there are fewer memories of this
     //  opponent than the one requested.
 
-    if ( num_memories(opponent) < past ) {
+    const GameInfoList * memories = find_memories(opponent);
+    if ( memories == 0 || past == 0 || memories->size() < past ) {
         throw InvalidOpponentMemory();
     }
 
-    //  Get an iterator to the end of the memories with this opponent
+    //  Return the opponent's move contained in the desired memory,
+    //  counting back from the most recent.
 
-    GameInfoMap::const_iterator map_itr = m_memories.find(opponent);
-    const GameInfoList& memories = (*map_itr).second;
-    GameInfoList::const_iterator mem_itr = memories.end();
+    const GameInfo& gInfo = (*memories)[memories->size() - past];
+    return gInfo.opponent_move;
+}
 
-    //  ...back up the iterator to the desired memory
 
-    unsigned int n = past;
-    while ( n-- > 0 ) {
-        --mem_itr;
-    }
+/*
+ *  Returns the number of games played against the specified opponent,
+ *  counting no further than two, and the opponent's moves in the last
+ *  two of them, with a single search of the memories.
+ */
 
-    //  ...and return the opponent's move contained in that memory.
+MatchHistory Memory::match_history(const CreatureID opponent) const {
+    MatchHistory history;
+    const GameInfoList * found = find_memories(opponent);
+    if ( found == 0 ) {
+        return history;
+    }
 
-    const GameInfo& gInfo = *mem_itr;
-    return gInfo.opponent_move;
+    const GameInfoList& memories = *found;
+    const std::size_t n = memories.size();
+    history.games = (n < 2) ? static_cast<unsigned int>(n) : 2;
+    if ( n > 0 ) {
+        history.last_move = memories[n - 1].opponent_move;
+    }
+    if ( n > 1 ) {
+        history.second_last_move = memories[n - 2].opponent_move;
+    }
+    return history;
 }
 
 
@@ -110,9 +134,9 @@ GameMove Memory::remember_move(const CreatureID opponent,
  */
 
 void Memory::show_detailed_memories(std::ostream& out) const {
-    for ( GameInfoMap::const_iterator map_itr = m_memories.begin();
-          map_itr != m_memories.end(); ++map_itr ) {
-        const GameInfoList& mem_list = map_itr->second;
+    for ( std::vector<IndexEntry>::const_iterator index_itr = m_index.begin();
+          index_itr != m_index.end(); ++index_itr ) {
+        const GameInfoList& mem_list = m_slots[index_itr->second];
 
         for ( GameInfoList::const_iterator mem_itr = mem_list.begin();
               mem_itr != mem_list.end(); ++mem_itr ) {
@@ -137,6 +161,118 @@ void Memory::show_detailed_memories(std::ostream& out) const {
  */
 
 void Memory::store_memory(const GameInfo& g_info) {
-    GameInfoList& mem_list = m_memories[g_info.id];
+    GameInfoList& mem_list = opponent_memories(g_info.id);
     mem_list.push_back(g_info);
+    ++m_games_played;
+}
+
+
+/*
+ *  Stores memories of a series of games, all against the same opponent,
+ *  with a single search of the memories.
+ *
+ *  Arguments:
+ *    games -- pointer to the first of the GameInfo objects to store
+ *    count -- the number of GameInfo objects to store
+ */
+
+void Memory::store_memories(const GameInfo * games, const std::size_t count) {
+    if ( count == 0 ) {
+        return;
+    }
+
+    GameInfoList& mem_list = opponent_memories(games[0].id);
+    mem_list.insert(mem_list.end(), games, games + count);
+    m_games_played += count;
+}
+
+
+/*
+ *  Returns the number of games stored, including those with opponents
+ *  since forgotten.
+ */
+
+unsigned int Memory::games_played() const {
+    return m_games_played;
+}
+
+
+/*
+ *  Erases all memories of the specified opponent. The last slot in use
+ *  is moved into the opponent's slot, so the slots in use stay at the
+ *  front, and the emptied slot keeps its storage.
+ */
+
+void Memory::forget(const CreatureID opponent) {
+    std::vector<IndexEntry>::iterator entry =
+        std::lower_bound(m_index.begin(), m_index.end(), opponent, precedes);
+    if ( entry == m_index.end() || entry->first != opponent ) {
+        return;
+    }
+
+    const std::size_t slot = entry->second;
+    const std::size_t last = m_slots_used - 1;
+    m_index.erase(entry);
+    if ( slot != last ) {
+        const CreatureID moved = m_slot_opponents[last];
+        m_slots[slot].swap(m_slots[last]);
+        m_slot_opponents[slot] = moved;
+        std::lower_bound(m_index.begin(), m_index.end(),
+                         moved, precedes)->second = slot;
+    }
+    m_slots[last].clear();
+    --m_slots_used;
+}
+
+
+/*
+ *  Erases all memories. The slots keep their storage.
+ */
+
+void Memory::clear() {
+    for ( std::size_t slot = 0; slot < m_slots_used; ++slot ) {
+        m_slots[slot].clear();
+    }
+    m_index.clear();
+    m_slots_used = 0;
+    m_games_played = 0;
+}
+
+
+/*
+ *  Returns a pointer to the memories of the specified opponent, or a
+ *  null pointer if there are none.
+ */
+
+const GameInfoList * Memory::find_memories(const CreatureID opponent) const {
+    std::vector<IndexEntry>::const_iterator entry =
+        std::lower_bound(m_index.begin(), m_index.end(), opponent, precedes);
+    if ( entry == m_index.end() || entry->first != opponent ) {
+        return 0;
+    }
+    return &m_slots[entry->second];
+}
+
+
+/*
+ *  Returns the memories of the specified opponent, giving it the next
+ *  free slot if it has none.
+ */
+
+GameInfoList& Memory::opponent_memories(const CreatureID opponent) {
+    std::vector<IndexEntry>::iterator entry =
+        std::lower_bound(m_index.begin(), m_index.end(), opponent, precedes);
+    if ( entry != m_index.end() && entry->first == opponent ) {
+        return m_slots[entry->second];
+    }
+
+    const std::size_t slot = m_slots_used++;
+    if ( slot == m_slots.size() ) {
+        m_slots.push_back(GameInfoList());
+        m_slot_opponents.push_back(opponent);
+    } else {
+        m_slot_opponents[slot] = opponent;
+    }
+    m_index.insert(entry, IndexEntry(opponent, slot));
+    return m_slots[slot];
 }
@@ -0,0 +1,313 @@
+/*
+ *  moran.cpp
+ *  =========
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Implementation of Moran class for Prisoners' Dilemma simulation.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <limits>
+#include <cstddef>
+#include <cstdlib>
+#include <ctime>
+#include "pridil_common.h"
+#include "moran.h"
+#include "creature.h"
+#include "game.h"
+
+using std::endl;
+using std::map;
+using std::ostream;
+using std::pair;
+using std::string;
+using std::vector;
+
+using namespace pridil;
+
+
+/*
+ *  Number of strategies, for statistics kept by strategy.
+ */
+
+namespace {
+    const std::size_t c_num_strategies = always_defect + 1;
+
+
+    /*
+     *  Returns the number of birth-death steps in a day, for a
+     *  population of the specified size.
+     */
+
+    std::size_t steps_per_day(const std::size_t size,
+                              const Day repro_cycle_days) {
+        const std::size_t cycle = repro_cycle_days > 0 ?
+                                  repro_cycle_days : 1;
+        const std::size_t steps = size / cycle;
+        return steps > 0 ? steps : 1;
+    }
+}
+
+
+/*
+ *  Constructor. Creates the starting population as a World does, and
+ *  sets each creature's weight for reproduction.
+ *
+ *  Arguments:
+ *    wInfo -- the starting population, starting resources,
+ *             reproduction characteristics and seed, as for a World
+ */
+
+Moran::Moran(const WorldInfo& wInfo) :
+        m_steps_per_day(0),
+        m_offspring_init(offspring_init(wInfo)),
+        m_day(1),
+        m_rng(seed_or_time(wInfo.m_seed)),
+        m_starting_creatures(0),
+        m_steps(0),
+        m_games_played(0),
+        m_brains(),
+        m_creatures(&m_brains),
+        m_fitness(create_creatures(wInfo, m_creatures)),   // Sized to fit
+        m_counts(c_num_strategies, 0),
+        m_deaths(c_num_strategies, 0),
+        m_strategy_names(strategy_names()) {
+
+    seed_strategy_genes(wInfo.m_seed);
+
+    m_starting_creatures = m_creatures.size();
+    m_steps_per_day = steps_per_day(m_creatures.size(),
+                                    wInfo.m_repro_cycle_days);
+
+    for ( std::size_t i = 0; i < m_creatures.size(); ++i ) {
+        ++m_counts[m_creatures.strategy_value(i)];
+        update_fitness(i);
+    }
+}
+
+
+/*
+ *  Destructor.
+ */
+
+Moran::~Moran() {}
+
+
+/*
+ *  Advances the population by one day, playing the day's games and
+ *  then taking the day's birth-death steps.
+ */
+
+void Moran::advance_day() {
+    play_games();
+    for ( std::size_t i = 0; i < m_steps_per_day; ++i ) {
+        step();
+    }
+    ++m_day;
+}
+
+
+/*
+ *  Takes one birth-death step. The parent is chosen with probability
+ *  proportional to its resources, and pays the cost of reproducing,
+ *  and the newborn takes the row of a uniformly chosen creature, whose
+ *  Brain goes back to the pool to be reused for the newborn.
+ */
+
+void Moran::step() {
+    const std::size_t num_creatures = m_creatures.size();
+    if ( num_creatures == 0 ) {
+        return;
+    }
+
+    std::size_t parent = 0;
+    const unsigned long total = m_fitness.total();
+    if ( total > 0 ) {
+        const unsigned long point = static_cast<unsigned long>(
+                                        m_rng.uniform() * total);
+        parent = m_fitness.find(std::min(point, total - 1));
+    } else {
+        parent = m_rng.below(static_cast<uint32_t>(num_creatures));
+    }
+    const std::size_t dying =
+        m_rng.below(static_cast<uint32_t>(num_creatures));
+
+    CreatureInit child_init = m_offspring_init;
+    child_init.strategy = m_creatures.strategy_value(parent);
+    m_creatures.spend_resources(parent, child_init.repro_cost);
+    update_fitness(parent);
+
+    const Strategy dead_strategy = m_creatures.strategy_value(dying);
+    --m_counts[dead_strategy];
+    ++m_deaths[dead_strategy];
+    m_creatures.release_brain(dying);
+    m_creatures.create(dying, child_init, Creature::reserve_ids(1), m_day);
+    ++m_counts[child_init.strategy];
+    update_fitness(dying);
+
+    ++m_steps;
+}
+
+
+/*
+ *  Returns the current day.
+ */
+
+Day Moran::day() const {
+    return m_day;
+}
+
+
+/*
+ *  Returns the number of creatures.
+ */
+
+std::size_t Moran::size() const {
+    return m_creatures.size();
+}
+
+
+/*
+ *  Returns the number of creatures of a strategy.
+ */
+
+std::size_t Moran::count(const Strategy strategy) const {
+    return m_counts[strategy];
+}
+
+
+/*
+ *  Returns true if every creature has the same strategy.
+ */
+
+bool Moran::fixed() const {
+    for ( std::size_t s = 0; s < c_num_strategies; ++s ) {
+        if ( m_counts[s] == m_creatures.size() ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/*
+ *  Returns the creatures.
+ */
+
+const Population& Moran::creatures() const {
+    return m_creatures;
+}
+
+
+/*
+ *  Return running totals.
+ */
+
+unsigned long Moran::steps() const {
+    return m_steps;
+}
+
+unsigned long Moran::games_played() const {
+    return m_games_played;
+}
+
+
+/*
+ *  Member function outputs summary statistics, as for a World, with
+ *  the number of steps taken, and the strategy which has taken over
+ *  the population, if any.
+ *
+ *  Arguments: reference to a ostream object to which to output.
+ */
+
+void Moran::output_world_stats(ostream& out) const {
+    out << "Summary world statistics:" << endl
+        << "Days passed: " << m_day - 1 << endl
+        << "Games played: " << m_games_played << endl
+        << "Starting creatures: " << m_starting_creatures << endl
+        << "Living creatures: " << m_creatures.size() << endl
+        << "Creatures born: " << m_steps << endl
+        << "Creatures died: " << m_steps << endl
+        << "Moran steps: " << m_steps << endl;
+    if ( m_creatures.size() > 0 && fixed() ) {
+        out << "Fixed strategy: "
+            << m_strategy_names[m_creatures.strategy_value(0)] << endl;
+    }
+    out << endl;
+}
+
+
+/*
+ *  Member function outputs summary statistics for the creatures of
+ *  each strategy, as for a World, ranked by average resources.
+ *
+ *  Arguments: reference to a ostream object to which to output.
+ */
+
+void Moran::output_summary_resources_by_strategy(ostream& out) const {
+    StrategyStatsList strategy_stats(c_num_strategies);
+    for ( std::size_t i = 0; i < m_creatures.size(); ++i ) {
+        strategy_stats[m_creatures.strategy_value(i)].add(
+                m_creatures.resources(i));
+    }
+    output_resources_by_strategy(out, strategy_stats);
+}
+
+
+/*
+ *  Member function outputs the number of creatures of each strategy
+ *  that have died, as for a World.
+ *
+ *  Arguments: reference to a ostream object to which to output.
+ */
+
+void Moran::output_summary_dead_by_strategy(ostream& out) const {
+    output_deaths_by_strategy(out, vector<double>(m_deaths.begin(),
+                                                  m_deaths.end()));
+}
+
+
+/*
+ *  Plays the day's games. The creatures are shuffled and paired off in
+ *  turn, so each creature plays one game with a randomly chosen
+ *  partner, and if the number of creatures is odd, one sits the day
+ *  out. Each creature's weight is updated after its game.
+ */
+
+void Moran::play_games() {
+    const std::size_t num_creatures = m_creatures.size();
+    vector<std::size_t> order(num_creatures);
+    for ( std::size_t i = 0; i < num_creatures; ++i ) {
+        const std::size_t j = m_rng.below(static_cast<uint32_t>(i + 1));
+        order[i] = order[j];
+        order[j] = i;
+    }
+
+    for ( std::size_t i = 0; i + 1 < num_creatures; i += 2 ) {
+        play_game(m_creatures, order[i], order[i + 1]);
+        update_fitness(order[i]);
+        update_fitness(order[i + 1]);
+        ++m_games_played;
+    }
+}
+
+
+/*
+ *  Sets a creature's weight for reproduction to its resources, or to
+ *  zero if it has none.
+ */
+
+void Moran::update_fitness(const std::size_t row) {
+    const int resources = m_creatures.resources(row);
+    m_fitness.set(row, resources > 0 ?
+                       static_cast<unsigned long>(resources) : 0);
+}
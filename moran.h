@@ -0,0 +1,141 @@
+/*
+ *  moran.h
+ *  =======
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Interface to Moran class for Prisoner's Dilemma simulation.
+ *
+ *  A Moran is an alternative to a World which runs the Moran process
+ *  of evolutionary game theory on a population of fixed size. Instead
+ *  of creatures reproducing on reproduction days once they have enough
+ *  resources, and dying of old age or starvation, births and deaths
+ *  come in pairs, one birth-death step at a time. At each step, one
+ *  creature is chosen to reproduce, with probability proportional to
+ *  its resources, and one is chosen uniformly to die, and the newborn
+ *  takes the place of the one which died, which may be its parent. As
+ *  in a World, the parent pays the cost of reproducing, and the
+ *  newborn starts with that cost as its resources.
+ *
+ *  Each day, every creature plays one game with a randomly chosen
+ *  partner, as in a World with uniform pairing, and there are then as
+ *  many steps as there are creatures, divided by the number of days in
+ *  the reproduction cycle, so that each creature reproduces and dies
+ *  on average once a cycle, as in a World.
+ *
+ *  Creatures' resources are held in a Fenwick tree (see
+ *  fenwick_tree.h), which is updated after every game and every step,
+ *  so choosing the creature to reproduce takes O(log n) time, rather
+ *  than a scan of the whole population. A creature whose resources
+ *  have fallen to zero or below cannot be chosen to reproduce. If no
+ *  creature has any resources, the creature to reproduce is chosen
+ *  uniformly.
+ *
+ *  Creatures are held in a Population (see population.h), whose Brains
+ *  come from a BrainPool (see brain_pool.h), so a step reuses the Brain
+ *  of the creature which died for the newborn. Regions, migration,
+ *  partner choice and local pairing are not supported.
+ *
+ *  Public member functions:
+ *    advance_day() - plays the day's games, and takes the day's
+ *                    birth-death steps.
+ *
+ *    step() - takes one birth-death step.
+ *
+ *    day() - returns the current day.
+ *
+ *    size() - returns the number of creatures.
+ *
+ *    count() - returns the number of creatures of a strategy.
+ *
+ *    fixed() - returns true if every creature has the same strategy.
+ *
+ *    creatures() - returns the creatures.
+ *
+ *    steps(), games_played() - return running totals since the start.
+ *
+ *    output_world_stats(), output_summary_resources_by_strategy(),
+ *    output_summary_dead_by_strategy()
+ *        - output statistics in the same formats as the World functions
+ *          of the same names, with the number of steps taken and the
+ *          strategy which has taken over the population, if any.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#ifndef PG_PRIDIL_MORAN_H
+#define PG_PRIDIL_MORAN_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "pridil_common.h"
+#include "population.h"
+#include "brain_pool.h"
+#include "fenwick_tree.h"
+#include "rng.h"
+
+namespace pridil {
+
+class Moran {
+    public:
+
+        //  Constructor and destructor
+
+        explicit Moran(const WorldInfo& wInfo);
+        ~Moran();
+
+        //  Methods to advance and access the population
+
+        void advance_day();
+        void step();
+        Day day() const;
+        std::size_t size() const;
+        std::size_t count(const Strategy strategy) const;
+        bool fixed() const;
+        const Population& creatures() const;
+        unsigned long steps() const;
+        unsigned long games_played() const;
+
+        //  Methods to output statistics
+
+        void output_world_stats(std::ostream& out) const;
+        void output_summary_resources_by_strategy(std::ostream& out) const;
+        void output_summary_dead_by_strategy(std::ostream& out) const;
+
+    private:
+        std::size_t m_steps_per_day;
+        CreatureInit m_offspring_init;
+        Day m_day;
+        Rng m_rng;
+        unsigned int m_starting_creatures;
+        unsigned long m_steps;
+        unsigned long m_games_played;
+
+        //  The creatures, whose Brains come from the pool, which must
+        //  outlive them, and their weights for reproduction
+
+        BrainPool m_brains;
+        Population m_creatures;
+        FenwickTree m_fitness;
+
+        //  Live creatures and deaths, and strategy names, indexed by
+        //  Strategy value
+
+        std::vector<std::size_t> m_counts;
+        std::vector<unsigned long> m_deaths;
+        std::vector<std::string> m_strategy_names;
+
+        void play_games();
+        void update_fitness(const std::size_t row);
+
+        Moran(const Moran&);                // Prevent copying
+        Moran& operator=(const Moran&);     // Prevent assignment
+};
+
+}       //  namespace pridil
+
+#endif      // PG_PRIDIL_MORAN_H
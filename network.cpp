@@ -0,0 +1,760 @@
+/*
+ *  network.cpp
+ *  ===========
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Implementation of Network class for Prisoners' Dilemma simulation.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <cstddef>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+#include "pridil_common.h"
+#include "network.h"
+#include "creature.h"
+#include "game.h"
+#include "graph.h"
+#include "thread_pool.h"
+#include "rng.h"
+
+using std::ostream;
+using std::endl;
+using std::vector;
+
+using namespace pridil;
+
+
+/*
+ *  Number of slots in each chunk of the parallel passes, the number of
+ *  rounds in which to look for a matching, and the random number
+ *  streams used to place creatures, to connect newborns and to draw
+ *  the random choices of strategy genes.
+ */
+
+namespace {
+    const std::size_t c_slots_per_chunk = 512;
+    const int c_matching_rounds = 4;
+    const Slot c_no_slot = 0xFFFFFFFFU;
+    const uint64_t c_placement_stream = 0xFFFFFFFDUL;
+    const uint64_t c_birth_stream = 0xFFFFFFFCUL;
+    const uint64_t c_move_stream = 0xFFFFFFFBUL;
+    const std::size_t c_num_strategies = always_defect + 1;
+
+    enum Fate { lives, dies, reproduces };
+}
+
+
+/*
+ *  Parallel task to play a day's games and age the creatures, one
+ *  chunk of slots at a time.
+ *
+ *  Playing every edge takes a move_pass, in which each creature picks
+ *  its move for each half-edge, and a result_pass, in which it reads
+ *  its opponents' moves from the opposite half-edges and records each
+ *  result. Playing a matching takes rounds of a propose_pass and a
+ *  match_pass (see network.h), then a matched_games_pass. The
+ *  age_pass then ages each creature and records its fate. Every pass
+ *  writes only to the slots in its own chunk, apart from the games of
+ *  the matched_games_pass, which are played by the lower-numbered slot
+ *  of each matched pair.
+ *
+ *  Each chunk counts the games played or creatures matched in its own
+ *  slot of m_chunk_counts, which are summed once the pass is done.
+ */
+
+class Network::DayTask : public ParallelTask {
+    public:
+        enum Pass { move_pass, result_pass, propose_pass, match_pass,
+                    matched_games_pass, age_pass };
+
+        DayTask(const Graph& graph, CreatureList& creatures,
+                vector<unsigned char>& moves, vector<Slot>& proposals,
+                vector<Slot>& mates, vector<unsigned char>& status,
+                const uint64_t day_seed, const bool deaths_enabled,
+                const bool repro_day) :
+            m_graph(graph), m_creatures(creatures), m_moves(moves),
+            m_proposals(proposals), m_mates(mates), m_status(status),
+            m_day_seed(day_seed),
+            m_move_seed(mix_seed(day_seed, c_move_stream)),
+            m_deaths_enabled(deaths_enabled),
+            m_repro_day(repro_day), m_pass(move_pass),
+            m_num_slots(creatures.size()),
+            m_num_chunks(num_chunks_for(m_num_slots, c_slots_per_chunk)),
+            m_chunk_counts(m_num_chunks, 0) {}
+
+        virtual void run_chunk(const std::size_t chunk,
+                               const unsigned int thread);
+        void run_pass(ThreadPool& pool, const Pass pass);
+        unsigned long total() const;
+
+    private:
+        const Graph& m_graph;
+        CreatureList& m_creatures;
+        vector<unsigned char>& m_moves;
+        vector<Slot>& m_proposals;
+        vector<Slot>& m_mates;
+        vector<unsigned char>& m_status;
+        const uint64_t m_day_seed;
+        const uint64_t m_move_seed;
+        const bool m_deaths_enabled;
+        const bool m_repro_day;
+        Pass m_pass;
+        const std::size_t m_num_slots;
+        const std::size_t m_num_chunks;
+        vector<unsigned long> m_chunk_counts;
+
+        unsigned long choose_moves(const std::size_t begin,
+                                   const std::size_t end);
+        unsigned long record_results(const std::size_t begin,
+                                     const std::size_t end);
+        unsigned long propose(const std::size_t begin,
+                              const std::size_t end);
+        unsigned long match(const std::size_t begin, const std::size_t end);
+        unsigned long play_matched(const std::size_t begin,
+                                   const std::size_t end);
+        unsigned long age(const std::size_t begin, const std::size_t end);
+        uint64_t edge_priority(const Slot first, const Slot second) const;
+        uint64_t edge_draw(const Slot first, const Slot second) const;
+
+        DayTask(const DayTask&);
+        DayTask& operator=(const DayTask&);
+};
+
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+/*
+ *  Runs the current pass over one chunk. The thread number is not
+ *  needed, since all scratch space is kept per slot or per chunk.
+ */
+
+void Network::DayTask::run_chunk(const std::size_t chunk,
+                                 const unsigned int thread) {
+    std::size_t begin;
+    std::size_t end;
+    chunk_range(m_num_slots, m_num_chunks, chunk, begin, end);
+
+    switch ( m_pass ) {
+        case move_pass:
+            m_chunk_counts[chunk] = choose_moves(begin, end);
+            break;
+        case result_pass:
+            m_chunk_counts[chunk] = record_results(begin, end);
+            break;
+        case propose_pass:
+            m_chunk_counts[chunk] = propose(begin, end);
+            break;
+        case match_pass:
+            m_chunk_counts[chunk] = match(begin, end);
+            break;
+        case matched_games_pass:
+            m_chunk_counts[chunk] = play_matched(begin, end);
+            break;
+        case age_pass:
+            m_chunk_counts[chunk] = age(begin, end);
+            break;
+    }
+}
+
+#pragma GCC diagnostic pop
+
+
+/*
+ *  Runs a pass over all the chunks.
+ */
+
+void Network::DayTask::run_pass(ThreadPool& pool, const Pass pass) {
+    m_pass = pass;
+    pool.run(*this, m_num_chunks);
+}
+
+
+/*
+ *  Returns the total of the chunks' counts from the last pass.
+ */
+
+unsigned long Network::DayTask::total() const {
+    unsigned long total = 0;
+    for ( vector<unsigned long>::const_iterator itr =
+                m_chunk_counts.begin();
+          itr != m_chunk_counts.end(); ++itr ) {
+        total += *itr;
+    }
+    return total;
+}
+
+
+/*
+ *  Stores each creature's move against each live neighbour, with any
+ *  random choice taken from the edge's draw, the lower slot taking its
+ *  high 32 bits and the higher slot the low 32 bits, as play_game()
+ *  gives them.
+ */
+
+unsigned long Network::DayTask::choose_moves(const std::size_t begin,
+                                             const std::size_t end) {
+    for ( std::size_t slot = begin; slot < end; ++slot ) {
+        const Creature * creature = m_creatures[slot];
+        if ( creature == 0 ) {
+            continue;
+        }
+        for ( std::size_t h = m_graph.first_half_edge(slot);
+              h != Graph::no_half_edge;
+              h = m_graph.next_half_edge(slot, h) ) {
+            const Slot target = m_graph.target(h);
+            const Creature * opponent = m_creatures[target];
+            if ( opponent ) {
+                const uint64_t draw = edge_draw(slot, target);
+                const uint32_t own_draw = (slot < target) ?
+                        static_cast<uint32_t>(draw >> 32) :
+                        static_cast<uint32_t>(draw);
+                m_moves[h] = static_cast<unsigned char>(
+                        creature->get_game_move(opponent->id(), own_draw));
+            }
+        }
+    }
+    return 0;
+}
+
+
+/*
+ *  Gives each creature the result of its game against each live
+ *  neighbour, exactly as play_game() would, and returns the number of
+ *  games, counting each game at the end with the lower slot.
+ */
+
+unsigned long Network::DayTask::record_results(const std::size_t begin,
+                                               const std::size_t end) {
+    unsigned long games = 0;
+    for ( std::size_t slot = begin; slot < end; ++slot ) {
+        Creature * creature = m_creatures[slot];
+        if ( creature == 0 ) {
+            continue;
+        }
+        for ( std::size_t h = m_graph.first_half_edge(slot);
+              h != Graph::no_half_edge;
+              h = m_graph.next_half_edge(slot, h) ) {
+            const Slot target = m_graph.target(h);
+            const Creature * opponent = m_creatures[target];
+            if ( opponent == 0 ) {
+                continue;
+            }
+
+            const GameMove own_move = static_cast<GameMove>(m_moves[h]);
+            const GameMove opp_move =
+                static_cast<GameMove>(m_moves[m_graph.opposite(h)]);
+            GameInfo own_info(opponent->id(), own_move,
+                              simplify_game_move(opp_move), 0);
+            GameInfo opp_info(creature->id(), opp_move,
+                              simplify_game_move(own_move), 0);
+            game_result(own_info, opp_info);
+            creature->give_game_result(own_info);
+
+            if ( target > slot ) {
+                ++games;
+            }
+        }
+    }
+    return games;
+}
+
+
+/*
+ *  Has each unmatched creature propose to its unmatched neighbour
+ *  with the highest edge priority, if it has any.
+ */
+
+unsigned long Network::DayTask::propose(const std::size_t begin,
+                                        const std::size_t end) {
+    for ( std::size_t slot = begin; slot < end; ++slot ) {
+        m_proposals[slot] = c_no_slot;
+        if ( m_creatures[slot] == 0 || m_mates[slot] != c_no_slot ) {
+            continue;
+        }
+
+        uint64_t best_priority = 0;
+        for ( std::size_t h = m_graph.first_half_edge(slot);
+              h != Graph::no_half_edge;
+              h = m_graph.next_half_edge(slot, h) ) {
+            const Slot target = m_graph.target(h);
+            if ( m_creatures[target] == 0 || m_mates[target] != c_no_slot ) {
+                continue;
+            }
+            const uint64_t priority = edge_priority(slot, target);
+            if ( m_proposals[slot] == c_no_slot ||
+                 priority > best_priority ) {
+                m_proposals[slot] = target;
+                best_priority = priority;
+            }
+        }
+    }
+    return 0;
+}
+
+
+/*
+ *  Matches each creature whose proposal was returned, and returns the
+ *  number of creatures matched.
+ */
+
+unsigned long Network::DayTask::match(const std::size_t begin,
+                                      const std::size_t end) {
+    unsigned long matched = 0;
+    for ( std::size_t slot = begin; slot < end; ++slot ) {
+        const Slot proposal = m_proposals[slot];
+        if ( proposal != c_no_slot && m_proposals[proposal] == slot ) {
+            m_mates[slot] = proposal;
+            ++matched;
+        }
+    }
+    return matched;
+}
+
+
+/*
+ *  Plays the game of each matched pair whose lower slot is in the
+ *  chunk, with the random choices taken from the edge's draw, and
+ *  returns the number of games.
+ */
+
+unsigned long Network::DayTask::play_matched(const std::size_t begin,
+                                             const std::size_t end) {
+    unsigned long games = 0;
+    for ( std::size_t slot = begin; slot < end; ++slot ) {
+        const Slot mate = m_mates[slot];
+        if ( mate != c_no_slot && mate > slot ) {
+            play_game(m_creatures[slot], m_creatures[mate],
+                      edge_draw(slot, mate));
+            ++games;
+        }
+    }
+    return games;
+}
+
+
+/*
+ *  Ages each creature by a day and records its fate.
+ */
+
+unsigned long Network::DayTask::age(const std::size_t begin,
+                                    const std::size_t end) {
+    for ( std::size_t slot = begin; slot < end; ++slot ) {
+        Creature * creature = m_creatures[slot];
+        m_status[slot] = lives;
+        if ( creature == 0 ) {
+            continue;
+        }
+
+        creature->age_day();
+        if ( m_deaths_enabled && creature->is_dead() ) {
+            m_status[slot] = dies;
+        } else if ( m_repro_day && creature->can_reproduce() ) {
+            m_status[slot] = reproduces;
+        }
+    }
+    return 0;
+}
+
+
+/*
+ *  Returns the day's priority of the edge between two slots, which is
+ *  the same from either end.
+ */
+
+uint64_t Network::DayTask::edge_priority(const Slot first,
+                                         const Slot second) const {
+    const uint64_t low = std::min(first, second);
+    const uint64_t high = std::max(first, second);
+    return mix_seed(m_day_seed, (low << 32) | high);
+}
+
+
+/*
+ *  Returns the day's draw for the random choices of the game on the
+ *  edge between two slots, which is the same from either end. The
+ *  draws are hashed rather than taken from std::rand(), so the moves
+ *  do not depend on which thread chooses them.
+ */
+
+uint64_t Network::DayTask::edge_draw(const Slot first,
+                                     const Slot second) const {
+    const uint64_t low = std::min(first, second);
+    const uint64_t high = std::max(first, second);
+    return mix_seed(m_move_seed, (low << 32) | high);
+}
+
+
+/*
+ *  Constructor.
+ *
+ *  Arguments:
+ *    wInfo -- the world's settings, including the starting creatures,
+ *             seed, number of threads and life cycle settings
+ *    nInfo -- the shape of the network and how its games are played
+ *
+ *  Throws BadEdgeList if the network is read from an edge list which
+ *  cannot be read, or which refers to more creatures than there are.
+ */
+
+Network::Network(const WorldInfo& wInfo, const NetworkInfo& nInfo) :
+        m_nInfo(nInfo),
+        m_seed(wInfo.m_seed),
+        m_disable_deaths(wInfo.m_disable_deaths),
+        m_disable_repro(wInfo.m_disable_repro),
+        m_repro_cycle_days(wInfo.m_repro_cycle_days),
+        m_starting_creatures(0),
+        m_day(1),
+        m_pool(wInfo.m_threads),
+        m_graph(),
+        m_creatures(),
+        m_dead_creatures(),
+        m_games_played(0),
+        m_born_creatures(0),
+        m_rebuilds(0),
+        m_birth_edges(1),
+        m_moves(),
+        m_proposals(),
+        m_mates(),
+        m_status() {
+    place_creatures(wInfo);
+
+    try {
+        EdgeList edges;
+        switch ( m_nInfo.m_shape ) {
+            case small_world_network:
+                small_world_edges(m_creatures.size(), m_nInfo.m_degree,
+                                  m_nInfo.m_rewire_prob, m_seed, m_pool,
+                                  edges);
+                break;
+            case scale_free_network:
+                scale_free_edges(m_creatures.size(), m_nInfo.m_degree,
+                                 m_seed, m_pool, edges);
+                break;
+            case edge_list_network:
+                {
+                    std::ifstream in(m_nInfo.m_edge_file.c_str());
+                    if ( !in ) {
+                        throw BadEdgeList();
+                    }
+                    read_edge_list(in, edges);
+                }
+                break;
+        }
+        m_graph.build(m_creatures.size(), edges, m_pool);
+    } catch(...) {
+        for ( CreatureList::iterator itr = m_creatures.begin();
+              itr != m_creatures.end(); ++itr ) {
+            delete *itr;
+        }
+        throw;
+    }
+
+    if ( m_graph.num_live() > 0 ) {
+        m_birth_edges = std::max(static_cast<std::size_t>(1),
+            (m_graph.num_edges() + m_graph.num_live() / 2) /
+                m_graph.num_live());
+    }
+}
+
+
+/*
+ *  Destructor. Deletes all the network's creatures.
+ */
+
+Network::~Network() {
+    for ( CreatureList::iterator itr = m_creatures.begin();
+          itr != m_creatures.end(); ++itr ) {
+        delete *itr;
+    }
+}
+
+
+/*
+ *  Creates the starting population and places it in the slots in a
+ *  random order.
+ */
+
+void Network::place_creatures(const WorldInfo& wInfo) {
+    m_starting_creatures = create_creatures(wInfo, m_creatures);
+
+    Rng rng(m_seed, c_placement_stream);
+    for ( std::size_t i = m_creatures.size(); i > 1; --i ) {
+        std::swap(m_creatures[i - 1],
+                  m_creatures[rng.below(static_cast<uint32_t>(i))]);
+    }
+}
+
+
+/*
+ *  Plays the day's games, ages the creatures and processes deaths and
+ *  births, and rebuilds the graph at the end of every rebuild period.
+ */
+
+void Network::advance_day() {
+    const bool deaths_enabled = (m_disable_deaths != true);
+    const bool repro_day = (m_disable_repro != true) &&
+                           (m_day % m_repro_cycle_days) == 0;
+
+    m_proposals.assign(m_creatures.size(), c_no_slot);
+    m_mates.assign(m_creatures.size(), c_no_slot);
+    m_status.assign(m_creatures.size(), lives);
+    DayTask task(m_graph, m_creatures, m_moves, m_proposals, m_mates,
+                 m_status, mix_seed(m_seed, m_day), deaths_enabled,
+                 repro_day);
+
+    if ( m_nInfo.m_play == all_edges_play ) {
+        play_all_edges(task);
+    } else {
+        play_edge_matching(task);
+    }
+    life_cycle(task);
+
+    if ( m_nInfo.m_rebuild_days > 0 &&
+         (m_day % m_nInfo.m_rebuild_days) == 0 ) {
+        rebuild();
+    }
+
+    ++m_day;
+}
+
+
+/*
+ *  Plays one game along every edge between live creatures.
+ */
+
+void Network::play_all_edges(DayTask& task) {
+    m_moves.resize(m_graph.num_half_edges());
+    task.run_pass(m_pool, DayTask::move_pass);
+    task.run_pass(m_pool, DayTask::result_pass);
+    m_games_played += task.total();
+}
+
+
+/*
+ *  Finds a random matching of the edges between live creatures, and
+ *  plays one game along each matched edge. Stops looking for more
+ *  matches after a round which matches nobody.
+ */
+
+void Network::play_edge_matching(DayTask& task) {
+    for ( int round = 0; round < c_matching_rounds; ++round ) {
+        task.run_pass(m_pool, DayTask::propose_pass);
+        task.run_pass(m_pool, DayTask::match_pass);
+        if ( task.total() == 0 ) {
+            break;
+        }
+    }
+    task.run_pass(m_pool, DayTask::matched_games_pass);
+    m_games_played += task.total();
+}
+
+
+/*
+ *  Ages the creatures in parallel, then deletes those which died,
+ *  keeping their tombstones, and vacates their slots, and gives
+ *  newborns new slots, in slot order.
+ */
+
+void Network::life_cycle(DayTask& task) {
+    task.run_pass(m_pool, DayTask::age_pass);
+
+    const std::size_t num_slots = m_creatures.size();
+    for ( std::size_t slot = 0; slot < num_slots; ++slot ) {
+        if ( m_status[slot] == dies ) {
+            m_dead_creatures.push_back(m_creatures[slot]->tombstone(m_day));
+            delete m_creatures[slot];
+            m_creatures[slot] = 0;
+            m_graph.vacate(static_cast<Slot>(slot));
+        }
+    }
+
+    Rng rng(mix_seed(m_seed, m_day), c_birth_stream);
+    vector<Slot> neighbours;
+    for ( std::size_t slot = 0; slot < num_slots; ++slot ) {
+        if ( m_status[slot] == reproduces ) {
+            Creature * child = m_creatures[slot]->reproduce();
+            if ( child ) {
+                add_newborn(static_cast<Slot>(slot), child,
+                            neighbours, rng);
+            }
+        }
+    }
+}
+
+
+/*
+ *  Gives a newborn a new slot, joined to its parent and to randomly
+ *  chosen live neighbours of its parent, up to m_birth_edges edges in
+ *  all, so that newborns keep the network's starting mean degree.
+ *
+ *  Arguments:
+ *    parent -- the slot of the newborn's parent
+ *    child -- the newborn
+ *    neighbours -- scratch space for the parent's neighbours
+ *    rng -- the generator from which to draw the newborn's neighbours
+ */
+
+void Network::add_newborn(const Slot parent, Creature * child,
+                          vector<Slot>& neighbours, Rng& rng) {
+    m_graph.neighbours(parent, neighbours);
+
+    const Slot slot = m_graph.add_slot();
+    m_creatures.push_back(child);
+    ++m_born_creatures;
+
+    m_graph.add_edge(slot, parent);
+    const std::size_t links = std::min(m_birth_edges - 1,
+                                       neighbours.size());
+    for ( std::size_t i = 0; i < links; ++i ) {
+        const std::size_t pick = i + rng.below(
+                static_cast<uint32_t>(neighbours.size() - i));
+        std::swap(neighbours[i], neighbours[pick]);
+        m_graph.add_edge(slot, neighbours[i]);
+    }
+}
+
+
+/*
+ *  Rebuilds the graph, if it has been patched since it was last built,
+ *  and drops the vacated slots from the creatures list to match.
+ */
+
+void Network::rebuild() {
+    if ( m_graph.num_live() == m_graph.num_slots() &&
+         m_graph.num_patch_edges() == 0 ) {
+        return;
+    }
+
+    m_graph.rebuild(m_pool);
+    m_creatures.erase(std::remove(m_creatures.begin(), m_creatures.end(),
+                                  static_cast<Creature *>(0)),
+                      m_creatures.end());
+    ++m_rebuilds;
+}
+
+
+/*
+ *  Returns the current network day.
+ */
+
+Day Network::day() const {
+    return m_day;
+}
+
+
+/*
+ *  Returns the interaction graph.
+ */
+
+const Graph& Network::graph() const {
+    return m_graph;
+}
+
+
+/*
+ *  Return the creatures, indexed by slot, and the tombstones of the
+ *  dead creatures.
+ */
+
+const CreatureList& Network::creatures() const {
+    return m_creatures;
+}
+
+const TombstoneList& Network::dead_creatures() const {
+    return m_dead_creatures;
+}
+
+
+/*
+ *  Return the network's running totals.
+ */
+
+unsigned long Network::games_played() const {
+    return m_games_played;
+}
+
+unsigned long Network::born_creatures() const {
+    return m_born_creatures;
+}
+
+unsigned long Network::rebuilds() const {
+    return m_rebuilds;
+}
+
+
+/*
+ *  Outputs summary statistics of the network, and the number and
+ *  average resources of the creatures of each strategy.
+ */
+
+void Network::output_network_stats(ostream& out) const {
+    vector<std::size_t> counts(c_num_strategies, 0);
+    vector<double> totals(c_num_strategies, 0.0);
+    vector<std::string> names(c_num_strategies);
+    for ( CreatureList::const_iterator itr = m_creatures.begin();
+          itr != m_creatures.end(); ++itr ) {
+        if ( *itr ) {
+            const Strategy strategy = (*itr)->strategy_value();
+            if ( counts[strategy]++ == 0 ) {
+                names[strategy] = (*itr)->strategy();
+            }
+            totals[strategy] += (*itr)->resources();
+        }
+    }
+
+    const std::size_t num_live = m_graph.num_live();
+    const std::size_t num_edges = m_graph.num_edges();
+
+    out << "Summary network statistics:" << endl
+        << "Days passed: " << m_day - 1 << endl
+        << "Network: ";
+    switch ( m_nInfo.m_shape ) {
+        case small_world_network:
+            out << "small world, degree " << m_nInfo.m_degree
+                << ", rewiring probability " << m_nInfo.m_rewire_prob;
+            break;
+        case scale_free_network:
+            out << "scale free, degree " << m_nInfo.m_degree;
+            break;
+        case edge_list_network:
+            out << "edge list " << m_nInfo.m_edge_file;
+            break;
+    }
+    out << endl
+        << "Games per day: "
+        << (m_nInfo.m_play == all_edges_play ? "every edge" :
+                                               "random edge matching")
+        << endl
+        << "Games played: " << m_games_played << endl
+        << "Starting creatures: " << m_starting_creatures << endl
+        << "Living creatures: " << num_live << endl
+        << "Creatures born: " << m_born_creatures << endl
+        << "Creatures died: " << m_dead_creatures.size() << endl
+        << "Edges: " << num_edges << endl
+        << "Mean degree: "
+        << (num_live > 0 ? 2.0 * num_edges / num_live : 0.0) << endl
+        << "Maximum degree: " << m_graph.max_degree() << endl
+        << "Graph rebuilds: " << m_rebuilds << endl
+        << endl;
+
+    out << "Summary creatures by strategy:" << endl;
+    for ( std::size_t s = 0; s < c_num_strategies; ++s ) {
+        if ( counts[s] == 0 ) {
+            continue;
+        }
+        out << names[s] << ": " << counts[s]
+            << " (" << 100.0 * counts[s] / num_live << "%)"
+            << ", avg resources " << totals[s] / counts[s] << endl;
+    }
+    out << endl;
+}
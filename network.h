@@ -0,0 +1,193 @@
+/*
+ *  network.h
+ *  =========
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Interface to Network class for Prisoner's Dilemma simulation.
+ *
+ *  A Network is an alternative to a World in which creatures only play
+ *  games along the edges of an interaction graph: a small-world or a
+ *  scale-free network generated from the seed, or a network read from
+ *  a file listing its edges. Each creature occupies one slot of the
+ *  graph (see graph.h). Creatures are placed in the slots in a random
+ *  order, so creatures of the same strategy do not start out clustered
+ *  together.
+ *
+ *  Each day, either every edge between live creatures is played once,
+ *  or a random matching of the edges is played, so each creature plays
+ *  at most one game. Creatures then age, die and reproduce as in a
+ *  World. A dead creature's slot is vacated, and a newborn takes a new
+ *  slot joined to its parent and to randomly chosen neighbours of its
+ *  parent, so a creature's offspring stay in its neighbourhood. Each
+ *  newborn is given half the network's starting mean degree in edges,
+ *  which keeps the mean degree steady as creatures come and go. These
+ *  changes are patched into the graph as they happen, and every few
+ *  days the graph is rebuilt, dropping vacated slots and renumbering
+ *  the rest.
+ *
+ *  Games are played in parallel over chunks of slots:
+ *
+ *   - Playing every edge runs two passes. First, each creature chooses
+ *     its move for each of its edges, writing them to an array with one
+ *     entry per half-edge. Then each creature reads its opponents' moves
+ *     from the opposite half-edges and records the results of all its
+ *     games. Each pass writes only to the creature whose slot is being
+ *     processed, so no locking is needed. Creatures remember each
+ *     opponent separately and play each opponent once a day, so the
+ *     results are just as if the games had been played one by one.
+ *
+ *   - A matching is found in a few rounds, in each of which every
+ *     unmatched creature proposes to the unmatched neighbour with which
+ *     its edge has the highest priority, drawn from a hash of the seed,
+ *     the day and the pair of slots, and each pair of creatures which
+ *     propose to each other is matched. The matched pairs are disjoint,
+ *     so their games are then played in parallel.
+ *
+ *  Deaths and births are processed in slot order after the day's
+ *  games, so the network and creature IDs do not depend on the number
+ *  of threads. The random choices of strategy genes are taken from a
+ *  hash of the seed, the day and the pair of slots, rather than from
+ *  std::rand(), so they do not depend on it either.
+ *
+ *  Public member functions:
+ *    advance_day() - plays the day's games, then ages the creatures
+ *                    and processes deaths and births.
+ *
+ *    day() - returns the current network day.
+ *
+ *    graph() - returns the interaction graph.
+ *
+ *    creatures() - returns the creatures, indexed by slot, with a null
+ *                  pointer for each vacated slot.
+ *
+ *    dead_creatures() - returns the tombstones of the creatures which
+ *                       have died, which are deleted as they die.
+ *
+ *    games_played(), born_creatures(), rebuilds() - return running
+ *                                                  totals.
+ *
+ *    output_network_stats() - outputs summary statistics of the network
+ *                             and its creatures.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#ifndef PG_PRIDIL_NETWORK_H
+#define PG_PRIDIL_NETWORK_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "pridil_common.h"
+#include "creature.h"
+#include "graph.h"
+#include "thread_pool.h"
+#include "rng.h"
+
+namespace pridil {
+
+enum NetworkShape { small_world_network, scale_free_network,
+                    edge_list_network };
+enum NetworkPlay { all_edges_play, edge_matching_play };
+
+
+/*
+ *  Struct for describing a network.
+ */
+
+struct NetworkInfo {
+    NetworkShape m_shape;
+    NetworkPlay m_play;
+    unsigned int m_degree;
+    double m_rewire_prob;
+    std::string m_edge_file;
+    Day m_rebuild_days;
+
+    NetworkInfo() :
+        m_shape(small_world_network), m_play(all_edges_play),
+        m_degree(4), m_rewire_prob(0.1), m_edge_file(),
+        m_rebuild_days(10) {}
+};
+
+
+/*
+ *  Network class.
+ */
+
+class Network {
+    public:
+
+        //  Constructor and destructor
+
+        Network(const WorldInfo& wInfo, const NetworkInfo& nInfo);
+        ~Network();
+
+        //  Methods to advance and access the network
+
+        void advance_day();
+        Day day() const;
+        const Graph& graph() const;
+        const CreatureList& creatures() const;
+        const TombstoneList& dead_creatures() const;
+        unsigned long games_played() const;
+        unsigned long born_creatures() const;
+        unsigned long rebuilds() const;
+
+        //  Methods to output network statistics
+
+        void output_network_stats(std::ostream& out) const;
+
+    private:
+        const NetworkInfo m_nInfo;
+        const uint64_t m_seed;
+        const bool m_disable_deaths;
+        const bool m_disable_repro;
+        const Day m_repro_cycle_days;
+        std::size_t m_starting_creatures;
+        Day m_day;
+        ThreadPool m_pool;
+        Graph m_graph;
+        CreatureList m_creatures;
+        TombstoneList m_dead_creatures;
+
+        unsigned long m_games_played;
+        unsigned long m_born_creatures;
+        unsigned long m_rebuilds;
+
+        //  Number of edges given to each newborn, half the starting
+        //  mean degree
+
+        std::size_t m_birth_edges;
+
+        //  Per half-edge moves, and per slot proposals, mates and fates,
+        //  kept between days to save reallocating them.
+
+        std::vector<unsigned char> m_moves;
+        std::vector<Slot> m_proposals;
+        std::vector<Slot> m_mates;
+        std::vector<unsigned char> m_status;
+
+        //  Parallel task used by advance_day()
+
+        class DayTask;
+
+        void place_creatures(const WorldInfo& wInfo);
+        void play_all_edges(DayTask& task);
+        void play_edge_matching(DayTask& task);
+        void life_cycle(DayTask& task);
+        void add_newborn(const Slot parent, Creature * child,
+                         std::vector<Slot>& neighbours, Rng& rng);
+        void rebuild();
+
+        Network(const Network&);                // Prevent copying
+        Network& operator=(const Network&);     // Prevent assignment
+};
+
+}       //  namespace pridil
+
+#endif      // PG_PRIDIL_NETWORK_H
@@ -0,0 +1,558 @@
+/*
+ *  pairing.cpp
+ *  ===========
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Implementation of Pairing class for Prisoners' Dilemma simulation.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+#include "pridil_common.h"
+#include "pairing.h"
+#include "thread_pool.h"
+#include "rng.h"
+
+using namespace pridil;
+
+
+namespace {
+
+    /*
+     *  Number of indices in each chunk, and expected number in each
+     *  bucket. 64K four-byte indices fit comfortably in L2 cache, so
+     *  each bucket is shuffled in cache.
+     */
+
+    const std::size_t c_shuffle_block = 65536;
+
+
+    /*
+     *  Default number of creatures in each block in local pairing mode.
+     *  A creature with its brain, genes and a modest memory takes a few
+     *  hundred bytes, so two blocks of 1024 creatures fit in a typical
+     *  L2 cache of 512KB to 1MB.
+     */
+
+    const std::size_t c_default_local_block = 1024;
+
+
+    /*
+     *  First random number stream used to shuffle creatures which are
+     *  paired again, one stream per round, well clear of the streams
+     *  used by the shuffles.
+     */
+
+    const uint64_t c_rematch_stream = 0x100000000UL;
+
+
+    /*
+     *  Fisher-Yates shuffles a range of a matching.
+     */
+
+    void fisher_yates(Matching& matching, const std::size_t begin,
+                      const std::size_t end, Rng& rng) {
+        for ( std::size_t i = end - begin; i > 1; --i ) {
+            const std::size_t j = rng.below(i);
+            const uint32_t temp = matching[begin + i - 1];
+            matching[begin + i - 1] = matching[begin + j];
+            matching[begin + j] = temp;
+        }
+    }
+
+
+    /*
+     *  Parallel task performing the three passes of the bucket
+     *  shuffle. The count and scatter passes run one chunk of input
+     *  indices per ParallelTask chunk, and draw the same sequence of
+     *  bucket numbers from the same Rng stream, so the bucket chosen
+     *  for each index does not need to be stored. The shuffle pass
+     *  runs one bucket per ParallelTask chunk.
+     */
+
+    class BucketShuffleTask : public ParallelTask {
+        public:
+            enum Pass { count_pass, scatter_pass, shuffle_pass };
+
+            BucketShuffleTask(Matching& matching, const uint64_t seed,
+                              const std::size_t num_chunks) :
+                m_matching(matching), m_seed(seed),
+                m_num_chunks(num_chunks), m_pass(count_pass),
+                m_offsets(num_chunks * num_chunks, 0),
+                m_bucket_starts(num_chunks + 1, 0) {}
+
+            void set_pass(const Pass pass) {
+                m_pass = pass;
+            }
+
+            virtual void run_chunk(const std::size_t chunk,
+                                   const unsigned int thread);
+            void calculate_offsets();
+
+        private:
+            Matching& m_matching;
+            const uint64_t m_seed;
+            const std::size_t m_num_chunks;
+            Pass m_pass;
+
+            //  m_offsets[chunk * m_num_chunks + bucket] holds first the
+            //  number of the chunk's indices sent to the bucket, and
+            //  then the position of the next of them in m_matching.
+
+            std::vector<std::size_t> m_offsets;
+            std::vector<std::size_t> m_bucket_starts;
+
+            void count(const std::size_t chunk);
+            void scatter(const std::size_t chunk);
+            void shuffle(const std::size_t bucket);
+    };
+
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+    void BucketShuffleTask::run_chunk(const std::size_t chunk,
+                                      const unsigned int thread) {
+        switch ( m_pass ) {
+            case count_pass:
+                count(chunk);
+                break;
+            case scatter_pass:
+                scatter(chunk);
+                break;
+            case shuffle_pass:
+                shuffle(chunk);
+                break;
+        }
+    }
+
+#pragma GCC diagnostic pop
+
+
+    void BucketShuffleTask::count(const std::size_t chunk) {
+        std::size_t begin;
+        std::size_t end;
+        chunk_range(m_matching.size(), m_num_chunks, chunk, begin, end);
+
+        Rng rng(m_seed, 2 * chunk);
+        std::size_t * counts = &m_offsets[chunk * m_num_chunks];
+        for ( std::size_t i = begin; i < end; ++i ) {
+            ++counts[rng.below(m_num_chunks)];
+        }
+    }
+
+
+    /*
+     *  Converts the counts to positions, with buckets laid out in
+     *  order, and each bucket holding the indices from each chunk
+     *  in chunk order.
+     */
+
+    void BucketShuffleTask::calculate_offsets() {
+        std::size_t position = 0;
+        for ( std::size_t bucket = 0; bucket < m_num_chunks; ++bucket ) {
+            m_bucket_starts[bucket] = position;
+            for ( std::size_t chunk = 0; chunk < m_num_chunks; ++chunk ) {
+                std::size_t& offset = m_offsets[chunk * m_num_chunks +
+                                                bucket];
+                const std::size_t count = offset;
+                offset = position;
+                position += count;
+            }
+        }
+        m_bucket_starts[m_num_chunks] = position;
+    }
+
+
+    void BucketShuffleTask::scatter(const std::size_t chunk) {
+        std::size_t begin;
+        std::size_t end;
+        chunk_range(m_matching.size(), m_num_chunks, chunk, begin, end);
+
+        Rng rng(m_seed, 2 * chunk);
+        std::size_t * offsets = &m_offsets[chunk * m_num_chunks];
+        for ( std::size_t i = begin; i < end; ++i ) {
+            m_matching[offsets[rng.below(m_num_chunks)]++] =
+                static_cast<uint32_t>(i);
+        }
+    }
+
+
+    void BucketShuffleTask::shuffle(const std::size_t bucket) {
+        Rng rng(m_seed, 2 * bucket + 1);
+        fisher_yates(m_matching, m_bucket_starts[bucket],
+                     m_bucket_starts[bucket + 1], rng);
+    }
+
+
+    /*
+     *  A region of a local matching, made up of the games between two
+     *  blocks, or within a single block if second_block is no_block.
+     */
+
+    const uint32_t no_block = static_cast<uint32_t>(-1);
+
+    struct LocalRegion {
+        uint32_t first_block;
+        uint32_t second_block;
+        std::size_t start;
+    };
+
+
+    /*
+     *  Parallel task which fills in the regions of a local matching,
+     *  one region per ParallelTask chunk. Each thread has its own
+     *  scratch space for the second block of a region.
+     */
+
+    class LocalPairingTask : public ParallelTask {
+        public:
+            LocalPairingTask(Matching& matching,
+                             const std::vector<LocalRegion>& regions,
+                             const uint64_t seed,
+                             const std::size_t block_size,
+                             const std::size_t rotation,
+                             const unsigned int num_threads) :
+                m_matching(matching), m_regions(regions), m_seed(seed),
+                m_block_size(block_size), m_rotation(rotation),
+                m_scratch(num_threads) {}
+
+            virtual void run_chunk(const std::size_t chunk,
+                                   const unsigned int thread);
+
+        private:
+            Matching& m_matching;
+            const std::vector<LocalRegion>& m_regions;
+            const uint64_t m_seed;
+            const std::size_t m_block_size;
+            const std::size_t m_rotation;
+            std::vector<Matching> m_scratch;
+
+            std::size_t fill_block(const uint32_t block, Matching& out,
+                                   const std::size_t pos) const;
+    };
+
+
+    /*
+     *  Writes the creature indices of a block, in rotated order,
+     *  to out starting at pos, and returns the number written.
+     */
+
+    std::size_t LocalPairingTask::fill_block(const uint32_t block,
+                                             Matching& out,
+                                             const std::size_t pos) const {
+        const std::size_t num_creatures = m_matching.size();
+        const std::size_t begin = block * m_block_size;
+        std::size_t end = begin + m_block_size;
+        if ( end > num_creatures ) {
+            end = num_creatures;
+        }
+
+        for ( std::size_t q = begin; q < end; ++q ) {
+            std::size_t index = q + m_rotation;
+            if ( index >= num_creatures ) {
+                index -= num_creatures;
+            }
+            out[pos + q - begin] = static_cast<uint32_t>(index);
+        }
+        return end - begin;
+    }
+
+
+    /*
+     *  Shuffles both blocks of a region and writes cross-block pairs,
+     *  followed by pairs within the larger block for any of its
+     *  creatures left over. Only the last region can hold a partial
+     *  block, so only it can leave an odd creature at its end.
+     */
+
+    void LocalPairingTask::run_chunk(const std::size_t chunk,
+                                     const unsigned int thread) {
+        const LocalRegion& region = m_regions[chunk];
+        Rng rng(m_seed, chunk + 1);
+
+        const std::size_t first_size = fill_block(region.first_block,
+                                                  m_matching, region.start);
+        fisher_yates(m_matching, region.start,
+                     region.start + first_size, rng);
+        if ( region.second_block == no_block ) {
+            return;
+        }
+
+        //  Put the second block in scratch space, and interleave
+        //  it with the first block working back from the end, so
+        //  that no element of the first is overwritten before it
+        //  has been moved.
+
+        Matching& second = m_scratch[thread];
+        second.resize(m_block_size);
+        const std::size_t second_size = fill_block(region.second_block,
+                                                   second, 0);
+        fisher_yates(second, 0, second_size, rng);
+
+        const std::size_t num_cross = first_size < second_size ?
+                                      first_size : second_size;
+        const std::size_t region_end = region.start + first_size +
+                                       second_size;
+
+        //  Leftovers from the second block go at the end of the region,
+        //  leftovers from the first stay where they are after the
+        //  cross pairs.
+
+        std::size_t out = region_end;
+        for ( std::size_t i = second_size; i > num_cross; --i ) {
+            m_matching[--out] = second[i - 1];
+        }
+        for ( std::size_t i = first_size; i > num_cross; --i ) {
+            m_matching[--out] = m_matching[region.start + i - 1];
+        }
+        for ( std::size_t i = num_cross; i > 0; --i ) {
+            m_matching[--out] = second[i - 1];
+            m_matching[--out] = m_matching[region.start + i - 1];
+        }
+    }
+
+}
+
+
+/*
+ *  Constructor.
+ *
+ *  Arguments:
+ *    pool -- the thread pool on which to run the shuffle
+ *    seed -- the seed from which all the matchings are generated
+ *    mode -- uniform or local pairing
+ *    block_size -- the number of creatures in each block in local
+ *                  pairing mode, rounded up to an even number, or 0
+ *                  for the default
+ */
+
+Pairing::Pairing(ThreadPool& pool, const uint64_t seed,
+                 const PairingMode mode, const std::size_t block_size) :
+        m_pool(pool), m_seed(seed), m_mode(mode),
+        m_block_size(block_size > 0 ?
+                     (block_size + 1) / 2 * 2 : c_default_local_block),
+        m_matching(), m_num_pairs(0) {}
+
+
+/*
+ *  Generates a new matching.
+ *
+ *  Arguments:
+ *    num_creatures -- the number of creatures to be paired
+ *    day -- the current world day, from which together with the seed
+ *           the matching is generated
+ */
+
+void Pairing::pair(const std::size_t num_creatures, const Day day) {
+    const uint64_t day_seed = mix_seed(m_seed, day);
+
+    if ( m_mode == local_pairing ) {
+        pair_local(num_creatures, day_seed);
+    } else {
+        pair_uniform(num_creatures, day_seed);
+    }
+    m_num_pairs = num_creatures / 2;
+}
+
+
+/*
+ *  Keeps the pairs accepted, in order, at the front of the matching,
+ *  from first_pair onwards, and appends the creatures of the refused
+ *  pairs to refused_creatures. Returns the number of pairs now at the
+ *  front of the matching.
+ */
+
+std::size_t Pairing::keep_accepted(const std::vector<unsigned char>& refused,
+                                   const std::size_t first_pair,
+                                   Matching& refused_creatures) {
+    std::size_t kept = first_pair;
+    for ( std::size_t pair = first_pair; pair < m_num_pairs; ++pair ) {
+        if ( refused[pair] ) {
+            refused_creatures.push_back(m_matching[2 * pair]);
+            refused_creatures.push_back(m_matching[2 * pair + 1]);
+        } else {
+            m_matching[2 * kept] = m_matching[2 * pair];
+            m_matching[2 * kept + 1] = m_matching[2 * pair + 1];
+            ++kept;
+        }
+    }
+    return kept;
+}
+
+
+/*
+ *  Pairs again the creatures of the refused pairs, along with any
+ *  creatures sitting out, in a uniformly random order.
+ *
+ *  Arguments:
+ *    refused -- flags for each pair of the matching, set for each pair
+ *               refused; only those from first_pair onwards are read
+ *    first_pair -- the first pair which may have been refused, where
+ *                  all earlier pairs have been accepted
+ *    day -- the current world day
+ *    round -- the number of earlier rounds of rematching on this day
+ *
+ *  Returns:
+ *    The first of the new pairs, all of which follow the accepted ones.
+ */
+
+std::size_t Pairing::rematch(const std::vector<unsigned char>& refused,
+                             const std::size_t first_pair, const Day day,
+                             const unsigned int round) {
+    Matching pool;
+    const std::size_t kept = keep_accepted(refused, first_pair, pool);
+    pool.insert(pool.end(), m_matching.begin() + 2 * m_num_pairs,
+                m_matching.end());
+
+    Rng rng(mix_seed(m_seed, day), c_rematch_stream + round);
+    fisher_yates(pool, 0, pool.size(), rng);
+    std::copy(pool.begin(), pool.end(), m_matching.begin() + 2 * kept);
+
+    m_num_pairs = kept + pool.size() / 2;
+    return kept;
+}
+
+
+/*
+ *  Drops the refused pairs, moving their creatures to the end of the
+ *  matching, ahead of any creatures already sitting out.
+ *
+ *  Arguments:
+ *    refused -- flags for each pair of the matching, set for each pair
+ *               refused; only those from first_pair onwards are read
+ *    first_pair -- the first pair which may have been refused
+ */
+
+void Pairing::sit_out(const std::vector<unsigned char>& refused,
+                      const std::size_t first_pair) {
+    Matching dropped;
+    const std::size_t kept = keep_accepted(refused, first_pair, dropped);
+    std::copy(dropped.begin(), dropped.end(),
+              m_matching.begin() + 2 * kept);
+    m_num_pairs = kept;
+}
+
+
+/*
+ *  Generates a uniformly random matching with the bucket shuffle.
+ */
+
+void Pairing::pair_uniform(const std::size_t num_creatures,
+                           const uint64_t day_seed) {
+    const std::size_t num_chunks = num_chunks_for(num_creatures,
+                                                  c_shuffle_block);
+
+    if ( num_chunks == 1 ) {
+        m_matching.resize(num_creatures);
+        for ( std::size_t i = 0; i < num_creatures; ++i ) {
+            m_matching[i] = static_cast<uint32_t>(i);
+        }
+        Rng rng(day_seed, 1);
+        fisher_yates(m_matching, 0, num_creatures, rng);
+        return;
+    }
+
+    //  The scatter pass overwrites every element, so the matching
+    //  only needs to be sized, not filled, before it starts.
+
+    m_matching.resize(num_creatures);
+    BucketShuffleTask task(m_matching, day_seed, num_chunks);
+    m_pool.run(task, num_chunks);
+    task.calculate_offsets();
+    task.set_pass(BucketShuffleTask::scatter_pass);
+    m_pool.run(task, num_chunks);
+    task.set_pass(BucketShuffleTask::shuffle_pass);
+    m_pool.run(task, num_chunks);
+}
+
+
+/*
+ *  Generates a local matching, as described in pairing.h.
+ */
+
+void Pairing::pair_local(const std::size_t num_creatures,
+                         const uint64_t day_seed) {
+    m_matching.resize(num_creatures);
+    if ( num_creatures == 0 ) {
+        return;
+    }
+
+    //  Draw the day's rotation and block order
+
+    Rng rng(day_seed, 0);
+    const std::size_t rotation = rng.below(num_creatures);
+    const std::size_t num_blocks = num_chunks_for(num_creatures,
+                                                  m_block_size);
+    const bool has_partial = (num_creatures % m_block_size) != 0;
+
+    Matching order(num_blocks);
+    for ( std::size_t i = 0; i < num_blocks; ++i ) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+    fisher_yates(order, 0, num_blocks, rng);
+
+    //  Pair off the blocks into regions, moving the region holding the
+    //  partial block, if any, to the end, and then lay out the regions.
+
+    std::vector<LocalRegion> regions((num_blocks + 1) / 2);
+    std::size_t partial_region = regions.size() - 1;
+    for ( std::size_t r = 0; r < regions.size(); ++r ) {
+        regions[r].first_block = order[2 * r];
+        regions[r].second_block = (2 * r + 1 < num_blocks) ?
+                                  order[2 * r + 1] : no_block;
+        if ( has_partial && (regions[r].first_block == num_blocks - 1 ||
+                             regions[r].second_block == num_blocks - 1) ) {
+            partial_region = r;
+        }
+    }
+    std::swap(regions[partial_region], regions.back());
+
+    std::size_t start = 0;
+    for ( std::size_t r = 0; r < regions.size(); ++r ) {
+        regions[r].start = start;
+        start += m_block_size;
+        if ( regions[r].second_block != no_block ) {
+            start += m_block_size;
+        }
+    }
+
+    LocalPairingTask task(m_matching, regions, day_seed, m_block_size,
+                          rotation, m_pool.num_threads());
+    m_pool.run(task, regions.size());
+}
+
+
+/*
+ *  Returns the number of pairs in the current matching.
+ */
+
+std::size_t Pairing::num_pairs() const {
+    return m_num_pairs;
+}
+
+
+/*
+ *  Returns the number of creatures not in any pair.
+ */
+
+std::size_t Pairing::num_sitting_out() const {
+    return m_matching.size() - 2 * m_num_pairs;
+}
+
+
+/*
+ *  Returns the current matching. Pair i is made up of the creatures
+ *  whose indices are at positions 2i and 2i + 1.
+ */
+
+const Matching& Pairing::matching() const {
+    return m_matching;
+}
@@ -0,0 +1,174 @@
+/*
+ *  pairing.h
+ *  =========
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Interface to Pairing class for Prisoner's Dilemma simulation.
+ *
+ *  A Pairing generates each day's uniformly random perfect matching of
+ *  creatures, in the form of a random permutation of the indices of the
+ *  live creatures list. Pair i of the matching is made up of the
+ *  creatures at positions 2i and 2i + 1 of the permutation, and when
+ *  there is an odd number of creatures the last one sits out.
+ *
+ *  The permutation is produced by a parallel bucket shuffle. The
+ *  indices are split into contiguous chunks, and every index is sent to
+ *  a uniformly random bucket, with each chunk counting how many of its
+ *  indices go to each bucket. A prefix sum over those counts gives each
+ *  chunk its positions within each bucket, the indices are scattered
+ *  to those positions, and each bucket is then shuffled independently
+ *  with a Fisher-Yates shuffle. Sending each item to an independent
+ *  uniform bucket and then uniformly permuting every bucket gives a
+ *  uniformly random permutation of the whole. Each of the three passes
+ *  runs in parallel on the ThreadPool.
+ *
+ *  Random numbers come from Rng streams keyed by the seed, the day and
+ *  the chunk or bucket number, so the matching for a given seed and day
+ *  is the same whatever number of threads is used.
+ *
+ *  Local pairing mode
+ *  ------------------
+ *  With a uniform matching, consecutive games touch creatures scattered
+ *  across the whole population. In local pairing mode, creatures are
+ *  only ever paired between two blocks of consecutive indices, and all
+ *  the games between those two blocks are consecutive in the matching,
+ *  so each stretch of games works on just two blocks of creatures. The
+ *  block size is chosen so that two blocks' creatures fit in L2 cache,
+ *  and since the creature list keeps creatures in creation order, two
+ *  blocks are also two runs of creatures created close together.
+ *
+ *  Each day, the block boundaries are rotated by a uniformly random
+ *  offset, the blocks are randomly permuted and paired off, and the
+ *  creatures in each pair of blocks are shuffled and paired across the
+ *  two blocks. With K blocks of B creatures (n = KB), this means that:
+ *
+ *   - a creature's partner block is uniformly distributed over the
+ *     other K - 1 blocks, and its partner is uniformly distributed
+ *     within that block, so a creature never meets one in the same
+ *     block on that day, and meets any other with probability exactly
+ *     1 / (n - B), compared with 1 / (n - 1) for a uniform matching;
+ *
+ *   - two creatures whose indices are d apart (cyclically) share a
+ *     block with probability max(0, B - d) / B, because of the random
+ *     rotation. Creatures at least B apart therefore always meet with
+ *     probability 1 / (n - B), and the total variation distance between
+ *     a creature's partner distribution and the uniform one is about
+ *     B / n on every day;
+ *
+ *   - the rotation and permutation are drawn afresh each day, so days
+ *     are independent, and over D days each pair of creatures at
+ *     least B apart expects D / (n - B) meetings, against D / (n - 1)
+ *     with uniform mixing. Only the roughly 2B nearest neighbours of a
+ *     creature are met less often, and none is excluded over more than
+ *     one day, since a neighbour d apart is in another block on a
+ *     fraction d / B of days.
+ *
+ *  When the number of blocks is odd, one block is paired within itself,
+ *  and the final partial block, if any, is always placed last in the
+ *  matching so that pairs stay aligned and, with an odd number of
+ *  creatures, the one sitting out is at the very end.
+ *
+ *  Partner choice
+ *  --------------
+ *  When creatures may refuse their partners, the owner of the pairing
+ *  checks each pair and calls rematch() with the pairs refused. The
+ *  pairs accepted are kept, in order, at the front of the matching, and
+ *  the creatures of the refused pairs, together with any creature
+ *  sitting out, are shuffled and paired again after them. rematch()
+ *  returns the first of the new pairs, so the next round of checks
+ *  need only look at those. After a bounded number of rounds,
+ *  sit_out() drops the pairs still refused, moving their creatures to
+ *  the end of the matching, after the pairs which play. Each round
+ *  costs time in proportion to the number of pairs still refused, so
+ *  the whole stays linear in the number of creatures, rather than
+ *  searching for acceptable partners.
+ *
+ *  Public member functions:
+ *    pair() - generates the matching for the specified number of
+ *             creatures on the specified day, using the pairing mode
+ *             given to the constructor.
+ *
+ *    rematch() - shuffles and pairs again the creatures of refused
+ *                pairs, and of any creature sitting out.
+ *
+ *    sit_out() - drops refused pairs from the pairs which play.
+ *
+ *    num_pairs() - returns the number of pairs in the current matching.
+ *
+ *    num_sitting_out() - returns the number of creatures which are not
+ *                        in any pair of the current matching.
+ *
+ *    matching() - returns the current matching as an array of indices.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#ifndef PG_PRIDIL_PAIRING_H
+#define PG_PRIDIL_PAIRING_H
+
+#include <cstddef>
+#include <vector>
+#include <stdint.h>
+#include "pridil_common.h"
+#include "thread_pool.h"
+
+namespace pridil {
+
+/*
+ *  Typedef for a matching, stored as a permutation of indices.
+ */
+
+typedef std::vector<uint32_t> Matching;
+
+
+/*
+ *  Pairing class.
+ */
+
+class Pairing {
+    public:
+
+        //  Constructor
+
+        Pairing(ThreadPool& pool, const uint64_t seed,
+                const PairingMode mode = uniform_pairing,
+                const std::size_t block_size = 0);
+
+        //  Methods to generate and access the matching
+
+        void pair(const std::size_t num_creatures, const Day day);
+        std::size_t rematch(const std::vector<unsigned char>& refused,
+                            const std::size_t first_pair, const Day day,
+                            const unsigned int round);
+        void sit_out(const std::vector<unsigned char>& refused,
+                     const std::size_t first_pair);
+        std::size_t num_pairs() const;
+        std::size_t num_sitting_out() const;
+        const Matching& matching() const;
+
+    private:
+        ThreadPool& m_pool;
+        const uint64_t m_seed;
+        const PairingMode m_mode;
+        const std::size_t m_block_size;
+        Matching m_matching;
+        std::size_t m_num_pairs;
+
+        std::size_t keep_accepted(const std::vector<unsigned char>& refused,
+                                  const std::size_t first_pair,
+                                  Matching& refused_creatures);
+        void pair_uniform(const std::size_t num_creatures,
+                          const uint64_t day_seed);
+        void pair_local(const std::size_t num_creatures,
+                        const uint64_t day_seed);
+
+        Pairing(const Pairing&);                // Prevent copying
+        Pairing& operator=(const Pairing&);     // Prevent assignment
+};
+
+}       //  namespace pridil
+
+#endif      // PG_PRIDIL_PAIRING_H
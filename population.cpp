@@ -0,0 +1,408 @@
+/*
+ *  population.cpp
+ *  ==============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Implementation of Population class for Prisoners' Dilemma simulation.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "pridil_common.h"
+#include "population.h"
+#include "creature.h"
+#include "brain_pool.h"
+#include "slot_map.h"
+
+using namespace pridil;
+
+
+/*
+ *  Constructor.
+ *
+ *  Arguments:
+ *    pool -- the pool from which to take Brains, or null to create
+ *            and delete them directly
+ */
+
+Population::Population(BrainPool * pool) :
+        m_pool(pool), m_ids(), m_birth_days(), m_resources(), m_strategies(),
+        m_life_expectancies(), m_handles(), m_brains() {}
+
+
+/*
+ *  Destructor. Deletes or gives back the Brains of all rows which are
+ *  not empty.
+ */
+
+Population::~Population() {
+    resize(0);
+}
+
+
+/*
+ *  Appends a newly created creature.
+ *
+ *  Arguments:
+ *    c_init -- the creature's strategy, life expectancy, starting
+ *              resources and reproduction characteristics
+ *    id -- the creature's ID
+ *    birth_day -- the day on which the creature was born
+ *
+ *  Returns:
+ *    The creature's row.
+ */
+
+std::size_t Population::add(const CreatureInit& c_init, const CreatureID id,
+                            const Day birth_day) {
+    const std::size_t index = size();
+    resize(index + 1);
+    try {
+        create(index, c_init, id, birth_day);
+    } catch(...) {
+        resize(index);
+        throw;
+    }
+    return index;
+}
+
+
+/*
+ *  Creates a creature in an existing, empty, row, with a Brain taken
+ *  from the pool, or a new Brain if the population has no pool. Must
+ *  not be called by two threads at once if the population has a pool.
+ *
+ *  Arguments:
+ *    index -- the row
+ *    c_init, id, birth_day -- as for add()
+ */
+
+void Population::create(const std::size_t index, const CreatureInit& c_init,
+                        const CreatureID id, const Day birth_day) {
+    Brain * brain = m_pool ? m_pool->acquire(c_init) : new Brain(c_init);
+    create(index, brain, c_init, id, birth_day);
+}
+
+
+/*
+ *  Creates a creature in an existing, empty, row, with a Brain already
+ *  taken from the population's pool, which is reset for the creature.
+ *  Different threads may create different rows at the same time.
+ *
+ *  Arguments:
+ *    index -- the row
+ *    brain -- the Brain, which the row now owns
+ *    c_init, id, birth_day -- as for add()
+ */
+
+void Population::create(const std::size_t index, Brain * brain,
+                        const CreatureInit& c_init, const CreatureID id,
+                        const Day birth_day) {
+    m_brains[index] = brain;
+    brain->reset(c_init);
+    m_ids[index] = id;
+    m_birth_days[index] = birth_day;
+    m_resources[index] = c_init.starting_resources;
+    m_strategies[index] = static_cast<unsigned char>(
+                                m_brains[index]->strategy_value());
+    m_life_expectancies[index] = c_init.life_expectancy;
+    m_handles[index] = SlotMap::null_handle;
+}
+
+
+/*
+ *  Moves all the rows of another population to the end of this one,
+ *  leaving the other population empty.
+ */
+
+void Population::append(Population& source) {
+    const std::size_t first = size();
+    resize(first + source.size());
+    for ( std::size_t i = 0; i < source.size(); ++i ) {
+        move(source, i, first + i);
+    }
+    source.resize(0);
+}
+
+
+/*
+ *  Moves one row of another population to the end of this one. The
+ *  source row is left empty.
+ */
+
+void Population::append(Population& source, const std::size_t index) {
+    const std::size_t to = size();
+    resize(to + 1);
+    move(source, index, to);
+}
+
+
+/*
+ *  Moves a row of a population, which may be this one, to an existing
+ *  row of this one. The destination row must be empty, and the source
+ *  row is left empty, unless it is the destination row.
+ *
+ *  Arguments:
+ *    source -- the population from which to move the row
+ *    from -- the row to move
+ *    to -- the row to which to move it
+ */
+
+void Population::move(Population& source, const std::size_t from,
+                      const std::size_t to) {
+    if ( &source == this && from == to ) {
+        return;
+    }
+
+    m_ids[to] = source.m_ids[from];
+    m_birth_days[to] = source.m_birth_days[from];
+    m_resources[to] = source.m_resources[from];
+    m_strategies[to] = source.m_strategies[from];
+    m_life_expectancies[to] = source.m_life_expectancies[from];
+    m_handles[to] = source.m_handles[from];
+    m_brains[to] = source.m_brains[from];
+    source.m_brains[from] = 0;
+}
+
+
+/*
+ *  Changes the number of rows. Rows added are empty, and the Brains of
+ *  any rows removed which are not empty are deleted or given back.
+ */
+
+void Population::resize(const std::size_t new_size) {
+    for ( std::size_t i = new_size; i < m_brains.size(); ++i ) {
+        release_brain(i);
+    }
+
+    m_ids.resize(new_size, 0);
+    m_birth_days.resize(new_size, 0);
+    m_resources.resize(new_size, 0);
+    m_strategies.resize(new_size, 0);
+    m_life_expectancies.resize(new_size, 0);
+    m_handles.resize(new_size, SlotMap::null_handle);
+    m_brains.resize(new_size, static_cast<Brain *>(0));
+}
+
+
+/*
+ *  Deletes a row's Brain, or gives it back to the pool, leaving the
+ *  rest of the row as it was.
+ */
+
+void Population::release_brain(const std::size_t index) {
+    if ( m_brains[index] == 0 ) {
+        return;
+    }
+
+    if ( m_pool ) {
+        m_pool->release(m_brains[index]);
+    } else {
+        delete m_brains[index];
+    }
+    m_brains[index] = 0;
+}
+
+
+/*
+ *  Swaps the contents of two populations, which must use the same
+ *  pool.
+ */
+
+void Population::swap(Population& other) {
+    m_ids.swap(other.m_ids);
+    m_birth_days.swap(other.m_birth_days);
+    m_resources.swap(other.m_resources);
+    m_strategies.swap(other.m_strategies);
+    m_life_expectancies.swap(other.m_life_expectancies);
+    m_handles.swap(other.m_handles);
+    m_brains.swap(other.m_brains);
+}
+
+
+/*
+ *  Returns a string describing the game-playing strategy of a creature.
+ */
+
+const std::string Population::strategy(const std::size_t index) const {
+    return m_brains[index]->strategy();
+}
+
+
+/*
+ *  Returns the number of games a creature has played.
+ */
+
+unsigned int Population::games_played(const std::size_t index) const {
+    return m_brains[index]->games_played();
+}
+
+
+/*
+ *  Returns a tombstone recording a creature which died on the
+ *  specified day. The creature's Brain must not yet have been given
+ *  back.
+ */
+
+Tombstone Population::tombstone(const std::size_t index,
+                                const Day death_day) const {
+    return Tombstone(m_ids[index], m_birth_days[index], death_day,
+                     m_resources[index], m_brains[index]->games_played(),
+                     strategy_value(index));
+}
+
+
+/*
+ *  Outputs a creature's detailed memories.
+ */
+
+void Population::detailed_memories(const std::size_t index,
+                                   std::ostream& out) const {
+    m_brains[index]->show_detailed_memories(out);
+}
+
+
+/*
+ *  Gets a creature's game move against the specified opponent.
+ */
+
+GameMove Population::get_game_move(const std::size_t index,
+                                   const CreatureID opponent) const {
+    return m_brains[index]->get_game_move(opponent);
+}
+
+GameMove Population::get_game_move(const std::size_t index,
+                                   const CreatureID opponent,
+                                   const uint32_t draw) const {
+    return m_brains[index]->get_game_move(opponent, draw);
+}
+
+
+/*
+ *  Adds the result of a game to a creature's resources, and stores the
+ *  details of the game in its memory.
+ */
+
+void Population::give_game_result(const std::size_t index,
+                                  const GameInfo& g_info) {
+    m_resources[index] += g_info.result;
+    m_brains[index]->store_memory(g_info);
+}
+
+
+/*
+ *  Returns the history of a creature's games with an opponent.
+ */
+
+MatchHistory Population::match_history(const std::size_t index,
+                                       const CreatureID opponent) const {
+    return m_brains[index]->match_history(opponent);
+}
+
+
+/*
+ *  Gets a creature's game move given the history of its games with an
+ *  opponent.
+ */
+
+GameMove Population::get_match_move(const std::size_t index,
+                                    const MatchHistory& history) const {
+    return m_brains[index]->get_match_move(history);
+}
+
+GameMove Population::get_match_move(const std::size_t index,
+                                    const MatchHistory& history,
+                                    const uint32_t draw) const {
+    return m_brains[index]->get_match_move(history, draw);
+}
+
+
+/*
+ *  Adds the total result of a series of games against one opponent to
+ *  a creature's resources, and stores the details of the games in its
+ *  memory.
+ *
+ *  Arguments:
+ *    index -- the creature's row
+ *    games -- pointer to the first of the games, as seen by the creature
+ *    count -- the number of games
+ *    result -- the total result of the games
+ */
+
+void Population::give_match_result(const std::size_t index,
+                                   const GameInfo * games,
+                                   const std::size_t count,
+                                   const int result) {
+    m_resources[index] += result;
+    m_brains[index]->store_memories(games, count);
+}
+
+
+/*
+ *  Returns true if the opponent defected in the last game a creature
+ *  remembers playing against it.
+ */
+
+bool Population::refuses(const std::size_t index,
+                         const CreatureID opponent) const {
+    const Brain& brain = *m_brains[index];
+    return brain.num_memories(opponent) > 0 &&
+           brain.remember_move(opponent) == defect;
+}
+
+
+/*
+ *  Deducts resources from a creature.
+ */
+
+void Population::spend_resources(const std::size_t index, const int amount) {
+    m_resources[index] -= amount;
+}
+
+
+/*
+ *  Creates the starting population of creatures described by a
+ *  WorldInfo structure, with the creatures of each strategy together,
+ *  and appends them to a population. Creatures are born on day 0, and
+ *  are given the IDs they would have been given as Creature objects.
+ *
+ *  Arguments:
+ *    wInfo -- the number of creatures of each strategy, and their
+ *             life expectancies, starting resources and reproduction
+ *             characteristics
+ *    population -- the population to which the new creatures are
+ *                  appended
+ *
+ *  Returns:
+ *    The number of creatures created.
+ *
+ *  If there is any problem with construction, the creatures created
+ *  so far are removed from the population, and the exception is
+ *  re-thrown.
+ */
+
+unsigned int pridil::create_creatures(const WorldInfo& wInfo,
+                                      Population& population) {
+    std::vector<Strategy> strategies;
+    CreatureInit c_init = starting_population(wInfo, strategies);
+
+    const std::size_t first_new = population.size();
+    try {
+        for ( std::size_t i = 0; i < strategies.size(); ++i ) {
+            c_init.strategy = strategies[i];
+            population.add(c_init, Creature::reserve_ids(1), 0);
+        }
+    } catch(...) {
+        population.resize(first_new);
+        throw;                      // Re-throw exception to caller
+    }
+
+    return population.size() - first_new;
+}
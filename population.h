@@ -0,0 +1,252 @@
+/*
+ *  population.h
+ *  ============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Interface to Population class for Prisoner's Dilemma simulation.
+ *
+ *  A Population stores a list of creatures as a structure of arrays,
+ *  rather than as a list of pointers to Creature objects. Each
+ *  creature is a row, identified by its position in the list, and the
+ *  state the daily passes need is held in separate contiguous arrays,
+ *  one entry per row:
+ *
+ *   - the creature's ID;
+ *   - the day on which it was born, from which its age follows;
+ *   - its resources;
+ *   - its strategy;
+ *   - its life expectancy; and
+ *   - its handle in the World's slot map (see slot_map.h), if any.
+ *
+ *  Ageing, deaths, reproduction and statistics by strategy then stream
+ *  through dense arrays without touching anything else. Ageing in
+ *  particular writes nothing, since a creature's age is the current
+ *  day less its birth day.
+ *
+ *  Each row also has a Brain, holding the creature's DNA and Memory,
+ *  which is consulted only when the creature plays a game or its
+ *  memories are shown. Brains are kept in a parallel array of
+ *  pointers, owned by the population. A population may be given a
+ *  BrainPool (see brain_pool.h), in which case it takes its Brains from
+ *  the pool, resetting each one for its new creature, and gives them
+ *  back to the pool instead of deleting them. Populations between which
+ *  rows are moved must use the same pool, or none.
+ *
+ *  Rows move between populations, or within one, by moving their
+ *  entries and the ownership of their Brain, so moving a creature
+ *  never copies its memories. The source row is left empty, and must
+ *  be overwritten or removed by resize() before the population is
+ *  used again. move() and create() write to an existing row, so, once
+ *  a population has been resized, different threads may move or create
+ *  different rows at the same time. A row's handle moves with it, and
+ *  the owner of the slot map records the row's new location.
+ *
+ *  Public member functions:
+ *    add() - appends a newly created creature.
+ *
+ *    create() - creates a creature in an existing row, optionally with
+ *               a Brain taken from the pool beforehand.
+ *
+ *    append() - moves one or all of the rows of another population to
+ *               the end of this one.
+ *
+ *    move() - moves a row of a population, which may be this one, to an
+ *             existing row of this one.
+ *
+ *    resize() - changes the number of rows, deleting or giving back
+ *               the Brains of any rows removed which are not empty.
+ *
+ *    release_brain() - deletes or gives back a row's Brain, keeping the
+ *                      row's entries in the dense arrays, e.g. once a
+ *                      creature has died.
+ *
+ *    swap() - swaps the contents of two populations.
+ *
+ *    size() - returns the number of rows.
+ *
+ *    id(), birth_day(), resources(), strategy_value(),
+ *    life_expectancy(), handle() - return a row's entries in the dense
+ *                                  arrays.
+ *
+ *    set_handle() - sets a row's handle.
+ *
+ *    is_dead() - returns true if a creature has outlived its life
+ *                expectancy on the specified day, or has run out of
+ *                resources.
+ *
+ *    strategy() - returns a std::string representation of a creature's
+ *                 game-playing strategy.
+ *
+ *    games_played() - returns the number of games a creature has played.
+ *
+ *    tombstone() - returns a record of a creature which has died, to be
+ *                  kept once its row and Brain are gone.
+ *
+ *    detailed_memories() - outputs all of a creature's memories.
+ *
+ *    get_game_move(), give_game_result(), refuses() - as for Creature.
+ *
+ *    match_history(), get_match_move() - return the history of a
+ *                                        creature's games with an
+ *                                        opponent, and its move given
+ *                                        that history, for a match.
+ *
+ *    get_game_move() and get_match_move() may be given a draw from
+ *    which to take any random choice (see strategy_gene.h).
+ *
+ *    give_match_result() - adds the total result of a series of games
+ *                          to a creature's resources, and stores the
+ *                          games in its memory, in one update.
+ *
+ *    spend_resources() - deducts resources from a creature, e.g. the
+ *                        cost of reproducing.
+ *
+ *  Non-member functions:
+ *    create_creatures() - creates the starting population of creatures
+ *                         described by a WorldInfo structure, as does
+ *                         the function of the same name for lists of
+ *                         Creature objects, with the same IDs.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#ifndef PG_PRIDIL_POPULATION_H
+#define PG_PRIDIL_POPULATION_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "pridil_common.h"
+#include "brain_complex.h"
+#include "brain_pool.h"
+#include "slot_map.h"
+
+namespace pridil {
+
+class Population {
+    public:
+
+        //  Constructor and destructor
+
+        explicit Population(BrainPool * pool = 0);
+        ~Population();
+
+        //  Methods to add, move and remove creatures
+
+        std::size_t add(const CreatureInit& c_init, const CreatureID id,
+                        const Day birth_day);
+        void create(const std::size_t index, const CreatureInit& c_init,
+                    const CreatureID id, const Day birth_day);
+        void create(const std::size_t index, Brain * brain,
+                    const CreatureInit& c_init, const CreatureID id,
+                    const Day birth_day);
+        void append(Population& source);
+        void append(Population& source, const std::size_t index);
+        void move(Population& source, const std::size_t from,
+                  const std::size_t to);
+        void resize(const std::size_t new_size);
+        void release_brain(const std::size_t index);
+        void swap(Population& other);
+
+        //  Methods to access the dense arrays
+
+        std::size_t size() const {
+            return m_ids.size();
+        }
+
+        CreatureID id(const std::size_t index) const {
+            return m_ids[index];
+        }
+
+        Day birth_day(const std::size_t index) const {
+            return m_birth_days[index];
+        }
+
+        int resources(const std::size_t index) const {
+            return m_resources[index];
+        }
+
+        Strategy strategy_value(const std::size_t index) const {
+            return static_cast<Strategy>(m_strategies[index]);
+        }
+
+        Day life_expectancy(const std::size_t index) const {
+            return m_life_expectancies[index];
+        }
+
+        CreatureHandle handle(const std::size_t index) const {
+            return m_handles[index];
+        }
+
+        void set_handle(const std::size_t index,
+                        const CreatureHandle handle) {
+            m_handles[index] = handle;
+        }
+
+        bool is_dead(const std::size_t index, const Day today) const {
+            return today - m_birth_days[index] > m_life_expectancies[index] ||
+                   m_resources[index] <= 0;
+        }
+
+        //  Methods to access the Brains
+
+        const std::string strategy(const std::size_t index) const;
+        unsigned int games_played(const std::size_t index) const;
+        Tombstone tombstone(const std::size_t index,
+                            const Day death_day) const;
+        void detailed_memories(const std::size_t index,
+                               std::ostream& out) const;
+
+        //  Gaming and resources methods
+
+        GameMove get_game_move(const std::size_t index,
+                               const CreatureID opponent) const;
+        GameMove get_game_move(const std::size_t index,
+                               const CreatureID opponent,
+                               const uint32_t draw) const;
+        void give_game_result(const std::size_t index,
+                              const GameInfo& g_info);
+        MatchHistory match_history(const std::size_t index,
+                                   const CreatureID opponent) const;
+        GameMove get_match_move(const std::size_t index,
+                                const MatchHistory& history) const;
+        GameMove get_match_move(const std::size_t index,
+                                const MatchHistory& history,
+                                const uint32_t draw) const;
+        void give_match_result(const std::size_t index,
+                               const GameInfo * games,
+                               const std::size_t count, const int result);
+        bool refuses(const std::size_t index,
+                     const CreatureID opponent) const;
+        void spend_resources(const std::size_t index, const int amount);
+
+    private:
+        BrainPool * const m_pool;
+        std::vector<CreatureID> m_ids;
+        std::vector<Day> m_birth_days;
+        std::vector<int> m_resources;
+        std::vector<unsigned char> m_strategies;
+        std::vector<Day> m_life_expectancies;
+        std::vector<CreatureHandle> m_handles;
+        std::vector<Brain *> m_brains;
+
+        Population(const Population&);              // Prevent copying
+        Population& operator=(const Population&);   // Prevent assignment
+};
+
+
+/*
+ *  Function to create a starting population
+ */
+
+unsigned int create_creatures(const WorldInfo& wInfo,
+                              Population& population);
+
+}       //  namespace pridil
+
+#endif      // PG_PRIDIL_POPULATION_H
@@ -20,5 +20,13 @@
 
 #include "pridil_exceptions.h"
 #include "world.h"
+#include "tournament.h"
+#include "lattice.h"
+#include "network.h"
+#include "mean_field.h"
+#include "cohort_world.h"
+#include "moran.h"
+#include "replicates.h"
+#include "gillespie.h"
 
 #endif      //  PG_PRIDIL_INTERFACE_H
@@ -23,7 +23,6 @@
 #include <memory>
 #include <string>
 #include <vector>
-#include <map>
 #include <list>
 #include "pridil_exceptions.h"
 
@@ -43,6 +42,10 @@ enum Strategy { random_strategy, tit_for_tat, susp_tit_for_tat,
                 tit_for_two_tats, grudger, naive_prober, remorseful_prober,
                 always_cooperate, always_defect };
 
+enum PairingMode { uniform_pairing, local_pairing };
+
+enum DeathCause { died_of_age, died_of_starvation };
+
 
 //  Structures and classes
 
@@ -93,6 +96,50 @@ struct GameInfo {
     GameInfo() : id(0), own_move(coop), opponent_move(coop), result(3) {}
 };
 
+/*
+ *  Structure to record as much of the history of games with a given
+ *  opponent as the strategy genes consult: the number of games played,
+ *  counting no further than two, and the opponent's moves in the last
+ *  two of them. A match keeps one of these for each creature, rather
+ *  than searching its memories before every game.
+ */
+
+struct MatchHistory {
+    unsigned int games;
+    GameMove last_move;
+    GameMove second_last_move;
+
+    MatchHistory() : games(0), last_move(coop), second_last_move(coop) {}
+};
+
+/*
+ *  Structure to record a creature which has died. A tombstone is all
+ *  that is kept of a dead creature once its Brain, with its DNA and
+ *  Memory, has been freed or reused, and is enough for statistics
+ *  about the dead. A creature which ran out of resources is recorded
+ *  as having starved, even if it also reached its life expectancy.
+ */
+
+struct Tombstone {
+    CreatureID id;
+    Day birth_day;
+    Day death_day;
+    int final_resources;
+    unsigned int games_played;
+    unsigned char strategy;
+    unsigned char cause;
+
+    Tombstone() :
+        id(0), birth_day(0), death_day(0), final_resources(0),
+        games_played(0), strategy(random_strategy), cause(died_of_age) {}
+    Tombstone(const CreatureID i, const Day bd, const Day dd,
+              const int res, const unsigned int gp,
+              const Strategy stgy) :
+        id(i), birth_day(bd), death_day(dd), final_resources(res),
+        games_played(gp), strategy(static_cast<unsigned char>(stgy)),
+        cause(res <= 0 ? died_of_starvation : died_of_age) {}
+};
+
 /*
  *  WorldInfo structure for holding attributes about the
  *  simulated world, including number of different types
@@ -119,6 +166,20 @@ struct WorldInfo {
     Day m_repro_cycle_days;
     bool m_disable_deaths;
     bool m_disable_repro;
+    unsigned int m_threads;
+    unsigned long m_seed;
+    PairingMode m_pairing_mode;
+    unsigned int m_pairing_block;
+    unsigned int m_regions;
+    double m_migration_rate;
+    bool m_partner_choice;
+    unsigned int m_rematch_rounds;
+    Day m_converge_check_days;
+    unsigned int m_converge_window;
+    double m_converge_tolerance;
+    unsigned int m_match_rounds;
+    double m_continuation_prob;
+    double m_match_length;
 
     WorldInfo() :
         m_random_strategy(1), m_tit_for_tat(1),
@@ -131,13 +192,21 @@ struct WorldInfo {
         m_days_to_run(10), m_default_starting_resources(100),
         m_repro_cost(50), m_repro_min_resources(100),
         m_repro_cycle_days(10),
-        m_disable_deaths(false), m_disable_repro(false) {}
+        m_disable_deaths(false), m_disable_repro(false),
+        m_threads(1), m_seed(0),
+        m_pairing_mode(uniform_pairing), m_pairing_block(0),
+        m_regions(1), m_migration_rate(0.0),
+        m_partner_choice(false), m_rematch_rounds(3),
+        m_converge_check_days(0), m_converge_window(10),
+        m_converge_tolerance(0.01),
+        m_match_rounds(1), m_continuation_prob(0.0),
+        m_match_length(0.0) {}
 };
 
 //  Class and struct typedefs
 
-typedef std::list<GameInfo> GameInfoList;
-typedef std::map<CreatureID, GameInfoList > GameInfoMap;
+typedef std::vector<GameInfo> GameInfoList;
+typedef std::vector<Tombstone> TombstoneList;
 
 }       //  namespace pridil
 
@@ -32,6 +32,14 @@ class PridilException {
         virtual ~PridilException() {}
 
         const std::string& what() const { return m_error_message; }
+
+        //  Copy and re-throw with the most derived type, so an
+        //  exception can be kept and thrown again without slicing
+
+        virtual PridilException * clone() const {
+            return new PridilException(*this);
+        }
+        virtual void raise() const { throw *this; }
 };
 
 
@@ -40,6 +48,10 @@ class PridilException {
 class BadGameMove : public PridilException {
     public:
         explicit BadGameMove() : PridilException("Unknown game move") {};
+        virtual BadGameMove * clone() const {
+            return new BadGameMove(*this);
+        }
+        virtual void raise() const { throw *this; }
 };
 
 
@@ -48,6 +60,10 @@ class BadGameMove : public PridilException {
 class UnknownStrategy : public PridilException {
     public:
         explicit UnknownStrategy() : PridilException("Unknown strategy") {};
+        virtual UnknownStrategy * clone() const {
+            return new UnknownStrategy(*this);
+        }
+        virtual void raise() const { throw *this; }
 };
 
 
@@ -57,6 +73,92 @@ class InvalidOpponentMemory : public PridilException {
     public:
         explicit InvalidOpponentMemory() :
             PridilException("Invalid opponent memory index") {};
+        virtual InvalidOpponentMemory * clone() const {
+            return new InvalidOpponentMemory(*this);
+        }
+        virtual void raise() const { throw *this; }
+};
+
+
+//  Thrown when a ThreadPool cannot start its worker threads
+
+class ThreadPoolError : public PridilException {
+    public:
+        explicit ThreadPoolError() :
+            PridilException("Could not start worker threads") {};
+        virtual ThreadPoolError * clone() const {
+            return new ThreadPoolError(*this);
+        }
+        virtual void raise() const { throw *this; }
+};
+
+
+//  Thrown when a Lattice is too small or has no creatures to place
+
+class BadLatticeSize : public PridilException {
+    public:
+        explicit BadLatticeSize() :
+            PridilException("Lattice must be at least 3 by 3 cells, "
+                            "with at least one strategy") {};
+        virtual BadLatticeSize * clone() const {
+            return new BadLatticeSize(*this);
+        }
+        virtual void raise() const { throw *this; }
+};
+
+//  Thrown when an edge list cannot be read, or refers to a creature
+//  which does not exist
+
+class BadEdgeList : public PridilException {
+    public:
+        explicit BadEdgeList() :
+            PridilException("Bad edge list, or edge list refers to "
+                            "creatures which do not exist") {};
+        virtual BadEdgeList * clone() const {
+            return new BadEdgeList(*this);
+        }
+        virtual void raise() const { throw *this; }
+};
+
+
+//  Thrown when a creature is looked up by a handle which is stale
+
+class StaleHandle : public PridilException {
+    public:
+        explicit StaleHandle() :
+            PridilException("Creature handle is stale") {};
+        virtual StaleHandle * clone() const {
+            return new StaleHandle(*this);
+        }
+        virtual void raise() const { throw *this; }
+};
+
+
+//  Thrown when a SlotMap has no slots left to give out
+
+class SlotMapFull : public PridilException {
+    public:
+        explicit SlotMapFull() :
+            PridilException("Too many creatures for creature handles") {};
+        virtual SlotMapFull * clone() const {
+            return new SlotMapFull(*this);
+        }
+        virtual void raise() const { throw *this; }
+};
+
+
+//  Thrown when bit-sliced replicates are given creatures whose moves
+//  are not determined by their memories
+
+class NondeterministicStrategy : public PridilException {
+    public:
+        explicit NondeterministicStrategy() :
+            PridilException("Replicates need strategies with "
+                            "deterministic moves") {};
+        virtual NondeterministicStrategy * clone() const {
+            return new NondeterministicStrategy(*this);
+        }
+        virtual void raise() const { throw *this; }
 };
 
 }       //  namespace pridil
@@ -0,0 +1,1572 @@
+/*
+ *  region.cpp
+ *  ==========
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Implementation of Region class for Prisoners' Dilemma simulation.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <stdint.h>
+#include "pridil_common.h"
+#include "region.h"
+#include "creature.h"
+#include "population.h"
+#include "slot_map.h"
+#include "brain_pool.h"
+#include "game.h"
+#include "thread_pool.h"
+#include "pairing.h"
+#include "rng.h"
+
+using std::vector;
+
+using namespace pridil;
+
+
+/*
+ *  Number of games in each chunk of the parallel game phase. Chunks
+ *  are claimed dynamically by the pool's threads, so this only needs
+ *  to be large enough to amortize the cost of claiming a chunk.
+ */
+
+namespace {
+    const std::size_t c_games_per_chunk = 512;
+    const std::size_t c_creatures_per_chunk = 1024;
+    const std::size_t c_num_strategies = always_defect + 1;
+
+
+    /*
+     *  Stream number from which the lengths of matches are derived,
+     *  clear of the pairing's and migration's streams.
+     */
+
+    const uint64_t c_match_stream = 0xFFFFFFFDUL;
+
+
+    /*
+     *  Stream number from which the draws for the random choices of
+     *  strategy genes are hashed, in single games and in matches. The
+     *  draws are hashed from the day and the game, and the game of a
+     *  match, rather than taken from std::rand(), so they do not depend
+     *  on the order in which threads play the games.
+     */
+
+    const uint64_t c_move_stream = 0xFFFFFFFCUL;
+
+
+    /*
+     *  Position recorded for a row which plays no game today.
+     */
+
+    const std::size_t c_no_position = static_cast<std::size_t>(-1);
+
+
+    /*
+     *  Returns the slot map location of a row of a region's live
+     *  creatures.
+     */
+
+    SlotLocation slot_location(const unsigned int region,
+                               const std::size_t row) {
+        return SlotLocation(region, static_cast<uint32_t>(row));
+    }
+
+
+    /*
+     *  Plays match number game of the day between two paired creatures,
+     *  with its length drawn from a hash of the day's match seed and the
+     *  game number, and its moves from draws hashed from the day's move
+     *  seed and the game number, and returns the number of games played.
+     */
+
+    unsigned int play_pair(Population& creatures, const std::size_t first,
+                           const std::size_t second, const std::size_t game,
+                           const unsigned int match_rounds,
+                           const double continuation_prob,
+                           const uint64_t match_seed,
+                           const uint64_t move_seed) {
+        const unsigned int rounds = match_length(match_rounds,
+                continuation_prob, mix_seed(match_seed, game));
+        play_match(creatures, first, second, rounds,
+                   mix_seed(move_seed, game));
+        return rounds;
+    }
+}
+
+
+/*
+ *  Parallel task to play a range of the day's paired matches.
+ *
+ *  The creatures at positions 2i and 2i + 1 of the day's matching
+ *  play match i. Every creature appears in at most one pair, so the
+ *  games in different chunks never touch the same creature, and each
+ *  creature's resources and memories can be updated without locking.
+ *  Each chunk counts the games it played in its own slot of
+ *  m_chunk_games, which are summed once the job is done, and notes the
+ *  creatures whose resources have run out or reached the minimum to
+ *  reproduce in its own ResourceWatch, which are merged in chunk order.
+ */
+
+class Region::GamePhaseTask : public ParallelTask {
+    public:
+        GamePhaseTask(Population& creatures, const Matching& matching,
+                      const std::size_t num_games,
+                      const std::size_t num_chunks, const int repro_min,
+                      const unsigned int match_rounds,
+                      const double continuation_prob,
+                      const uint64_t match_seed, const uint64_t move_seed) :
+            m_creatures(creatures), m_matching(matching),
+            m_num_games(num_games),
+            m_num_chunks(num_chunks), m_match_rounds(match_rounds),
+            m_continuation_prob(continuation_prob),
+            m_match_seed(match_seed), m_move_seed(move_seed),
+            m_chunk_games(num_chunks, 0),
+            m_chunk_watches(num_chunks, ResourceWatch(repro_min)) {}
+
+        virtual void run_chunk(const std::size_t chunk,
+                               const unsigned int thread);
+        unsigned long games_played() const;
+        void merge_watches(ResourceWatch& watch);
+
+    private:
+        Population& m_creatures;
+        const Matching& m_matching;
+        const std::size_t m_num_games;
+        const std::size_t m_num_chunks;
+        const unsigned int m_match_rounds;
+        const double m_continuation_prob;
+        const uint64_t m_match_seed;
+        const uint64_t m_move_seed;
+        std::vector<unsigned long> m_chunk_games;
+        std::vector<ResourceWatch> m_chunk_watches;
+};
+
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+/*
+ *  Plays the games belonging to one chunk. The thread number is not
+ *  needed, since the task keeps no per-thread scratch space.
+ */
+
+void Region::GamePhaseTask::run_chunk(const std::size_t chunk,
+                                     const unsigned int thread) {
+    std::size_t begin;
+    std::size_t end;
+    chunk_range(m_num_games, m_num_chunks, chunk, begin, end);
+
+    ResourceWatch& watch = m_chunk_watches[chunk];
+    unsigned long games_played = 0;
+    for ( std::size_t game = begin; game < end; ++game ) {
+        const std::size_t first = m_matching[2 * game];
+        const std::size_t second = m_matching[2 * game + 1];
+        const int first_before = m_creatures.resources(first);
+        const int second_before = m_creatures.resources(second);
+        games_played += play_pair(m_creatures, first, second, game,
+                                  m_match_rounds, m_continuation_prob,
+                                  m_match_seed, m_move_seed);
+        watch.note(m_creatures, first, first_before);
+        watch.note(m_creatures, second, second_before);
+    }
+    m_chunk_games[chunk] = games_played;
+}
+
+#pragma GCC diagnostic pop
+
+
+/*
+ *  Returns the total number of games played by all chunks.
+ */
+
+unsigned long Region::GamePhaseTask::games_played() const {
+    unsigned long total = 0;
+    for ( std::vector<unsigned long>::const_iterator itr =
+                m_chunk_games.begin();
+          itr != m_chunk_games.end(); ++itr ) {
+        total += *itr;
+    }
+    return total;
+}
+
+
+/*
+ *  Adds the creatures noted by all chunks to a ResourceWatch.
+ */
+
+void Region::GamePhaseTask::merge_watches(ResourceWatch& watch) {
+    for ( std::size_t chunk = 0; chunk < m_num_chunks; ++chunk ) {
+        watch.merge(m_chunk_watches[chunk]);
+    }
+}
+
+
+/*
+ *  Parallel task to play the day's games when each pair plays a single
+ *  game, in three stages, each run over the whole day before the next
+ *  one starts:
+ *
+ *   - gather asks every paired creature for its move, the creatures at
+ *     positions 2i and 2i + 1 of the matching making moves 2i and
+ *     2i + 1, and records each creature's position by its row;
+ *
+ *   - resolve finds the results of every game, with a lookup in a table
+ *     of payoffs indexed by whether each creature defected, rather than
+ *     a branch on the moves;
+ *
+ *   - scatter gives each creature its game and result in order of rows,
+ *     rather than in the random order of the matching, so resources and
+ *     Brains are visited in the order in which they are stored.
+ *
+ *  A creature plays at most one game a day, so its move depends only
+ *  on its memories of earlier days, and gathering every move before
+ *  giving any results changes nothing. Gather and resolve are split
+ *  into chunks of games, and scatter into chunks of rows, so no two
+ *  chunks write the same element or the same creature. Each chunk of
+ *  the scatter notes creatures in its own ResourceWatch, which are
+ *  merged in chunk order.
+ */
+
+class Region::GamePipelineTask : public ParallelTask {
+    public:
+        enum Stage { gather_stage, resolve_stage, scatter_stage };
+
+        GamePipelineTask(Population& creatures, const Matching& matching,
+                         const std::size_t num_games,
+                         const std::size_t num_chunks, const int repro_min,
+                         const uint64_t move_seed, GameMove * moves,
+                         int * results, std::size_t * positions);
+
+        virtual void run_chunk(const std::size_t chunk,
+                               const unsigned int thread);
+        void set_stage(const Stage stage);
+        void merge_watches(ResourceWatch& watch);
+
+    private:
+        Population& m_creatures;
+        const Matching& m_matching;
+        const std::size_t m_num_games;
+        const std::size_t m_num_chunks;
+        Stage m_stage;
+        const uint64_t m_move_seed;
+        GameMove * const m_moves;
+        int * const m_results;
+        std::size_t * const m_positions;
+        unsigned char m_defects[defect_random + 1];
+        int m_payoffs[2][2];
+        std::vector<ResourceWatch> m_chunk_watches;
+
+        void gather(const std::size_t begin, const std::size_t end);
+        void resolve(const std::size_t begin, const std::size_t end);
+        void scatter(const std::size_t begin, const std::size_t end,
+                     ResourceWatch& watch);
+
+        GamePipelineTask(const GamePipelineTask&);
+        GamePipelineTask& operator=(const GamePipelineTask&);
+};
+
+
+/*
+ *  Constructor. Takes the scratch arrays, with room for two moves and
+ *  results per game and a position per row, and builds the tables of
+ *  which moves are defections and of the result of a game for the
+ *  creature whose defection is bit 0 of the index, from game_result().
+ */
+
+Region::GamePipelineTask::GamePipelineTask(Population& creatures,
+                                           const Matching& matching,
+                                           const std::size_t num_games,
+                                           const std::size_t num_chunks,
+                                           const int repro_min,
+                                           const uint64_t move_seed,
+                                           GameMove * moves, int * results,
+                                           std::size_t * positions) :
+        m_creatures(creatures), m_matching(matching),
+        m_num_games(num_games), m_num_chunks(num_chunks),
+        m_stage(gather_stage), m_move_seed(move_seed), m_moves(moves),
+        m_results(results),
+        m_positions(positions), m_defects(), m_payoffs(),
+        m_chunk_watches(num_chunks, ResourceWatch(repro_min)) {
+    for ( int move = coop; move <= defect_random; ++move ) {
+        m_defects[move] = simplify_game_move(
+                static_cast<GameMove>(move)) == defect ? 1 : 0;
+    }
+    payoff_table(m_payoffs);
+}
+
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+/*
+ *  Runs the current stage over the games, or rows, belonging to one
+ *  chunk. The thread number is not needed, since the task keeps no
+ *  per-thread scratch space.
+ */
+
+void Region::GamePipelineTask::run_chunk(const std::size_t chunk,
+                                         const unsigned int thread) {
+    std::size_t begin;
+    std::size_t end;
+    if ( m_stage == scatter_stage ) {
+        chunk_range(m_creatures.size(), m_num_chunks, chunk, begin, end);
+        scatter(begin, end, m_chunk_watches[chunk]);
+    } else {
+        chunk_range(m_num_games, m_num_chunks, chunk, begin, end);
+        if ( m_stage == gather_stage ) {
+            gather(begin, end);
+        } else {
+            resolve(begin, end);
+        }
+    }
+}
+
+#pragma GCC diagnostic pop
+
+
+/*
+ *  Sets the stage to run on the next call to ThreadPool::run().
+ */
+
+void Region::GamePipelineTask::set_stage(const Stage stage) {
+    m_stage = stage;
+}
+
+
+/*
+ *  Adds the creatures noted by all chunks of the scatter to a
+ *  ResourceWatch.
+ */
+
+void Region::GamePipelineTask::merge_watches(ResourceWatch& watch) {
+    for ( std::size_t chunk = 0; chunk < m_num_chunks; ++chunk ) {
+        watch.merge(m_chunk_watches[chunk]);
+    }
+}
+
+
+/*
+ *  Gathers the moves of a range of games, and the positions in the
+ *  matching of the creatures playing them. Each game's random choices
+ *  come from a hash of the day's move seed and the game number, the
+ *  high half for the first creature and the low half for the second.
+ */
+
+void Region::GamePipelineTask::gather(const std::size_t begin,
+                                      const std::size_t end) {
+    for ( std::size_t slot = 2 * begin; slot < 2 * end; slot += 2 ) {
+        const std::size_t first = m_matching[slot];
+        const std::size_t second = m_matching[slot + 1];
+        const uint64_t draw = mix_seed(m_move_seed, slot / 2);
+        m_moves[slot] = m_creatures.get_game_move(first,
+                m_creatures.id(second), static_cast<uint32_t>(draw >> 32));
+        m_moves[slot + 1] = m_creatures.get_game_move(second,
+                m_creatures.id(first), static_cast<uint32_t>(draw));
+        m_positions[first] = slot;
+        m_positions[second] = slot + 1;
+    }
+}
+
+
+/*
+ *  Resolves the results of a range of games from their moves.
+ */
+
+void Region::GamePipelineTask::resolve(const std::size_t begin,
+                                       const std::size_t end) {
+    for ( std::size_t slot = 2 * begin; slot < 2 * end; slot += 2 ) {
+        const unsigned int first = m_defects[m_moves[slot]];
+        const unsigned int second = m_defects[m_moves[slot + 1]];
+        m_results[slot] = m_payoffs[first][second];
+        m_results[slot + 1] = m_payoffs[second][first];
+    }
+}
+
+
+/*
+ *  Gives the creatures in a range of rows which played today their
+ *  games, in the same GameInfo as play_game() would, with the
+ *  opponent's move simplified, and notes any whose resources have run
+ *  out or reached the minimum to reproduce.
+ */
+
+void Region::GamePipelineTask::scatter(const std::size_t begin,
+                                       const std::size_t end,
+                                       ResourceWatch& watch) {
+    for ( std::size_t row = begin; row < end; ++row ) {
+        const std::size_t slot = m_positions[row];
+        if ( slot == c_no_position ) {
+            continue;
+        }
+
+        const std::size_t other = slot ^ 1;
+        const GameInfo info(m_creatures.id(m_matching[other]), m_moves[slot],
+                            m_defects[m_moves[other]] ? defect : coop,
+                            m_results[slot]);
+        const int before = m_creatures.resources(row);
+        m_creatures.give_game_result(row, info);
+        watch.note(m_creatures, row, before);
+    }
+}
+
+
+/*
+ *  Parallel task to check which of a range of the day's pairs are
+ *  refused by either creature.
+ *
+ *  Each chunk only reads the creatures and writes the flags of its own
+ *  pairs, and counts the refusals in its own slot of m_chunk_refusals.
+ */
+
+class Region::RefusalTask : public ParallelTask {
+    public:
+        RefusalTask(const Population& creatures, const Matching& matching,
+                    std::vector<unsigned char>& refused,
+                    const std::size_t first_pair, const std::size_t end_pair,
+                    const std::size_t num_chunks) :
+            m_creatures(creatures), m_matching(matching),
+            m_refused(refused), m_first_pair(first_pair),
+            m_num_pairs(end_pair - first_pair),
+            m_num_chunks(num_chunks), m_chunk_refusals(num_chunks, 0) {}
+
+        virtual void run_chunk(const std::size_t chunk,
+                               const unsigned int thread);
+        std::size_t refusals() const;
+
+    private:
+        const Population& m_creatures;
+        const Matching& m_matching;
+        std::vector<unsigned char>& m_refused;
+        const std::size_t m_first_pair;
+        const std::size_t m_num_pairs;
+        const std::size_t m_num_chunks;
+        std::vector<std::size_t> m_chunk_refusals;
+};
+
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+/*
+ *  Checks the pairs belonging to one chunk.
+ */
+
+void Region::RefusalTask::run_chunk(const std::size_t chunk,
+                                   const unsigned int thread) {
+    std::size_t begin;
+    std::size_t end;
+    chunk_range(m_num_pairs, m_num_chunks, chunk, begin, end);
+
+    std::size_t refusals = 0;
+    for ( std::size_t pair = m_first_pair + begin;
+          pair < m_first_pair + end; ++pair ) {
+        const std::size_t first = m_matching[2 * pair];
+        const std::size_t second = m_matching[2 * pair + 1];
+        const bool refused =
+            m_creatures.refuses(first, m_creatures.id(second)) ||
+            m_creatures.refuses(second, m_creatures.id(first));
+        m_refused[pair] = refused;
+        refusals += refused;
+    }
+    m_chunk_refusals[chunk] = refusals;
+}
+
+#pragma GCC diagnostic pop
+
+
+/*
+ *  Returns the total number of pairs refused in all chunks.
+ */
+
+std::size_t Region::RefusalTask::refusals() const {
+    std::size_t total = 0;
+    for ( std::size_t chunk = 0; chunk < m_num_chunks; ++chunk ) {
+        total += m_chunk_refusals[chunk];
+    }
+    return total;
+}
+
+
+/*
+ *  Parallel task to process deaths and births.
+ *
+ *  The task is given the rows of the day's candidates for death or
+ *  reproduction, in order, and the creatures not among them just live
+ *  on. It runs in two passes, with an exclusive prefix sum over the
+ *  per-chunk counts in between:
+ *
+ *   - mark_pass: each chunk records whether each of its candidates
+ *     died, will reproduce, or just lives on, and counts the
+ *     survivors, deaths, and births of each strategy in its own slots.
+ *
+ *   - offsets(): the counts are turned into each chunk's starting
+ *     position in the new live creatures list, the day's dead and
+ *     their tombstones, and the newborns section at the end of the
+ *     live list, and into its starting position among the Brains
+ *     taken for newborns of each strategy.
+ *
+ *   - commit_pass: each chunk writes its survivors, dead creatures and
+ *     tombstones to those positions, and creates its newborns there
+ *     with their Brains, recording the new rows of its survivors and
+ *     newborns in the slot map.
+ *
+ *  Chunks keep the original order of the creatures, and newborns are
+ *  given IDs from a block reserved up front in order of their parents,
+ *  so the resulting lists and IDs are exactly those of a simple serial
+ *  loop, however many threads are used. Survivors are written straight
+ *  to their final positions, so removing the dead takes a single pass
+ *  however many creatures die.
+ */
+
+class Region::LifeCycleTask : public ParallelTask {
+    public:
+        enum Pass { mark_pass, commit_pass };
+
+        LifeCycleTask(Population& creatures,
+                      const std::vector<std::size_t>& candidates,
+                      const std::size_t num_chunks,
+                      const Day day, const bool deaths_enabled,
+                      const bool repro_day,
+                      const CreatureInit& offspring_init,
+                      SlotMap& slots, const unsigned int region);
+
+        virtual void run_chunk(const std::size_t chunk,
+                               const unsigned int thread);
+        void set_pass(const Pass pass);
+        void calculate_offsets();
+
+        std::size_t num_chunks() const;
+        std::size_t total_survivors() const;
+        std::size_t total_deaths() const;
+        std::size_t total_births() const;
+        std::size_t strategy_births(const std::size_t strategy) const;
+        void parents(HandleList& handles) const;
+
+        void set_outputs(Population * new_creatures,
+                         Population * dying,
+                         TombstoneList * tombstones,
+                         const std::size_t tombstone_base,
+                         const CreatureID first_child_id,
+                         const HandleList * child_handles,
+                         const BrainList * child_brains);
+
+    private:
+        enum Status { lives, dies, reproduces };
+
+        Population& m_creatures;
+        const std::vector<std::size_t>& m_candidates;
+        const std::size_t m_num_chunks;
+        const Day m_day;
+        const bool m_deaths_enabled;
+        const bool m_repro_day;
+        const CreatureInit& m_offspring_init;
+        SlotMap& m_slots;
+        const unsigned int m_region;
+        Pass m_pass;
+
+        std::vector<unsigned char> m_status;
+        std::vector<std::size_t> m_survivors;
+        std::vector<std::size_t> m_deaths;
+        std::vector<std::size_t> m_births;
+
+        //  Births of each strategy in each chunk, by chunk and then by
+        //  strategy, the total births of each strategy, and the start
+        //  of each strategy's Brains among those taken for newborns
+
+        std::vector<std::size_t> m_strategy_births;
+        std::vector<std::size_t> m_strategy_totals;
+        std::vector<std::size_t> m_strategy_bases;
+
+        Population * m_new_creatures;
+        Population * m_dying;
+        TombstoneList * m_tombstones;
+        std::size_t m_tombstone_base;
+        CreatureID m_first_child_id;
+        const HandleList * m_child_handles;
+        const BrainList * m_child_brains;
+
+        std::size_t first_candidate(const std::size_t row) const;
+        void mark(const std::size_t chunk);
+        void commit(const std::size_t chunk);
+
+        LifeCycleTask(const LifeCycleTask&);
+        LifeCycleTask& operator=(const LifeCycleTask&);
+};
+
+
+/*
+ *  Constructor.
+ */
+
+Region::LifeCycleTask::LifeCycleTask(Population& creatures,
+                                    const vector<std::size_t>& candidates,
+                                    const std::size_t num_chunks,
+                                    const Day day,
+                                    const bool deaths_enabled,
+                                    const bool repro_day,
+                                    const CreatureInit& offspring_init,
+                                    SlotMap& slots,
+                                    const unsigned int region) :
+        m_creatures(creatures), m_candidates(candidates),
+        m_num_chunks(num_chunks), m_day(day),
+        m_deaths_enabled(deaths_enabled), m_repro_day(repro_day),
+        m_offspring_init(offspring_init),
+        m_slots(slots), m_region(region),
+        m_pass(mark_pass),
+        m_status(candidates.size(), lives),
+        m_survivors(num_chunks, 0), m_deaths(num_chunks, 0),
+        m_births(num_chunks, 0),
+        m_strategy_births(num_chunks * c_num_strategies, 0),
+        m_strategy_totals(c_num_strategies, 0),
+        m_strategy_bases(c_num_strategies, 0),
+        m_new_creatures(0), m_dying(0), m_tombstones(0),
+        m_tombstone_base(0), m_first_child_id(0), m_child_handles(0),
+        m_child_brains(0) {}
+
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+/*
+ *  Runs the current pass over one chunk. The thread number is not
+ *  needed, since all scratch space is kept per chunk.
+ */
+
+void Region::LifeCycleTask::run_chunk(const std::size_t chunk,
+                                     const unsigned int thread) {
+    if ( m_pass == mark_pass ) {
+        mark(chunk);
+    } else {
+        commit(chunk);
+    }
+}
+
+#pragma GCC diagnostic pop
+
+
+/*
+ *  Sets the pass to be run by the next job.
+ */
+
+void Region::LifeCycleTask::set_pass(const Pass pass) {
+    m_pass = pass;
+}
+
+
+/*
+ *  Returns the position of the first candidate whose row is not before
+ *  the specified row.
+ */
+
+std::size_t Region::LifeCycleTask::first_candidate(
+                                        const std::size_t row) const {
+    return std::lower_bound(m_candidates.begin(), m_candidates.end(), row) -
+           m_candidates.begin();
+}
+
+
+/*
+ *  Records the fate of each candidate in a chunk. Ageing needs no work,
+ *  since each creature's age follows from its birth day, so only the
+ *  dense arrays are read.
+ */
+
+void Region::LifeCycleTask::mark(const std::size_t chunk) {
+    std::size_t begin;
+    std::size_t end;
+    chunk_range(m_creatures.size(), m_num_chunks, chunk, begin, end);
+
+    std::size_t deaths = 0;
+    std::size_t births = 0;
+    std::size_t * strategy_births = &m_strategy_births[chunk *
+                                                       c_num_strategies];
+    const std::size_t last = first_candidate(end);
+    for ( std::size_t c = first_candidate(begin); c < last; ++c ) {
+        const std::size_t i = m_candidates[c];
+        if ( m_deaths_enabled && m_creatures.is_dead(i, m_day) ) {
+            m_status[c] = dies;
+            ++deaths;
+        } else if ( m_repro_day && m_creatures.resources(i) >=
+                                   m_offspring_init.repro_min_resources ) {
+            m_status[c] = reproduces;
+            ++births;
+            ++strategy_births[m_creatures.strategy_value(i)];
+        }
+    }
+
+    m_survivors[chunk] = (end - begin) - deaths;
+    m_deaths[chunk] = deaths;
+    m_births[chunk] = births;
+}
+
+
+/*
+ *  Replaces each chunk's counts with the exclusive prefix sum of the
+ *  counts of all preceding chunks, i.e. with the chunk's offset into
+ *  its output section.
+ */
+
+void Region::LifeCycleTask::calculate_offsets() {
+    std::size_t survivors = 0;
+    std::size_t deaths = 0;
+    std::size_t births = 0;
+
+    for ( std::size_t chunk = 0; chunk < m_num_chunks; ++chunk ) {
+        const std::size_t chunk_survivors = m_survivors[chunk];
+        const std::size_t chunk_deaths = m_deaths[chunk];
+        const std::size_t chunk_births = m_births[chunk];
+
+        m_survivors[chunk] = survivors;
+        m_deaths[chunk] = deaths;
+        m_births[chunk] = births;
+
+        survivors += chunk_survivors;
+        deaths += chunk_deaths;
+        births += chunk_births;
+    }
+
+    m_survivors.push_back(survivors);
+    m_deaths.push_back(deaths);
+    m_births.push_back(births);
+
+    std::size_t base = 0;
+    for ( std::size_t strategy = 0; strategy < c_num_strategies;
+          ++strategy ) {
+        std::size_t total = 0;
+        for ( std::size_t chunk = 0; chunk < m_num_chunks; ++chunk ) {
+            std::size_t& count =
+                m_strategy_births[chunk * c_num_strategies + strategy];
+            const std::size_t chunk_count = count;
+            count = total;
+            total += chunk_count;
+        }
+        m_strategy_totals[strategy] = total;
+        m_strategy_bases[strategy] = base;
+        base += total;
+    }
+}
+
+
+/*
+ *  Returns the number of chunks into which the creatures are divided.
+ */
+
+std::size_t Region::LifeCycleTask::num_chunks() const {
+    return m_num_chunks;
+}
+
+
+/*
+ *  Return the totals calculated by calculate_offsets().
+ */
+
+std::size_t Region::LifeCycleTask::total_survivors() const {
+    return m_survivors.back();
+}
+
+std::size_t Region::LifeCycleTask::total_deaths() const {
+    return m_deaths.back();
+}
+
+std::size_t Region::LifeCycleTask::total_births() const {
+    return m_births.back();
+}
+
+std::size_t Region::LifeCycleTask::strategy_births(
+                                        const std::size_t strategy) const {
+    return m_strategy_totals[strategy];
+}
+
+
+/*
+ *  Appends the handles of the creatures which will reproduce to a
+ *  list. Must be called before the commit pass moves them.
+ */
+
+void Region::LifeCycleTask::parents(HandleList& handles) const {
+    for ( std::size_t c = 0; c < m_candidates.size(); ++c ) {
+        if ( m_status[c] == reproduces ) {
+            handles.push_back(m_creatures.handle(m_candidates[c]));
+        }
+    }
+}
+
+
+/*
+ *  Sets the lists and positions written by the commit pass.
+ *
+ *  Arguments:
+ *    new_creatures -- the new live creatures, already sized to hold
+ *                     all survivors followed by all newborns
+ *    dying -- the day's dead creatures, already sized to hold them
+ *    tombstones -- the tombstones, already sized to hold the new
+ *                  deaths after any existing ones
+ *    tombstone_base -- the position of the first new tombstone
+ *    first_child_id -- the first of the IDs reserved for newborns
+ *    child_handles -- the handles reserved for newborns, in order
+ *    child_brains -- the Brains taken for newborns, in order of
+ *                    strategy
+ */
+
+void Region::LifeCycleTask::set_outputs(Population * new_creatures,
+                                       Population * dying,
+                                       TombstoneList * tombstones,
+                                       const std::size_t tombstone_base,
+                                       const CreatureID first_child_id,
+                                       const HandleList * child_handles,
+                                       const BrainList * child_brains) {
+    m_new_creatures = new_creatures;
+    m_dying = dying;
+    m_tombstones = tombstones;
+    m_tombstone_base = tombstone_base;
+    m_first_child_id = first_child_id;
+    m_child_handles = child_handles;
+    m_child_brains = child_brains;
+}
+
+
+/*
+ *  Moves a chunk's survivors and dead creatures to their output rows,
+ *  writing a tombstone for each of the dead, and creates its newborns,
+ *  born on the current day with their parent's strategy. Survivors and
+ *  newborns are relocated in the slot map; the dead keep their handles
+ *  until release_dead() frees them.
+ */
+
+void Region::LifeCycleTask::commit(const std::size_t chunk) {
+    std::size_t begin;
+    std::size_t end;
+    chunk_range(m_creatures.size(), m_num_chunks, chunk, begin, end);
+
+    std::size_t survivor_pos = m_survivors[chunk];
+    std::size_t dead_pos = m_deaths[chunk];
+    std::size_t birth_offset = m_births[chunk];
+    const std::size_t newborn_base = total_survivors();
+    const std::size_t * strategy_offsets =
+        &m_strategy_births[chunk * c_num_strategies];
+    std::size_t strategy_counts[c_num_strategies] = { 0 };
+
+    CreatureInit child_init = m_offspring_init;
+    std::size_t c = first_candidate(begin);
+    for ( std::size_t i = begin; i < end; ++i ) {
+        Status status = lives;
+        if ( c < m_candidates.size() && m_candidates[c] == i ) {
+            status = static_cast<Status>(m_status[c++]);
+        }
+
+        if ( status == dies ) {
+            (*m_tombstones)[m_tombstone_base + dead_pos] =
+                m_creatures.tombstone(i, m_day);
+            m_dying->move(m_creatures, i, dead_pos++);
+            continue;
+        }
+
+        if ( status == reproduces ) {
+            const CreatureID child_id = m_first_child_id + birth_offset;
+            const std::size_t child = newborn_base + birth_offset;
+            const CreatureHandle handle = (*m_child_handles)[birth_offset];
+            const Strategy strategy = m_creatures.strategy_value(i);
+            Brain * brain = (*m_child_brains)[m_strategy_bases[strategy] +
+                                              strategy_offsets[strategy] +
+                                              strategy_counts[strategy]++];
+            child_init.strategy = strategy;
+            m_new_creatures->create(child, brain, child_init, child_id,
+                                    m_day);
+            m_new_creatures->set_handle(child, handle);
+            m_slots.relocate(handle, slot_location(m_region, child));
+            m_creatures.spend_resources(i, child_init.repro_cost);
+            ++birth_offset;
+        }
+        m_new_creatures->move(m_creatures, i, survivor_pos);
+        m_slots.relocate(m_new_creatures->handle(survivor_pos),
+                         slot_location(m_region, survivor_pos));
+        ++survivor_pos;
+    }
+}
+
+
+/*
+ *  Member function checks the day's pairs for refusals, and rematches
+ *  the creatures of refused pairs, checking only the new pairs each
+ *  round. Pairs still refused after the last round sit the day out.
+ */
+
+void Region::choose_partners(const Day day) {
+    const Matching& matching = m_pairing.matching();
+    m_refused.resize(m_pairing.num_pairs());
+    std::size_t first_pair = 0;
+
+    for ( unsigned int round = 0; ; ++round ) {
+        const std::size_t end_pair = m_pairing.num_pairs();
+        const std::size_t num_chunks = num_chunks_for(end_pair - first_pair,
+                                                      c_games_per_chunk);
+        RefusalTask task(m_creatures, matching, m_refused, first_pair,
+                         end_pair, num_chunks);
+        m_pool.run(task, num_chunks);
+
+        const std::size_t refusals = task.refusals();
+        m_refusals += refusals;
+        if ( refusals == 0 ) {
+            break;
+        } else if ( round == m_rematch_rounds ) {
+            m_pairing.sit_out(m_refused, first_pair);
+            break;
+        }
+        first_pair = m_pairing.rematch(m_refused, first_pair, day, round);
+    }
+
+    m_unmatched_last_day = m_pairing.num_sitting_out();
+    m_unmatched += m_unmatched_last_day;
+}
+
+
+/*
+ *  Member function plays the day's games, or matches, between the
+ *  paired creatures.
+ *
+ *  Single games are played by a GamePipelineTask, one stage at a time.
+ *  With a single thread, matches are played in order. Otherwise they
+ *  are split into chunks and shared out among the thread pool.
+ */
+
+void Region::play_games(const Day day) {
+    const Matching& matching = m_pairing.matching();
+    const std::size_t num_games = m_pairing.num_pairs();
+
+    if ( m_match_rounds == 1 && m_continuation_prob == 0.0 ) {
+        if ( num_games == 0 ) {
+            return;
+        }
+
+        m_moves.resize(2 * num_games);
+        m_results.resize(2 * num_games);
+        m_positions.assign(m_creatures.size(), c_no_position);
+
+        const std::size_t num_chunks = num_chunks_for(num_games,
+                                                      c_games_per_chunk);
+        GamePipelineTask task(m_creatures, matching, num_games, num_chunks,
+                              m_watch.repro_min, move_seed(day),
+                              &m_moves[0], &m_results[0], &m_positions[0]);
+        task.set_stage(GamePipelineTask::gather_stage);
+        m_pool.run(task, num_chunks);
+        task.set_stage(GamePipelineTask::resolve_stage);
+        m_pool.run(task, num_chunks);
+        task.set_stage(GamePipelineTask::scatter_stage);
+        m_pool.run(task, num_chunks);
+        task.merge_watches(m_watch);
+        m_games_played += num_games;
+        return;
+    }
+
+    const uint64_t match_seed = mix_seed(mix_seed(m_seed, c_match_stream),
+                                         day);
+    if ( m_pool.num_threads() == 1 ) {
+        for ( std::size_t game = 0; game < num_games; ++game ) {
+            const std::size_t first = matching[2 * game];
+            const std::size_t second = matching[2 * game + 1];
+            const int first_before = m_creatures.resources(first);
+            const int second_before = m_creatures.resources(second);
+            m_games_played += play_pair(m_creatures, first, second, game,
+                                        m_match_rounds, m_continuation_prob,
+                                        match_seed, move_seed(day));
+            m_watch.note(m_creatures, first, first_before);
+            m_watch.note(m_creatures, second, second_before);
+        }
+    } else {
+        const std::size_t num_chunks = num_chunks_for(num_games,
+                                                      c_games_per_chunk);
+        GamePhaseTask task(m_creatures, matching, num_games, num_chunks,
+                           m_watch.repro_min, m_match_rounds,
+                           m_continuation_prob, match_seed,
+                           move_seed(day));
+        m_pool.run(task, num_chunks);
+        m_games_played += task.games_played();
+        task.merge_watches(m_watch);
+    }
+}
+
+
+/*
+ *  Member function returns the seed from which the random choices of
+ *  the day's single games and matches are drawn.
+ */
+
+uint64_t Region::move_seed(const Day day) const {
+    return mix_seed(mix_seed(m_seed, c_move_stream), day);
+}
+
+
+/*
+ *  Constants used to derive each region's random number streams.
+ *  Regions' seeds are spaced far apart, and migrations use a stream
+ *  number well clear of those used by the pairing.
+ */
+
+namespace {
+    const uint64_t c_region_seed_step = 0x9E3779B97F4A7C15UL;
+    const uint64_t c_migration_stream = 0xFFFFFFFFUL;
+}
+
+
+/*
+ *  Constructor.
+ *
+ *  Arguments:
+ *    wInfo -- the world's settings, including its seed, pairing mode
+ *             and migration rate
+ *    index -- the region's number, from 0
+ *    num_threads -- the number of threads with which to play the
+ *                   region's games and process its deaths and births
+ *    slots -- the World's slot map, in which the region's creatures
+ *             have their handles
+ *    brains -- the World's brain pool, from which the region's
+ *              creatures take their Brains
+ */
+
+Region::Region(const WorldInfo& wInfo, const unsigned int index,
+               const unsigned int num_threads, SlotMap& slots,
+               BrainPool& brains) :
+        m_index(index),
+        m_seed(wInfo.m_seed + index * c_region_seed_step),
+        m_migration_rate(wInfo.m_migration_rate),
+        m_partner_choice(wInfo.m_partner_choice),
+        m_rematch_rounds(wInfo.m_rematch_rounds),
+        m_match_rounds(wInfo.m_match_rounds > 0 ? wInfo.m_match_rounds : 1),
+        m_continuation_prob(wInfo.m_continuation_prob),
+        m_offspring_init(offspring_init(wInfo)),
+        m_slots(slots),
+        m_brains(brains),
+        m_pool(num_threads),
+        m_pairing(m_pool, m_seed, wInfo.m_pairing_mode,
+                  wInfo.m_pairing_block),
+        m_creatures(&brains),
+        m_dead_creatures(),
+        m_next_creatures(&brains),
+        m_inbox(0),
+        m_games_played(0),
+        m_born_creatures(0),
+        m_dead_count(0),
+        m_emigrants(0),
+        m_refusals(0),
+        m_unmatched(0),
+        m_unmatched_last_day(0),
+        m_refused(),
+        m_deaths_due(),
+        m_watch(wInfo.m_repro_min_resources),
+        m_due(),
+        m_candidates(),
+        m_moves(),
+        m_results(),
+        m_positions(),
+        m_child_handles(),
+        m_child_brains(),
+        m_dying(&brains),
+        m_life_cycle() {}
+
+
+/*
+ *  Destructor. Deletes any migrants still waiting in the region's
+ *  inbox. The region's own populations give their creatures' Brains
+ *  back to the pool.
+ */
+
+Region::~Region() {
+    MigrantBatch * batch = m_inbox;
+    while ( batch ) {
+        MigrantBatch * next = batch->next;
+        delete batch;
+        batch = next;
+    }
+}
+
+
+/*
+ *  Plays the day's games, then decides which creatures die and which
+ *  reproduce, checking only the day's candidates. The creature lists
+ *  are not changed until commit_day(), and are left alone if no
+ *  creature dies or reproduces.
+ *
+ *  Arguments:
+ *    day -- the current world day
+ *    deaths_enabled -- true if creatures can die
+ *    repro_day -- true if creatures can reproduce today
+ */
+
+void Region::play_day(const Day day, const bool deaths_enabled,
+                      const bool repro_day) {
+    m_pairing.pair(m_creatures.size(), day);
+    if ( m_partner_choice ) {
+        choose_partners(day);
+    }
+    play_games(day);
+
+    find_candidates(day, deaths_enabled, repro_day);
+    m_life_cycle.reset();
+    if ( m_candidates.empty() ) {
+        return;
+    }
+
+    const std::size_t num_chunks = num_chunks_for(m_creatures.size(),
+                                                  c_creatures_per_chunk);
+    m_life_cycle.reset(new LifeCycleTask(m_creatures, m_candidates,
+                                         num_chunks, day,
+                                         deaths_enabled, repro_day,
+                                         m_offspring_init, m_slots,
+                                         m_index));
+    m_pool.run(*m_life_cycle, num_chunks);
+    m_life_cycle->calculate_offsets();
+    if ( m_life_cycle->total_deaths() == 0 &&
+         m_life_cycle->total_births() == 0 ) {
+        m_life_cycle.reset();
+    }
+}
+
+
+/*
+ *  Returns the number of newborns due from the last call to play_day(),
+ *  for which commit_day() needs a block of IDs.
+ */
+
+std::size_t Region::births() const {
+    return m_life_cycle.get() ? m_life_cycle->total_births() : 0;
+}
+
+
+/*
+ *  Takes a handle from the slot map, and a Brain from the pool, for
+ *  each newborn due from the last call to play_day(). The newborns'
+ *  locations are recorded, and their Brains reset, by commit_day().
+ *  Must not be called by two regions sharing a slot map or pool at
+ *  once.
+ *
+ *  Returns:
+ *    The handles, in the order of the newborns' IDs.
+ */
+
+const HandleList& Region::reserve_newborns() {
+    m_child_handles.clear();
+    m_child_brains.clear();
+    if ( m_life_cycle.get() == 0 ) {
+        return m_child_handles;
+    }
+
+    const LifeCycleTask& task = *m_life_cycle;
+    for ( std::size_t i = 0; i < task.total_births(); ++i ) {
+        m_child_handles.push_back(m_slots.insert(slot_location(m_index, 0)));
+    }
+
+    CreatureInit child_init = m_offspring_init;
+    for ( std::size_t strategy = 0; strategy < c_num_strategies;
+          ++strategy ) {
+        child_init.strategy = static_cast<Strategy>(strategy);
+        for ( std::size_t i = 0; i < task.strategy_births(strategy); ++i ) {
+            m_child_brains.push_back(m_brains.acquire(child_init));
+        }
+    }
+    return m_child_handles;
+}
+
+
+/*
+ *  Records the creatures which died as tombstones, adds
+ *  newborns to the end of the live creatures list, and then sends any
+ *  emigrants to their new regions.
+ *
+ *  Arguments:
+ *    day -- the current world day
+ *    first_child_id -- the first of births() IDs reserved for newborns
+ *    regions -- all of the world's regions, including this one
+ *
+ *  The newborns' handles and Brains must have been taken by
+ *  reserve_newborns().
+ */
+
+void Region::commit_day(const Day day, const CreatureID first_child_id,
+                        vector<Region *>& regions) {
+    if ( m_life_cycle.get() ) {
+        LifeCycleTask& task = *m_life_cycle;
+        const std::size_t births = task.total_births();
+        const std::size_t deaths = task.total_deaths();
+        const std::size_t tombstone_base = m_dead_creatures.size();
+        assert(m_child_handles.size() == births);
+        assert(m_child_brains.size() == births);
+        assert(m_dying.size() == 0);
+
+        HandleList parents;
+        task.parents(parents);
+
+        m_next_creatures.resize(task.total_survivors() + births);
+        m_dying.resize(deaths);
+        m_dead_creatures.resize(tombstone_base + deaths);
+        task.set_outputs(&m_next_creatures, &m_dying, &m_dead_creatures,
+                         tombstone_base, first_child_id, &m_child_handles,
+                         &m_child_brains);
+        task.set_pass(LifeCycleTask::commit_pass);
+        m_pool.run(task, task.num_chunks());
+
+        m_creatures.swap(m_next_creatures);
+        watch_births(parents, task.total_survivors());
+        m_dead_count += deaths;
+        m_born_creatures += births;
+        m_child_handles.clear();
+        m_child_brains.clear();
+        m_life_cycle.reset();
+    }
+
+    if ( m_migration_rate > 0 && regions.size() > 1 ) {
+        send_emigrants(day, regions);
+    }
+}
+
+
+/*
+ *  Picks each live creature to emigrate with probability equal to the
+ *  migration rate, to a uniformly chosen other region. Stayers are
+ *  compacted towards the front of the list in a single pass, and the
+ *  emigrants are posted to their new regions in one batch per region.
+ */
+
+void Region::send_emigrants(const Day day, vector<Region *>& regions) {
+    Rng rng(mix_seed(m_seed, day), c_migration_stream);
+    const uint32_t other_regions = static_cast<uint32_t>(regions.size() - 1);
+    vector<MigrantBatch *> outgoing(regions.size(),
+                                    static_cast<MigrantBatch *>(0));
+
+    std::size_t stayers = 0;
+    for ( std::size_t i = 0; i < m_creatures.size(); ++i ) {
+        if ( rng.uniform() >= m_migration_rate ) {
+            m_creatures.move(m_creatures, i, stayers);
+            m_slots.relocate(m_creatures.handle(stayers),
+                             slot_location(m_index, stayers));
+            ++stayers;
+            continue;
+        }
+
+        uint32_t destination = rng.below(other_regions);
+        if ( destination >= m_index ) {
+            ++destination;
+        }
+        if ( outgoing[destination] == 0 ) {
+            outgoing[destination] = new MigrantBatch(&m_brains);
+            outgoing[destination]->source = m_index;
+        }
+        outgoing[destination]->creatures.append(m_creatures, i);
+    }
+    m_creatures.resize(stayers);
+
+    for ( std::size_t destination = 0; destination < regions.size();
+          ++destination ) {
+        if ( outgoing[destination] ) {
+            m_emigrants += outgoing[destination]->creatures.size();
+            regions[destination]->post(outgoing[destination]);
+        }
+    }
+}
+
+
+/*
+ *  Frees the handles of the creatures which died in the last call to
+ *  commit_day(), gives their Brains back to the pool, and discards
+ *  their rows, leaving only their tombstones. Must not be called by two
+ *  regions sharing a slot map or pool at once.
+ */
+
+void Region::release_dead() {
+    for ( std::size_t i = 0; i < m_dying.size(); ++i ) {
+        m_slots.erase(m_dying.handle(i));
+        m_dying.release_brain(i);
+    }
+    m_dying.resize(0);
+}
+
+
+/*
+ *  Pushes a batch of migrants onto the region's inbox. Safe to call
+ *  from several threads at once.
+ */
+
+void Region::post(MigrantBatch * batch) {
+    MigrantBatch * head;
+    do {
+        head = m_inbox;
+        batch->next = head;
+    } while ( !__sync_bool_compare_and_swap(&m_inbox, head, batch) );
+}
+
+
+/*
+ *  Takes every batch from the inbox and adds their migrants to the end
+ *  of the live creatures list, in order of their source regions, and
+ *  records their new locations in the slot map.
+ */
+
+void Region::admit_immigrants() {
+    MigrantBatch * batch = __sync_lock_test_and_set(&m_inbox,
+                                        static_cast<MigrantBatch *>(0));
+    if ( batch == 0 ) {
+        return;
+    }
+
+    vector<MigrantBatch *> batches;
+    for ( ; batch != 0; batch = batch->next ) {
+        batches.push_back(batch);
+    }
+    std::sort(batches.begin(), batches.end(), earlier_source);
+
+    for ( vector<MigrantBatch *>::iterator itr = batches.begin();
+          itr != batches.end(); ++itr ) {
+        const std::size_t first = m_creatures.size();
+        m_creatures.append((*itr)->creatures);
+        delete *itr;
+        for ( std::size_t i = first; i < m_creatures.size(); ++i ) {
+            m_slots.relocate(m_creatures.handle(i),
+                             slot_location(m_index, i));
+            track(i);
+        }
+    }
+}
+
+
+/*
+ *  Returns true if the first batch came from a lower-numbered region
+ *  than the second.
+ */
+
+bool Region::earlier_source(const MigrantBatch * first,
+                            const MigrantBatch * second) {
+    return first->source < second->source;
+}
+
+
+/*
+ *  Moves a creature from another population to the end of the live
+ *  creatures, and gives it a handle in the slot map.
+ */
+
+void Region::add_creature(Population& source, const std::size_t index) {
+    const std::size_t row = m_creatures.size();
+    m_creatures.append(source, index);
+    m_creatures.set_handle(row, m_slots.insert(slot_location(m_index, row)));
+    track(row);
+}
+
+
+/*
+ *  Schedules the death of old age of a creature which has just arrived
+ *  in the region, on the day after its life expectancy runs out, and
+ *  notes it if it has no resources, or enough to reproduce.
+ */
+
+void Region::track(const std::size_t row) {
+    m_deaths_due.schedule(m_creatures.birth_day(row) +
+                          m_creatures.life_expectancy(row) + 1,
+                          m_creatures.handle(row));
+    m_watch.note(m_creatures, row);
+}
+
+
+/*
+ *  Finds the rows of the day's candidates for death or reproduction,
+ *  in order: if deaths are enabled, those due to die of old age and
+ *  those noted as having no resources, and on reproduction days, those
+ *  noted as having enough resources to reproduce. Every creature which
+ *  could die or reproduce is among them, since resources change only
+ *  in games, when creatures reproduce, and when they arrive.
+ */
+
+void Region::find_candidates(const Day day, const bool deaths_enabled,
+                             const bool repro_day) {
+    m_candidates.clear();
+    m_due.clear();
+    m_deaths_due.take(day, m_due);
+    if ( deaths_enabled ) {
+        add_candidates(m_due);
+        add_candidates(m_watch.starving);
+    }
+    m_watch.starving.clear();
+
+    if ( repro_day ) {
+        add_candidates(m_watch.repro_candidates);
+        m_watch.repro_candidates.clear();
+    } else if ( m_watch.repro_candidates.size() > 2 * m_creatures.size() ) {
+        prune_repro_candidates();
+    }
+
+    std::sort(m_candidates.begin(), m_candidates.end());
+    m_candidates.erase(std::unique(m_candidates.begin(), m_candidates.end()),
+                       m_candidates.end());
+}
+
+
+/*
+ *  Adds the rows of the creatures with the specified handles to the
+ *  day's candidates, skipping those which have died or left the region
+ *  since they were noted.
+ */
+
+void Region::add_candidates(const HandleList& handles) {
+    for ( std::size_t i = 0; i < handles.size(); ++i ) {
+        if ( m_slots.contains(handles[i]) ) {
+            const SlotLocation location = m_slots.location(handles[i]);
+            if ( location.region == m_index ) {
+                m_candidates.push_back(location.row);
+            }
+        }
+    }
+}
+
+
+/*
+ *  Drops the creatures noted as having enough resources to reproduce
+ *  which have died, left the region, or fallen below the minimum since,
+ *  and any noted more than once, so the list stays no longer than the
+ *  region while there is no reproduction day.
+ */
+
+void Region::prune_repro_candidates() {
+    HandleList& handles = m_watch.repro_candidates;
+    std::sort(handles.begin(), handles.end());
+    handles.erase(std::unique(handles.begin(), handles.end()),
+                  handles.end());
+
+    std::size_t kept = 0;
+    for ( std::size_t i = 0; i < handles.size(); ++i ) {
+        if ( m_slots.contains(handles[i]) ) {
+            const SlotLocation location = m_slots.location(handles[i]);
+            if ( location.region == m_index &&
+                 m_creatures.resources(location.row) >= m_watch.repro_min ) {
+                handles[kept++] = handles[i];
+            }
+        }
+    }
+    handles.resize(kept);
+}
+
+
+/*
+ *  Notes the day's parents, whose resources have changed, and tracks
+ *  the newborns, which follow the survivors in the live creatures list.
+ */
+
+void Region::watch_births(const HandleList& parents,
+                          const std::size_t first_child) {
+    for ( std::size_t i = 0; i < parents.size(); ++i ) {
+        m_watch.note(m_creatures, m_slots.location(parents[i]).row);
+    }
+    for ( std::size_t row = first_child; row < m_creatures.size(); ++row ) {
+        track(row);
+    }
+}
+
+
+/*
+ *  Notes a creature with no resources left, or with enough resources
+ *  to reproduce.
+ */
+
+void Region::ResourceWatch::note(const Population& creatures,
+                                 const std::size_t row) {
+    const int resources = creatures.resources(row);
+    if ( resources <= 0 ) {
+        starving.push_back(creatures.handle(row));
+    }
+    if ( resources >= repro_min ) {
+        repro_candidates.push_back(creatures.handle(row));
+    }
+}
+
+
+/*
+ *  Notes a creature whose resources have just changed from the
+ *  specified amount, if it has no resources left, or if it has just
+ *  reached the minimum to reproduce. A creature which already had
+ *  enough to reproduce was noted when it reached the minimum.
+ */
+
+void Region::ResourceWatch::note(const Population& creatures,
+                                 const std::size_t row, const int before) {
+    const int resources = creatures.resources(row);
+    if ( resources <= 0 ) {
+        starving.push_back(creatures.handle(row));
+    }
+    if ( resources >= repro_min && before < repro_min ) {
+        repro_candidates.push_back(creatures.handle(row));
+    }
+}
+
+
+/*
+ *  Moves the creatures noted by another ResourceWatch to the end of
+ *  this one's lists.
+ */
+
+void Region::ResourceWatch::merge(ResourceWatch& other) {
+    starving.insert(starving.end(), other.starving.begin(),
+                    other.starving.end());
+    repro_candidates.insert(repro_candidates.end(),
+                            other.repro_candidates.begin(),
+                            other.repro_candidates.end());
+    other.starving.clear();
+    other.repro_candidates.clear();
+}
+
+
+/*
+ *  Return the region's live creatures and the tombstones of its dead.
+ */
+
+const Population& Region::creatures() const {
+    return m_creatures;
+}
+
+const TombstoneList& Region::dead_creatures() const {
+    return m_dead_creatures;
+}
+
+
+/*
+ *  Return the region's running totals.
+ */
+
+unsigned long Region::games_played() const {
+    return m_games_played;
+}
+
+unsigned long Region::born_creatures() const {
+    return m_born_creatures;
+}
+
+unsigned long Region::dead_count() const {
+    return m_dead_count;
+}
+
+unsigned long Region::emigrants() const {
+    return m_emigrants;
+}
+
+unsigned long Region::refusals() const {
+    return m_refusals;
+}
+
+unsigned long Region::unmatched() const {
+    return m_unmatched;
+}
+
+
+/*
+ *  Returns the number of creatures which did not play on the last day,
+ *  including any creature left over from an odd number.
+ */
+
+std::size_t Region::unmatched_last_day() const {
+    return m_unmatched_last_day;
+}
@@ -0,0 +1,316 @@
+/*
+ *  region.h
+ *  ========
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Interface to Region class for Prisoner's Dilemma simulation.
+ *
+ *  A Region is one geographical area of a World. Each region has its
+ *  own list of live creatures, held as a Population (see population.h),
+ *  its own list of tombstones for the creatures which have died in it,
+ *  and its own daily pairing, and creatures only play
+ *  games against other creatures in the same region. At the end of
+ *  each day, each creature may migrate to a uniformly chosen other
+ *  region with a fixed probability.
+ *
+ *  A region shares nothing with other regions during a day, so a World
+ *  advances all its regions in parallel, one region per thread, in
+ *  three phases separated by barriers:
+ *
+ *   - play_day() pairs the region's creatures and plays the day's
+ *     games, then ages the creatures and decides which of them die and
+ *     which reproduce, without yet changing the creature lists.
+ *
+ *   - commit_day() records the dead as tombstones, adds the
+ *     newborns to the end of the live creatures list, and then picks
+ *     the day's emigrants and posts them to the inboxes of the regions
+ *     they are moving to. Between the two phases, the World reserves
+ *     each region's block of IDs for newborns in region order, so that
+ *     creature IDs do not depend on the order in which regions run.
+ *
+ *   - admit_immigrants() adds the creatures posted to the region's
+ *     inbox to the end of its live creatures list.
+ *
+ *  Every live creature has a handle in the World's slot map (see
+ *  slot_map.h), and the region records each creature's new row in the
+ *  slot map whenever it moves, in the same passes which move it. Each
+ *  creature's Brain comes from the World's brain pool (see
+ *  brain_pool.h). The slot map and the pool are shared by all regions,
+ *  so the handles and Brains for a day's newborns are taken, and those
+ *  of the day's dead are given back, by reserve_newborns() and
+ *  release_dead(), which the World calls for each region in turn
+ *  either side of commit_day(). The commit pass writes each dead
+ *  creature's tombstone and moves its row aside, and release_dead()
+ *  then gives its Brain back to the pool, for later newborns of the
+ *  same strategy, and discards the row. The Brains
+ *  for the newborns are taken in order of strategy, and the counts of
+ *  births of each strategy in each chunk tell the commit pass which
+ *  Brain each newborn gets.
+ *
+ *  Each inbox is a lock-free stack of batches of migrants, one batch
+ *  per source region, pushed with a compare-and-swap, so regions can
+ *  post migrants to each other at the same time without locking.
+ *  admit_immigrants() sorts the batches by source region before adding
+ *  them, so the resulting list does not depend on the order in which
+ *  they arrived.
+ *
+ *  The day's deaths and births are found without checking every
+ *  creature. Each creature's death of old age is scheduled, by its
+ *  handle, in a calendar queue (see calendar.h) when it arrives in the
+ *  region, on the day after its life expectancy runs out. The games
+ *  note each creature whose resources have run out, and each whose
+ *  resources have just reached the minimum to reproduce, and the latter
+ *  are kept until the next reproduction day. play_day() checks only the
+ *  creatures due from the calendar and noted since they were last
+ *  checked, with the same tests as before, and a day with no deaths or
+ *  births leaves the creature lists alone.
+ *
+ *  With partner choice, each creature refuses to play a partner which
+ *  defected against it the last time they met. After pairing, play_day()
+ *  checks every pair in parallel and has the pairing rematch the refused
+ *  pairs, checking only the new pairs each time, for a bounded number of
+ *  rounds. Pairs still refused after the last round sit the day out.
+ *  The number of creatures left unmatched is recorded each day.
+ *
+ *  Each pair can instead play a match of several games, either a fixed
+ *  number or a number drawn from a geometric distribution, so that each
+ *  game is followed by another with a fixed probability. The matches
+ *  are played with play_match() (see game.h), and count as that many
+ *  games played.
+ *
+ *  When each pair plays a single game, the day's games are played in
+ *  three stages over all the pairs at once: gather collects every
+ *  creature's move into an array, resolve looks up the results of all
+ *  the games in a table of payoffs, and scatter gives each creature its
+ *  game in order of rows. Each stage is shared out among the thread
+ *  pool on its own, and the results are the same as from play_game().
+ *
+ *  Each region draws its pairings, migrations, match lengths and the
+ *  random moves of its games and matches from its own random number
+ *  streams, derived from the world seed and the region number, so a
+ *  run with a given seed is repeatable whatever the number of threads.
+ *  Region 0 uses the world seed itself, so a single-region world pairs
+ *  creatures exactly as a World did before regions were added.
+ *
+ *  Public member functions:
+ *    play_day() - plays the day's games, ages the region's creatures
+ *                 and decides which die and which reproduce.
+ *
+ *    births() - returns the number of newborns due from the last
+ *               call to play_day().
+ *
+ *    reserve_newborns() - takes handles and Brains for the newborns due
+ *                         from the last call to play_day(), and returns
+ *                         the handles in the order of the newborns' IDs.
+ *
+ *    release_dead() - frees the handles, and gives back the Brains, of
+ *                     the creatures which died in the last call to
+ *                     commit_day().
+ *
+ *    commit_day() - processes the deaths and births decided by the last
+ *                   call to play_day(), and sends off emigrants.
+ *
+ *    admit_immigrants() - adds the creatures in the region's inbox to
+ *                         its live creatures list.
+ *
+ *    add_creature() - moves a creature from another population to the
+ *                     region's live creatures list and gives it a
+ *                     handle, used to give the region its starting
+ *                     population.
+ *
+ *    creatures(), dead_creatures() - return the region's live creatures
+ *                                    and the tombstones of its dead.
+ *
+ *    games_played(), born_creatures(), dead_count(), emigrants(),
+ *    refusals(), unmatched()
+ *        - return the region's running totals since it was created.
+ *
+ *    unmatched_last_day() - returns the number of creatures which did
+ *                           not play on the last day.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#ifndef PG_PRIDIL_REGION_H
+#define PG_PRIDIL_REGION_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <stdint.h>
+#include "pridil_common.h"
+#include "creature.h"
+#include "population.h"
+#include "slot_map.h"
+#include "brain_pool.h"
+#include "thread_pool.h"
+#include "pairing.h"
+#include "calendar.h"
+
+namespace pridil {
+
+class Region {
+    public:
+
+        //  Constructor and destructor
+
+        Region(const WorldInfo& wInfo, const unsigned int index,
+               const unsigned int num_threads, SlotMap& slots,
+               BrainPool& brains);
+        ~Region();
+
+        //  Methods to advance the region through a day
+
+        void play_day(const Day day, const bool deaths_enabled,
+                      const bool repro_day);
+        std::size_t births() const;
+        const HandleList& reserve_newborns();
+        void commit_day(const Day day, const CreatureID first_child_id,
+                        std::vector<Region *>& regions);
+        void release_dead();
+        void admit_immigrants();
+
+        //  Methods to add and access creatures
+
+        void add_creature(Population& source, const std::size_t index);
+        const Population& creatures() const;
+        const TombstoneList& dead_creatures() const;
+
+        //  Methods to access running totals
+
+        unsigned long games_played() const;
+        unsigned long born_creatures() const;
+        unsigned long dead_count() const;
+        unsigned long emigrants() const;
+        unsigned long refusals() const;
+        unsigned long unmatched() const;
+        std::size_t unmatched_last_day() const;
+
+    private:
+
+        //  Creatures noted, by their handles, as having no resources
+        //  left, or as having enough resources to reproduce
+
+        struct ResourceWatch {
+            int repro_min;
+            HandleList starving;
+            HandleList repro_candidates;
+
+            explicit ResourceWatch(const int min_resources) :
+                repro_min(min_resources), starving(), repro_candidates() {}
+
+            void note(const Population& creatures, const std::size_t row);
+            void note(const Population& creatures, const std::size_t row,
+                      const int before);
+            void merge(ResourceWatch& other);
+        };
+
+        //  A batch of migrants posted to an inbox by one region
+
+        struct MigrantBatch {
+            unsigned int source;
+            Population creatures;
+            MigrantBatch * next;
+
+            explicit MigrantBatch(BrainPool * pool) :
+                source(0), creatures(pool), next(0) {}
+
+            private:
+                MigrantBatch(const MigrantBatch&);
+                MigrantBatch& operator=(const MigrantBatch&);
+        };
+
+        const unsigned int m_index;
+        const uint64_t m_seed;
+        const double m_migration_rate;
+        const bool m_partner_choice;
+        const unsigned int m_rematch_rounds;
+        const unsigned int m_match_rounds;
+        const double m_continuation_prob;
+        const CreatureInit m_offspring_init;
+        SlotMap& m_slots;
+        BrainPool& m_brains;
+        ThreadPool m_pool;
+        Pairing m_pairing;
+        Population m_creatures;
+        TombstoneList m_dead_creatures;
+
+        //  The live creatures list being built by commit_day(), kept
+        //  between days to save reallocating it
+
+        Population m_next_creatures;
+        MigrantBatch * volatile m_inbox;
+
+        unsigned long m_games_played;
+        unsigned long m_born_creatures;
+        unsigned long m_dead_count;
+        unsigned long m_emigrants;
+        unsigned long m_refusals;
+        unsigned long m_unmatched;
+        std::size_t m_unmatched_last_day;
+
+        //  Per pair refusal flags, kept between days to save
+        //  reallocating them.
+
+        std::vector<unsigned char> m_refused;
+
+        //  Creatures due to die of old age, by day, creatures noted by
+        //  the games and by commit_day(), and the rows of the day's
+        //  candidates for death or reproduction, kept between days to
+        //  save reallocating them
+
+        Calendar m_deaths_due;
+        ResourceWatch m_watch;
+        HandleList m_due;
+        std::vector<std::size_t> m_candidates;
+
+        //  The moves and results of the day's single games, two per
+        //  game, and the position in the matching of each row, kept
+        //  between days to save reallocating them
+
+        std::vector<GameMove> m_moves;
+        std::vector<int> m_results;
+        std::vector<std::size_t> m_positions;
+
+        //  Handles and Brains taken for the day's newborns, and the
+        //  rows of the day's dead, kept until their handles and Brains
+        //  have been given back
+
+        HandleList m_child_handles;
+        BrainList m_child_brains;
+        Population m_dying;
+
+        //  Parallel tasks used within the region, and the life cycle
+        //  task kept from play_day() until commit_day().
+
+        class GamePhaseTask;
+        class GamePipelineTask;
+        class RefusalTask;
+        class LifeCycleTask;
+        std::auto_ptr<LifeCycleTask> m_life_cycle;
+
+        void choose_partners(const Day day);
+        void play_games(const Day day);
+        uint64_t move_seed(const Day day) const;
+        void track(const std::size_t row);
+        void find_candidates(const Day day, const bool deaths_enabled,
+                             const bool repro_day);
+        void add_candidates(const HandleList& handles);
+        void prune_repro_candidates();
+        void watch_births(const HandleList& parents,
+                          const std::size_t first_child);
+        void send_emigrants(const Day day, std::vector<Region *>& regions);
+        void post(MigrantBatch * batch);
+        static bool earlier_source(const MigrantBatch * first,
+                                   const MigrantBatch * second);
+
+        Region(const Region&);              // Prevent copying
+        Region& operator=(const Region&);   // Prevent assignment
+};
+
+}       //  namespace pridil
+
+#endif      // PG_PRIDIL_REGION_H
@@ -0,0 +1,488 @@
+/*
+ *  replicates.cpp
+ *  ==============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Implementation of Replicates class for Prisoners' Dilemma
+ *  simulation.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <ctime>
+#include <stdint.h>
+#include "pridil_common.h"
+#include "replicates.h"
+#include "creature.h"
+#include "game.h"
+
+using std::endl;
+using std::ostream;
+using std::vector;
+
+using namespace pridil;
+
+
+/*
+ *  Number of strategies, for words kept by strategy, and number of
+ *  bits in a creature's resources.
+ */
+
+namespace {
+    const std::size_t c_num_strategies = always_defect + 1;
+    const std::size_t c_resource_bits = 32;
+
+    const uint64_t c_no_lanes = 0;
+    const uint64_t c_all_lanes = ~c_no_lanes;
+
+
+    /*
+     *  Returns the number of birth-death steps in a day, for a
+     *  population of the specified size, as for a Moran.
+     */
+
+    std::size_t steps_per_day(const std::size_t size,
+                              const Day repro_cycle_days) {
+        const std::size_t cycle = repro_cycle_days > 0 ?
+                                  repro_cycle_days : 1;
+        const std::size_t steps = size / cycle;
+        return steps > 0 ? steps : 1;
+    }
+
+
+    /*
+     *  Returns the word with only a replicate's bit set.
+     */
+
+    uint64_t lane(const std::size_t replicate) {
+        return static_cast<uint64_t>(1) << replicate;
+    }
+
+
+    /*
+     *  Returns the starting strategies, throwing NondeterministicStrategy
+     *  if there are any strategies whose moves are not determined by
+     *  their memories.
+     */
+
+    vector<Strategy> starting_strategies(const WorldInfo& wInfo) {
+        if ( wInfo.m_random_strategy > 0 || wInfo.m_naive_prober > 0 ) {
+            throw NondeterministicStrategy();
+        }
+
+        vector<Strategy> strategies;
+        starting_population(wInfo, strategies);
+        return strategies;
+    }
+}
+
+
+/*
+ *  Constructor. Places the starting creatures of each strategy in a
+ *  different random order in each replicate, with the starting
+ *  resources and no memories, and works out the words to add to
+ *  resources for the result of each pair of moves.
+ *
+ *  Arguments:
+ *    wInfo -- the starting population, starting resources,
+ *             reproduction characteristics and seed, as for a World
+ *
+ *  Throws NondeterministicStrategy if there are random strategy or
+ *  naive prober creatures.
+ */
+
+Replicates::Replicates(const WorldInfo& wInfo) :
+        m_size(starting_strategies(wInfo).size()),
+        m_steps_per_day(steps_per_day(m_size, wInfo.m_repro_cycle_days)),
+        m_repro_cost(wInfo.m_repro_cost),
+        m_disable_repro(wInfo.m_disable_repro),
+        m_day(1),
+        m_games_played(0),
+        m_births(0),
+        m_rng(seed_or_time(wInfo.m_seed)),
+        m_replicate_rngs(),
+        m_order(),
+        m_strategies(c_num_strategies * m_size, c_no_lanes),
+        m_met(m_size * m_size, c_no_lanes),
+        m_last_defect(m_size * m_size, c_no_lanes),
+        m_prev_defect(m_size * m_size, c_no_lanes),
+        m_resources(m_size * c_resource_bits, c_no_lanes),
+        m_strategy_names(strategy_names()) {
+
+    //  Place the creatures, each replicate shuffling them with its own
+    //  random number stream
+
+    const vector<Strategy> strategies = starting_strategies(wInfo);
+    for ( std::size_t r = 0; r < num_replicates; ++r ) {
+        m_replicate_rngs.push_back(Rng(seed_or_time(wInfo.m_seed), r + 1));
+        Rng& rng = m_replicate_rngs.back();
+
+        vector<Strategy> placed(strategies);
+        for ( std::size_t i = placed.size(); i > 1; --i ) {
+            const std::size_t j = rng.below(static_cast<uint32_t>(i));
+            std::swap(placed[i - 1], placed[j]);
+        }
+        for ( std::size_t i = 0; i < m_size; ++i ) {
+            set_strategy(r, i, placed[i]);
+        }
+    }
+
+    //  Every creature starts with the same resources in every replicate
+
+    const uint32_t start = static_cast<uint32_t>(
+                               wInfo.m_default_starting_resources);
+    for ( std::size_t i = 0; i < m_size; ++i ) {
+        for ( std::size_t b = 0; b < c_resource_bits; ++b ) {
+            m_resources[i * c_resource_bits + b] =
+                ((start >> b) & 1) ? c_all_lanes : c_no_lanes;
+        }
+    }
+
+    //  Take each result from game_result(), and each bit of it, in two's
+    //  complement, as a word to select by the moves
+
+    int payoffs[2][2];
+    payoff_table(payoffs);
+    for ( int own = 0; own < 2; ++own ) {
+        for ( int other = 0; other < 2; ++other ) {
+            const uint32_t result = static_cast<uint32_t>(payoffs[own][other]);
+            for ( std::size_t b = 0; b < c_resource_bits; ++b ) {
+                m_payoff_bits[b][own][other] =
+                    ((result >> b) & 1) ? c_all_lanes : c_no_lanes;
+            }
+        }
+    }
+}
+
+
+/*
+ *  Destructor.
+ */
+
+Replicates::~Replicates() {}
+
+
+/*
+ *  Advances the replicates by one day. The creatures are shuffled and
+ *  paired off in turn, with the same pairs in every replicate, and if
+ *  the number of creatures is odd, one sits the day out. Each pair's
+ *  game is played in all the replicates at once, and each replicate
+ *  then takes its birth-death steps, unless reproduction is disabled.
+ */
+
+void Replicates::advance_day() {
+    m_order.resize(m_size);
+    for ( std::size_t i = 0; i < m_size; ++i ) {
+        const std::size_t j = m_rng.below(static_cast<uint32_t>(i + 1));
+        m_order[i] = m_order[j];
+        m_order[j] = i;
+    }
+
+    for ( std::size_t i = 0; i + 1 < m_size; i += 2 ) {
+        const std::size_t first = m_order[i];
+        const std::size_t second = m_order[i + 1];
+        const uint64_t first_moves = get_moves(first, second);
+        const uint64_t second_moves = get_moves(second, first);
+
+        add_results(first, first_moves, second_moves);
+        add_results(second, second_moves, first_moves);
+        remember(first, second, second_moves);
+        remember(second, first, first_moves);
+        ++m_games_played;
+    }
+
+    if ( !m_disable_repro && m_size > 0 ) {
+        for ( std::size_t r = 0; r < num_replicates; ++r ) {
+            for ( std::size_t i = 0; i < m_steps_per_day; ++i ) {
+                step(r);
+            }
+        }
+        m_births += m_steps_per_day;
+    }
+    ++m_day;
+}
+
+
+/*
+ *  Returns the current day.
+ */
+
+Day Replicates::day() const {
+    return m_day;
+}
+
+
+/*
+ *  Returns the number of creatures in each replicate.
+ */
+
+std::size_t Replicates::size() const {
+    return m_size;
+}
+
+
+/*
+ *  Returns the strategy of a creature in a replicate.
+ */
+
+Strategy Replicates::strategy(const std::size_t replicate,
+                              const std::size_t creature) const {
+    for ( std::size_t s = 0; s < c_num_strategies; ++s ) {
+        if ( m_strategies[s * m_size + creature] & lane(replicate) ) {
+            return static_cast<Strategy>(s);
+        }
+    }
+    throw UnknownStrategy();
+}
+
+
+/*
+ *  Returns the resources of a creature in a replicate, gathering its
+ *  bit from each of the creature's resources words.
+ */
+
+int Replicates::resources(const std::size_t replicate,
+                          const std::size_t creature) const {
+    const uint64_t* const words = &m_resources[creature * c_resource_bits];
+    uint32_t value = 0;
+    for ( std::size_t b = 0; b < c_resource_bits; ++b ) {
+        value |= static_cast<uint32_t>((words[b] >> replicate) & 1) << b;
+    }
+    return static_cast<int>(value);
+}
+
+
+/*
+ *  Returns the number of creatures of a strategy in a replicate.
+ */
+
+std::size_t Replicates::count(const std::size_t replicate,
+                              const Strategy strategy) const {
+    std::size_t number = 0;
+    for ( std::size_t i = 0; i < m_size; ++i ) {
+        if ( m_strategies[strategy * m_size + i] & lane(replicate) ) {
+            ++number;
+        }
+    }
+    return number;
+}
+
+
+/*
+ *  Returns the order in which the creatures were paired on the last
+ *  day, the first and second creatures playing each other, and so on.
+ */
+
+const vector<std::size_t>& Replicates::pairing() const {
+    return m_order;
+}
+
+
+/*
+ *  Returns the number of replicates in which every creature has the
+ *  specified strategy.
+ */
+
+std::size_t Replicates::fixed_replicates(const Strategy strategy) const {
+    uint64_t fixed = c_all_lanes;
+    for ( std::size_t i = 0; i < m_size; ++i ) {
+        fixed &= m_strategies[strategy * m_size + i];
+    }
+
+    std::size_t number = 0;
+    for ( ; fixed != 0; fixed &= fixed - 1 ) {
+        ++number;
+    }
+    return m_size > 0 ? number : 0;
+}
+
+
+/*
+ *  Member function outputs summary statistics, with the number of
+ *  replicates which each strategy has taken over.
+ *
+ *  Arguments: reference to a ostream object to which to output.
+ */
+
+void Replicates::output_replicate_stats(ostream& out) const {
+    out << "Summary replicate statistics:" << endl
+        << "Replicates: " << num_replicates << endl
+        << "Days passed: " << m_day - 1 << endl
+        << "Creatures per replicate: " << m_size << endl
+        << "Games played per replicate: " << m_games_played << endl
+        << "Births per replicate: " << m_births << endl;
+
+    for ( std::size_t s = 0; s < c_num_strategies; ++s ) {
+        const std::size_t fixed = fixed_replicates(static_cast<Strategy>(s));
+        if ( fixed > 0 ) {
+            out << "Fixed strategy: " << m_strategy_names[s] << " in "
+                << fixed << " of " << num_replicates << " replicates"
+                << endl;
+        }
+    }
+    out << endl;
+}
+
+
+/*
+ *  Returns a creature's moves against a partner in every replicate,
+ *  with a bit set where it defects, following the genes'
+ *  get_game_move() functions. The last and previous defection words
+ *  are clear wherever the creature has not met the partner, so tit
+ *  for tat and tit for two tats cooperate with strangers, and tit for
+ *  two tats cooperates after only one game.
+ */
+
+uint64_t Replicates::get_moves(const std::size_t creature,
+                               const std::size_t partner) const {
+    const std::size_t pair = creature * m_size + partner;
+    const uint64_t last = m_last_defect[pair];
+
+    return m_strategies[always_defect * m_size + creature] |
+           (m_strategies[tit_for_tat * m_size + creature] & last) |
+           (m_strategies[susp_tit_for_tat * m_size + creature] &
+                (~m_met[pair] | last)) |
+           (m_strategies[tit_for_two_tats * m_size + creature] &
+                last & m_prev_defect[pair]);
+}
+
+
+/*
+ *  Adds a creature's results from a game to its resources in every
+ *  replicate. The words of the result for each pair of moves are
+ *  selected by the moves, and added to the resources words bit by bit,
+ *  carrying into the next bit, as an adder circuit does.
+ */
+
+void Replicates::add_results(const std::size_t creature, const uint64_t own,
+                             const uint64_t other) {
+    const uint64_t both_coop = ~own & ~other;
+    const uint64_t sucker = ~own & other;
+    const uint64_t temptation = own & ~other;
+    const uint64_t both_defect = own & other;
+
+    uint64_t* const words = &m_resources[creature * c_resource_bits];
+    uint64_t carry = c_no_lanes;
+    for ( std::size_t b = 0; b < c_resource_bits; ++b ) {
+        const uint64_t addend = (both_coop & m_payoff_bits[b][0][0]) |
+                                (sucker & m_payoff_bits[b][0][1]) |
+                                (temptation & m_payoff_bits[b][1][0]) |
+                                (both_defect & m_payoff_bits[b][1][1]);
+        const uint64_t half_sum = words[b] ^ addend;
+        const uint64_t new_carry = (words[b] & addend) | (carry & half_sum);
+        words[b] = half_sum ^ carry;
+        carry = new_carry;
+    }
+}
+
+
+/*
+ *  Remembers a partner's moves in every replicate, keeping the last
+ *  two games against it.
+ */
+
+void Replicates::remember(const std::size_t creature,
+                          const std::size_t partner,
+                          const uint64_t partner_moves) {
+    const std::size_t pair = creature * m_size + partner;
+    m_prev_defect[pair] = m_last_defect[pair];
+    m_last_defect[pair] = partner_moves;
+    m_met[pair] = c_all_lanes;
+}
+
+
+/*
+ *  Takes one birth-death step in a replicate, as a Moran does. The
+ *  parent is chosen with probability proportional to its resources, or
+ *  uniformly if no creature has any, and pays the cost of reproducing,
+ *  and the newborn takes the place of a uniformly chosen creature, with
+ *  the parent's strategy, the cost as its resources, and no memories,
+ *  nor any place in the other creatures' memories.
+ */
+
+void Replicates::step(const std::size_t replicate) {
+    Rng& rng = m_replicate_rngs[replicate];
+
+    vector<unsigned long> weights(m_size);
+    unsigned long total = 0;
+    for ( std::size_t i = 0; i < m_size; ++i ) {
+        const int res = resources(replicate, i);
+        weights[i] = res > 0 ? static_cast<unsigned long>(res) : 0;
+        total += weights[i];
+    }
+
+    std::size_t parent = 0;
+    if ( total > 0 ) {
+        unsigned long point = static_cast<unsigned long>(
+                                  rng.uniform() * total);
+        while ( point >= weights[parent] ) {
+            point -= weights[parent];
+            ++parent;
+        }
+    } else {
+        parent = rng.below(static_cast<uint32_t>(m_size));
+    }
+    const std::size_t dying = rng.below(static_cast<uint32_t>(m_size));
+
+    const Strategy child_strategy = strategy(replicate, parent);
+    set_resources(replicate, parent,
+                  resources(replicate, parent) - m_repro_cost);
+    set_resources(replicate, dying, m_repro_cost);
+    set_strategy(replicate, dying, child_strategy);
+
+    const uint64_t keep = ~lane(replicate);
+    for ( std::size_t j = 0; j < m_size; ++j ) {
+        m_met[dying * m_size + j] &= keep;
+        m_last_defect[dying * m_size + j] &= keep;
+        m_prev_defect[dying * m_size + j] &= keep;
+        m_met[j * m_size + dying] &= keep;
+        m_last_defect[j * m_size + dying] &= keep;
+        m_prev_defect[j * m_size + dying] &= keep;
+    }
+}
+
+
+/*
+ *  Sets the resources of a creature in a replicate, scattering its
+ *  bits to the creature's resources words.
+ */
+
+void Replicates::set_resources(const std::size_t replicate,
+                               const std::size_t creature,
+                               const int value) {
+    uint64_t* const words = &m_resources[creature * c_resource_bits];
+    const uint32_t bits = static_cast<uint32_t>(value);
+    for ( std::size_t b = 0; b < c_resource_bits; ++b ) {
+        if ( (bits >> b) & 1 ) {
+            words[b] |= lane(replicate);
+        } else {
+            words[b] &= ~lane(replicate);
+        }
+    }
+}
+
+
+/*
+ *  Sets the strategy of a creature in a replicate, clearing its bit in
+ *  the creature's other strategy words.
+ */
+
+void Replicates::set_strategy(const std::size_t replicate,
+                              const std::size_t creature,
+                              const Strategy strategy) {
+    for ( std::size_t s = 0; s < c_num_strategies; ++s ) {
+        if ( s == static_cast<std::size_t>(strategy) ) {
+            m_strategies[s * m_size + creature] |= lane(replicate);
+        } else {
+            m_strategies[s * m_size + creature] &= ~lane(replicate);
+        }
+    }
+}
@@ -0,0 +1,176 @@
+/*
+ *  replicates.h
+ *  ============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Interface to Replicates class for Prisoner's Dilemma simulation.
+ *
+ *  A Replicates object runs 64 independent replicates of a small world
+ *  at once, for estimating how often each strategy takes over from a
+ *  given starting mix. Every replicate starts with the same numbers of
+ *  creatures of each strategy, placed in a different random order.
+ *
+ *  Replicate r is held in bit r of 64-bit words, so one bitwise
+ *  operation acts on all the replicates together. For each creature
+ *  there is a word per strategy, whose bits are set in the replicates
+ *  in which the creature has that strategy. For each pair of creatures
+ *  there are words recording, for each replicate, whether the first
+ *  has met the second, and whether the second defected in their last
+ *  two games, which is all the memory that the deterministic strategy
+ *  genes consult. A creature's move against a partner is then a few
+ *  bitwise operations on these words, following the genes'
+ *  get_game_move() functions, with a set bit meaning defect.
+ *
+ *  Resources are bit-sliced too, as 32 words per creature holding bit
+ *  b of its resources in every replicate, in two's complement. The
+ *  result of each game, from game_result(), is selected by the moves,
+ *  and added to all 64 replicates' resources by a ripple-carry adder
+ *  built from bitwise operations, so resources wrap around exactly as
+ *  an int does.
+ *
+ *  Each day, the creatures are paired at random, with the same pairing
+ *  in every replicate, and every pair plays one game. Given the same
+ *  strategies in the same places, a replicate's games and resources are
+ *  therefore exactly those of creatures playing play_game() with the
+ *  real genes and the same pairings. Only strategies whose moves are
+ *  determined by their memories are supported, and the constructor
+ *  throws NondeterministicStrategy if there are random strategy or
+ *  naive prober creatures.
+ *
+ *  After the games, each replicate separately takes Moran birth-death
+ *  steps, as in a Moran (see moran.h): a parent is chosen with
+ *  probability proportional to its resources, and pays the cost of
+ *  reproducing, and the newborn replaces a uniformly chosen creature,
+ *  with no memories and with the cost as its resources. There are as
+ *  many steps a day as there are creatures, divided by the number of
+ *  days in the reproduction cycle, unless reproduction is disabled.
+ *  Each replicate draws its steps from its own random number stream.
+ *
+ *  Public member functions:
+ *    advance_day() - plays the day's games in every replicate, and
+ *                    takes each replicate's birth-death steps.
+ *
+ *    day() - returns the current day.
+ *
+ *    size() - returns the number of creatures in each replicate.
+ *
+ *    strategy(), resources() - return the strategy and resources of a
+ *                              creature in a replicate.
+ *
+ *    count() - returns the number of creatures of a strategy in a
+ *              replicate.
+ *
+ *    pairing() - returns the order in which the creatures were paired
+ *                on the last day, each pair being consecutive.
+ *
+ *    fixed_replicates() - returns the number of replicates in which a
+ *                         strategy has taken over.
+ *
+ *    output_replicate_stats() - outputs the number of days, games and
+ *                               births in each replicate, and how many
+ *                               replicates each strategy has taken over.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#ifndef PG_PRIDIL_REPLICATES_H
+#define PG_PRIDIL_REPLICATES_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "pridil_common.h"
+#include "rng.h"
+
+namespace pridil {
+
+class Replicates {
+    public:
+
+        //  Number of replicates, one per bit of a word
+
+        static const std::size_t num_replicates = 64;
+
+        //  Constructor and destructor
+
+        explicit Replicates(const WorldInfo& wInfo);
+        ~Replicates();
+
+        //  Methods to advance and access the replicates
+
+        void advance_day();
+        Day day() const;
+        std::size_t size() const;
+        Strategy strategy(const std::size_t replicate,
+                          const std::size_t creature) const;
+        int resources(const std::size_t replicate,
+                      const std::size_t creature) const;
+        std::size_t count(const std::size_t replicate,
+                          const Strategy strategy) const;
+        const std::vector<std::size_t>& pairing() const;
+        std::size_t fixed_replicates(const Strategy strategy) const;
+
+        //  Method to output statistics
+
+        void output_replicate_stats(std::ostream& out) const;
+
+    private:
+        const std::size_t m_size;
+        const std::size_t m_steps_per_day;
+        const int m_repro_cost;
+        const bool m_disable_repro;
+        Day m_day;
+
+        //  Running totals, which are the same in every replicate
+
+        unsigned long m_games_played;
+        unsigned long m_births;
+
+        //  Random number streams for the pairings, and for each
+        //  replicate's birth-death steps
+
+        Rng m_rng;
+        std::vector<Rng> m_replicate_rngs;
+        std::vector<std::size_t> m_order;
+
+        //  Strategy words, indexed by strategy and then creature;
+        //  memory words, indexed by creature and then partner; and
+        //  resources words, indexed by creature and then bit
+
+        std::vector<uint64_t> m_strategies;
+        std::vector<uint64_t> m_met;
+        std::vector<uint64_t> m_last_defect;
+        std::vector<uint64_t> m_prev_defect;
+        std::vector<uint64_t> m_resources;
+
+        //  Words to add to resources for each bit and pair of moves,
+        //  and strategy names, indexed by Strategy value
+
+        uint64_t m_payoff_bits[32][2][2];
+        std::vector<std::string> m_strategy_names;
+
+        uint64_t get_moves(const std::size_t creature,
+                           const std::size_t partner) const;
+        void add_results(const std::size_t creature, const uint64_t own,
+                         const uint64_t other);
+        void remember(const std::size_t creature, const std::size_t partner,
+                      const uint64_t partner_moves);
+        void step(const std::size_t replicate);
+        void set_resources(const std::size_t replicate,
+                           const std::size_t creature, const int value);
+        void set_strategy(const std::size_t replicate,
+                          const std::size_t creature,
+                          const Strategy strategy);
+
+        Replicates(const Replicates&);              // Prevent copying
+        Replicates& operator=(const Replicates&);   // Prevent assignment
+};
+
+}       //  namespace pridil
+
+#endif      // PG_PRIDIL_REPLICATES_H
@@ -0,0 +1,120 @@
+/*
+ *  rng.h
+ *  =====
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Interface to Rng class for Prisoner's Dilemma simulation.
+ *
+ *  Rng is a small, fast, seedable pseudo-random number generator
+ *  (xoshiro256**) for use where std::rand() is too slow, or where
+ *  independent reproducible streams are needed, e.g. one per chunk of
+ *  a parallel job. Unlike std::rand() it has no hidden global state,
+ *  so separate Rng objects can be used from separate threads.
+ *
+ *  A generator is identified by a seed and a stream number, and
+ *  generators with the same seed but different stream numbers produce
+ *  unrelated sequences. The simulation typically derives the stream
+ *  number from the world day and the chunk of work being done.
+ *
+ *  Public member functions:
+ *    next() - returns the next 64-bit pseudo-random value.
+ *
+ *    below() - returns a pseudo-random integer uniformly distributed
+ *              in the range [0, n), without modulo bias.
+ *
+ *    uniform() - returns a pseudo-random double uniformly distributed
+ *                in the range [0, 1).
+ *
+ *  Non-member functions:
+ *    mix_seed() - combines a seed with a number to give a new,
+ *                 well-scrambled seed, used for deriving stream numbers.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#ifndef PG_PRIDIL_RNG_H
+#define PG_PRIDIL_RNG_H
+
+#include <stdint.h>
+
+namespace pridil {
+
+/*
+ *  SplitMix64 finalizer, used to scramble seeds.
+ */
+
+inline uint64_t mix_seed(const uint64_t seed, const uint64_t value) {
+    uint64_t z = seed + (value + 1) * 0x9E3779B97F4A7C15UL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9UL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBUL;
+    return z ^ (z >> 31);
+}
+
+
+/*
+ *  Rng class.
+ */
+
+class Rng {
+    public:
+
+        //  Constructor
+
+        explicit Rng(const uint64_t seed, const uint64_t stream = 0) :
+                m_state() {
+            const uint64_t base = mix_seed(seed, stream);
+            for ( int i = 0; i < 4; ++i ) {
+                m_state[i] = mix_seed(base, i);
+            }
+        }
+
+        //  Generator methods
+
+        uint64_t next() {
+            const uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+            const uint64_t t = m_state[1] << 17;
+
+            m_state[2] ^= m_state[0];
+            m_state[3] ^= m_state[1];
+            m_state[1] ^= m_state[2];
+            m_state[0] ^= m_state[3];
+            m_state[2] ^= t;
+            m_state[3] = rotl(m_state[3], 45);
+
+            return result;
+        }
+
+        //  Uses Lemire's multiply-and-shift method, rejecting the
+        //  few low products which would otherwise bias the result.
+
+        uint32_t below(const uint32_t n) {
+            uint64_t product = (next() >> 32) * n;
+            uint32_t low = static_cast<uint32_t>(product);
+            if ( low < n ) {
+                const uint32_t threshold = static_cast<uint32_t>(-n) % n;
+                while ( low < threshold ) {
+                    product = (next() >> 32) * n;
+                    low = static_cast<uint32_t>(product);
+                }
+            }
+            return static_cast<uint32_t>(product >> 32);
+        }
+
+        double uniform() {
+            return (next() >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+    private:
+        uint64_t m_state[4];
+
+        static uint64_t rotl(const uint64_t x, const int k) {
+            return (x << k) | (x >> (64 - k));
+        }
+};
+
+}       //  namespace pridil
+
+#endif      // PG_PRIDIL_RNG_H
@@ -0,0 +1,150 @@
+/*
+ *  slot_map.cpp
+ *  ============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Implementation of SlotMap class for Prisoners' Dilemma simulation.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <cstddef>
+#include <vector>
+#include <stdint.h>
+#include "pridil_exceptions.h"
+#include "slot_map.h"
+
+using namespace pridil;
+
+
+/*
+ *  Definitions of static constants.
+ */
+
+const CreatureHandle SlotMap::null_handle;
+const unsigned int SlotMap::c_default_slot_bits;
+const unsigned int SlotMap::c_min_slot_bits;
+const unsigned int SlotMap::c_max_slot_bits;
+
+
+/*
+ *  Constructor.
+ *
+ *  Arguments:
+ *    slot_bits -- the number of low handle bits which are the slot
+ *                 number, kept between c_min_slot_bits and
+ *                 c_max_slot_bits.
+ */
+
+SlotMap::SlotMap(const unsigned int slot_bits) :
+        m_slot_bits(slot_bits < c_min_slot_bits ? c_min_slot_bits :
+                    (slot_bits > c_max_slot_bits ? c_max_slot_bits :
+                     slot_bits)),
+        m_slot_mask((1U << m_slot_bits) - 1),
+        m_handles(), m_locations(), m_generations(), m_free_slots(),
+        m_size(0) {}
+
+
+/*
+ *  Gives a new creature a handle, reusing the most recently freed slot
+ *  if there is one.
+ *
+ *  Arguments:
+ *    location -- the creature's region and row
+ *
+ *  Returns:
+ *    The creature's handle.
+ *
+ *  Throws SlotMapFull if every slot number is in use or retired. The
+ *  highest slot number is never used, so no handle is ever null_handle.
+ */
+
+CreatureHandle SlotMap::insert(const SlotLocation& location) {
+    uint32_t slot;
+    if ( !m_free_slots.empty() ) {
+        slot = m_free_slots.back();
+        m_free_slots.pop_back();
+    } else if ( m_handles.size() < m_slot_mask ) {
+        slot = static_cast<uint32_t>(m_handles.size());
+        m_handles.push_back(null_handle);
+        m_locations.push_back(SlotLocation());
+        m_generations.push_back(0);
+    } else {
+        throw SlotMapFull();
+    }
+
+    const CreatureHandle handle =
+        (static_cast<uint32_t>(m_generations[slot]) << m_slot_bits) | slot;
+    m_handles[slot] = handle;
+    m_locations[slot] = location;
+    ++m_size;
+    return handle;
+}
+
+
+/*
+ *  Frees the handle of a creature which has died. The slot's generation
+ *  is advanced, so the handle is stale from now on, and the slot is put
+ *  on the free list, unless it has given out its last generation, in
+ *  which case it is retired. Stale handles are ignored.
+ */
+
+void SlotMap::erase(const CreatureHandle handle) {
+    if ( !contains(handle) ) {
+        return;
+    }
+
+    const uint32_t slot = handle & m_slot_mask;
+    m_handles[slot] = null_handle;
+    --m_size;
+    if ( m_generations[slot] + 1U < num_generations() ) {
+        ++m_generations[slot];
+        m_free_slots.push_back(slot);
+    }
+}
+
+
+/*
+ *  Returns a creature's region and row.
+ *
+ *  Throws StaleHandle if the creature has died.
+ */
+
+const SlotLocation& SlotMap::location(const CreatureHandle handle) const {
+    if ( !contains(handle) ) {
+        throw StaleHandle();
+    }
+    return m_locations[handle & m_slot_mask];
+}
+
+
+/*
+ *  Returns the number of handles in use, i.e. the number of live
+ *  creatures.
+ */
+
+std::size_t SlotMap::size() const {
+    return m_size;
+}
+
+
+/*
+ *  Returns the number of slots, including free and retired slots.
+ */
+
+std::size_t SlotMap::num_slots() const {
+    return m_handles.size();
+}
+
+
+/*
+ *  Returns the number of handles each slot gives out before it is
+ *  retired, i.e. 2 to the power of the number of generation bits.
+ */
+
+unsigned int SlotMap::num_generations() const {
+    return 1U << (32 - m_slot_bits);
+}
@@ -0,0 +1,161 @@
+/*
+ *  slot_map.h
+ *  ==========
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Interface to SlotMap class for Prisoner's Dilemma simulation.
+ *
+ *  A SlotMap gives each live creature in a World a 32-bit handle, and
+ *  maps the handle to where the creature currently is: its region and
+ *  its row in that region's live creatures (see population.h). Rows
+ *  move every day, as the dead are removed and creatures migrate, but
+ *  a creature's handle stays the same for as long as it lives, and
+ *  finding it from its handle takes a single array lookup.
+ *
+ *  Slots are held in a dense array, and the slots of creatures which
+ *  have died are kept on a free list and reused for newborns. Each slot
+ *  has a generation, which is part of every handle to it and which is
+ *  advanced whenever the slot is freed, so a handle to a creature which
+ *  has died is seen to be stale even once its slot has been reused. A
+ *  slot whose generation has run out is retired instead of being put
+ *  on the free list, so a stale handle can never match a later
+ *  creature.
+ *
+ *  Handles are kept at 32 bits, so that the handle stored in each row
+ *  of a Population is no wider than the other per-row fields. The low
+ *  bits of a handle are the slot number, and the rest are the
+ *  generation. How many bits go to the slot number is given to the
+ *  constructor, and defaults to c_default_slot_bits, 28, which allows
+ *  up to 2^28 - 1 (about 268 million) creatures alive at once and 16
+ *  generations for each slot. More slot bits allow more live creatures
+ *  but retire slots sooner, so the slot array grows by one slot for
+ *  every 2^(32 - slot bits) creatures ever born. The slot bits are kept
+ *  between c_min_slot_bits and c_max_slot_bits. insert() throws
+ *  SlotMapFull once every slot number is in use or retired.
+ *
+ *  insert() and erase() change the free list, and so must not be
+ *  called by two threads at once. relocate() writes only to the slot
+ *  of the handle given, so different threads may relocate different
+ *  creatures at the same time.
+ *
+ *  Public member functions:
+ *    insert() - gives a new creature a handle.
+ *
+ *    erase() - frees the handle of a creature which has died, making
+ *              the handle stale.
+ *
+ *    relocate() - records a creature's new region and row.
+ *
+ *    contains() - returns true if a handle is not stale.
+ *
+ *    location() - returns a creature's region and row from its handle,
+ *                 throwing StaleHandle if the handle is stale.
+ *
+ *    size() - returns the number of handles in use.
+ *
+ *    num_slots() - returns the number of slots, including free and
+ *                  retired ones.
+ *
+ *    slot_bits() - returns the number of low handle bits which are the
+ *                  slot number.
+ *
+ *    num_generations() - returns the number of handles each slot gives
+ *                        out before it is retired.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#ifndef PG_PRIDIL_SLOT_MAP_H
+#define PG_PRIDIL_SLOT_MAP_H
+
+#include <cstddef>
+#include <vector>
+#include <stdint.h>
+
+namespace pridil {
+
+typedef uint32_t CreatureHandle;
+typedef std::vector<CreatureHandle> HandleList;
+
+
+/*
+ *  Struct for the location of a creature.
+ */
+
+struct SlotLocation {
+    uint32_t region;
+    uint32_t row;
+
+    SlotLocation() : region(0), row(0) {}
+    SlotLocation(const uint32_t loc_region, const uint32_t loc_row) :
+        region(loc_region), row(loc_row) {}
+};
+
+
+/*
+ *  SlotMap class.
+ */
+
+class SlotMap {
+    public:
+        static const CreatureHandle null_handle = 0xFFFFFFFFU;
+        static const unsigned int c_default_slot_bits = 28;
+        static const unsigned int c_min_slot_bits = 24;
+        static const unsigned int c_max_slot_bits = 31;
+
+        //  Constructor
+
+        explicit SlotMap(const unsigned int slot_bits = c_default_slot_bits);
+
+        //  Methods to give out and free handles
+
+        CreatureHandle insert(const SlotLocation& location);
+        void erase(const CreatureHandle handle);
+
+        //  Methods to record and look up locations
+
+        void relocate(const CreatureHandle handle,
+                      const SlotLocation& location) {
+            m_locations[handle & m_slot_mask] = location;
+        }
+
+        bool contains(const CreatureHandle handle) const {
+            const uint32_t slot = handle & m_slot_mask;
+            return slot < m_handles.size() && m_handles[slot] == handle;
+        }
+
+        const SlotLocation& location(const CreatureHandle handle) const;
+
+        //  Methods to access the size of the map
+
+        std::size_t size() const;
+        std::size_t num_slots() const;
+
+        //  Methods to access the split of a handle
+
+        unsigned int slot_bits() const { return m_slot_bits; }
+        unsigned int num_generations() const;
+
+    private:
+        unsigned int m_slot_bits;
+        CreatureHandle m_slot_mask;
+
+        //  The handle currently belonging to each slot, or null_handle
+        //  for a free or retired slot, and each slot's location
+
+        std::vector<CreatureHandle> m_handles;
+        std::vector<SlotLocation> m_locations;
+
+        //  The generation each slot will give its next handle
+
+        std::vector<unsigned char> m_generations;
+        std::vector<uint32_t> m_free_slots;
+        std::size_t m_size;
+};
+
+}       //  namespace pridil
+
+#endif      // PG_PRIDIL_SLOT_MAP_H
@@ -0,0 +1,192 @@
+/*
+ *  test_cohort_world.cpp
+ *  =====================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Pridil unit tests for CohortWorld class.
+ *
+ *  Uses CppUTest unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <CppUTest/CommandLineTestRunner.h>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include "../../cohort_world.h"
+#include "../../mean_field.h"
+#include "../../world.h"
+#include "../test_helpers.h"
+
+using namespace pridil;
+using namespace pridil::test;
+
+
+TEST_GROUP(CohortWorldGroup) {
+};
+
+
+
+/*
+ *  Tests that a population of cooperators with no deaths or births
+ *  stays in a single cohort, gaining the reward for mutual cooperation
+ *  every day, and that the statistics are output in the same format as
+ *  a World's.
+ */
+
+TEST(CohortWorldGroup, CooperatorsTest) {
+    WorldInfo wInfo = TestWorld(5).with(always_cooperate, 100)
+                                  .life_expectancy(30)
+                                  .repro_min_resources(75)
+                                  .closed();
+    CohortWorld cohort_world(wInfo);
+    for ( Day day = 1; day <= 10; ++day ) {
+        cohort_world.advance_day();
+        CHECK_EQUAL(1u, cohort_world.num_cohorts());
+    }
+
+    CHECK_EQUAL(100ul, cohort_world.count(always_cooperate));
+    CHECK_EQUAL(0u, cohort_world.num_individuals());
+    CHECK_EQUAL(11, cohort_world.day());
+
+    std::ostringstream out;
+    cohort_world.output_world_stats(out);
+    cohort_world.output_summary_resources_by_strategy(out);
+    cohort_world.output_summary_dead_by_strategy(out);
+    CHECK_EQUAL(std::string("Summary world statistics:\n"
+                            "Days passed: 10\n"
+                            "Games played: 500\n"
+                            "Starting creatures: 100\n"
+                            "Living creatures: 100\n"
+                            "Creatures born: 0\n"
+                            "Creatures died: 0\n\n"
+                            "Summary resource statistics by strategy:\n"
+                            "1, always cooperate (100): max 130, "
+                            "min 130, sprd 0, avg 130\n\n"),
+                out.str());
+}
+
+
+/*
+ *  Tests that creatures whose strategies use their memories leave
+ *  their cohorts when they play their first game, while the others
+ *  stay in cohorts, and that every creature plays once a day.
+ */
+
+TEST(CohortWorldGroup, SplitTest) {
+    WorldInfo wInfo = TestWorld(5).with(tit_for_tat, 50)
+                                  .with(always_defect, 500)
+                                  .life_expectancy(30)
+                                  .repro_min_resources(75)
+                                  .closed();
+    CohortWorld cohort_world(wInfo);
+    CHECK_EQUAL(2u, cohort_world.num_cohorts());
+
+    cohort_world.advance_day();
+    CHECK_EQUAL(50u, cohort_world.num_individuals());
+    CHECK_EQUAL(50ul, cohort_world.count(tit_for_tat));
+    CHECK_EQUAL(500ul, cohort_world.count(always_defect));
+    CHECK(cohort_world.num_cohorts() <= 2);
+    CHECK_EQUAL(275ul, cohort_world.games_played());
+
+    cohort_world.advance_day();
+    CHECK_EQUAL(550ul, cohort_world.games_played());
+}
+
+
+/*
+ *  Tests that a large population of creatures which do not use their
+ *  memories is held in a few cohorts, and that live creatures are
+ *  always the starting creatures plus those born less those which died.
+ */
+
+TEST(CohortWorldGroup, CompressionTest) {
+    WorldInfo wInfo = TestWorld(5).with(always_cooperate, 1000000)
+                                  .with(always_defect, 1000000)
+                                  .with(random_strategy, 1000000)
+                                  .life_expectancy(30)
+                                  .repro_min_resources(75);
+    CohortWorld cohort_world(wInfo);
+    for ( Day day = 1; day <= 100; ++day ) {
+        cohort_world.advance_day();
+        CHECK_EQUAL(3000000ul + cohort_world.born_creatures() -
+                    cohort_world.dead_creatures(), cohort_world.num_live());
+        CHECK(cohort_world.num_cohorts() < 10000);
+    }
+
+    CHECK_EQUAL(0u, cohort_world.num_individuals());
+    CHECK(cohort_world.born_creatures() > 1000000ul);
+    CHECK(cohort_world.dead_creatures() > 1000000ul);
+}
+
+
+/*
+ *  Tests that a large population of creatures which do not use their
+ *  memories ends up close to the mean field from the same starting mix.
+ */
+
+TEST(CohortWorldGroup, AgreesWithMeanFieldTest) {
+    WorldInfo wInfo = TestWorld(5).with(always_cooperate, 100000)
+                                  .with(always_defect, 50000)
+                                  .with(random_strategy, 100000)
+                                  .life_expectancy(30)
+                                  .repro_min_resources(75);
+    wInfo.m_days_to_run = 40;
+
+    CohortWorld cohort_world(wInfo);
+    MeanField mean_field(wInfo);
+    for ( Day day = 1; day <= wInfo.m_days_to_run; ++day ) {
+        cohort_world.advance_day();
+        mean_field.advance_day();
+    }
+
+    const Strategy strategies[] = { always_cooperate, always_defect,
+                                    random_strategy };
+    for ( int s = 0; s < 3; ++s ) {
+        const double expected = mean_field.count(strategies[s]);
+        const double actual = static_cast<double>(
+                                  cohort_world.count(strategies[s]));
+        CHECK(expected > 1000.0);
+        CHECK(std::fabs(actual - expected) < 0.05 * expected);
+    }
+}
+
+
+/*
+ *  Tests that a mixed population, in which tit for tat creatures are
+ *  individuals, ends up close to a World from the same starting mix.
+ */
+
+TEST(CohortWorldGroup, AgreesWithWorldTest) {
+    WorldInfo wInfo = TestWorld(5).with(tit_for_tat, 3000)
+                                  .with(always_defect, 1500)
+                                  .with(random_strategy, 1500)
+                                  .life_expectancy(30)
+                                  .repro_min_resources(75);
+    wInfo.m_days_to_run = 60;
+
+    World world(wInfo);
+    CohortWorld cohort_world(wInfo);
+    for ( Day day = 1; day <= wInfo.m_days_to_run; ++day ) {
+        world.advance_day();
+        cohort_world.advance_day();
+    }
+
+    std::ostringstream world_out;
+    std::ostringstream cohort_out;
+    world.output_world_stats(world_out);
+    cohort_world.output_world_stats(cohort_out);
+
+    const char * labels[] = { "Living creatures: ", "Creatures born: ",
+                              "Creatures died: " };
+    for ( int i = 0; i < 3; ++i ) {
+        const double world_value = stat(world_out.str(), labels[i]);
+        const double cohort_value = stat(cohort_out.str(), labels[i]);
+        CHECK(world_value > 0.0);
+        CHECK(std::fabs(world_value - cohort_value) < 0.05 * world_value);
+    }
+}
@@ -0,0 +1,136 @@
+/*
+ *  test_convergence.cpp
+ *  ====================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Pridil unit tests for ConvergenceMonitor class, and for convergence
+ *  checks in a World.
+ *
+ *  Uses CppUTest unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <CppUTest/CommandLineTestRunner.h>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../../convergence.h"
+#include "../../world.h"
+#include "../test_helpers.h"
+
+using namespace pridil;
+using namespace pridil::test;
+
+
+namespace {
+
+    /*
+     *  Returns a WorldInfo with only always cooperate creatures, which
+     *  neither die nor reproduce, and whose resources grow steadily
+     *  from a large start, with the specified convergence checks.
+     */
+
+    WorldInfo steady_world(const Day check_days, const double tolerance) {
+        WorldInfo wInfo = TestWorld(3).with(always_cooperate, 20)
+                                      .starting_resources(1000000)
+                                      .closed();
+        wInfo.m_converge_check_days = check_days;
+        wInfo.m_converge_window = 4;
+        wInfo.m_converge_tolerance = tolerance;
+        return wInfo;
+    }
+
+}
+
+
+TEST_GROUP(ConvergenceGroup) {
+};
+
+
+
+/*
+ *  Tests that statistics converge only once the window is full, that
+ *  small statistics are held to an absolute tolerance and large ones
+ *  to a relative tolerance, and that an outlying sample stops them
+ *  converging until it has left the window.
+ */
+
+TEST(ConvergenceGroup, MonitorTest) {
+    ConvergenceMonitor monitor(2, 3, 0.01);
+    std::vector<double> sample(2);
+    sample[0] = 0.5;
+    sample[1] = 1000.0;
+
+    CHECK(monitor.add_sample(sample) == false);
+    CHECK(monitor.add_sample(sample) == false);
+    CHECK(monitor.add_sample(sample));
+    CHECK(monitor.converged());
+
+    sample[0] = 0.505;
+    sample[1] = 1005.0;
+    CHECK(monitor.add_sample(sample));
+
+    sample[0] = 0.6;
+    CHECK(monitor.add_sample(sample) == false);
+    CHECK(monitor.converged() == false);
+
+    sample[0] = 0.505;
+    CHECK(monitor.add_sample(sample) == false);
+    CHECK(monitor.add_sample(sample) == false);
+    CHECK(monitor.add_sample(sample));
+    CHECK_EQUAL(8ul, monitor.samples());
+
+    sample[1] = 1100.0;
+    CHECK(monitor.add_sample(sample) == false);
+}
+
+
+/*
+ *  Tests that a world records the day on which its statistics first
+ *  converged, checking every few days, and reports it.
+ */
+
+TEST(ConvergenceGroup, WorldConvergedTest) {
+    World world(steady_world(5, 0.01));
+    for ( int day = 0; day < 100 && !world.converged(); ++day ) {
+        world.advance_day();
+    }
+
+    CHECK(world.converged());
+    CHECK_EQUAL(20, world.converged_day());
+    CHECK_EQUAL(21, world.day());
+
+    std::ostringstream out;
+    world.output_world_stats(out);
+    CHECK(out.str().find("Converged on day: 20\n") != std::string::npos);
+}
+
+
+/*
+ *  Tests that a world whose statistics have not converged, or which is
+ *  not checked, is not reported as converged.
+ */
+
+TEST(ConvergenceGroup, WorldNotConvergedTest) {
+    World strict(steady_world(5, 1e-9));
+    World unchecked(steady_world(0, 0.01));
+    for ( int day = 0; day < 50; ++day ) {
+        strict.advance_day();
+        unchecked.advance_day();
+    }
+
+    CHECK(strict.converged() == false);
+    CHECK_EQUAL(0, strict.converged_day());
+    CHECK(unchecked.converged() == false);
+
+    std::ostringstream strict_out;
+    std::ostringstream unchecked_out;
+    strict.output_world_stats(strict_out);
+    unchecked.output_world_stats(unchecked_out);
+    CHECK(strict_out.str().find("Converged: no\n") != std::string::npos);
+    CHECK(unchecked_out.str().find("Converged") == std::string::npos);
+}
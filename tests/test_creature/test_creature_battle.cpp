@@ -20,8 +20,6 @@
 using namespace pridil;
 
 
-static void play_game(Creature * creature1, Creature * creature2);
-
 static int mutual_coop_result = 3;
 static int mutual_defect_result = -1;
 static int sucker_result = -3;
@@ -189,49 +187,3 @@ TEST(CreatureBattleGroup, TfttVsStftTest) {
     CHECK_EQUAL(exp_res2, creature2.resources());
 }
 
-
-/*
- *  Function plays a game between two creatures.
- *
- *  Each creature is asked for a move, and told the ID of their
- *  opponent so that they can remember previous games with that
- *  opponent. The result of the game is calculated, and each
- *  creature is informed of the result so that they can update
- *  their memories.
- *
- *  Arguments: a pointer to each of the two creatures playing.
- *
- *  Note: duplicated from World::play_game()
- */
-
-static void play_game(Creature * creature1, Creature * creature2) {
-
-    //  Get the move from each of the two creatures
-
-    GameMove c1move = creature1->get_game_move(creature2->id());
-    GameMove c2move = creature2->get_game_move(creature1->id());
-
-
-    //  Populate GameInfo objects for each creature, and
-    //  populate with the game result. Simplify the opponent's move
-    //  each time, to avoid giving a creature an indication of its
-    //  opponent's internal state with regards to game-playing
-    //  strategy.
-
-    GameInfo c1info(creature2->id(),
-                    c1move,
-                    simplify_game_move(c2move),
-                    0);
-    GameInfo c2info(creature1->id(),
-                    c2move,
-                    simplify_game_move(c1move),
-                    0);
-    game_result(c1info, c2info);
-
-
-    //  Communicate results of the game to each creature
-
-    creature1->give_game_result(c1info);
-    creature2->give_game_result(c2info);
-}
-
@@ -0,0 +1,179 @@
+/*
+ *  test_play_match.cpp
+ *  ===================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Pridil unit tests for play_match() and match_length() functions.
+ *
+ *  Uses CppUTest unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <CppUTest/CommandLineTestRunner.h>
+#include <sstream>
+#include <string>
+#include <stdint.h>
+#include "../../creature.h"
+#include "../../population.h"
+#include "../../game.h"
+#include "../../rng.h"
+
+using namespace pridil;
+
+
+TEST_GROUP(PlayMatchGroup) {
+};
+
+
+
+/*
+ *  Tests that a 10 game match between a tit_for_tat creature and an
+ *  always_defect creature gives the expected scores, and changes
+ *  resources by the same amounts.
+ *
+ *  Tit for tat is the sucker in the first game, and both creatures
+ *  defect for the remaining nine, so the scores are:
+ *    tit_for_tat:   -3 + 9 * -1 = -12
+ *    always_defect:  5 + 9 * -1 = -4
+ */
+
+TEST(PlayMatchGroup, TftVsAlwaysDefectTest) {
+    Creature creature1(CreatureInit(1000, 0, tit_for_tat, 100, 50, 75));
+    Creature creature2(CreatureInit(1000, 0, always_defect, 100, 50, 75));
+
+    int score1 = 1;
+    int score2 = 1;
+    play_match(&creature1, &creature2, 10, score1, score2);
+
+    CHECK_EQUAL(-12, score1);
+    CHECK_EQUAL(-4, score2);
+    CHECK_EQUAL(88, creature1.resources());
+    CHECK_EQUAL(96, creature2.resources());
+}
+
+
+/*
+ *  Tests that a match of no games gives zero scores.
+ */
+
+TEST(PlayMatchGroup, EmptyMatchTest) {
+    Creature creature1(CreatureInit(1000, 0, tit_for_tat, 100, 50, 75));
+    Creature creature2(CreatureInit(1000, 0, always_defect, 100, 50, 75));
+
+    int score1 = 1;
+    int score2 = 1;
+    play_match(&creature1, &creature2, 0, score1, score2);
+
+    CHECK_EQUAL(0, score1);
+    CHECK_EQUAL(0, score2);
+    CHECK_EQUAL(100, creature1.resources());
+}
+
+
+/*
+ *  Tests that a match between two creatures in a population, long
+ *  enough to be given to the creatures in several batches, leaves the
+ *  same resources and memories as playing its games one at a time, for
+ *  every pair of strategies with deterministic moves, including after
+ *  an earlier game.
+ */
+
+TEST(PlayMatchGroup, PopulationMatchTest) {
+    const Strategy strategies[] = { tit_for_tat, tit_for_two_tats,
+                                    susp_tit_for_tat, always_cooperate,
+                                    always_defect };
+    for ( int s1 = 0; s1 < 5; ++s1 ) {
+        for ( int s2 = 0; s2 < 5; ++s2 ) {
+            Population matched;
+            Population played;
+            for ( int i = 0; i < 2; ++i ) {
+                const Strategy strategy = strategies[i ? s2 : s1];
+                matched.add(CreatureInit(1000, 0, strategy, 100, 50, 75),
+                            i + 1, 0);
+                played.add(CreatureInit(1000, 0, strategy, 100, 50, 75),
+                           i + 1, 0);
+            }
+
+            play_game(matched, 0, 1);
+            play_match(matched, 0, 1, 150);
+            for ( int game = 0; game < 151; ++game ) {
+                play_game(played, 0, 1);
+            }
+
+            for ( int i = 0; i < 2; ++i ) {
+                CHECK_EQUAL(played.resources(i), matched.resources(i));
+                CHECK_EQUAL(151u, matched.games_played(i));
+
+                std::ostringstream matched_out;
+                std::ostringstream played_out;
+                matched.detailed_memories(i, matched_out);
+                played.detailed_memories(i, played_out);
+                CHECK(matched_out.str() == played_out.str());
+            }
+        }
+    }
+}
+
+
+/*
+ *  Tests that a match between random strategy creatures in a
+ *  population, with moves drawn from a seed, leaves the same resources
+ *  and memories whenever it is played with the same seed, and that
+ *  each creature's moves are about half defections.
+ */
+
+TEST(PlayMatchGroup, SeededMatchTest) {
+    std::string memories[2];
+    int resources[2] = { 0, 0 };
+    for ( int i = 0; i < 2; ++i ) {
+        Population creatures;
+        creatures.add(CreatureInit(1000, 0, random_strategy, 10000, 50, 75),
+                      1, 0);
+        creatures.add(CreatureInit(1000, 0, always_cooperate, 10000, 50, 75),
+                      2, 0);
+        play_match(creatures, 0, 1, 1000, 42);
+
+        std::ostringstream out;
+        creatures.detailed_memories(0, out);
+        memories[i] = out.str();
+        resources[i] = creatures.resources(1);
+    }
+
+    CHECK(memories[0] == memories[1]);
+    CHECK_EQUAL(resources[0], resources[1]);
+
+    //  The always cooperate creature gains 3 a game when its opponent
+    //  cooperates and loses 3 when it defects, so about nothing
+
+    CHECK(resources[0] > 10000 - 300 && resources[0] < 10000 + 300);
+}
+
+
+/*
+ *  Tests that matches have a fixed length unless there is a
+ *  probability of continuing between 0 and 1, that otherwise their
+ *  lengths average 1 / (1 - w) for a continuation probability w, and
+ *  that lengths are capped at a million games.
+ */
+
+TEST(PlayMatchGroup, MatchLengthTest) {
+    CHECK_EQUAL(7u, match_length(7, 0.0, 12345));
+    CHECK_EQUAL(7u, match_length(7, 1.0, 12345));
+    CHECK_EQUAL(1u, match_length(7, 0.5, ~static_cast<uint64_t>(0)));
+    CHECK_EQUAL(1000000u, match_length(7, 1.0 - 1e-12, 0));
+    CHECK_EQUAL(1000000u, match_length(7, 0.999999, 0));
+
+    Rng rng(9);
+    double total = 0.0;
+    const int num_matches = 20000;
+    for ( int i = 0; i < num_matches; ++i ) {
+        const unsigned int rounds = match_length(7, 0.75, rng.next());
+        CHECK(rounds >= 1);
+        total += rounds;
+    }
+    DOUBLES_EQUAL(4.0, total / num_matches, 0.1);
+}
@@ -0,0 +1,118 @@
+/*
+ *  test_gillespie.cpp
+ *  ==================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Pridil unit tests for Gillespie class.
+ *
+ *  Uses CppUTest unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <CppUTest/CommandLineTestRunner.h>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include "../../gillespie.h"
+#include "../test_helpers.h"
+
+using namespace pridil;
+using namespace pridil::test;
+
+
+TEST_GROUP(GillespieGroup) {
+};
+
+
+
+/*
+ *  Tests that, with deaths and reproduction disabled, creatures play
+ *  one game a day on average, and time ends each day at its end.
+ */
+
+TEST(GillespieGroup, EncounterRateTest) {
+    WorldInfo wInfo = TestWorld(7).with(always_cooperate, 100)
+                                  .with(always_defect, 100)
+                                  .closed();
+    Gillespie gillespie(wInfo);
+    for ( Day day = 1; day <= 50; ++day ) {
+        gillespie.advance_day();
+        CHECK_EQUAL(static_cast<double>(day), gillespie.time());
+    }
+
+    CHECK_EQUAL(200u, gillespie.size());
+    CHECK(gillespie.games_played() > 4700 && gillespie.games_played() < 5300);
+    CHECK_EQUAL(0ul, gillespie.born_creatures());
+    CHECK_EQUAL(0ul, gillespie.dead_creatures());
+}
+
+
+/*
+ *  Tests that creatures which never run out of resources all die of
+ *  old age on the day they would in a World, and not before.
+ */
+
+TEST(GillespieGroup, OldAgeTest) {
+    WorldInfo wInfo = TestWorld(7).with(always_cooperate, 150);
+    wInfo.m_default_life_expectancy = 10;
+    wInfo.m_disable_repro = true;
+    Gillespie gillespie(wInfo);
+    for ( Day day = 1; day <= 10; ++day ) {
+        gillespie.advance_day();
+    }
+    CHECK_EQUAL(150u, gillespie.size());
+
+    gillespie.advance_day();
+    CHECK_EQUAL(0u, gillespie.size());
+    CHECK_EQUAL(150ul, gillespie.dead_creatures());
+
+    std::ostringstream out;
+    gillespie.output_summary_dead_by_strategy(out);
+    CHECK(out.str().find("150 always cooperate creatures died.") !=
+          std::string::npos);
+}
+
+
+/*
+ *  Tests that births and deaths keep the counts by strategy in step
+ *  with the creatures, and that newborns take their parents' places
+ *  among those able to reproduce.
+ */
+
+TEST(GillespieGroup, BirthsAndDeathsTest) {
+    WorldInfo wInfo = TestWorld(7).with(always_cooperate, 100)
+                                  .with(always_defect, 100);
+    wInfo.m_default_life_expectancy = 8;
+    wInfo.m_default_starting_resources = 20;
+    wInfo.m_repro_min_resources = 30;
+    wInfo.m_repro_cost = 10;
+    wInfo.m_repro_cycle_days = 2;
+    Gillespie gillespie(wInfo);
+    for ( Day day = 1; day <= 30; ++day ) {
+        gillespie.advance_day();
+
+        const Population& creatures = gillespie.creatures();
+        std::size_t cooperators = 0;
+        for ( std::size_t i = 0; i < creatures.size(); ++i ) {
+            CHECK(creatures.resources(i) > 0);
+            CHECK(creatures.birth_day(i) + 9 > day);
+            if ( creatures.strategy_value(i) == always_cooperate ) {
+                ++cooperators;
+            }
+        }
+        CHECK_EQUAL(gillespie.count(always_cooperate), cooperators);
+        CHECK_EQUAL(creatures.size(), cooperators +
+                                      gillespie.count(always_defect));
+    }
+
+    CHECK(gillespie.born_creatures() > 0);
+    CHECK(gillespie.dead_creatures() > 200);
+    CHECK_EQUAL(200 + gillespie.born_creatures() -
+                gillespie.dead_creatures(),
+                static_cast<unsigned long>(gillespie.size()));
+}
+
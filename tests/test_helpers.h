@@ -0,0 +1,159 @@
+/*
+ *  test_helpers.h
+ *  ==============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Helpers shared by the Pridil unit tests.
+ *
+ *  TestWorld builds the WorldInfo structures on which the tests run.
+ *  It starts with no creatures of any strategy and the specified seed,
+ *  and each of its member functions sets one more characteristic and
+ *  returns the TestWorld, so that they may be chained:
+ *
+ *    WorldInfo wInfo = TestWorld(5).with(tit_for_tat, 900)
+ *                                  .with(always_defect, 100)
+ *                                  .closed();
+ *
+ *  stat() reads a number from the statistics which an engine outputs.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#ifndef PG_PRIDIL_TEST_HELPERS_H
+#define PG_PRIDIL_TEST_HELPERS_H
+
+#include <sstream>
+#include <string>
+#include "../pridil_common.h"
+#include "../pridil_exceptions.h"
+
+
+namespace pridil {
+namespace test {
+
+/*
+ *  Builder for WorldInfo structures.
+ */
+
+class TestWorld {
+    public:
+        explicit TestWorld(const unsigned long seed) : m_wInfo() {
+            m_wInfo.m_random_strategy = 0;
+            m_wInfo.m_tit_for_tat = 0;
+            m_wInfo.m_tit_for_two_tats = 0;
+            m_wInfo.m_susp_tit_for_tat = 0;
+            m_wInfo.m_naive_prober = 0;
+            m_wInfo.m_always_cooperate = 0;
+            m_wInfo.m_always_defect = 0;
+            m_wInfo.m_seed = seed;
+        }
+
+        //  Sets the number of starting creatures of a strategy
+
+        TestWorld& with(const Strategy strategy, const int number) {
+            switch ( strategy ) {
+                case random_strategy:
+                    m_wInfo.m_random_strategy = number;
+                    break;
+
+                case tit_for_tat:
+                    m_wInfo.m_tit_for_tat = number;
+                    break;
+
+                case tit_for_two_tats:
+                    m_wInfo.m_tit_for_two_tats = number;
+                    break;
+
+                case susp_tit_for_tat:
+                    m_wInfo.m_susp_tit_for_tat = number;
+                    break;
+
+                case naive_prober:
+                    m_wInfo.m_naive_prober = number;
+                    break;
+
+                case always_cooperate:
+                    m_wInfo.m_always_cooperate = number;
+                    break;
+
+                case always_defect:
+                    m_wInfo.m_always_defect = number;
+                    break;
+
+                default:
+                    throw UnknownStrategy();
+            }
+            return *this;
+        }
+
+        //  Disables deaths and reproduction, so that the creatures
+        //  only play games
+
+        TestWorld& closed() {
+            m_wInfo.m_disable_deaths = true;
+            m_wInfo.m_disable_repro = true;
+            return *this;
+        }
+
+        TestWorld& life_expectancy(const Day days) {
+            m_wInfo.m_default_life_expectancy = days;
+            return *this;
+        }
+
+        TestWorld& starting_resources(const int resources) {
+            m_wInfo.m_default_starting_resources = resources;
+            return *this;
+        }
+
+        TestWorld& repro_min_resources(const int resources) {
+            m_wInfo.m_repro_min_resources = resources;
+            return *this;
+        }
+
+        TestWorld& repro_cycle_days(const Day days) {
+            m_wInfo.m_repro_cycle_days = days;
+            return *this;
+        }
+
+        TestWorld& match_length(const double games) {
+            m_wInfo.m_match_length = games;
+            return *this;
+        }
+
+        TestWorld& threads(const unsigned int number) {
+            m_wInfo.m_threads = number;
+            return *this;
+        }
+
+        operator WorldInfo() const {
+            return m_wInfo;
+        }
+
+    private:
+        WorldInfo m_wInfo;
+};
+
+
+/*
+ *  Returns the number on the line of a statistics output which
+ *  starts with the specified label, or -1 if there is no such line.
+ */
+
+inline double stat(const std::string& output, const std::string& label) {
+    const std::size_t pos = output.find(label);
+    if ( pos == std::string::npos ) {
+        return -1.0;
+    }
+    std::istringstream in(output.substr(pos + label.size()));
+    double value = -1.0;
+    in >> value;
+    return value;
+}
+
+}       //  namespace test
+}       //  namespace pridil
+
+#endif      // PG_PRIDIL_TEST_HELPERS_H
@@ -0,0 +1,242 @@
+/*
+ *  test_lattice.cpp
+ *  ================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Pridil unit tests for Lattice class.
+ *
+ *  Uses CppUTest unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <CppUTest/CommandLineTestRunner.h>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include "../../lattice.h"
+#include "../../creature.h"
+#include "../../game.h"
+#include "../test_helpers.h"
+
+using namespace pridil;
+using namespace pridil::test;
+
+
+namespace {
+
+    /*
+     *  Returns a new creature of the specified strategy.
+     */
+
+    Creature * new_creature(const Strategy strategy) {
+        CreatureInit c_init;
+        c_init.strategy = strategy;
+        return new Creature(c_init);
+    }
+
+}
+
+
+TEST_GROUP(LatticeGroup) {
+};
+
+
+
+/*
+ *  Tests that on a checkerboard, where every neighbour of a creature
+ *  has the other strategy, each creature gains four times what it
+ *  would from a match of the same number of games in a World, for
+ *  every pair of strategies which do not move at random.
+ */
+
+TEST(LatticeGroup, CheckerboardMatchesWorldTest) {
+    const Strategy strategies[] = { tit_for_tat, susp_tit_for_tat,
+                                    tit_for_two_tats, always_cooperate,
+                                    always_defect };
+    const std::size_t num_strategies = sizeof(strategies) /
+                                       sizeof(strategies[0]);
+    const int days = 7;
+
+    for ( std::size_t i = 0; i < num_strategies; ++i ) {
+        for ( std::size_t j = 0; j < num_strategies; ++j ) {
+            WorldInfo wInfo = TestWorld(1).with(always_cooperate, 1)
+                                          .repro_cycle_days(1)
+                                          .threads(2);
+            wInfo.m_disable_repro = true;
+            Lattice lattice(wInfo, 6, 4, von_neumann_neighbourhood);
+            for ( std::size_t y = 0; y < 4; ++y ) {
+                for ( std::size_t x = 0; x < 6; ++x ) {
+                    lattice.set_strategy(x, y, ((x + y) % 2) ?
+                                         strategies[j] : strategies[i]);
+                }
+            }
+            for ( int day = 0; day < days; ++day ) {
+                lattice.advance_day();
+            }
+
+            Creature * creature1 = new_creature(strategies[i]);
+            Creature * creature2 = new_creature(strategies[j]);
+            int score1;
+            int score2;
+            play_match(creature1, creature2, days, score1, score2);
+            delete creature1;
+            delete creature2;
+
+            CHECK_EQUAL(4 * score1, lattice.resources(0, 0));
+            CHECK_EQUAL(4 * score2, lattice.resources(1, 0));
+            CHECK_EQUAL(4 * score2, lattice.resources(4, 3));
+        }
+    }
+}
+
+
+/*
+ *  Tests that a lone always defect creature among always cooperate
+ *  creatures replaces its worst-off neighbour, which is its first
+ *  neighbour in direction order (to the east), and nothing else, and
+ *  that resources restart after the cycle.
+ */
+
+TEST(LatticeGroup, ReplaceWorstNeighbourTest) {
+    const WorldInfo wInfo = TestWorld(1).with(always_cooperate, 1)
+                                        .repro_cycle_days(1);
+    Lattice lattice(wInfo, 9, 9, von_neumann_neighbourhood);
+    lattice.set_strategy(4, 4, always_defect);
+    lattice.advance_day();
+
+    CHECK_EQUAL(2u, lattice.count(always_defect));
+    CHECK(lattice.strategy(4, 4) == always_defect);
+    CHECK(lattice.strategy(5, 4) == always_defect);
+    CHECK_EQUAL(79u, lattice.count(always_cooperate));
+
+    //  Resources of the last cycle remain visible until the next day
+
+    CHECK(lattice.resources(4, 4) > lattice.resources(0, 0));
+    lattice.advance_day();
+    CHECK(lattice.resources(0, 0) > 0);
+}
+
+
+/*
+ *  Tests that a lattice with every strategy, including those which
+ *  move at random, gives the same results whatever the number of
+ *  threads, with either neighbourhood.
+ */
+
+TEST(LatticeGroup, DeterministicTest) {
+    const Neighbourhood neighbourhoods[] = { von_neumann_neighbourhood,
+                                             moore_neighbourhood };
+    for ( int n = 0; n < 2; ++n ) {
+        std::string maps[2];
+        const unsigned int threads[2] = { 1, 3 };
+
+        for ( int i = 0; i < 2; ++i ) {
+            WorldInfo wInfo = TestWorld(1).with(always_cooperate, 1)
+                                          .repro_cycle_days(3)
+                                          .threads(threads[i]);
+            wInfo.m_random_strategy = 1;
+            wInfo.m_tit_for_tat = 1;
+            wInfo.m_tit_for_two_tats = 1;
+            wInfo.m_susp_tit_for_tat = 1;
+            wInfo.m_naive_prober = 1;
+            wInfo.m_always_defect = 1;
+            wInfo.m_seed = 77;
+
+            Lattice lattice(wInfo, 50, 37, neighbourhoods[n]);
+            for ( int day = 0; day < 30; ++day ) {
+                lattice.advance_day();
+            }
+
+            std::ostringstream out;
+            lattice.output_lattice_stats(out);
+            lattice.output_lattice_map(out);
+            maps[i] = out.str();
+        }
+        CHECK(maps[0] == maps[1]);
+    }
+}
+
+
+/*
+ *  Tests that advancing a deterministic lattice with reproduction
+ *  disabled skips most of its days, with the same results as playing
+ *  every day, and that a lattice with random moves skips none.
+ */
+
+TEST(LatticeGroup, SkipCyclesTest) {
+    const Neighbourhood neighbourhoods[] = { von_neumann_neighbourhood,
+                                             moore_neighbourhood };
+    for ( int n = 0; n < 2; ++n ) {
+        WorldInfo wInfo = TestWorld(1).with(always_cooperate, 1)
+                                      .repro_cycle_days(3)
+                                      .threads(2);
+        wInfo.m_tit_for_tat = 1;
+        wInfo.m_tit_for_two_tats = 1;
+        wInfo.m_susp_tit_for_tat = 1;
+        wInfo.m_always_defect = 1;
+        wInfo.m_disable_repro = true;
+        wInfo.m_seed = 19;
+
+        Lattice played(wInfo, 20, 15, neighbourhoods[n]);
+        Lattice skipped(wInfo, 20, 15, neighbourhoods[n]);
+        for ( int day = 0; day < 1001; ++day ) {
+            played.advance_day();
+        }
+        skipped.advance_days(1000);
+        skipped.advance_days(1);
+
+        CHECK(skipped.days_skipped() > 900);
+        CHECK_EQUAL(played.day(), skipped.day());
+        for ( std::size_t y = 0; y < 15; ++y ) {
+            for ( std::size_t x = 0; x < 20; ++x ) {
+                CHECK_EQUAL(played.resources(x, y), skipped.resources(x, y));
+            }
+        }
+
+        std::ostringstream played_out;
+        std::ostringstream skipped_out;
+        played.output_lattice_stats(played_out);
+        skipped.output_lattice_stats(skipped_out);
+        CHECK(played_out.str() == skipped_out.str());
+    }
+
+    WorldInfo wInfo = TestWorld(1).with(always_cooperate, 1)
+                                  .repro_cycle_days(3);
+    wInfo.m_random_strategy = 1;
+    wInfo.m_disable_repro = true;
+    Lattice lattice(wInfo, 10, 10, von_neumann_neighbourhood);
+    lattice.advance_days(50);
+    CHECK_EQUAL(51, lattice.day());
+    CHECK_EQUAL(0, lattice.days_skipped());
+}
+
+
+/*
+ *  Tests that too small a lattice, or one with no creatures, is
+ *  rejected.
+ */
+
+TEST(LatticeGroup, BadSizeTest) {
+    WorldInfo wInfo = TestWorld(1).with(always_cooperate, 1)
+                                  .repro_cycle_days(1);
+    bool thrown = false;
+    try {
+        Lattice lattice(wInfo, 2, 10, von_neumann_neighbourhood);
+    } catch(BadLatticeSize&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    wInfo.m_always_cooperate = 0;
+    thrown = false;
+    try {
+        Lattice lattice(wInfo, 10, 10, moore_neighbourhood);
+    } catch(BadLatticeSize&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
@@ -0,0 +1,410 @@
+/*
+ *  test_mean_field.cpp
+ *  ===================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Pridil unit tests for MeanField class.
+ *
+ *  Uses CppUTest unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <CppUTest/CommandLineTestRunner.h>
+#include <cmath>
+#include <map>
+#include <sstream>
+#include <string>
+#include "../../mean_field.h"
+#include "../../world.h"
+#include "../../cmdline.h"
+#include "../test_helpers.h"
+
+using namespace pridil;
+using namespace pridil::test;
+
+
+TEST_GROUP(MeanFieldGroup) {
+};
+
+
+
+/*
+ *  Tests that a population of cooperators with no deaths or births
+ *  gains the reward for mutual cooperation every day, and that the
+ *  statistics are output in the same format as a World's.
+ */
+
+TEST(MeanFieldGroup, CooperatorsTest) {
+    WorldInfo wInfo = TestWorld(5).with(tit_for_tat, 100).closed();
+    MeanField mean_field(wInfo);
+    for ( Day day = 1; day <= 10; ++day ) {
+        mean_field.advance_day();
+    }
+
+    DOUBLES_EQUAL(100.0, mean_field.count(tit_for_tat), 1e-9);
+    DOUBLES_EQUAL(130.0, mean_field.mean_resources(tit_for_tat), 1e-9);
+    DOUBLES_EQUAL(0.0, mean_field.count(always_defect), 1e-9);
+    CHECK_EQUAL(11, mean_field.day());
+
+    std::ostringstream out;
+    mean_field.output_world_stats(out);
+    mean_field.output_summary_resources_by_strategy(out);
+    mean_field.output_summary_dead_by_strategy(out);
+    CHECK_EQUAL(std::string("Summary world statistics:\n"
+                            "Days passed: 10\n"
+                            "Games played: 500\n"
+                            "Starting creatures: 100\n"
+                            "Living creatures: 100\n"
+                            "Creatures born: 0\n"
+                            "Creatures died: 0\n\n"
+                            "Summary resource statistics by strategy:\n"
+                            "1, tit for tat (100): max 130, min 130, "
+                            "sprd 0, avg 130\n\n"),
+                out.str());
+}
+
+
+/*
+ *  Tests that live creatures are always the starting creatures plus
+ *  those born less those which died, and that always defect grows at
+ *  the expense of tit for tat, which cooperates with strangers, and
+ *  then starves once it has nobody left to exploit.
+ */
+
+TEST(MeanFieldGroup, ConservationTest) {
+    WorldInfo wInfo = TestWorld(5).with(tit_for_tat, 900)
+                                  .with(always_defect, 100);
+    wInfo.m_default_life_expectancy = 40;
+    wInfo.m_repro_min_resources = 75;
+    MeanField mean_field(wInfo);
+    for ( Day day = 1; day <= 200; ++day ) {
+        mean_field.advance_day();
+        const double total = 1000.0 + mean_field.born_creatures();
+        DOUBLES_EQUAL(total - mean_field.dead_creatures(),
+                      mean_field.num_live(), 1e-9 * total);
+        if ( day == 100 ) {
+            CHECK(mean_field.count(always_defect) >
+                  2 * mean_field.count(tit_for_tat));
+        }
+    }
+
+    CHECK(mean_field.born_creatures() > 10000.0);
+    CHECK(mean_field.num_live() < 10.0);
+}
+
+
+/*
+ *  Tests that the chance of two creatures having met before follows
+ *  the population: a growing population meets each partner less
+ *  often, so its games stay close to first games, while a small closed
+ *  one keeps meeting the same partners.
+ */
+
+TEST(MeanFieldGroup, EncounterRateTest) {
+    WorldInfo small = TestWorld(5).with(tit_for_tat, 5).closed();
+    MeanField small_field(small);
+    WorldInfo growing = TestWorld(5).with(tit_for_tat, 5)
+                                    .repro_cycle_days(1);
+    growing.m_repro_cost = 1;
+    growing.m_repro_min_resources = 1;
+    MeanField growing_field(growing);
+
+    for ( Day day = 1; day <= 20; ++day ) {
+        small_field.advance_day();
+        growing_field.advance_day();
+    }
+
+    DOUBLES_EQUAL(1.0 + 19.0 / 4.0, small_field.match_length(), 1e-4);
+    CHECK(growing_field.num_live() > 1000.0);
+    CHECK(growing_field.match_length() < 2.0);
+}
+
+
+/*
+ *  Tests that the expected numbers of creatures scale with the size of
+ *  the starting population, so a population of billions gives the same
+ *  proportions as a small one.
+ */
+
+TEST(MeanFieldGroup, ScaleTest) {
+    WorldInfo small = TestWorld(5).with(tit_for_tat, 30)
+                                  .with(susp_tit_for_tat, 20)
+                                  .with(always_defect, 10)
+                                  .match_length(5);
+    small.m_default_life_expectancy = 30;
+    small.m_repro_min_resources = 75;
+    WorldInfo large = small;
+    large.m_tit_for_tat = 1500000000;
+    large.m_susp_tit_for_tat = 1000000000;
+    large.m_always_defect = 500000000;
+
+    MeanField small_field(small);
+    MeanField large_field(large);
+    for ( Day day = 1; day <= 60; ++day ) {
+        small_field.advance_day();
+        large_field.advance_day();
+    }
+
+    const Strategy strategies[] = { tit_for_tat, susp_tit_for_tat,
+                                    always_defect };
+    for ( int s = 0; s < 3; ++s ) {
+        const double expected = small_field.count(strategies[s]) * 5e7;
+        CHECK(expected > 1e5);
+        DOUBLES_EQUAL(expected, large_field.count(strategies[s]),
+                      1e-9 * expected);
+        DOUBLES_EQUAL(small_field.mean_resources(strategies[s]),
+                      large_field.mean_resources(strategies[s]), 1e-9);
+    }
+}
+
+
+/*
+ *  Tests that the payoffs come from repeated play, so that tit for tat
+ *  does better than always cooperate against always defect once the
+ *  creatures meet more than once, and that the match length is derived
+ *  from the chance of a re-encounter when it is not specified.
+ */
+
+TEST(MeanFieldGroup, RepeatedPlayTest) {
+    WorldInfo wInfo = TestWorld(5).with(tit_for_tat, 100)
+                                  .with(always_cooperate, 100)
+                                  .with(always_defect, 100)
+                                  .closed()
+                                  .match_length(20);
+    MeanField repeated(wInfo);
+    repeated.advance_day();
+    CHECK(repeated.mean_resources(tit_for_tat) >
+          repeated.mean_resources(always_cooperate));
+
+    wInfo.m_match_length = 1;
+    MeanField single(wInfo);
+    single.advance_day();
+    DOUBLES_EQUAL(single.mean_resources(always_cooperate),
+                  single.mean_resources(tit_for_tat), 1e-9);
+
+    WorldInfo derived = TestWorld(5).with(tit_for_tat, 11).closed();
+    MeanField encounters(derived);
+    for ( Day day = 1; day <= 3; ++day ) {
+        encounters.advance_day();
+    }
+    DOUBLES_EQUAL(1.2, encounters.match_length(), 1e-4);
+}
+
+
+/*
+ *  Tests that a large well-mixed World ends up close to the mean field
+ *  from the same starting mix.
+ */
+
+TEST(MeanFieldGroup, AgreesWithWorldTest) {
+    WorldInfo wInfo = TestWorld(5).with(tit_for_tat, 3000)
+                                  .with(susp_tit_for_tat, 1500)
+                                  .with(always_defect, 1500);
+    wInfo.m_default_life_expectancy = 30;
+    wInfo.m_repro_min_resources = 75;
+    wInfo.m_days_to_run = 60;
+
+    World world(wInfo);
+    MeanField mean_field(wInfo);
+    for ( Day day = 1; day <= wInfo.m_days_to_run; ++day ) {
+        world.advance_day();
+        mean_field.advance_day();
+    }
+
+    std::ostringstream world_out;
+    std::ostringstream field_out;
+    world.output_world_stats(world_out);
+    mean_field.output_world_stats(field_out);
+
+    const char * labels[] = { "Living creatures: ", "Creatures born: ",
+                              "Creatures died: " };
+    for ( int i = 0; i < 3; ++i ) {
+        const double world_value = stat(world_out.str(), labels[i]);
+        const double field_value = stat(field_out.str(), labels[i]);
+        CHECK(world_value > 0.0);
+        CHECK(std::fabs(world_value - field_value) < 0.05 * world_value);
+    }
+}
+
+
+/*
+ *  Reads the starting population, life expectancy, resources and
+ *  reproduction characteristics, and the days to run, from a
+ *  configuration file.
+ */
+
+namespace {
+    WorldInfo config_world(const char * config_option) {
+        const char * t_argv[] = {"pridil", config_option, NULL};
+        cmdline::CmdLineOptions clopt;
+        clopt.set_stropt("cfile", "-c", "--cfile", "config file", "");
+        clopt.set_config_file_option("cfile");
+        clopt.parse(2, t_argv);
+
+        WorldInfo wInfo = TestWorld(0)
+            .with(random_strategy, clopt.get_intopt_value("random_strategy"))
+            .with(tit_for_tat, clopt.get_intopt_value("tit_for_tat"))
+            .with(tit_for_two_tats,
+                  clopt.get_intopt_value("tit_for_two_tats"))
+            .with(susp_tit_for_tat,
+                  clopt.get_intopt_value("susp_tit_for_tat"))
+            .with(naive_prober, clopt.get_intopt_value("naive_prober"))
+            .with(always_cooperate,
+                  clopt.get_intopt_value("always_cooperate"))
+            .with(always_defect, clopt.get_intopt_value("always_defect"))
+            .life_expectancy(
+                clopt.get_intopt_value("default_life_expectancy"))
+            .starting_resources(
+                clopt.get_intopt_value("default_starting_resources"))
+            .repro_min_resources(clopt.get_intopt_value("repro_min_resources"))
+            .repro_cycle_days(clopt.get_intopt_value("repro_cycle_days"));
+        wInfo.m_repro_cost = clopt.get_intopt_value("repro_cost");
+        wInfo.m_days_to_run = clopt.get_intopt_value("days_to_run");
+        return wInfo;
+    }
+
+
+    /*
+     *  Adds the number of creatures of each strategy shown in summary
+     *  resource statistics, such as "1, always defect (146): ...", to
+     *  a total for each strategy name.
+     */
+
+    void add_strategy_counts(const std::string& output,
+                             std::map<std::string, double>& counts) {
+        std::istringstream in(output);
+        std::string line;
+        while ( std::getline(in, line) ) {
+            const std::size_t name = line.find(", ");
+            const std::size_t open = line.find(" (");
+            const std::size_t close = line.find("):");
+            if ( name == std::string::npos || open == std::string::npos ||
+                 close == std::string::npos ) {
+                continue;
+            }
+            counts[line.substr(name + 2, open - name - 2)] +=
+                stat(line.substr(open + 2), "");
+        }
+    }
+
+
+    /*
+     *  Returns the name of the strategy with the most creatures.
+     */
+
+    std::string most_numerous(const std::map<std::string, double>& counts,
+                              const std::string& except = "") {
+        std::string best;
+        double best_count = -1.0;
+        for ( std::map<std::string, double>::const_iterator itr =
+                  counts.begin(); itr != counts.end(); ++itr ) {
+            if ( itr->first != except && itr->second > best_count ) {
+                best = itr->first;
+                best_count = itr->second;
+            }
+        }
+        return best;
+    }
+}
+
+
+/*
+ *  Tests that the mean field agrees with seeded Worlds on the shipped
+ *  configuration, pridil-config: the numbers of live and dead
+ *  creatures are close to the Worlds' average, and the same two
+ *  strategies come out on top.
+ */
+
+TEST(MeanFieldGroup, ShippedConfigTest) {
+    const WorldInfo shipped = config_world("-c=pridil-config");
+    const int num_seeds = 6;
+
+    double world_live = 0.0;
+    double world_dead = 0.0;
+    std::map<std::string, double> world_counts;
+    for ( int seed = 1; seed <= num_seeds; ++seed ) {
+        WorldInfo wInfo = shipped;
+        wInfo.m_seed = seed;
+        World world(wInfo);
+        for ( Day day = 1; day <= wInfo.m_days_to_run; ++day ) {
+            world.advance_day();
+        }
+
+        std::ostringstream out;
+        world.output_world_stats(out);
+        world_live += stat(out.str(), "Living creatures: ") / num_seeds;
+        world_dead += stat(out.str(), "Creatures died: ") / num_seeds;
+        std::ostringstream resources;
+        world.output_summary_resources_by_strategy(resources);
+        add_strategy_counts(resources.str(), world_counts);
+    }
+
+    WorldInfo wInfo = shipped;
+    wInfo.m_seed = 7;
+    MeanField mean_field(wInfo);
+    for ( Day day = 1; day <= wInfo.m_days_to_run; ++day ) {
+        mean_field.advance_day();
+    }
+
+    std::ostringstream out;
+    mean_field.output_world_stats(out);
+    CHECK(world_dead > 0.0);
+    CHECK(std::fabs(stat(out.str(), "Living creatures: ") - world_live) <
+          0.25 * world_live);
+    CHECK(std::fabs(stat(out.str(), "Creatures died: ") - world_dead) <
+          0.25 * world_dead);
+
+    std::map<std::string, double> field_counts;
+    std::ostringstream resources;
+    mean_field.output_summary_resources_by_strategy(resources);
+    add_strategy_counts(resources.str(), field_counts);
+
+    const std::string world_top = most_numerous(world_counts);
+    const std::string field_top = most_numerous(field_counts);
+    CHECK(world_top == field_top ||
+          world_top == most_numerous(field_counts, field_top));
+    CHECK_EQUAL(most_numerous(world_counts, world_top),
+                most_numerous(field_counts, world_top));
+    CHECK(mean_field.count(tit_for_two_tats) < 1.0);
+}
+
+
+/*
+ *  Tests that the minimum and maximum resources of each strategy take
+ *  in its average, on the shipped configuration, under which the few
+ *  random strategy creatures left are spread thinly over many levels
+ *  of resources, with less than half a creature at each.
+ */
+
+TEST(MeanFieldGroup, ThinlySpreadRangeTest) {
+    WorldInfo wInfo = config_world("-c=pridil-config");
+    wInfo.m_seed = 7;
+    MeanField mean_field(wInfo);
+    for ( Day day = 1; day <= wInfo.m_days_to_run; ++day ) {
+        mean_field.advance_day();
+    }
+    CHECK(mean_field.count(random_strategy) > 0.5);
+    CHECK(mean_field.count(random_strategy) < 5.0);
+
+    std::ostringstream out;
+    mean_field.output_summary_resources_by_strategy(out);
+    std::istringstream in(out.str());
+    std::string line;
+    int strategies = 0;
+    while ( std::getline(in, line) ) {
+        if ( line.find("): max ") == std::string::npos ) {
+            continue;
+        }
+        const double max_res = stat(line, "max ");
+        const double min_res = stat(line, "min ");
+        const double avg_res = stat(line, "avg ");
+        CHECK(min_res <= avg_res);
+        CHECK(avg_res <= max_res);
+        ++strategies;
+    }
+    CHECK(strategies >= 3);
+}
@@ -0,0 +1,104 @@
+/*
+ *  test_forget.cpp
+ *  ===============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Pridil unit tests for forget() Memory function.
+ *
+ *  Uses CppUTest unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <CppUTest/CommandLineTestRunner.h>
+#include <sstream>
+#include "../../game.h"
+#include "../../brain_complex.h"
+
+using namespace pridil;
+
+
+TEST_GROUP(ForgetGroup) {
+};
+
+
+
+/*
+ *  Tests that forget() erases all memories of one opponent, and
+ *  leaves memories of other opponents alone.
+ */
+
+TEST(ForgetGroup, ForgetTest) {
+    Memory test_memories;
+
+    test_memories.store_memory(GameInfo(1, coop, coop, 0));
+    test_memories.store_memory(GameInfo(2, defect, coop, 0));
+    test_memories.store_memory(GameInfo(1, coop_recip, defect, 0));
+
+    test_memories.forget(1);
+    CHECK_EQUAL(false, test_memories.recognize(1));
+    CHECK_EQUAL(0, test_memories.num_memories(1));
+    CHECK_EQUAL(true, test_memories.recognize(2));
+    CHECK_EQUAL(1, test_memories.num_memories(2));
+
+    //  Forgetting an unknown opponent does nothing
+
+    test_memories.forget(3);
+    CHECK_EQUAL(1, test_memories.num_memories(2));
+
+    //  A forgotten opponent can be remembered afresh
+
+    test_memories.store_memory(GameInfo(1, defect, defect, 0));
+    CHECK_EQUAL(1, test_memories.num_memories(1));
+    CHECK_EQUAL(defect, test_memories.remember_move(1));
+}
+
+
+/*
+ *  Tests that memories stored after forget() and clear() reuse emptied
+ *  slots without mixing up opponents, and that memories are still shown
+ *  in opponent order.
+ */
+
+TEST(ForgetGroup, ReuseTest) {
+    Memory test_memories;
+
+    for ( CreatureID opponent = 5; opponent > 0; --opponent ) {
+        for ( CreatureID game = 0; game < opponent; ++game ) {
+            test_memories.store_memory(GameInfo(opponent, coop, coop, 0));
+        }
+    }
+
+    test_memories.forget(2);
+    test_memories.forget(5);
+    CHECK_EQUAL(1, test_memories.num_memories(1));
+    CHECK_EQUAL(3, test_memories.num_memories(3));
+    CHECK_EQUAL(4, test_memories.num_memories(4));
+
+    test_memories.store_memory(GameInfo(7, defect, defect, 0));
+    test_memories.store_memory(GameInfo(0, coop, defect, 0));
+    CHECK_EQUAL(1, test_memories.num_memories(7));
+    CHECK_EQUAL(defect, test_memories.remember_move(7));
+    CHECK_EQUAL(1, test_memories.num_memories(0));
+    CHECK_EQUAL(3, test_memories.num_memories(3));
+    CHECK_EQUAL(false, test_memories.recognize(2));
+
+    std::ostringstream shown;
+    test_memories.show_detailed_memories(shown);
+    CHECK_EQUAL(0u, shown.str().find("C0,"));
+    CHECK(shown.str().find("C3,") < shown.str().find("C7,"));
+
+    test_memories.clear();
+    CHECK_EQUAL(0u, test_memories.games_played());
+    for ( CreatureID opponent = 0; opponent < 8; ++opponent ) {
+        CHECK_EQUAL(false, test_memories.recognize(opponent));
+    }
+
+    test_memories.store_memory(GameInfo(3, coop, defect, 0));
+    CHECK_EQUAL(1, test_memories.num_memories(3));
+    CHECK_EQUAL(defect, test_memories.remember_move(3));
+    CHECK_EQUAL(1u, test_memories.games_played());
+}
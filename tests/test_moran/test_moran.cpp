@@ -0,0 +1,121 @@
+/*
+ *  test_moran.cpp
+ *  ==============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Pridil unit tests for Moran and FenwickTree classes.
+ *
+ *  Uses CppUTest unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <CppUTest/CommandLineTestRunner.h>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../../moran.h"
+#include "../../fenwick_tree.h"
+#include "../../rng.h"
+#include "../test_helpers.h"
+
+using namespace pridil;
+using namespace pridil::test;
+
+
+TEST_GROUP(MoranGroup) {
+};
+
+
+
+/*
+ *  Tests that a Fenwick tree finds the same item at every point of the
+ *  running total as a scan of the weights does, as weights change.
+ */
+
+TEST(MoranGroup, FenwickTreeTest) {
+    const std::size_t num_items = 37;
+    FenwickTree tree(num_items);
+    std::vector<unsigned long> weights(num_items, 0);
+    CHECK_EQUAL(0ul, tree.total());
+
+    Rng rng(11);
+    for ( int round = 0; round < 50; ++round ) {
+        for ( int change = 0; change < 10; ++change ) {
+            const std::size_t item = rng.below(num_items);
+            weights[item] = rng.below(5);
+            tree.set(item, weights[item]);
+        }
+
+        unsigned long total = 0;
+        for ( std::size_t i = 0; i < num_items; ++i ) {
+            CHECK_EQUAL(weights[i], tree.weight(i));
+            total += weights[i];
+        }
+        CHECK_EQUAL(total, tree.total());
+
+        unsigned long point = 0;
+        for ( std::size_t i = 0; i < num_items; ++i ) {
+            for ( unsigned long w = 0; w < weights[i]; ++w ) {
+                CHECK_EQUAL(i, tree.find(point++));
+            }
+        }
+    }
+}
+
+
+/*
+ *  Tests that the population keeps its size, with a death for every
+ *  birth, and that the counts by strategy stay in step with the
+ *  creatures.
+ */
+
+TEST(MoranGroup, ConstantSizeTest) {
+    WorldInfo wInfo = TestWorld(5).with(always_cooperate, 60)
+                                  .with(always_defect, 40);
+    Moran moran(wInfo);
+    for ( Day day = 1; day <= 30; ++day ) {
+        moran.advance_day();
+        CHECK_EQUAL(100u, moran.size());
+        CHECK_EQUAL(100u, moran.count(always_cooperate) +
+                          moran.count(always_defect));
+    }
+
+    std::size_t cooperators = 0;
+    for ( std::size_t i = 0; i < moran.creatures().size(); ++i ) {
+        if ( moran.creatures().strategy_value(i) == always_cooperate ) {
+            ++cooperators;
+        }
+    }
+    CHECK_EQUAL(moran.count(always_cooperate), cooperators);
+    CHECK_EQUAL(300ul, moran.steps());
+    CHECK_EQUAL(1500ul, moran.games_played());
+}
+
+
+/*
+ *  Tests that always defect, which gains from every game with always
+ *  cooperate, takes over the population.
+ */
+
+TEST(MoranGroup, FixationTest) {
+    WorldInfo wInfo = TestWorld(5).with(always_cooperate, 100)
+                                  .with(always_defect, 100);
+    Moran moran(wInfo);
+    for ( Day day = 1; day <= 1000 && !moran.fixed(); ++day ) {
+        moran.advance_day();
+    }
+
+    CHECK(moran.fixed());
+    CHECK_EQUAL(200u, moran.count(always_defect));
+
+    std::ostringstream out;
+    moran.output_world_stats(out);
+    CHECK(out.str().find("Fixed strategy: always defect\n") !=
+          std::string::npos);
+}
+
@@ -0,0 +1,362 @@
+/*
+ *  test_network.cpp
+ *  ================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Pridil unit tests for Graph and Network classes.
+ *
+ *  Uses CppUTest unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <CppUTest/CommandLineTestRunner.h>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../../graph.h"
+#include "../../network.h"
+#include "../../creature.h"
+#include "../../game.h"
+#include "../../thread_pool.h"
+#include "../test_helpers.h"
+
+using namespace pridil;
+using namespace pridil::test;
+
+
+namespace {
+
+    /*
+     *  Returns true if every half-edge of every live slot is the
+     *  opposite of its own opposite, which leads back to the slot.
+     */
+
+    bool opposites_match(const Graph& graph) {
+        for ( Slot slot = 0; slot < graph.num_slots(); ++slot ) {
+            for ( std::size_t h = graph.first_half_edge(slot);
+                  h != Graph::no_half_edge;
+                  h = graph.next_half_edge(slot, h) ) {
+                const std::size_t opposite = graph.opposite(h);
+                if ( graph.opposite(opposite) != h ||
+                     graph.target(opposite) != slot ) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+
+    /*
+     *  Returns a string listing the neighbours of every slot.
+     */
+
+    std::string adjacency(const Graph& graph) {
+        std::ostringstream out;
+        std::vector<Slot> neighbours;
+        for ( Slot slot = 0; slot < graph.num_slots(); ++slot ) {
+            graph.neighbours(slot, neighbours);
+            out << slot << ':';
+            for ( std::size_t i = 0; i < neighbours.size(); ++i ) {
+                out << ' ' << neighbours[i];
+            }
+            out << '\n';
+        }
+        return out.str();
+    }
+
+}
+
+
+TEST_GROUP(NetworkGroup) {
+};
+
+
+
+/*
+ *  Tests that a small-world network with no rewiring is a ring in
+ *  which each slot is joined to its nearest neighbours on each side.
+ */
+
+TEST(NetworkGroup, SmallWorldRingTest) {
+    ThreadPool pool(2);
+    EdgeList edges;
+    small_world_edges(20, 4, 0.0, 1, pool, edges);
+    Graph graph;
+    graph.build(20, edges, pool);
+
+    CHECK_EQUAL(40u, graph.num_edges());
+    CHECK_EQUAL(4u, graph.max_degree());
+    CHECK(opposites_match(graph));
+
+    std::vector<Slot> neighbours;
+    graph.neighbours(0, neighbours);
+    CHECK_EQUAL(4u, neighbours.size());
+    CHECK_EQUAL(1u, neighbours[0]);
+    CHECK_EQUAL(2u, neighbours[1]);
+    CHECK_EQUAL(18u, neighbours[2]);
+    CHECK_EQUAL(19u, neighbours[3]);
+}
+
+
+/*
+ *  Tests that generated networks are the same whatever the number of
+ *  threads, and that a scale-free network has hubs.
+ */
+
+TEST(NetworkGroup, GeneratorsDeterministicTest) {
+    std::string small_world[2];
+    std::string scale_free[2];
+    std::size_t max_degree = 0;
+    std::size_t num_edges = 0;
+    const unsigned int threads[2] = { 1, 3 };
+
+    for ( int i = 0; i < 2; ++i ) {
+        ThreadPool pool(threads[i]);
+        EdgeList edges;
+        Graph graph;
+
+        small_world_edges(30000, 6, 0.3, 9, pool, edges);
+        graph.build(30000, edges, pool);
+        CHECK(opposites_match(graph));
+        small_world[i] = adjacency(graph);
+
+        scale_free_edges(30000, 6, 9, pool, edges);
+        graph.build(30000, edges, pool);
+        CHECK(opposites_match(graph));
+        scale_free[i] = adjacency(graph);
+        max_degree = graph.max_degree();
+        num_edges = graph.num_edges();
+    }
+
+    CHECK(small_world[0] == small_world[1]);
+    CHECK(scale_free[0] == scale_free[1]);
+    CHECK(num_edges > 80000 && num_edges <= 90000);
+    CHECK(max_degree > 50 * 2 * num_edges / 30000);
+}
+
+
+/*
+ *  Tests that edge lists are read with comments and blank lines
+ *  skipped, duplicate edges merged and edges from a slot to itself
+ *  ignored, and that bad edge lists are rejected.
+ */
+
+TEST(NetworkGroup, EdgeListTest) {
+    ThreadPool pool(1);
+    EdgeList edges;
+    std::istringstream in("# A triangle\n0 1\n\n1 2\n  2 0\n1 0\n3 3\n");
+    read_edge_list(in, edges);
+    CHECK_EQUAL(5u, edges.size());
+
+    Graph graph;
+    graph.build(4, edges, pool);
+    CHECK_EQUAL(3u, graph.num_edges());
+    CHECK_EQUAL(2u, graph.degree(0));
+    CHECK_EQUAL(0u, graph.degree(3));
+
+    bool thrown = false;
+    try {
+        graph.build(3, edges, pool);
+    } catch(BadEdgeList&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    const char * bad_lists[] = { "0 1\n2\n", "0 x\n", "0 -1\n", "0 1 2\n" };
+    for ( int i = 0; i < 4; ++i ) {
+        std::istringstream bad_in(bad_lists[i]);
+        thrown = false;
+        try {
+            read_edge_list(bad_in, edges);
+        } catch(BadEdgeList&) {
+            thrown = true;
+        }
+        CHECK(thrown);
+    }
+}
+
+
+/*
+ *  Tests that vacated slots and patch edges are seen straight away,
+ *  and that a rebuild folds them in and renumbers the live slots in
+ *  order.
+ */
+
+TEST(NetworkGroup, PatchAndRebuildTest) {
+    ThreadPool pool(2);
+    EdgeList edges;
+    small_world_edges(6, 2, 0.0, 1, pool, edges);
+    Graph graph;
+    graph.build(6, edges, pool);
+    CHECK_EQUAL(6u, graph.num_edges());
+
+    graph.vacate(2);
+    const Slot slot = graph.add_slot();
+    graph.add_edge(slot, 0);
+    graph.add_edge(slot, 3);
+
+    CHECK_EQUAL(6u, slot);
+    CHECK_EQUAL(6u, graph.num_live());
+    CHECK_EQUAL(2u, graph.num_patch_edges());
+    CHECK_EQUAL(1u, graph.degree(1));
+    CHECK_EQUAL(3u, graph.degree(0));
+    CHECK_EQUAL(2u, graph.degree(slot));
+    CHECK_EQUAL(6u, graph.num_edges());
+    CHECK(opposites_match(graph));
+
+    graph.rebuild(pool);
+    CHECK_EQUAL(6u, graph.num_slots());
+    CHECK_EQUAL(0u, graph.num_patch_edges());
+    CHECK_EQUAL(6u, graph.num_edges());
+    CHECK(opposites_match(graph));
+
+    std::vector<Slot> neighbours;
+    graph.neighbours(5, neighbours);
+    CHECK_EQUAL(2u, neighbours.size());
+    CHECK_EQUAL(0u, neighbours[0]);
+    CHECK_EQUAL(2u, neighbours[1]);
+}
+
+
+/*
+ *  Tests that when every edge is played, two joined creatures gain
+ *  what they would from a match of the same number of games.
+ */
+
+TEST(NetworkGroup, AllEdgesMatchesPlayMatchTest) {
+    const Strategy strategies[] = { tit_for_tat, susp_tit_for_tat,
+                                    always_defect };
+    const int days = 7;
+
+    for ( int i = 0; i < 3; ++i ) {
+        for ( int j = i + 1; j < 3; ++j ) {
+            WorldInfo wInfo = TestWorld(5).closed();
+            int * counts[] = { &wInfo.m_tit_for_tat,
+                               &wInfo.m_susp_tit_for_tat,
+                               &wInfo.m_always_defect };
+            *counts[i] = 1;
+            *counts[j] = 1;
+            wInfo.m_threads = 2;
+
+            Network network(wInfo, NetworkInfo());
+            CHECK_EQUAL(1u, network.graph().num_edges());
+            for ( int day = 0; day < days; ++day ) {
+                network.advance_day();
+            }
+            CHECK_EQUAL(static_cast<unsigned long>(days),
+                        network.games_played());
+
+            CreatureInit c_init;
+            c_init.strategy = strategies[i];
+            Creature creature1(c_init, 0);
+            c_init.strategy = strategies[j];
+            Creature creature2(c_init, 0);
+            int score1;
+            int score2;
+            play_match(&creature1, &creature2, days, score1, score2);
+
+            const CreatureList& creatures = network.creatures();
+            for ( std::size_t c = 0; c < creatures.size(); ++c ) {
+                const int score = creatures[c]->strategy_value() ==
+                                  strategies[i] ? score1 : score2;
+                CHECK_EQUAL(wInfo.m_default_starting_resources + score,
+                            creatures[c]->resources());
+            }
+        }
+    }
+}
+
+
+/*
+ *  Tests the number of games played each day with every edge played,
+ *  and with a matching, in which no creature plays more than once.
+ */
+
+TEST(NetworkGroup, GamesPerDayTest) {
+    WorldInfo wInfo = TestWorld(5).with(tit_for_tat, 100)
+                                  .with(susp_tit_for_tat, 100)
+                                  .with(always_defect, 100)
+                                  .closed();
+    NetworkInfo nInfo;
+    nInfo.m_rewire_prob = 0.0;
+    Network all_edges(wInfo, nInfo);
+    for ( int day = 0; day < 5; ++day ) {
+        all_edges.advance_day();
+    }
+    CHECK_EQUAL(5u * 600u, all_edges.games_played());
+
+    nInfo.m_play = edge_matching_play;
+    nInfo.m_rewire_prob = 0.2;
+    Network matching(wInfo, nInfo);
+    for ( int day = 0; day < 5; ++day ) {
+        const unsigned long games = matching.games_played();
+        matching.advance_day();
+        const unsigned long day_games = matching.games_played() - games;
+        CHECK(day_games > 100 && day_games <= 150);
+    }
+}
+
+
+/*
+ *  Tests that a network with deaths, births and rebuilds, and with
+ *  creatures which move at random, gives the same results whatever the
+ *  number of threads, with either way of playing games, and that no
+ *  creatures are lost. Creature IDs carry
+ *  on from one network to the next, so only outputs without IDs are
+ *  compared.
+ */
+
+TEST(NetworkGroup, DeterministicTest) {
+    const NetworkShape shapes[] = { small_world_network,
+                                    scale_free_network };
+    const NetworkPlay plays[] = { all_edges_play, edge_matching_play };
+
+    for ( int n = 0; n < 2; ++n ) {
+        std::string results[2];
+        const unsigned int threads[2] = { 1, 3 };
+
+        for ( int i = 0; i < 2; ++i ) {
+            WorldInfo wInfo = TestWorld(5).with(tit_for_tat, 300)
+                                          .with(susp_tit_for_tat, 300)
+                                          .with(always_defect, 300)
+                                          .with(random_strategy, 300)
+                                          .with(naive_prober, 300)
+                                          .closed();
+            wInfo.m_disable_deaths = false;
+            wInfo.m_disable_repro = false;
+            wInfo.m_default_life_expectancy = 25;
+            wInfo.m_repro_cycle_days = 5;
+            wInfo.m_threads = threads[i];
+
+            NetworkInfo nInfo;
+            nInfo.m_shape = shapes[n];
+            nInfo.m_play = plays[n];
+            nInfo.m_rebuild_days = 7;
+
+            Network network(wInfo, nInfo);
+            for ( int day = 0; day < 40; ++day ) {
+                network.advance_day();
+            }
+
+            std::size_t live = 0;
+            for ( std::size_t c = 0; c < network.creatures().size(); ++c ) {
+                live += (network.creatures()[c] != 0);
+            }
+            CHECK_EQUAL(1500 + network.born_creatures(),
+                        live + network.dead_creatures().size());
+            CHECK(network.born_creatures() > 0);
+            CHECK(network.rebuilds() > 0);
+
+            std::ostringstream out;
+            network.output_network_stats(out);
+            results[i] = out.str();
+        }
+        CHECK(results[0] == results[1]);
+    }
+}
@@ -0,0 +1,306 @@
+/*
+ *  test_pairing.cpp
+ *  ================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Pridil unit tests for Pairing and Rng classes.
+ *
+ *  Uses CppUTest unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <CppUTest/CommandLineTestRunner.h>
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+#include "../../pairing.h"
+#include "../../thread_pool.h"
+#include "../../rng.h"
+
+using namespace pridil;
+
+
+namespace {
+
+    /*
+     *  Returns true if the matching is a permutation of 0 to n - 1.
+     */
+
+    bool is_permutation(const Matching& matching, const std::size_t n) {
+        if ( matching.size() != n ) {
+            return false;
+        }
+        std::vector<bool> seen(n, false);
+        for ( std::size_t i = 0; i < n; ++i ) {
+            if ( matching[i] >= n || seen[matching[i]] ) {
+                return false;
+            }
+            seen[matching[i]] = true;
+        }
+        return true;
+    }
+
+}
+
+
+TEST_GROUP(RngGroup) {
+};
+
+TEST_GROUP(PairingGroup) {
+};
+
+
+
+/*
+ *  Tests that generators with the same seed and stream repeat, and
+ *  that different streams differ.
+ */
+
+TEST(RngGroup, ReproducibleTest) {
+    Rng rng1(42, 7);
+    Rng rng2(42, 7);
+    Rng rng3(42, 8);
+
+    bool streams_differ = false;
+    for ( int i = 0; i < 100; ++i ) {
+        const uint64_t value = rng1.next();
+        CHECK(value == rng2.next());
+        if ( value != rng3.next() ) {
+            streams_differ = true;
+        }
+    }
+    CHECK(streams_differ);
+}
+
+
+/*
+ *  Tests that below() stays within range and hits every value, and
+ *  that uniform() stays within [0, 1).
+ */
+
+TEST(RngGroup, RangeTest) {
+    Rng rng(1);
+    std::vector<int> hits(10, 0);
+
+    for ( int i = 0; i < 10000; ++i ) {
+        const uint32_t value = rng.below(10);
+        CHECK(value < 10);
+        ++hits[value];
+
+        const double u = rng.uniform();
+        CHECK(u >= 0.0 && u < 1.0);
+    }
+    for ( int i = 0; i < 10; ++i ) {
+        CHECK(hits[i] > 800 && hits[i] < 1200);
+    }
+    CHECK_EQUAL(0u, rng.below(1));
+}
+
+
+/*
+ *  Tests that small and multi-bucket matchings are permutations, and
+ *  that odd numbers of creatures are handled.
+ */
+
+TEST(PairingGroup, PermutationTest) {
+    ThreadPool pool(3);
+    Pairing pairing(pool, 12345);
+
+    const std::size_t sizes[] = { 0, 1, 2, 7, 1000, 200001 };
+    for ( std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i ) {
+        pairing.pair(sizes[i], 1);
+        CHECK(is_permutation(pairing.matching(), sizes[i]));
+        CHECK_EQUAL(sizes[i] / 2, pairing.num_pairs());
+    }
+}
+
+
+/*
+ *  Tests that the matching depends only on the seed and day, not
+ *  on the number of threads, and that it changes from day to day.
+ */
+
+TEST(PairingGroup, DeterministicTest) {
+    ThreadPool pool1(1);
+    ThreadPool pool4(4);
+    Pairing pairing1(pool1, 99);
+    Pairing pairing4(pool4, 99);
+
+    pairing1.pair(300000, 5);
+    pairing4.pair(300000, 5);
+    CHECK(pairing1.matching() == pairing4.matching());
+
+    const Matching day5 = pairing1.matching();
+    pairing1.pair(300000, 6);
+    CHECK(pairing1.matching() != day5);
+}
+
+
+/*
+ *  Tests that each index is roughly equally likely to end up in
+ *  each position, across both the single-bucket and multi-bucket
+ *  shuffles.
+ */
+
+TEST(PairingGroup, UniformTest) {
+    ThreadPool pool(2);
+    Pairing pairing(pool, 7);
+
+    const std::size_t n = 4;
+    const int days = 8000;
+    std::vector<int> counts(n * n, 0);
+    for ( int day = 1; day <= days; ++day ) {
+        pairing.pair(n, day);
+        for ( std::size_t pos = 0; pos < n; ++pos ) {
+            ++counts[pairing.matching()[pos] * n + pos];
+        }
+    }
+    for ( std::size_t i = 0; i < n * n; ++i ) {
+        CHECK(counts[i] > 1800 && counts[i] < 2200);
+    }
+
+    //  With many buckets, check where index 0 lands, by tenths of
+    //  the matching.
+
+    const std::size_t big_n = 150000;
+    std::vector<int> tenths(10, 0);
+    for ( int day = 1; day <= 500; ++day ) {
+        pairing.pair(big_n, day);
+        const Matching& matching = pairing.matching();
+        for ( std::size_t pos = 0; pos < big_n; ++pos ) {
+            if ( matching[pos] == 0 ) {
+                ++tenths[pos * 10 / big_n];
+                break;
+            }
+        }
+    }
+    for ( int i = 0; i < 10; ++i ) {
+        CHECK(tenths[i] > 20 && tenths[i] < 85);
+    }
+}
+
+
+/*
+ *  Tests that local matchings are permutations, including with
+ *  partial blocks, odd numbers of blocks and odd numbers of
+ *  creatures, and that they are independent of the thread count.
+ */
+
+TEST(PairingGroup, LocalPermutationTest) {
+    ThreadPool pool1(1);
+    ThreadPool pool3(3);
+    Pairing pairing1(pool1, 5, local_pairing, 16);
+    Pairing pairing3(pool3, 5, local_pairing, 16);
+
+    const std::size_t sizes[] = { 0, 1, 2, 15, 16, 17, 48, 49, 160, 1001 };
+    for ( std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i ) {
+        for ( int day = 1; day <= 20; ++day ) {
+            pairing1.pair(sizes[i], day);
+            pairing3.pair(sizes[i], day);
+            CHECK(is_permutation(pairing1.matching(), sizes[i]));
+            CHECK(pairing1.matching() == pairing3.matching());
+        }
+    }
+}
+
+
+/*
+ *  Tests that local pairs are only ever made between two blocks, with
+ *  the block boundaries rotated, and that a creature's partners are
+ *  close to uniformly spread over the population.
+ */
+
+TEST(PairingGroup, LocalMixingTest) {
+    ThreadPool pool(2);
+    const std::size_t block = 64;
+    const std::size_t n = 64 * block;
+    Pairing pairing(pool, 11, local_pairing, block);
+
+    //  Consecutive stretches of 'block' games touch at most two
+    //  blocks' worth of distinct index ranges.
+
+    pairing.pair(n, 1);
+    const Matching& matching = pairing.matching();
+    for ( std::size_t start = 0; start < n; start += 2 * block ) {
+        std::vector<bool> blocks_seen(n / block + 1, false);
+        int distinct = 0;
+        for ( std::size_t pos = start; pos < start + 2 * block; ++pos ) {
+            const std::size_t b = matching[pos] / block;
+            if ( !blocks_seen[b] ) {
+                blocks_seen[b] = true;
+                ++distinct;
+            }
+        }
+
+        //  With rotation, each block spans at most two unrotated blocks.
+
+        CHECK(distinct <= 4);
+    }
+
+    //  Over many days, creature 0's partners fall evenly across
+    //  eighths of the population.
+
+    std::vector<int> eighths(8, 0);
+    const int days = 4000;
+    for ( int day = 1; day <= days; ++day ) {
+        pairing.pair(n, day);
+        const Matching& m = pairing.matching();
+        for ( std::size_t pos = 0; pos < n; ++pos ) {
+            if ( m[pos] == 0 ) {
+                ++eighths[m[pos ^ 1] * 8 / n];
+                break;
+            }
+        }
+    }
+    for ( int i = 0; i < 8; ++i ) {
+        CHECK(eighths[i] > 400 && eighths[i] < 600);
+    }
+}
+
+
+/*
+ *  Tests that rematching keeps accepted pairs in place, pairs the
+ *  creatures of refused pairs and the odd creature again after them,
+ *  and that sitting out drops refused pairs, all while keeping the
+ *  matching a permutation.
+ */
+
+TEST(PairingGroup, RematchTest) {
+    ThreadPool pool(2);
+    Pairing pairing(pool, 17);
+    const std::size_t n = 1001;
+
+    pairing.pair(n, 3);
+    const Matching original = pairing.matching();
+    std::vector<unsigned char> refused(pairing.num_pairs(), 0);
+    for ( std::size_t pair = 0; pair < refused.size(); pair += 3 ) {
+        refused[pair] = 1;
+    }
+
+    const std::size_t first_new = pairing.rematch(refused, 0, 3, 0);
+    CHECK_EQUAL(333u, first_new);
+    CHECK_EQUAL(500u, pairing.num_pairs());
+    CHECK(is_permutation(pairing.matching(), n));
+    for ( std::size_t pair = 0, kept = 0; pair < refused.size(); ++pair ) {
+        if ( !refused[pair] ) {
+            CHECK(pairing.matching()[2 * kept] == original[2 * pair]);
+            CHECK(pairing.matching()[2 * kept + 1] == original[2 * pair + 1]);
+            ++kept;
+        }
+    }
+
+    std::fill(refused.begin(), refused.end(), 0);
+    refused[first_new] = 1;
+    refused[first_new + 5] = 1;
+    const Matching before_sit_out = pairing.matching();
+    pairing.sit_out(refused, first_new);
+    CHECK_EQUAL(498u, pairing.num_pairs());
+    CHECK_EQUAL(5u, pairing.num_sitting_out());
+    CHECK(is_permutation(pairing.matching(), n));
+    CHECK(pairing.matching()[2 * first_new] ==
+          before_sit_out[2 * (first_new + 1)]);
+}
@@ -0,0 +1,215 @@
+/*
+ *  test_population.cpp
+ *  ===================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Pridil unit tests for Population class.
+ *
+ *  Uses CppUTest unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <CppUTest/CommandLineTestRunner.h>
+#include <string>
+#include "../../population.h"
+#include "../../creature.h"
+#include "../../game.h"
+
+using namespace pridil;
+
+
+TEST_GROUP(PopulationGroup) {
+};
+
+
+
+/*
+ *  Tests that creatures keep their entries when moved within and
+ *  between populations, and that rows removed by resize() are gone.
+ */
+
+TEST(PopulationGroup, MoveAndAppendTest) {
+    Population population;
+    const Strategy strategies[] = { tit_for_tat, always_defect,
+                                    always_cooperate, susp_tit_for_tat };
+    for ( int i = 0; i < 4; ++i ) {
+        population.add(CreatureInit(50 + i, 0, strategies[i], 100 + i,
+                                    50, 75), 10 + i, i);
+    }
+    CHECK_EQUAL(4u, population.size());
+    CHECK_EQUAL(always_defect, population.strategy_value(1));
+    CHECK_EQUAL(std::string("always defect"), population.strategy(1));
+
+    Population other;
+    other.append(population, 1);
+    population.move(population, 3, 1);
+    population.resize(3);
+
+    CHECK_EQUAL(1u, other.size());
+    CHECK_EQUAL(11, other.id(0));
+    CHECK_EQUAL(1, other.birth_day(0));
+    CHECK_EQUAL(101, other.resources(0));
+    CHECK_EQUAL(51, other.life_expectancy(0));
+    CHECK_EQUAL(always_defect, other.strategy_value(0));
+
+    CHECK_EQUAL(3u, population.size());
+    CHECK_EQUAL(13, population.id(1));
+    CHECK_EQUAL(susp_tit_for_tat, population.strategy_value(1));
+
+    population.append(other);
+    CHECK_EQUAL(0u, other.size());
+    CHECK_EQUAL(4u, population.size());
+    CHECK_EQUAL(11, population.id(3));
+    CHECK_EQUAL(std::string("always defect"), population.strategy(3));
+}
+
+
+/*
+ *  Tests that creatures die when they outlive their life expectancy,
+ *  counting from their birth day, or run out of resources.
+ */
+
+TEST(PopulationGroup, IsDeadTest) {
+    Population population;
+    population.add(CreatureInit(5, 0, tit_for_tat, 100, 66, 88), 0, 3);
+    population.add(CreatureInit(5, 0, tit_for_tat, 0, 66, 88), 1, 3);
+
+    CHECK(population.is_dead(0, 8) == false);
+    CHECK(population.is_dead(0, 9));
+    CHECK(population.is_dead(1, 4));
+
+    population.spend_resources(0, 100);
+    CHECK(population.is_dead(0, 4));
+}
+
+
+/*
+ *  Tests that games between creatures in a population give the same
+ *  results as games between Creature objects.
+ */
+
+TEST(PopulationGroup, PlayGameTest) {
+    const Strategy strategies[] = { tit_for_tat, susp_tit_for_tat,
+                                    tit_for_two_tats, always_defect };
+
+    for ( int i = 0; i < 4; ++i ) {
+        for ( int j = 0; j < 4; ++j ) {
+            const CreatureInit init1(1000, 0, strategies[i], 100, 50, 75);
+            const CreatureInit init2(1000, 0, strategies[j], 100, 50, 75);
+            Creature creature1(init1, 0);
+            Creature creature2(init2, 1);
+            Population population;
+            population.add(init1, 0, 0);
+            population.add(init2, 1, 0);
+
+            for ( int game = 0; game < 6; ++game ) {
+                play_game(&creature1, &creature2);
+                play_game(population, 0, 1);
+            }
+
+            CHECK_EQUAL(creature1.resources(), population.resources(0));
+            CHECK_EQUAL(creature2.resources(), population.resources(1));
+            CHECK(creature1.refuses(1) == population.refuses(0, 1));
+            CHECK(creature2.refuses(0) == population.refuses(1, 0));
+        }
+    }
+}
+
+
+/*
+ *  Tests that a population using a pool gives its Brains back when
+ *  rows die, and that a reused Brain plays as a new creature would,
+ *  with none of the memories of the creature it belonged to.
+ */
+
+TEST(PopulationGroup, BrainPoolTest) {
+    const CreatureInit init1(1000, 0, tit_for_tat, 100, 50, 75);
+    const CreatureInit init2(1000, 0, always_defect, 100, 50, 75);
+    BrainPool brains;
+
+    {
+        Population population(&brains);
+        population.add(init1, 0, 0);
+        population.add(init2, 1, 0);
+        for ( int game = 0; game < 3; ++game ) {
+            play_game(population, 0, 1);
+        }
+        CHECK_EQUAL(2u, brains.num_brains());
+        CHECK_EQUAL(0u, brains.num_free());
+
+        population.release_brain(0);
+        population.release_brain(1);
+        CHECK_EQUAL(2u, brains.num_free());
+        CHECK_EQUAL(std::string("tit for tat"),
+                    brains.strategy_name(tit_for_tat));
+
+        population.create(0, init1, 2, 5);
+        population.create(1, init2, 3, 5);
+        CHECK_EQUAL(2u, brains.num_brains());
+        CHECK_EQUAL(0u, brains.num_free());
+
+        Creature creature1(init1, 2);
+        Creature creature2(init2, 3);
+        for ( int game = 0; game < 3; ++game ) {
+            play_game(&creature1, &creature2);
+            play_game(population, 0, 1);
+        }
+        CHECK_EQUAL(creature1.resources(), population.resources(0));
+        CHECK_EQUAL(creature2.resources(), population.resources(1));
+        CHECK_EQUAL(2u, population.id(0));
+
+        population.resize(0);
+        CHECK_EQUAL(2u, brains.num_free());
+    }
+
+    const CreatureInit init3(1000, 0, susp_tit_for_tat, 100, 50, 75);
+    Population other(&brains);
+    other.add(init3, 4, 0);
+    CHECK_EQUAL(3u, brains.num_brains());
+}
+
+
+/*
+ *  Tests that tombstones record a creature's life and the cause of its
+ *  death, and the same for a Creature object.
+ */
+
+TEST(PopulationGroup, TombstoneTest) {
+    const CreatureInit init1(1000, 0, tit_for_tat, 100, 50, 75);
+    const CreatureInit init2(1000, 0, always_defect, 100, 50, 75);
+    Population population;
+    population.add(init1, 7, 2);
+    population.add(init2, 8, 4);
+    Creature creature(init1, 9);
+    for ( int game = 0; game < 3; ++game ) {
+        play_game(population, 0, 1);
+    }
+    creature.age_day();
+    creature.age_day();
+    CHECK_EQUAL(3u, population.games_played(0));
+
+    const Tombstone first = population.tombstone(0, 10);
+    CHECK_EQUAL(7, first.id);
+    CHECK_EQUAL(2, first.birth_day);
+    CHECK_EQUAL(10, first.death_day);
+    CHECK_EQUAL(population.resources(0), first.final_resources);
+    CHECK_EQUAL(3u, first.games_played);
+    CHECK_EQUAL(tit_for_tat, first.strategy);
+    CHECK_EQUAL(died_of_age, first.cause);
+
+    population.spend_resources(1, population.resources(1));
+    const Tombstone second = population.tombstone(1, 5);
+    CHECK_EQUAL(0, second.final_resources);
+    CHECK_EQUAL(always_defect, second.strategy);
+    CHECK_EQUAL(died_of_starvation, second.cause);
+
+    const Tombstone third = creature.tombstone(6);
+    CHECK_EQUAL(9, third.id);
+    CHECK_EQUAL(4, third.birth_day);
+    CHECK_EQUAL(0u, third.games_played);
+    CHECK_EQUAL(died_of_age, third.cause);
+}
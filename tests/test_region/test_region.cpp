@@ -0,0 +1,720 @@
+/*
+ *  test_region.cpp
+ *  ===============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Pridil unit tests for Region and Calendar classes, and regions in a
+ *  World.
+ *
+ *  Uses CppUTest unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <CppUTest/CommandLineTestRunner.h>
+#include <cstddef>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../../region.h"
+#include "../../world.h"
+#include "../../creature.h"
+#include "../../population.h"
+#include "../../slot_map.h"
+#include "../../brain_pool.h"
+#include "../../calendar.h"
+#include "../test_helpers.h"
+
+using namespace pridil;
+using namespace pridil::test;
+
+
+namespace {
+
+    /*
+     *  Creates the specified number of regions, with handles in the
+     *  specified slot map and Brains from the specified pool, and
+     *  shares the starting population out between them in consecutive
+     *  blocks.
+     */
+
+    std::vector<Region *> make_regions(const WorldInfo& wInfo,
+                                       const unsigned int num_regions,
+                                       SlotMap& slots, BrainPool& brains) {
+        std::vector<Region *> regions;
+        for ( unsigned int r = 0; r < num_regions; ++r ) {
+            regions.push_back(new Region(wInfo, r, 1, slots, brains));
+        }
+
+        Population creatures(&brains);
+        create_creatures(wInfo, creatures);
+        for ( std::size_t i = 0; i < creatures.size(); ++i ) {
+            regions[i * num_regions / creatures.size()]->add_creature(
+                    creatures, i);
+        }
+        return regions;
+    }
+
+
+    /*
+     *  Advances the regions through one day, one phase at a time, by
+     *  default without deaths or reproduction.
+     */
+
+    void advance_regions(std::vector<Region *>& regions, const Day day,
+                         const bool deaths_enabled = false,
+                         const bool repro_day = false) {
+        for ( std::size_t r = 0; r < regions.size(); ++r ) {
+            regions[r]->play_day(day, deaths_enabled, repro_day);
+        }
+        for ( std::size_t r = 0; r < regions.size(); ++r ) {
+            const CreatureID first_id =
+                Creature::reserve_ids(regions[r]->births());
+            regions[r]->reserve_newborns();
+            regions[r]->commit_day(day, first_id, regions);
+        }
+        for ( std::size_t r = 0; r < regions.size(); ++r ) {
+            regions[r]->release_dead();
+        }
+        for ( std::size_t r = 0; r < regions.size(); ++r ) {
+            regions[r]->admit_immigrants();
+        }
+    }
+
+
+    /*
+     *  Returns the set of IDs of the live creatures in a region.
+     */
+
+    std::set<CreatureID> region_ids(const Region& region) {
+        std::set<CreatureID> ids;
+        const Population& creatures = region.creatures();
+        for ( std::size_t i = 0; i < creatures.size(); ++i ) {
+            ids.insert(creatures.id(i));
+        }
+        return ids;
+    }
+
+
+    /*
+     *  Deletes the regions.
+     */
+
+    void delete_regions(std::vector<Region *>& regions) {
+        for ( std::size_t r = 0; r < regions.size(); ++r ) {
+            delete regions[r];
+        }
+        regions.clear();
+    }
+
+}
+
+
+TEST_GROUP(RegionGroup) {
+};
+
+
+
+/*
+ *  Tests that migration moves creatures between regions without
+ *  losing or duplicating any, that each region plays games only
+ *  among its own creatures, and that the slot map follows each
+ *  creature to its new region and row.
+ */
+
+TEST(RegionGroup, MigrationConservesCreaturesTest) {
+    WorldInfo wInfo = TestWorld(3).with(tit_for_tat, 300)
+                                  .with(always_defect, 301)
+                                  .closed();
+    wInfo.m_migration_rate = 0.2;
+    SlotMap slots;
+    BrainPool brains;
+    std::vector<Region *> regions = make_regions(wInfo, 4, slots, brains);
+
+    std::set<CreatureID> start_ids;
+    for ( std::size_t r = 0; r < regions.size(); ++r ) {
+        const std::set<CreatureID> ids = region_ids(*regions[r]);
+        start_ids.insert(ids.begin(), ids.end());
+    }
+    CHECK_EQUAL(601u, start_ids.size());
+
+    unsigned long expected_games = 0;
+    for ( Day day = 1; day <= 20; ++day ) {
+        for ( std::size_t r = 0; r < regions.size(); ++r ) {
+            expected_games += regions[r]->creatures().size() / 2;
+        }
+        advance_regions(regions, day);
+    }
+
+    std::set<CreatureID> end_ids;
+    std::size_t num_creatures = 0;
+    unsigned long games = 0;
+    unsigned long emigrants = 0;
+    for ( std::size_t r = 0; r < regions.size(); ++r ) {
+        const std::set<CreatureID> ids = region_ids(*regions[r]);
+        end_ids.insert(ids.begin(), ids.end());
+        num_creatures += regions[r]->creatures().size();
+        games += regions[r]->games_played();
+        emigrants += regions[r]->emigrants();
+    }
+    CHECK_EQUAL(601u, num_creatures);
+    CHECK(start_ids == end_ids);
+    CHECK_EQUAL(expected_games, games);
+
+    CHECK_EQUAL(601u, slots.size());
+    for ( std::size_t r = 0; r < regions.size(); ++r ) {
+        const Population& creatures = regions[r]->creatures();
+        for ( std::size_t i = 0; i < creatures.size(); ++i ) {
+            const SlotLocation& location = slots.location(creatures.handle(i));
+            CHECK_EQUAL(r, location.region);
+            CHECK_EQUAL(i, location.row);
+        }
+    }
+
+    //  About a fifth of the creatures migrate each day
+
+    CHECK(emigrants > 2000 && emigrants < 2800);
+
+    delete_regions(regions);
+}
+
+
+/*
+ *  Tests that with a migration rate of zero, each region keeps exactly
+ *  the creatures it started with.
+ */
+
+TEST(RegionGroup, ClosedRegionsTest) {
+    WorldInfo wInfo = TestWorld(3).with(tit_for_tat, 100)
+                                  .with(always_defect, 100)
+                                  .closed();
+    SlotMap slots;
+    BrainPool brains;
+    std::vector<Region *> regions = make_regions(wInfo, 3, slots, brains);
+
+    std::vector<std::set<CreatureID> > start_ids;
+    for ( std::size_t r = 0; r < regions.size(); ++r ) {
+        start_ids.push_back(region_ids(*regions[r]));
+    }
+    for ( Day day = 1; day <= 10; ++day ) {
+        advance_regions(regions, day);
+    }
+    for ( std::size_t r = 0; r < regions.size(); ++r ) {
+        CHECK(start_ids[r] == region_ids(*regions[r]));
+        CHECK_EQUAL(0u, regions[r]->emigrants());
+    }
+
+    delete_regions(regions);
+}
+
+
+/*
+ *  Tests that a world with several regions, deaths, births and
+ *  migration produces the same results whatever the number of
+ *  threads. Creature IDs carry on from one world to the next, so only
+ *  outputs without IDs are compared.
+ */
+
+TEST(RegionGroup, WorldDeterministicTest) {
+    std::string results[2];
+    const unsigned int threads[2] = { 1, 3 };
+
+    for ( int i = 0; i < 2; ++i ) {
+        WorldInfo wInfo = TestWorld(3).with(tit_for_tat, 200)
+                                      .with(always_defect, 200)
+                                      .closed();
+        wInfo.m_susp_tit_for_tat = 200;
+        wInfo.m_disable_deaths = false;
+        wInfo.m_disable_repro = false;
+        wInfo.m_default_life_expectancy = 40;
+        wInfo.m_repro_min_resources = 75;
+        wInfo.m_regions = 5;
+        wInfo.m_migration_rate = 0.05;
+        wInfo.m_threads = threads[i];
+
+        World world(wInfo);
+        for ( Day day = 1; day <= 60; ++day ) {
+            world.advance_day();
+        }
+
+        std::ostringstream out;
+        world.output_world_stats(out);
+        world.output_summary_resources_by_strategy(out);
+        world.output_summary_dead_by_strategy(out);
+        results[i] = out.str();
+    }
+
+    CHECK(results[0] == results[1]);
+    CHECK(results[0].find("Creatures migrated: 0") == std::string::npos);
+}
+
+
+/*
+ *  Tests that the single games of random strategy and naive prober
+ *  creatures, whose random moves are drawn while the games are shared
+ *  out among threads, give the same results whatever the number of
+ *  threads, and that random strategy creatures defect about half the
+ *  time.
+ */
+
+TEST(RegionGroup, RandomMovesDeterministicTest) {
+    std::string results[2];
+    const unsigned int threads[2] = { 1, 3 };
+
+    for ( int i = 0; i < 2; ++i ) {
+        WorldInfo wInfo = TestWorld(3).with(random_strategy, 1000)
+                                      .with(naive_prober, 1000)
+                                      .with(always_cooperate, 1000)
+                                      .closed()
+                                      .starting_resources(100)
+                                      .threads(threads[i]);
+
+        World world(wInfo);
+        for ( Day day = 1; day <= 20; ++day ) {
+            world.advance_day();
+        }
+
+        std::ostringstream out;
+        world.output_summary_resources_by_strategy(out);
+        results[i] = out.str();
+    }
+
+    CHECK(results[0] == results[1]);
+
+    //  An always cooperate creature gains 3 a game against its own
+    //  kind and against naive probers, which seldom meet it again and
+    //  so cooperate on their first game, and nothing on average
+    //  against random strategy creatures, so about 40 over 20 games.
+    //  Random strategy creatures which always cooperated or always
+    //  defected would make it 60 or 20.
+
+    const std::size_t pos = results[0].find("always cooperate");
+    CHECK(pos != std::string::npos);
+    const double gain = stat(results[0].substr(pos), "avg ") - 100.0;
+    CHECK(gain > 35.0 && gain < 45.0);
+}
+
+
+/*
+ *  Tests that with partner choice, creatures which never defect play
+ *  every day as before, while always defect creatures refuse each
+ *  other after their first game, so no pair plays twice and the
+ *  creatures left unmatched are reported.
+ */
+
+TEST(RegionGroup, PartnerChoiceTest) {
+    WorldInfo wInfo = TestWorld(3).with(tit_for_tat, 100).closed();
+    wInfo.m_partner_choice = true;
+    SlotMap slots;
+    BrainPool brains;
+    std::vector<Region *> regions = make_regions(wInfo, 1, slots, brains);
+    for ( Day day = 1; day <= 10; ++day ) {
+        advance_regions(regions, day);
+    }
+    CHECK_EQUAL(500u, regions[0]->games_played());
+    CHECK_EQUAL(0u, regions[0]->refusals());
+    CHECK_EQUAL(0u, regions[0]->unmatched());
+    delete_regions(regions);
+
+    wInfo = TestWorld(3).with(always_defect, 10).closed();
+    wInfo.m_partner_choice = true;
+    regions = make_regions(wInfo, 1, slots, brains);
+    for ( Day day = 1; day <= 30; ++day ) {
+        advance_regions(regions, day);
+    }
+    CHECK(regions[0]->games_played() <= 45);
+    CHECK(regions[0]->refusals() > 0);
+    CHECK(regions[0]->unmatched() > 0);
+    CHECK(regions[0]->unmatched_last_day() % 2 == 0);
+    CHECK(regions[0]->unmatched_last_day() > 0);
+    delete_regions(regions);
+}
+
+
+/*
+ *  Tests that a world with partner choice produces the same results
+ *  whatever the number of threads.
+ */
+
+TEST(RegionGroup, PartnerChoiceDeterministicTest) {
+    std::string results[2];
+    const unsigned int threads[2] = { 1, 3 };
+
+    for ( int i = 0; i < 2; ++i ) {
+        WorldInfo wInfo = TestWorld(3).with(tit_for_tat, 3000)
+                                      .with(always_defect, 3000)
+                                      .closed();
+        wInfo.m_susp_tit_for_tat = 3000;
+        wInfo.m_partner_choice = true;
+        wInfo.m_regions = 2;
+        wInfo.m_threads = threads[i];
+
+        World world(wInfo);
+        for ( Day day = 1; day <= 20; ++day ) {
+            world.advance_day();
+        }
+
+        std::ostringstream out;
+        world.output_world_stats(out);
+        world.output_summary_resources_by_strategy(out);
+        results[i] = out.str();
+    }
+
+    CHECK(results[0] == results[1]);
+    CHECK(results[0].find("Partner refusals: 0") == std::string::npos);
+}
+
+
+/*
+ *  Tests that paired creatures play matches of the requested number of
+ *  games, and that matches of random length, with creatures whose moves
+ *  are random, give the same results whatever the number of threads.
+ */
+
+TEST(RegionGroup, MatchesTest) {
+    WorldInfo wInfo = TestWorld(3).with(tit_for_tat, 100).closed();
+    wInfo.m_match_rounds = 4;
+    SlotMap slots;
+    BrainPool brains;
+    std::vector<Region *> regions = make_regions(wInfo, 1, slots, brains);
+    for ( Day day = 1; day <= 10; ++day ) {
+        advance_regions(regions, day);
+    }
+    CHECK_EQUAL(2000u, regions[0]->games_played());
+    CHECK_EQUAL(100 + 10 * 4 * 3, regions[0]->creatures().resources(0));
+    delete_regions(regions);
+
+    std::string results[2];
+    const unsigned int threads[2] = { 1, 3 };
+    for ( int i = 0; i < 2; ++i ) {
+        wInfo = TestWorld(3).with(tit_for_tat, 1500)
+                            .with(always_defect, 1500)
+                            .with(random_strategy, 1500)
+                            .with(naive_prober, 1500)
+                            .closed();
+        wInfo.m_susp_tit_for_tat = 1500;
+        wInfo.m_continuation_prob = 0.8;
+        wInfo.m_threads = threads[i];
+
+        World world(wInfo);
+        for ( Day day = 1; day <= 10; ++day ) {
+            world.advance_day();
+        }
+
+        std::ostringstream out;
+        world.output_world_stats(out);
+        world.output_summary_resources_by_strategy(out);
+        results[i] = out.str();
+    }
+
+    CHECK(results[0] == results[1]);
+    CHECK(results[0].find("Games played: 45000\n") == std::string::npos);
+}
+
+
+/*
+ *  Tests that the staged single games, shared out among several
+ *  threads, leave every creature as playing each pair's game in turn
+ *  does. A negative continuation probability, which match_length()
+ *  ignores, sends the single games of the second region through the
+ *  match path instead. With partner choice, some creatures sit out.
+ */
+
+TEST(RegionGroup, GamePipelineTest) {
+    WorldInfo wInfo = TestWorld(3).with(tit_for_tat, 1000)
+                                  .with(always_defect, 1000)
+                                  .closed();
+    wInfo.m_susp_tit_for_tat = 1000;
+    wInfo.m_tit_for_two_tats = 1000;
+    wInfo.m_partner_choice = true;
+    WorldInfo matchInfo = wInfo;
+    matchInfo.m_continuation_prob = -1.0;
+
+    SlotMap staged_slots;
+    SlotMap paired_slots;
+    BrainPool staged_brains;
+    BrainPool paired_brains;
+    std::vector<Region *> staged;
+    std::vector<Region *> paired;
+    staged.push_back(new Region(wInfo, 0, 3, staged_slots, staged_brains));
+    paired.push_back(new Region(matchInfo, 0, 1, paired_slots,
+                                paired_brains));
+
+    Population staged_creatures(&staged_brains);
+    Population paired_creatures(&paired_brains);
+    create_creatures(wInfo, staged_creatures);
+    create_creatures(wInfo, paired_creatures);
+    for ( std::size_t i = 0; i < staged_creatures.size(); ++i ) {
+        staged[0]->add_creature(staged_creatures, i);
+        paired[0]->add_creature(paired_creatures, i);
+    }
+
+    for ( Day day = 1; day <= 10; ++day ) {
+        advance_regions(staged, day);
+        advance_regions(paired, day);
+    }
+
+    const Population& first = staged[0]->creatures();
+    const Population& second = paired[0]->creatures();
+    CHECK_EQUAL(second.size(), first.size());
+    CHECK_EQUAL(paired[0]->games_played(), staged[0]->games_played());
+    CHECK_EQUAL(paired[0]->unmatched(), staged[0]->unmatched());
+    CHECK(staged[0]->unmatched() > 0);
+    for ( std::size_t i = 0; i < first.size(); ++i ) {
+        CHECK_EQUAL(second.strategy_value(i), first.strategy_value(i));
+        CHECK_EQUAL(second.resources(i), first.resources(i));
+        CHECK_EQUAL(second.games_played(i), first.games_played(i));
+    }
+
+    delete_regions(staged);
+    delete_regions(paired);
+}
+
+
+/*
+ *  Tests that each creature which dies leaves a tombstone recording
+ *  its death, that its handle and Brain are given back, and that the
+ *  dead are kept apart from the living.
+ */
+
+TEST(RegionGroup, TombstonesTest) {
+    WorldInfo wInfo = TestWorld(3).with(tit_for_tat, 200)
+                                  .with(always_defect, 200)
+                                  .closed();
+    wInfo.m_default_life_expectancy = 20;
+    wInfo.m_repro_min_resources = 75;
+    SlotMap slots;
+    BrainPool brains;
+    std::vector<Region *> regions = make_regions(wInfo, 1, slots, brains);
+    for ( Day day = 1; day <= 50; ++day ) {
+        advance_regions(regions, day, true, day % 10 == 0);
+    }
+
+    const Region& region = *regions[0];
+    const TombstoneList& dead = region.dead_creatures();
+    CHECK_EQUAL(region.dead_count(), dead.size());
+    CHECK(dead.size() > 400);
+
+    const std::set<CreatureID> live_ids = region_ids(region);
+    std::set<CreatureID> dead_ids;
+    std::size_t starved = 0;
+    for ( std::size_t i = 0; i < dead.size(); ++i ) {
+        const Tombstone& tombstone = dead[i];
+        CHECK(live_ids.count(tombstone.id) == 0);
+        dead_ids.insert(tombstone.id);
+        CHECK(tombstone.death_day >= 1 && tombstone.death_day <= 50);
+        CHECK(i == 0 || tombstone.death_day >= dead[i - 1].death_day);
+        CHECK(tombstone.strategy == tit_for_tat ||
+              tombstone.strategy == always_defect);
+        if ( tombstone.cause == died_of_starvation ) {
+            CHECK(tombstone.final_resources <= 0);
+            ++starved;
+        } else {
+            CHECK_EQUAL(died_of_age, tombstone.cause);
+            CHECK(tombstone.final_resources > 0);
+            CHECK_EQUAL(21, tombstone.death_day - tombstone.birth_day);
+            CHECK(tombstone.games_played >= 19);
+        }
+    }
+    CHECK_EQUAL(dead.size(), dead_ids.size());
+    CHECK(starved < dead.size());
+
+    CHECK_EQUAL(live_ids.size(), slots.size());
+    CHECK_EQUAL(live_ids.size() + brains.num_free(), brains.num_brains());
+
+    delete_regions(regions);
+}
+
+
+/*
+ *  Tests that ageing, deaths and births, shared out among several
+ *  threads, leave the same live creatures in the same rows, with the
+ *  same IDs and resources, and the same tombstones, as a single thread
+ *  does. The region is large enough for the life cycle to run in
+ *  several chunks, and IDs are compared relative to the first one
+ *  given out, since they carry on from one test to the next.
+ */
+
+TEST(RegionGroup, LifeCycleThreadsTest) {
+    std::string results[2];
+    const unsigned int threads[2] = { 1, 3 };
+
+    for ( int i = 0; i < 2; ++i ) {
+        WorldInfo wInfo = TestWorld(3).with(tit_for_tat, 2000)
+                                      .with(always_defect, 2000)
+                                      .with(susp_tit_for_tat, 2000)
+                                      .life_expectancy(25)
+                                      .starting_resources(20)
+                                      .repro_min_resources(30);
+        wInfo.m_default_life_expectancy_range = 10;
+        wInfo.m_repro_cost = 10;
+        SlotMap slots;
+        BrainPool brains;
+        std::vector<Region *> regions;
+        regions.push_back(new Region(wInfo, 0, threads[i], slots, brains));
+
+        const CreatureID first_id = Creature::reserve_ids(0);
+        Population creatures(&brains);
+        create_creatures(wInfo, creatures);
+        for ( std::size_t c = 0; c < creatures.size(); ++c ) {
+            regions[0]->add_creature(creatures, c);
+        }
+        for ( Day day = 1; day <= 40; ++day ) {
+            advance_regions(regions, day, true, day % 5 == 0);
+        }
+
+        const Region& region = *regions[0];
+        CHECK(region.born_creatures() > 1000);
+        CHECK(region.dead_count() > 1000);
+
+        std::ostringstream out;
+        const Population& live = region.creatures();
+        for ( std::size_t c = 0; c < live.size(); ++c ) {
+            out << live.id(c) - first_id << ' ' << live.resources(c)
+                << '\n';
+        }
+        const TombstoneList& dead = region.dead_creatures();
+        for ( std::size_t d = 0; d < dead.size(); ++d ) {
+            out << dead[d].id - first_id << ' ' << dead[d].death_day << ' '
+                << dead[d].final_resources << ' '
+                << static_cast<int>(dead[d].cause) << '\n';
+        }
+        results[i] = out.str();
+        delete_regions(regions);
+    }
+
+    CHECK(results[0] == results[1]);
+}
+
+
+/*
+ *  Tests that removing the dead, scattered through the live creatures
+ *  list and including its first and last rows, leaves the survivors in
+ *  the order, and the dead in the order, that erasing each dead row in
+ *  turn from the list would. Enough creatures die for the removal to
+ *  run in several chunks.
+ */
+
+TEST(RegionGroup, DeathCompactionTest) {
+    WorldInfo wInfo = TestWorld(3).with(tit_for_tat, 2000)
+                                  .with(always_defect, 2000);
+    SlotMap slots;
+    BrainPool brains;
+    std::vector<Region *> regions;
+    regions.push_back(new Region(wInfo, 0, 3, slots, brains));
+
+    Population creatures(&brains);
+    create_creatures(wInfo, creatures);
+    const std::size_t last = creatures.size() - 1;
+    std::vector<CreatureID> survivors;
+    std::vector<CreatureID> dead;
+    for ( std::size_t i = 0; i < creatures.size(); ++i ) {
+        survivors.push_back(creatures.id(i));
+    }
+    for ( std::size_t i = creatures.size(); i-- > 0; ) {
+        if ( i == 0 || i == last || i % 3 == 1 ) {
+            creatures.spend_resources(i, 1000);
+            dead.insert(dead.begin(), creatures.id(i));
+            survivors.erase(survivors.begin() + i);
+        }
+    }
+    for ( std::size_t i = 0; i < creatures.size(); ++i ) {
+        regions[0]->add_creature(creatures, i);
+    }
+
+    advance_regions(regions, 1, true, false);
+
+    const Population& live = regions[0]->creatures();
+    CHECK_EQUAL(survivors.size(), live.size());
+    for ( std::size_t i = 0; i < live.size(); ++i ) {
+        CHECK_EQUAL(survivors[i], live.id(i));
+    }
+    const TombstoneList& tombstones = regions[0]->dead_creatures();
+    CHECK_EQUAL(dead.size(), tombstones.size());
+    CHECK(dead.size() > 1024);
+    for ( std::size_t i = 0; i < tombstones.size(); ++i ) {
+        CHECK_EQUAL(dead[i], tombstones[i].id);
+        CHECK_EQUAL(died_of_starvation, tombstones[i].cause);
+    }
+
+    delete_regions(regions);
+}
+
+
+/*
+ *  Tests that a calendar gives back each handle on its day, however
+ *  far ahead it was scheduled, and takes days skipped along with the
+ *  next day taken.
+ */
+
+TEST(RegionGroup, CalendarTest) {
+    Calendar calendar;
+    for ( CreatureHandle handle = 0; handle < 300; ++handle ) {
+        calendar.schedule(1 + static_cast<Day>(handle * 7 % 150), handle);
+    }
+    calendar.schedule(0, 999);
+    CHECK_EQUAL(301u, calendar.size());
+
+    HandleList due;
+    calendar.take(1, due);
+    CHECK_EQUAL(3u, due.size());
+    for ( Day day = 2; day <= 150; ++day ) {
+        due.clear();
+        calendar.take(day, due);
+        CHECK_EQUAL(2u, due.size());
+        for ( std::size_t i = 0; i < due.size(); ++i ) {
+            CHECK_EQUAL(day, 1 + static_cast<Day>(due[i] * 7 % 150));
+        }
+    }
+    CHECK_EQUAL(0u, calendar.size());
+
+    calendar.schedule(155, 1);
+    calendar.schedule(160, 2);
+    due.clear();
+    calendar.take(157, due);
+    CHECK_EQUAL(1u, due.size());
+    CHECK_EQUAL(1u, calendar.size());
+}
+
+
+/*
+ *  Tests that checking only the day's candidates misses no death, in
+ *  regions with migration, so no creature outlives its life expectancy
+ *  or its resources.
+ */
+
+TEST(RegionGroup, NoMissedDeathsTest) {
+    WorldInfo wInfo = TestWorld(3).with(tit_for_tat, 200)
+                                  .with(always_defect, 200)
+                                  .closed();
+    wInfo.m_default_life_expectancy = 15;
+    wInfo.m_default_starting_resources = 20;
+    wInfo.m_repro_min_resources = 30;
+    wInfo.m_repro_cost = 10;
+    wInfo.m_migration_rate = 0.1;
+    SlotMap slots;
+    BrainPool brains;
+    std::vector<Region *> regions = make_regions(wInfo, 3, slots, brains);
+
+    unsigned long births = 0;
+    for ( Day day = 1; day <= 60; ++day ) {
+        advance_regions(regions, day, true, day % 5 == 0);
+        for ( std::size_t r = 0; r < regions.size(); ++r ) {
+            const Population& creatures = regions[r]->creatures();
+            for ( std::size_t i = 0; i < creatures.size(); ++i ) {
+                CHECK(creatures.birth_day(i) == day ||
+                      !creatures.is_dead(i, day));
+            }
+        }
+    }
+    for ( std::size_t r = 0; r < regions.size(); ++r ) {
+        births += regions[r]->born_creatures();
+    }
+    CHECK(births > 0);
+
+    delete_regions(regions);
+}
@@ -0,0 +1,147 @@
+/*
+ *  test_replicates.cpp
+ *  ===================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Pridil unit tests for Replicates class.
+ *
+ *  Uses CppUTest unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <CppUTest/CommandLineTestRunner.h>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../../replicates.h"
+#include "../../population.h"
+#include "../../creature.h"
+#include "../../game.h"
+#include "../test_helpers.h"
+
+using namespace pridil;
+using namespace pridil::test;
+
+
+TEST_GROUP(ReplicatesGroup) {
+};
+
+
+
+/*
+ *  Tests that every replicate's creatures end up with exactly the
+ *  resources of the same creatures playing play_game() with the real
+ *  genes on the same pairings, including resources below zero.
+ */
+
+TEST(ReplicatesGroup, ScalarEquivalenceTest) {
+    WorldInfo wInfo = TestWorld(9).with(tit_for_tat, 3)
+                                  .with(tit_for_two_tats, 3)
+                                  .with(susp_tit_for_tat, 3)
+                                  .with(always_cooperate, 3)
+                                  .with(always_defect, 3);
+    wInfo.m_default_starting_resources = 2;
+    wInfo.m_disable_repro = true;
+    Replicates replicates(wInfo);
+    const std::size_t num_creatures = replicates.size();
+    CHECK_EQUAL(15u, num_creatures);
+
+    std::vector<Population*> populations;
+    for ( std::size_t r = 0; r < Replicates::num_replicates; ++r ) {
+        populations.push_back(new Population);
+        for ( std::size_t i = 0; i < num_creatures; ++i ) {
+            populations[r]->add(CreatureInit(1000, 0,
+                                             replicates.strategy(r, i),
+                                             2, 50, 75),
+                                Creature::reserve_ids(1), 0);
+        }
+    }
+
+    for ( Day day = 1; day <= 40; ++day ) {
+        replicates.advance_day();
+        const std::vector<std::size_t>& order = replicates.pairing();
+        for ( std::size_t r = 0; r < Replicates::num_replicates; ++r ) {
+            for ( std::size_t i = 0; i + 1 < order.size(); i += 2 ) {
+                play_game(*populations[r], order[i], order[i + 1]);
+            }
+        }
+    }
+
+    bool any_negative = false;
+    for ( std::size_t r = 0; r < Replicates::num_replicates; ++r ) {
+        for ( std::size_t i = 0; i < num_creatures; ++i ) {
+            CHECK_EQUAL(populations[r]->resources(i),
+                        replicates.resources(r, i));
+            any_negative = any_negative || replicates.resources(r, i) < 0;
+        }
+        delete populations[r];
+    }
+    CHECK(any_negative);
+}
+
+
+/*
+ *  Tests that each replicate keeps its size, and that always defect
+ *  takes over more of the replicates than always cooperate.
+ */
+
+TEST(ReplicatesGroup, FixationTest) {
+    WorldInfo wInfo = TestWorld(9).with(always_cooperate, 10)
+                                  .with(always_defect, 10);
+    Replicates replicates(wInfo);
+    for ( Day day = 1; day <= 2000; ++day ) {
+        replicates.advance_day();
+        if ( replicates.fixed_replicates(always_defect) +
+             replicates.fixed_replicates(always_cooperate) ==
+             Replicates::num_replicates ) {
+            break;
+        }
+    }
+
+    for ( std::size_t r = 0; r < Replicates::num_replicates; ++r ) {
+        CHECK_EQUAL(20u, replicates.count(r, always_defect) +
+                         replicates.count(r, always_cooperate));
+    }
+    CHECK_EQUAL(Replicates::num_replicates,
+                replicates.fixed_replicates(always_defect) +
+                replicates.fixed_replicates(always_cooperate));
+    CHECK(replicates.fixed_replicates(always_defect) >
+          replicates.fixed_replicates(always_cooperate));
+
+    std::ostringstream out;
+    replicates.output_replicate_stats(out);
+    CHECK(out.str().find("Fixed strategy: always defect in ") !=
+          std::string::npos);
+}
+
+
+/*
+ *  Tests that strategies whose moves are random are refused.
+ */
+
+TEST(ReplicatesGroup, NondeterministicStrategyTest) {
+    WorldInfo wInfo = TestWorld(9).with(tit_for_tat, 1)
+                                  .with(tit_for_two_tats, 1)
+                                  .with(susp_tit_for_tat, 1)
+                                  .with(always_cooperate, 1)
+                                  .with(always_defect, 1);
+    wInfo.m_naive_prober = 1;
+    try {
+        Replicates replicates(wInfo);
+        FAIL("NondeterministicStrategy not thrown when expected.");
+    }
+    catch(const NondeterministicStrategy&) {
+
+        /*  Test succeeds if we get here  */
+
+    }
+    catch(...) {
+        FAIL("Unexpected exception thrown by Replicates()");
+    }
+}
+
@@ -0,0 +1,198 @@
+/*
+ *  test_slot_map.cpp
+ *  =================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Pridil unit tests for SlotMap class and finding creatures by ID.
+ *
+ *  Uses CppUTest unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <CppUTest/CommandLineTestRunner.h>
+#include <cstddef>
+#include <set>
+#include <sstream>
+#include <string>
+#include "../../slot_map.h"
+#include "../../world.h"
+#include "../../pridil_exceptions.h"
+
+using namespace pridil;
+
+
+TEST_GROUP(SlotMapGroup) {
+};
+
+
+
+/*
+ *  Tests that erased handles become stale, and that a freed slot is
+ *  reused with a new generation, so the old handle stays stale.
+ */
+
+TEST(SlotMapGroup, InsertEraseTest) {
+    SlotMap slots;
+    const CreatureHandle first = slots.insert(SlotLocation(0, 5));
+    const CreatureHandle second = slots.insert(SlotLocation(1, 7));
+    CHECK_EQUAL(2u, slots.size());
+    CHECK_EQUAL(1u, slots.location(second).region);
+    CHECK_EQUAL(7u, slots.location(second).row);
+
+    slots.relocate(first, SlotLocation(2, 9));
+    CHECK_EQUAL(2u, slots.location(first).region);
+    CHECK_EQUAL(9u, slots.location(first).row);
+
+    slots.erase(first);
+    CHECK(!slots.contains(first));
+    CHECK(slots.contains(second));
+    CHECK_EQUAL(1u, slots.size());
+    slots.erase(first);
+    CHECK_EQUAL(1u, slots.size());
+
+    bool thrown = false;
+    try {
+        slots.location(first);
+    } catch(StaleHandle&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    const CreatureHandle third = slots.insert(SlotLocation(0, 1));
+    CHECK(third != first);
+    CHECK(!slots.contains(first));
+    CHECK(slots.contains(third));
+    CHECK_EQUAL(2u, slots.num_slots());
+    CHECK(!slots.contains(SlotMap::null_handle));
+}
+
+
+/*
+ *  Tests that a slot is retired once it has given out its last
+ *  generation, rather than reused.
+ */
+
+TEST(SlotMapGroup, RetireTest) {
+    SlotMap slots;
+    const unsigned int generations = 16;
+    CHECK_EQUAL(generations, slots.num_generations());
+    std::set<CreatureHandle> handles;
+    for ( unsigned int i = 0; i < generations; ++i ) {
+        const CreatureHandle handle = slots.insert(SlotLocation());
+        handles.insert(handle);
+        slots.erase(handle);
+    }
+    CHECK_EQUAL(generations, handles.size());
+    CHECK_EQUAL(1u, slots.num_slots());
+
+    const CreatureHandle handle = slots.insert(SlotLocation());
+    CHECK(handles.count(handle) == 0);
+    CHECK_EQUAL(2u, slots.num_slots());
+}
+
+
+/*
+ *  Tests that handles stay 32 bits wide, that the default split leaves
+ *  room for far more live creatures than a 24-bit slot number would,
+ *  and that the split is kept in range.
+ */
+
+TEST(SlotMapGroup, SplitTest) {
+    CHECK_EQUAL(4u, sizeof(CreatureHandle));
+
+    SlotMap slots;
+    CHECK_EQUAL(SlotMap::c_default_slot_bits, slots.slot_bits());
+    CHECK(slots.slot_bits() > 24);
+    CHECK_EQUAL(16u, slots.num_generations());
+
+    SlotMap too_wide(32);
+    CHECK_EQUAL(SlotMap::c_max_slot_bits, too_wide.slot_bits());
+    CHECK_EQUAL(2u, too_wide.num_generations());
+    SlotMap too_narrow(0);
+    CHECK_EQUAL(SlotMap::c_min_slot_bits, too_narrow.slot_bits());
+    CHECK_EQUAL(256u, too_narrow.num_generations());
+
+    const CreatureHandle handle = too_wide.insert(SlotLocation(0, 3));
+    CHECK(too_wide.contains(handle));
+    too_wide.erase(handle);
+    const CreatureHandle reused = too_wide.insert(SlotLocation(0, 4));
+    CHECK(reused != handle);
+    CHECK(reused != SlotMap::null_handle);
+    CHECK(!too_wide.contains(handle));
+}
+
+
+/*
+ *  Tests that every live creature in a world with deaths, births and
+ *  migration can be found from its ID, and that no creature is found
+ *  for any other ID.
+ */
+
+TEST(SlotMapGroup, WorldLookupTest) {
+    WorldInfo wInfo;
+    wInfo.m_random_strategy = 0;
+    wInfo.m_tit_for_tat = 200;
+    wInfo.m_tit_for_two_tats = 0;
+    wInfo.m_susp_tit_for_tat = 0;
+    wInfo.m_naive_prober = 0;
+    wInfo.m_always_cooperate = 0;
+    wInfo.m_always_defect = 200;
+    wInfo.m_default_life_expectancy = 30;
+    wInfo.m_default_starting_resources = 10;
+    wInfo.m_repro_cost = 8;
+    wInfo.m_repro_min_resources = 20;
+    wInfo.m_regions = 3;
+    wInfo.m_migration_rate = 0.1;
+    wInfo.m_threads = 2;
+    wInfo.m_seed = 7;
+
+    World world(wInfo);
+    for ( Day day = 1; day <= 50; ++day ) {
+        world.advance_day();
+    }
+
+    std::ostringstream summary;
+    world.output_summary_creature_stats(summary);
+    std::istringstream in(summary.str());
+    std::string line;
+    std::getline(in, line);
+
+    std::set<CreatureID> ids;
+    CreatureID last_id = 0;
+    while ( std::getline(in, line) && !line.empty() ) {
+        std::istringstream fields(line.substr(9));
+        CreatureID id;
+        fields >> id;
+        CHECK(ids.empty() || id > last_id);
+        ids.insert(id);
+        last_id = id;
+
+        std::ostringstream out;
+        CHECK(world.output_creature_stats(id, out));
+        std::ostringstream header;
+        header << "=============\nCreature " << id << "\n";
+        CHECK(out.str().find(header.str()) == 0);
+    }
+    CHECK(ids.size() > 0);
+
+    std::ostringstream stats;
+    world.output_world_stats(stats);
+    std::ostringstream living;
+    living << "Living creatures: " << ids.size() << "\n";
+    CHECK(stats.str().find(living.str()) != std::string::npos);
+
+    std::size_t missing = 0;
+    for ( CreatureID id = *ids.begin() - 500; id < last_id + 500; ++id ) {
+        std::ostringstream out;
+        if ( ids.count(id) == 0 ) {
+            CHECK(!world.output_creature_stats(id, out));
+            CHECK(out.str().empty());
+            ++missing;
+        }
+    }
+    CHECK(missing > 1000);
+}
@@ -0,0 +1,180 @@
+/*
+ *  test_thread_pool.cpp
+ *  ====================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Pridil unit tests for ThreadPool class.
+ *
+ *  Uses CppUTest unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <CppUTest/CommandLineTestRunner.h>
+#include <cstddef>
+#include <new>
+#include <vector>
+#include "../../thread_pool.h"
+
+using namespace pridil;
+
+
+namespace {
+
+    /*
+     *  Task which counts how many times each chunk is run, and
+     *  optionally throws a BadGameMove, or std::bad_alloc, from one
+     *  chunk.
+     */
+
+    class CountingTask : public ParallelTask {
+        public:
+            explicit CountingTask(const std::size_t num_chunks,
+                                  const std::size_t throw_chunk = 0,
+                                  const bool do_throw = false,
+                                  const bool out_of_memory = false) :
+                m_runs(num_chunks, 0), m_throw_chunk(throw_chunk),
+                m_do_throw(do_throw), m_out_of_memory(out_of_memory) {}
+
+            virtual void run_chunk(const std::size_t chunk,
+                                   const unsigned int) {
+                ++m_runs[chunk];
+                if ( m_do_throw && chunk == m_throw_chunk ) {
+                    if ( m_out_of_memory ) {
+                        throw std::bad_alloc();
+                    }
+                    throw BadGameMove();
+                }
+            }
+
+            std::vector<int> m_runs;
+
+        private:
+            std::size_t m_throw_chunk;
+            bool m_do_throw;
+            bool m_out_of_memory;
+    };
+
+    bool all_run_once(const std::vector<int>& runs) {
+        for ( std::size_t i = 0; i < runs.size(); ++i ) {
+            if ( runs[i] != 1 ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+
+TEST_GROUP(ThreadPoolGroup) {
+};
+
+
+
+/*
+ *  Tests that the pool reports the requested number of threads, and
+ *  that a request for zero threads gives one.
+ */
+
+TEST(ThreadPoolGroup, NumThreadsTest) {
+    ThreadPool pool0(0);
+    ThreadPool pool1(1);
+    ThreadPool pool4(4);
+
+    CHECK_EQUAL(1u, pool0.num_threads());
+    CHECK_EQUAL(1u, pool1.num_threads());
+    CHECK_EQUAL(4u, pool4.num_threads());
+}
+
+
+/*
+ *  Tests that every chunk is run exactly once, on single- and
+ *  multi-threaded pools, and over repeated jobs.
+ */
+
+TEST(ThreadPoolGroup, EachChunkOnceTest) {
+    ThreadPool pool1(1);
+    CountingTask task1(100);
+    pool1.run(task1, 100);
+    CHECK(all_run_once(task1.m_runs));
+
+    ThreadPool pool4(4);
+    for ( int job = 0; job < 20; ++job ) {
+        CountingTask task4(1000);
+        pool4.run(task4, 1000);
+        CHECK(all_run_once(task4.m_runs));
+    }
+}
+
+
+/*
+ *  Tests that an exception thrown by one chunk reaches the caller with
+ *  its own type, and that the remaining chunks still run.
+ */
+
+TEST(ThreadPoolGroup, ExceptionTest) {
+    ThreadPool pool(3);
+    CountingTask task(50, 17, true);
+
+    bool caught = false;
+    try {
+        pool.run(task, 50);
+    } catch(const BadGameMove&) {
+        caught = true;
+    }
+
+    CHECK(caught);
+    CHECK(all_run_once(task.m_runs));
+}
+
+
+/*
+ *  Tests that std::bad_alloc thrown by one chunk reaches the caller as
+ *  std::bad_alloc, rather than as a PridilException.
+ */
+
+TEST(ThreadPoolGroup, OutOfMemoryTest) {
+    ThreadPool pool(3);
+    CountingTask task(50, 17, true, true);
+
+    bool caught = false;
+    try {
+        pool.run(task, 50);
+    } catch(const std::bad_alloc&) {
+        caught = true;
+    }
+
+    CHECK(caught);
+    CHECK(all_run_once(task.m_runs));
+}
+
+
+/*
+ *  Tests that chunk_range() covers all items exactly once, with
+ *  chunk sizes differing by no more than one.
+ */
+
+TEST(ThreadPoolGroup, ChunkRangeTest) {
+    const std::size_t num_items = 103;
+    const std::size_t num_chunks = 10;
+    std::size_t expected_begin = 0;
+
+    for ( std::size_t chunk = 0; chunk < num_chunks; ++chunk ) {
+        std::size_t begin;
+        std::size_t end;
+        chunk_range(num_items, num_chunks, chunk, begin, end);
+
+        CHECK_EQUAL(expected_begin, begin);
+        CHECK(end - begin == 10 || end - begin == 11);
+        expected_begin = end;
+    }
+    CHECK_EQUAL(num_items, expected_begin);
+
+    CHECK_EQUAL(1u, num_chunks_for(0, 16));
+    CHECK_EQUAL(1u, num_chunks_for(16, 16));
+    CHECK_EQUAL(2u, num_chunks_for(17, 16));
+}
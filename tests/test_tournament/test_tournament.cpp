@@ -0,0 +1,113 @@
+/*
+ *  test_tournament.cpp
+ *  ===================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Pridil unit tests for Tournament class.
+ *
+ *  Uses CppUTest unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <CppUTest/CommandLineTestRunner.h>
+#include "../../tournament.h"
+#include "../test_helpers.h"
+
+using namespace pridil;
+using namespace pridil::test;
+
+
+TEST_GROUP(TournamentGroup) {
+};
+
+
+
+/*
+ *  Tests that every pair of creatures plays one match, with numbers of
+ *  creatures making up less than one tile, an odd number of tiles and
+ *  an even number of tiles.
+ */
+
+TEST(TournamentGroup, MatchCountTest) {
+    const int sizes[] = { 0, 1, 2, 7, 300, 512, 700 };
+    for ( std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i ) {
+        WorldInfo wInfo = TestWorld(1).threads(3);
+        wInfo.m_tit_for_tat = sizes[i];
+
+        Tournament tournament(wInfo, 1);
+        tournament.run();
+        const unsigned long n = sizes[i];
+        CHECK_EQUAL(n * (n - (n > 0 ? 1 : 0)) / 2,
+                    tournament.matches_played());
+    }
+}
+
+
+/*
+ *  Tests the payoff matrix for always cooperate and always defect,
+ *  where the result of every game is known in advance.
+ */
+
+TEST(TournamentGroup, PayoffMatrixTest) {
+    WorldInfo wInfo = TestWorld(1).threads(2);
+    wInfo.m_always_cooperate = 150;
+    wInfo.m_always_defect = 170;
+
+    Tournament tournament(wInfo, 5);
+    tournament.run();
+
+    DOUBLES_EQUAL(3.0, tournament.average_payoff(always_cooperate,
+                                                 always_cooperate), 1e-9);
+    DOUBLES_EQUAL(-3.0, tournament.average_payoff(always_cooperate,
+                                                  always_defect), 1e-9);
+    DOUBLES_EQUAL(5.0, tournament.average_payoff(always_defect,
+                                                 always_cooperate), 1e-9);
+    DOUBLES_EQUAL(-1.0, tournament.average_payoff(always_defect,
+                                                  always_defect), 1e-9);
+    DOUBLES_EQUAL(0.0, tournament.average_payoff(tit_for_tat,
+                                                 always_defect), 1e-9);
+}
+
+
+/*
+ *  Tests that matches start afresh, and that the results do not
+ *  depend on the number of threads, including for strategies which
+ *  move at random.
+ *
+ *  Tit for tat scores -3 in the first game of a 10 game match against
+ *  always defect, and -1 in the other nine, whichever opponents it
+ *  played earlier.
+ */
+
+TEST(TournamentGroup, DeterministicTest) {
+    WorldInfo wInfo = TestWorld(1);
+    wInfo.m_tit_for_tat = 90;
+    wInfo.m_tit_for_two_tats = 80;
+    wInfo.m_susp_tit_for_tat = 70;
+    wInfo.m_always_defect = 60;
+    wInfo.m_random_strategy = 50;
+    wInfo.m_naive_prober = 40;
+
+    Tournament tournament1(wInfo, 10);
+    tournament1.run();
+    wInfo.m_threads = 4;
+    Tournament tournament4(wInfo, 10);
+    tournament4.run();
+
+    DOUBLES_EQUAL(-1.2, tournament1.average_payoff(tit_for_tat,
+                                                   always_defect), 1e-9);
+
+    const Strategy strategies[] = { tit_for_tat, tit_for_two_tats,
+                                    susp_tit_for_tat, always_defect,
+                                    random_strategy, naive_prober };
+    for ( int i = 0; i < 6; ++i ) {
+        for ( int j = 0; j < 6; ++j ) {
+            CHECK(tournament1.average_payoff(strategies[i], strategies[j]) ==
+                  tournament4.average_payoff(strategies[i], strategies[j]));
+        }
+    }
+}
@@ -0,0 +1,308 @@
+/*
+ *  thread_pool.cpp
+ *  ===============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Implementation of ThreadPool class for Prisoners' Dilemma simulation.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+#include <new>
+#include <exception>
+#include <pthread.h>
+#include <unistd.h>
+#include "pridil_common.h"
+#include "thread_pool.h"
+
+using namespace pridil;
+
+
+/*
+ *  Constructor.
+ *
+ *  Starts num_threads - 1 worker threads, since the thread calling
+ *  run() always works on the job too. A request for zero threads is
+ *  treated as a request for one.
+ *
+ *  Exceptions thrown:
+ *    ThreadPoolError() if the worker threads could not be started.
+ */
+
+ThreadPool::ThreadPool(const unsigned int num_threads) :
+        m_workers(), m_worker_args(),
+        m_mutex(), m_work_ready(), m_work_done(),
+        m_task(0), m_num_chunks(0), m_next_chunk(0),
+        m_generation(0), m_busy_workers(0),
+        m_shutdown(false), m_failed(false), m_out_of_memory(false),
+        m_failure(0) {
+    pthread_mutex_init(&m_mutex, 0);
+    pthread_cond_init(&m_work_ready, 0);
+    pthread_cond_init(&m_work_done, 0);
+
+    //  Size the argument vector up front, since each worker keeps
+    //  a pointer to its own element.
+
+    const unsigned int num_workers = (num_threads > 1) ? num_threads - 1 : 0;
+    m_worker_args.resize(num_workers);
+    m_workers.reserve(num_workers);
+
+    for ( unsigned int i = 0; i < num_workers; ++i ) {
+        m_worker_args[i].pool = this;
+        m_worker_args[i].thread = i + 1;
+
+        pthread_t worker;
+        if ( pthread_create(&worker, 0, worker_entry,
+                            &m_worker_args[i]) != 0 ) {
+            shutdown();
+            throw ThreadPoolError();
+        }
+        m_workers.push_back(worker);
+    }
+}
+
+
+/*
+ *  Destructor. Stops and joins all the worker threads.
+ */
+
+ThreadPool::~ThreadPool() {
+    shutdown();
+    delete m_failure;
+}
+
+
+/*
+ *  Returns the number of threads which run each job, including
+ *  the calling thread.
+ */
+
+unsigned int ThreadPool::num_threads() const {
+    return m_workers.size() + 1;
+}
+
+
+/*
+ *  Runs a job, returning when all of its chunks have completed.
+ *
+ *  Arguments:
+ *    task -- the task to run
+ *    num_chunks -- the number of chunks into which the task is divided.
+ *                  task.run_chunk() will be called exactly once for
+ *                  each chunk number from 0 to num_chunks - 1.
+ *
+ *  Exceptions thrown:
+ *    The first PridilException or std::bad_alloc thrown by any chunk of
+ *    the task, re-thrown with its own type.
+ */
+
+void ThreadPool::run(ParallelTask& task, const std::size_t num_chunks) {
+    if ( num_chunks == 0 ) {
+        return;
+    }
+
+    pthread_mutex_lock(&m_mutex);
+    m_task = &task;
+    m_num_chunks = num_chunks;
+    m_next_chunk = 0;
+    m_failed = false;
+    m_out_of_memory = false;
+    m_busy_workers = m_workers.size();
+    ++m_generation;
+    pthread_cond_broadcast(&m_work_ready);
+    pthread_mutex_unlock(&m_mutex);
+
+    work(0);
+
+    pthread_mutex_lock(&m_mutex);
+    while ( m_busy_workers > 0 ) {
+        pthread_cond_wait(&m_work_done, &m_mutex);
+    }
+    m_task = 0;
+    std::auto_ptr<PridilException> failure(m_failure);
+    m_failure = 0;
+    const bool out_of_memory = m_out_of_memory;
+    pthread_mutex_unlock(&m_mutex);
+
+    if ( failure.get() ) {
+        failure->raise();
+    } else if ( out_of_memory ) {
+        throw std::bad_alloc();
+    }
+}
+
+
+/*
+ *  Thread entry point for worker threads.
+ */
+
+void * ThreadPool::worker_entry(void * arg) {
+    WorkerArg * worker_arg = static_cast<WorkerArg *>(arg);
+    worker_arg->pool->worker_loop(worker_arg->thread);
+    return 0;
+}
+
+
+/*
+ *  Main loop for worker threads. Sleeps until a new job is posted,
+ *  works on it, reports completion, and goes back to sleep.
+ */
+
+void ThreadPool::worker_loop(const unsigned int thread) {
+    unsigned long seen_generation = 0;
+
+    pthread_mutex_lock(&m_mutex);
+    while ( true ) {
+        while ( !m_shutdown && m_generation == seen_generation ) {
+            pthread_cond_wait(&m_work_ready, &m_mutex);
+        }
+        if ( m_shutdown ) {
+            break;
+        }
+        seen_generation = m_generation;
+        pthread_mutex_unlock(&m_mutex);
+
+        work(thread);
+
+        pthread_mutex_lock(&m_mutex);
+        if ( --m_busy_workers == 0 ) {
+            pthread_cond_signal(&m_work_done);
+        }
+    }
+    pthread_mutex_unlock(&m_mutex);
+}
+
+
+/*
+ *  Claims and runs chunks of the current job until none remain.
+ *
+ *  Exceptions thrown by a chunk are recorded rather than propagated,
+ *  so that a failure in one chunk cannot leave the pool waiting for
+ *  a thread which has unwound out of its loop. A PridilException is
+ *  kept as a copy of its most derived type, and std::bad_alloc as a
+ *  flag, since there may be no memory to copy it. Exceptions of any
+ *  other type cannot be kept without losing their type, so they
+ *  terminate the program, as they would on escaping a worker thread.
+ */
+
+void ThreadPool::work(const unsigned int thread) {
+    while ( true ) {
+        const std::size_t chunk = __sync_fetch_and_add(&m_next_chunk, 1);
+        if ( chunk >= m_num_chunks ) {
+            break;
+        }
+
+        try {
+            m_task->run_chunk(chunk, thread);
+        } catch(const PridilException& e) {
+            PridilException * failure = 0;
+            try {
+                failure = e.clone();
+            } catch(const std::bad_alloc&) {
+                failure = 0;
+            }
+            record_failure(failure, failure == 0);
+        } catch(const std::bad_alloc&) {
+            record_failure(0, true);
+        } catch(...) {
+            std::terminate();
+        }
+    }
+}
+
+
+/*
+ *  Records the first failure of the current job, taking ownership of
+ *  the copy of the exception, if any, and discarding later failures.
+ */
+
+void ThreadPool::record_failure(PridilException * failure,
+                                const bool out_of_memory) {
+    pthread_mutex_lock(&m_mutex);
+    if ( !m_failed ) {
+        m_failed = true;
+        m_failure = failure;
+        m_out_of_memory = out_of_memory;
+        failure = 0;
+    }
+    pthread_mutex_unlock(&m_mutex);
+    delete failure;
+}
+
+
+/*
+ *  Signals all worker threads to exit, joins them, and releases the
+ *  synchronization objects.
+ */
+
+void ThreadPool::shutdown() {
+    pthread_mutex_lock(&m_mutex);
+    m_shutdown = true;
+    pthread_cond_broadcast(&m_work_ready);
+    pthread_mutex_unlock(&m_mutex);
+
+    for ( std::vector<pthread_t>::iterator itr = m_workers.begin();
+          itr != m_workers.end(); ++itr ) {
+        pthread_join(*itr, 0);
+    }
+    m_workers.clear();
+
+    pthread_cond_destroy(&m_work_done);
+    pthread_cond_destroy(&m_work_ready);
+    pthread_mutex_destroy(&m_mutex);
+}
+
+
+/*
+ *  Calculates the range of items belonging to a chunk.
+ *
+ *  The items are split as evenly as possible, with the first
+ *  (num_items % num_chunks) chunks getting one extra item.
+ *
+ *  Arguments:
+ *    num_items -- total number of items
+ *    num_chunks -- number of chunks the items are divided into
+ *    chunk -- the chunk for which to calculate the range
+ *    begin, end -- set to the half-open range [begin, end) of items
+ *                  belonging to the chunk
+ */
+
+void pridil::chunk_range(const std::size_t num_items,
+                         const std::size_t num_chunks,
+                         const std::size_t chunk,
+                         std::size_t& begin, std::size_t& end) {
+    const std::size_t base = num_items / num_chunks;
+    const std::size_t extra = num_items % num_chunks;
+
+    begin = chunk * base + (chunk < extra ? chunk : extra);
+    end = begin + base + (chunk < extra ? 1 : 0);
+}
+
+
+/*
+ *  Returns the number of chunks of at most chunk_size items needed
+ *  to hold num_items items. Always returns at least one chunk.
+ */
+
+std::size_t pridil::num_chunks_for(const std::size_t num_items,
+                                   const std::size_t chunk_size) {
+    const std::size_t chunks = (num_items + chunk_size - 1) / chunk_size;
+    return chunks > 0 ? chunks : 1;
+}
+
+
+/*
+ *  Returns the number of processors currently online, or 1 if that
+ *  number cannot be determined.
+ */
+
+unsigned int pridil::hardware_threads() {
+    const long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return num_cpus > 0 ? static_cast<unsigned int>(num_cpus) : 1;
+}
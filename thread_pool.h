@@ -0,0 +1,134 @@
+/*
+ *  thread_pool.h
+ *  =============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Interface to ThreadPool class for Prisoner's Dilemma simulation.
+ *
+ *  A ThreadPool owns a fixed number of worker threads which are created
+ *  once, when the pool is constructed, and which sleep between jobs. A
+ *  job is a ParallelTask divided into a number of chunks. The chunks are
+ *  handed out to the threads one at a time until none remain, and run()
+ *  does not return until every chunk has been completed. The calling
+ *  thread works on chunks alongside the pool's own threads, so a pool
+ *  of one thread creates no extra threads at all and simply runs every
+ *  chunk in order.
+ *
+ *  Which thread runs which chunk is not deterministic, so a task which
+ *  needs reproducible results should key any per-chunk state (random
+ *  number streams, partial counts, output buffers) by chunk number,
+ *  and only use the thread number for scratch space.
+ *
+ *  Public member functions:
+ *    num_threads() - returns the number of threads, including the
+ *                    calling thread, which run the pool's jobs.
+ *
+ *    run() - runs the specified number of chunks of a task, and
+ *            returns when they have all completed. If any chunk throws
+ *            a PridilException or std::bad_alloc, the remaining chunks
+ *            are still run and the first such exception is re-thrown
+ *            to the caller, with its own type. Any other exception
+ *            calls std::terminate(), as it would if it escaped a
+ *            thread.
+ *
+ *  Non-member functions:
+ *    chunk_range() - calculates the half-open range of items which
+ *                    belongs to a given chunk, when a number of items
+ *                    is split as evenly as possible into chunks.
+ *
+ *    num_chunks_for() - returns the number of chunks needed to split a
+ *                       number of items into chunks of a given size.
+ *
+ *    hardware_threads() - returns the number of processors online.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#ifndef PG_PRIDIL_THREAD_POOL_H
+#define PG_PRIDIL_THREAD_POOL_H
+
+#include <cstddef>
+#include <vector>
+#include <pthread.h>
+#include "pridil_common.h"
+
+namespace pridil {
+
+/*
+ *  Abstract base class for a job to be run on a ThreadPool.
+ */
+
+class ParallelTask {
+    public:
+        virtual ~ParallelTask() {}
+        virtual void run_chunk(const std::size_t chunk,
+                               const unsigned int thread) = 0;
+};
+
+
+/*
+ *  ThreadPool class.
+ */
+
+class ThreadPool {
+    public:
+
+        //  Constructor and destructor
+
+        explicit ThreadPool(const unsigned int num_threads);
+        ~ThreadPool();
+
+        //  Getter and job methods
+
+        unsigned int num_threads() const;
+        void run(ParallelTask& task, const std::size_t num_chunks);
+
+    private:
+        struct WorkerArg {
+            ThreadPool * pool;
+            unsigned int thread;
+        };
+
+        std::vector<pthread_t> m_workers;
+        std::vector<WorkerArg> m_worker_args;
+        pthread_mutex_t m_mutex;
+        pthread_cond_t m_work_ready;
+        pthread_cond_t m_work_done;
+
+        ParallelTask * m_task;
+        std::size_t m_num_chunks;
+        std::size_t m_next_chunk;
+        unsigned long m_generation;
+        unsigned int m_busy_workers;
+        bool m_shutdown;
+        bool m_failed;
+        bool m_out_of_memory;
+        PridilException * m_failure;
+
+        static void * worker_entry(void * arg);
+        void worker_loop(const unsigned int thread);
+        void work(const unsigned int thread);
+        void record_failure(PridilException * failure,
+                            const bool out_of_memory);
+        void shutdown();
+
+        ThreadPool(const ThreadPool&);              // Prevent copying
+        ThreadPool& operator=(const ThreadPool&);   // Prevent assignment
+};
+
+
+/*  Chunking helper functions  */
+
+void chunk_range(const std::size_t num_items, const std::size_t num_chunks,
+                 const std::size_t chunk,
+                 std::size_t& begin, std::size_t& end);
+std::size_t num_chunks_for(const std::size_t num_items,
+                           const std::size_t chunk_size);
+unsigned int hardware_threads();
+
+}       //  namespace pridil
+
+#endif      // PG_PRIDIL_THREAD_POOL_H
@@ -0,0 +1,391 @@
+/*
+ *  tournament.cpp
+ *  ==============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Implementation of Tournament class for Prisoners' Dilemma simulation.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#include <ostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <ctime>
+#include <stdint.h>
+#include "pridil_common.h"
+#include "tournament.h"
+#include "creature.h"
+#include "game.h"
+#include "thread_pool.h"
+#include "rng.h"
+
+using std::endl;
+using std::ostream;
+using std::vector;
+using std::pair;
+
+using namespace pridil;
+
+
+/*
+ *  Number of creatures in each tile. Two tiles of 128 creatures,
+ *  with their brains and genes, fit comfortably in L2 cache.
+ */
+
+namespace {
+    const std::size_t c_tile_size = 128;
+    const std::size_t c_num_strategies = always_defect + 1;
+
+    typedef pair<std::size_t, std::size_t> TilePair;
+}
+
+
+/*
+ *  Parallel task to play all the matches between the pairs of tiles
+ *  in one round of the schedule, one pair of tiles per chunk. A pair
+ *  made up of the same tile twice plays the matches within that tile.
+ *
+ *  The tile pairs in a round share no creatures, so creatures can be
+ *  updated without locking. Each thread adds its results to its own
+ *  payoff totals, which are summed by add_totals() at the end.
+ */
+
+class Tournament::TileRoundTask : public ParallelTask {
+    public:
+        TileRoundTask(CreatureList& creatures,
+                      const vector<Strategy>& strategies,
+                      const int games_per_match, const uint64_t seed,
+                      const unsigned int num_threads) :
+            m_creatures(creatures), m_strategies(strategies),
+            m_games_per_match(games_per_match), m_seed(seed), m_round(0),
+            m_payoffs(num_threads, vector<int64_t>(c_num_strategies *
+                                                   c_num_strategies, 0)),
+            m_matches(num_threads, 0) {}
+
+        void set_round(const vector<TilePair>& round) {
+            m_round = &round;
+        }
+
+        virtual void run_chunk(const std::size_t chunk,
+                               const unsigned int thread);
+        unsigned long add_totals(vector<int64_t>& payoffs,
+                                 vector<int64_t>& games) const;
+
+    private:
+        CreatureList& m_creatures;
+        const vector<Strategy>& m_strategies;
+        const int m_games_per_match;
+        const uint64_t m_seed;
+        const vector<TilePair> * m_round;
+        vector<vector<int64_t> > m_payoffs;
+        vector<unsigned long> m_matches;
+
+        void play(const std::size_t first, const std::size_t second,
+                  vector<int64_t>& payoffs);
+
+        TileRoundTask(const TileRoundTask&);
+        TileRoundTask& operator=(const TileRoundTask&);
+};
+
+
+/*
+ *  Plays the matches between the pair of tiles belonging to one chunk.
+ */
+
+void Tournament::TileRoundTask::run_chunk(const std::size_t chunk,
+                                          const unsigned int thread) {
+    const std::size_t num_creatures = m_creatures.size();
+    const TilePair& tiles = (*m_round)[chunk];
+    vector<int64_t>& payoffs = m_payoffs[thread];
+
+    const std::size_t begin1 = tiles.first * c_tile_size;
+    const std::size_t end1 = std::min(begin1 + c_tile_size, num_creatures);
+    const std::size_t begin2 = tiles.second * c_tile_size;
+    const std::size_t end2 = std::min(begin2 + c_tile_size, num_creatures);
+
+    unsigned long matches = 0;
+    if ( tiles.first == tiles.second ) {
+        for ( std::size_t i = begin1; i < end1; ++i ) {
+            for ( std::size_t j = i + 1; j < end1; ++j ) {
+                play(i, j, payoffs);
+                ++matches;
+            }
+        }
+    } else {
+        for ( std::size_t i = begin1; i < end1; ++i ) {
+            for ( std::size_t j = begin2; j < end2; ++j ) {
+                play(i, j, payoffs);
+                ++matches;
+            }
+        }
+    }
+    m_matches[thread] += matches;
+}
+
+
+/*
+ *  Plays a match between two creatures, identified by their positions
+ *  in the creatures list, records the results, and has the creatures
+ *  forget each other so that later matches start afresh. The random
+ *  moves of the match are drawn from a hash of the tournament's seed
+ *  and the two positions, so they do not depend on which thread plays
+ *  the match.
+ */
+
+void Tournament::TileRoundTask::play(const std::size_t first,
+                                     const std::size_t second,
+                                     vector<int64_t>& payoffs) {
+    Creature * creature1 = m_creatures[first];
+    Creature * creature2 = m_creatures[second];
+
+    int score1;
+    int score2;
+    play_match(creature1, creature2, m_games_per_match, score1, score2,
+               mix_seed(mix_seed(m_seed, first), second));
+    creature1->forget(creature2->id());
+    creature2->forget(creature1->id());
+
+    const std::size_t strategy1 = m_strategies[first];
+    const std::size_t strategy2 = m_strategies[second];
+    payoffs[strategy1 * c_num_strategies + strategy2] += score1;
+    payoffs[strategy2 * c_num_strategies + strategy1] += score2;
+}
+
+
+/*
+ *  Adds each thread's payoff totals to the specified totals, and the
+ *  number of games played to each strategy's game counts, and returns
+ *  the number of matches played.
+ */
+
+unsigned long Tournament::TileRoundTask::add_totals(
+        vector<int64_t>& payoffs, vector<int64_t>& games) const {
+    unsigned long matches = 0;
+    for ( std::size_t thread = 0; thread < m_payoffs.size(); ++thread ) {
+        for ( std::size_t i = 0; i < payoffs.size(); ++i ) {
+            payoffs[i] += m_payoffs[thread][i];
+        }
+        matches += m_matches[thread];
+    }
+
+    //  Every creature of one strategy plays every creature of the
+    //  other, so the game counts follow from the population sizes.
+
+    vector<int64_t> counts(c_num_strategies, 0);
+    for ( std::size_t i = 0; i < m_strategies.size(); ++i ) {
+        ++counts[m_strategies[i]];
+    }
+    for ( std::size_t row = 0; row < c_num_strategies; ++row ) {
+        for ( std::size_t col = 0; col < c_num_strategies; ++col ) {
+            const int64_t opponents = (row == col) ?
+                                      counts[col] - 1 : counts[col];
+            games[row * c_num_strategies + col] +=
+                counts[row] * opponents * m_games_per_match;
+        }
+    }
+
+    return matches;
+}
+
+
+/*
+ *  Constructor.
+ *
+ *  Arguments:
+ *    wInfo -- the starting population, creature characteristics,
+ *             number of threads and random number seed, as for a World
+ *    games_per_match -- the number of games in each match
+ */
+
+Tournament::Tournament(const WorldInfo& wInfo, const int games_per_match) :
+        m_games_per_match(games_per_match),
+        m_seed(seed_or_time(wInfo.m_seed)),
+        m_matches_played(0),
+        m_creatures(),
+        m_pool(wInfo.m_threads),
+        m_strategy_names(c_num_strategies),
+        m_payoffs(c_num_strategies * c_num_strategies, 0),
+        m_games(c_num_strategies * c_num_strategies, 0) {
+
+    create_creatures(wInfo, m_creatures);
+    for ( CreatureList::const_iterator itr = m_creatures.begin();
+          itr != m_creatures.end(); ++itr ) {
+        m_strategy_names[(*itr)->strategy_value()] = (*itr)->strategy();
+    }
+}
+
+
+/*
+ *  Destructor. Deletes all allocated creatures.
+ */
+
+Tournament::~Tournament() {
+    for ( CreatureList::iterator itr = m_creatures.begin();
+          itr != m_creatures.end(); ++itr ) {
+        delete *itr;
+    }
+}
+
+
+/*
+ *  Plays every match of the tournament, tile pair by tile pair, with
+ *  the tile pairs scheduled by the circle method as described in
+ *  tournament.h.
+ */
+
+void Tournament::run() {
+    vector<Strategy> strategies(m_creatures.size());
+    for ( std::size_t i = 0; i < m_creatures.size(); ++i ) {
+        strategies[i] = m_creatures[i]->strategy_value();
+    }
+
+    TileRoundTask task(m_creatures, strategies, m_games_per_match, m_seed,
+                       m_pool.num_threads());
+    vector<TilePair> round;
+
+    //  First round: the matches within each tile
+
+    const std::size_t num_tiles = num_chunks_for(m_creatures.size(),
+                                                 c_tile_size);
+    for ( std::size_t tile = 0; tile < num_tiles; ++tile ) {
+        round.push_back(TilePair(tile, tile));
+    }
+    task.set_round(round);
+    m_pool.run(task, round.size());
+
+    //  Remaining rounds: the circle method, with the last slot fixed
+    //  and an empty slot, whose partner sits out, if the number of
+    //  tiles is odd.
+
+    const std::size_t num_slots = num_tiles + (num_tiles % 2);
+    const std::size_t rotating = num_slots - 1;
+    for ( std::size_t r = 0; r < rotating; ++r ) {
+        round.clear();
+        if ( num_slots - 1 < num_tiles ) {
+            round.push_back(TilePair(r, num_slots - 1));
+        }
+        for ( std::size_t i = 1; i < num_slots / 2; ++i ) {
+            round.push_back(TilePair((r + i) % rotating,
+                                     (r + rotating - i) % rotating));
+        }
+        task.set_round(round);
+        m_pool.run(task, round.size());
+    }
+
+    m_matches_played += task.add_totals(m_payoffs, m_games);
+}
+
+
+/*
+ *  Returns the number of matches played so far.
+ */
+
+unsigned long Tournament::matches_played() const {
+    return m_matches_played;
+}
+
+
+/*
+ *  Returns the average result per game for creatures of one strategy
+ *  against creatures of another, or zero if no such games were played.
+ */
+
+double Tournament::average_payoff(const Strategy strategy,
+                                  const Strategy opponent) const {
+    const std::size_t cell = strategy * c_num_strategies + opponent;
+    if ( m_games[cell] == 0 ) {
+        return 0.0;
+    }
+    return static_cast<double>(m_payoffs[cell]) / m_games[cell];
+}
+
+
+/*
+ *  Member function outputs summary statistics of the tournament.
+ *
+ *  Arguments: reference to a ostream object to which to output.
+ */
+
+void Tournament::output_tournament_stats(ostream& out) const {
+    out << "Summary tournament statistics:" << endl
+        << "Creatures: " << m_creatures.size() << endl
+        << "Games per match: " << m_games_per_match << endl
+        << "Matches played: " << m_matches_played << endl
+        << "Games played: "
+        << m_matches_played * static_cast<unsigned long>(m_games_per_match)
+        << endl << endl;
+}
+
+
+/*
+ *  Member function outputs the payoff matrix. Each row shows the
+ *  average result per game for creatures of one strategy, against
+ *  creatures of each strategy in the numbered columns, and against
+ *  all opponents in the final column. Strategies with no creatures
+ *  are left out.
+ *
+ *  Arguments: reference to a ostream object to which to output.
+ */
+
+void Tournament::output_payoff_matrix(ostream& out) const {
+    vector<std::size_t> present;
+    for ( std::size_t s = 0; s < c_num_strategies; ++s ) {
+        if ( !m_strategy_names[s].empty() ) {
+            present.push_back(s);
+        }
+    }
+
+    out << "Strategy payoff matrix (average result per game):" << endl;
+    for ( std::size_t i = 0; i < present.size(); ++i ) {
+        out << i + 1 << ": " << m_strategy_names[present[i]] << endl;
+    }
+
+    out << std::setw(4) << " ";
+    for ( std::size_t i = 0; i < present.size(); ++i ) {
+        out << std::setw(8) << i + 1;
+    }
+    out << std::setw(8) << "all" << endl;
+
+    const std::ios::fmtflags old_flags = out.flags();
+    const std::streamsize old_precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+
+    for ( std::size_t i = 0; i < present.size(); ++i ) {
+        out << std::setw(4) << i + 1;
+
+        int64_t row_payoff = 0;
+        int64_t row_games = 0;
+        for ( std::size_t j = 0; j < present.size(); ++j ) {
+            const std::size_t cell = present[i] * c_num_strategies +
+                                     present[j];
+            row_payoff += m_payoffs[cell];
+            row_games += m_games[cell];
+            if ( m_games[cell] > 0 ) {
+                out << std::setw(8) << static_cast<double>(m_payoffs[cell]) /
+                                       m_games[cell];
+            } else {
+                out << std::setw(8) << "-";
+            }
+        }
+        if ( row_games > 0 ) {
+            out << std::setw(8) << static_cast<double>(row_payoff) /
+                                   row_games;
+        } else {
+            out << std::setw(8) << "-";
+        }
+        out << endl;
+    }
+
+    out.flags(old_flags);
+    out.precision(old_precision);
+    out << endl;
+}
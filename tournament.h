@@ -0,0 +1,121 @@
+/*
+ *  tournament.h
+ *  ============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Interface to Tournament class for Prisoner's Dilemma simulation.
+ *
+ *  A Tournament is a round-robin tournament in the style of Axelrod's,
+ *  as an alternative to running a World day by day. Every creature in
+ *  the starting population plays a match of a fixed number of games
+ *  against every other creature. The games are played exactly as in a
+ *  World, so creatures remember the earlier games of a match and gain
+ *  or lose resources, but each match starts afresh, since creatures
+ *  forget their opponent once the match is over. Creatures do not age,
+ *  die or reproduce.
+ *
+ *  The n(n - 1) / 2 matches are scheduled in tiles. The creatures are
+ *  split into tiles of consecutive creatures, small enough that two
+ *  tiles fit in cache, and each pair of tiles plays all the matches
+ *  between their creatures in one go. The pairs of tiles are ordered
+ *  with the circle method: one tile stays fixed and the rest rotate
+ *  around it, so that each round of the schedule pairs off every tile
+ *  exactly once, i.e. is a perfect matching of tiles, and after the
+ *  rounds every pair of tiles has met exactly once. With an odd number
+ *  of tiles, one tile sits out each round. Since no two tile pairs in a
+ *  round share a creature, the tile pairs of a round are played in
+ *  parallel on the thread pool without any locking. A first round
+ *  plays the matches within each tile.
+ *
+ *  The results are gathered into a payoff matrix of the average result
+ *  per game for creatures of each strategy against each other
+ *  strategy. Each thread keeps its own totals, which are summed when
+ *  the tournament is over, and the totals are integers, so the matrix
+ *  does not depend on the number of threads. Strategies which move at
+ *  random take each match's draws from a hash of the seed and the two
+ *  creatures' positions, rather than from std::rand(), so their moves,
+ *  and the matrix, are the same whatever the number of threads.
+ *
+ *  Public member functions:
+ *    run() - plays all of the tournament's matches.
+ *
+ *    matches_played() - returns the number of matches played so far.
+ *
+ *    average_payoff() - returns the average result per game for
+ *                       creatures of one strategy against creatures
+ *                       of another.
+ *
+ *    output_tournament_stats() - outputs summary statistics of the
+ *                                tournament, including the number of
+ *                                creatures, matches and games.
+ *
+ *    output_payoff_matrix() - outputs the strategy-versus-strategy
+ *                             payoff matrix, showing the average
+ *                             result per game for each strategy against
+ *                             each other strategy, and overall.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+
+#ifndef PG_PRIDIL_TOURNAMENT_H
+#define PG_PRIDIL_TOURNAMENT_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "pridil_common.h"
+#include "creature.h"
+#include "thread_pool.h"
+
+namespace pridil {
+
+class Tournament {
+    public:
+
+        //  Constructor and destructor
+
+        Tournament(const WorldInfo& wInfo, const int games_per_match);
+        ~Tournament();
+
+        //  Methods to run the tournament
+
+        void run();
+        unsigned long matches_played() const;
+        double average_payoff(const Strategy strategy,
+                              const Strategy opponent) const;
+
+        //  Methods to output tournament results
+
+        void output_tournament_stats(std::ostream& out) const;
+        void output_payoff_matrix(std::ostream& out) const;
+
+    private:
+        const int m_games_per_match;
+        const uint64_t m_seed;
+        unsigned long m_matches_played;
+        CreatureList m_creatures;
+        ThreadPool m_pool;
+
+        //  Names of the strategies, indexed by Strategy value, and
+        //  total results and number of games for row strategies
+        //  against column strategies.
+
+        std::vector<std::string> m_strategy_names;
+        std::vector<int64_t> m_payoffs;
+        std::vector<int64_t> m_games;
+
+        //  Parallel task used by run()
+
+        class TileRoundTask;
+
+        Tournament(const Tournament&);              // Prevent copying
+        Tournament& operator=(const Tournament&);   // Prevent assignment
+};
+
+}       //  namespace pridil
+
+#endif      // PG_PRIDIL_TOURNAMENT_H
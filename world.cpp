@@ -26,12 +26,16 @@
 #include "world.h"
 #include "creature.h"
 #include "game.h"
+#include "thread_pool.h"
+#include "region.h"
+#include "slot_map.h"
+#include "brain_pool.h"
+#include "convergence.h"
 
 
 using std::endl;
 using std::ostream;
 using std::sort;
-using std::random_shuffle;
 using std::vector;
 using std::map;
 using std::string;
@@ -43,110 +47,207 @@ using namespace pridil;
 
 
 /*
- *  Constructor.
+ *  Parallel task to run one phase of the day in every region, one
+ *  region per chunk. Regions share nothing during a phase, apart from
+ *  the lock-free inboxes to which commit_day() posts migrants, so the
+ *  pool's threads can run them without any further locking.
  */
 
-World::World(const WorldInfo& wInfo) : m_wInfo(wInfo),
-                        m_day(1),
-                        m_games_played(0),
-                        m_creatures(),
-                        m_dead_creatures() {
+class World::RegionPhaseTask : public ParallelTask {
+    public:
+        enum Phase { play_phase, commit_phase, admit_phase };
+
+        RegionPhaseTask(vector<Region *>& regions, const Day day,
+                        const bool deaths_enabled, const bool repro_day) :
+            m_regions(regions), m_day(day),
+            m_deaths_enabled(deaths_enabled), m_repro_day(repro_day),
+            m_phase(play_phase), m_first_ids(regions.size(), 0) {}
+
+        virtual void run_chunk(const std::size_t chunk,
+                               const unsigned int thread);
+        void set_phase(const Phase phase);
+        void reserve_ids();
+        CreatureID first_id(const std::size_t region) const;
+
+    private:
+        vector<Region *>& m_regions;
+        const Day m_day;
+        const bool m_deaths_enabled;
+        const bool m_repro_day;
+        Phase m_phase;
+        vector<CreatureID> m_first_ids;
+
+        RegionPhaseTask(const RegionPhaseTask&);
+        RegionPhaseTask& operator=(const RegionPhaseTask&);
+};
 
-    //  Seed the pseudo-random number generator
 
-    std::srand((unsigned) std::time(0));
+/*
+ *  Runs the current phase in the region belonging to one chunk.
+ */
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+void World::RegionPhaseTask::run_chunk(const std::size_t chunk,
+                                       const unsigned int thread) {
+    Region * region = m_regions[chunk];
+    switch ( m_phase ) {
+        case play_phase:
+            region->play_day(m_day, m_deaths_enabled, m_repro_day);
+            break;
+        case commit_phase:
+            region->commit_day(m_day, m_first_ids[chunk], m_regions);
+            break;
+        case admit_phase:
+            region->admit_immigrants();
+            break;
+    }
+}
+
+#pragma GCC diagnostic pop
 
-    //  Populate vector with correct numbers of creatures
 
-    CreatureInit c_init;
-    c_init.life_expectancy = wInfo.m_default_life_expectancy;
-    c_init.life_expectancy_range = wInfo.m_default_life_expectancy_range;
-    c_init.starting_resources = wInfo.m_default_starting_resources;
-    c_init.repro_cost = wInfo.m_repro_cost;
-    c_init.repro_min_resources = wInfo.m_repro_min_resources;
+/*
+ *  Sets the phase to run on the next call to ThreadPool::run().
+ */
+
+void World::RegionPhaseTask::set_phase(const Phase phase) {
+    m_phase = phase;
+}
+
+
+/*
+ *  Reserves each region's block of IDs for the day's newborns, in
+ *  region order, so that IDs do not depend on the order in which the
+ *  regions ran. Must be called between the play and commit phases.
+ */
+
+void World::RegionPhaseTask::reserve_ids() {
+    for ( std::size_t r = 0; r < m_regions.size(); ++r ) {
+        m_first_ids[r] = Creature::reserve_ids(m_regions[r]->births());
+    }
+}
 
+
+/*
+ *  Returns the first of the IDs reserved for a region's newborns.
+ */
+
+CreatureID World::RegionPhaseTask::first_id(const std::size_t region) const {
+    return m_first_ids[region];
+}
+
+
+
+/*
+ *  Returns a copy of a WorldInfo structure, with a seed chosen from
+ *  the current time if none was specified.
+ */
+
+namespace {
+    WorldInfo with_seed(const WorldInfo& wInfo) {
+        WorldInfo seeded_info(wInfo);
+        seeded_info.m_seed = seed_or_time(wInfo.m_seed);
+        return seeded_info;
+    }
+}
+
+
+/*
+ *  Constructor.
+ *
+ *  The starting population is created in order of strategy and split
+ *  into consecutive blocks, one per region. With more than one region,
+ *  the world's threads run the regions and each region has a single
+ *  thread; with a single region, the region has all the threads.
+ */
+
+World::World(const WorldInfo& wInfo) : m_wInfo(with_seed(wInfo)),
+                        m_day(1),
+                        m_pool(wInfo.m_regions > 1 ? wInfo.m_threads : 1),
+                        m_slots(),
+                        m_brains(),
+                        m_regions(),
+                        m_handles_by_id(),
+                        m_first_id(0),
+                        m_convergence(2 * (always_defect + 1),
+                                      wInfo.m_converge_window,
+                                      wInfo.m_converge_tolerance),
+                        m_converged_day(0) {
+
+    //  Seed the pseudo-random number generator used by the
+    //  strategy genes. The pairings and migrations use their own
+    //  generators, derived from the same seed.
+
+    seed_strategy_genes(m_wInfo.m_seed);
+
+    if ( m_wInfo.m_regions == 0 ) {
+        m_wInfo.m_regions = 1;
+    }
+
+    const unsigned int num_regions = m_wInfo.m_regions;
+    const unsigned int region_threads = (num_regions > 1) ?
+                                        1 : m_wInfo.m_threads;
     try {
-        for ( int i = 0; i < wInfo.m_random_strategy; ++i ) {
-            c_init.strategy = random_strategy;
-            m_creatures.push_back(new Creature(c_init));
-            m_wInfo.m_starting_creatures++;
-        }
-        for ( int i = 0; i < wInfo.m_tit_for_tat; ++i ) {
-            c_init.strategy = tit_for_tat;
-            m_creatures.push_back(new Creature(c_init));
-            m_wInfo.m_starting_creatures++;
-        }
-        for ( int i = 0; i < wInfo.m_tit_for_two_tats; ++i ) {
-            c_init.strategy = tit_for_two_tats;
-            m_creatures.push_back(new Creature(c_init));
-            m_wInfo.m_starting_creatures++;
-        }
-        for ( int i = 0; i < wInfo.m_susp_tit_for_tat; ++i ) {
-            c_init.strategy = susp_tit_for_tat;
-            m_creatures.push_back(new Creature(c_init));
-            m_wInfo.m_starting_creatures++;
-        }
-        for ( int i = 0; i < wInfo.m_naive_prober; ++i ) {
-            c_init.strategy = naive_prober;
-            m_creatures.push_back(new Creature(c_init));
-            m_wInfo.m_starting_creatures++;
+        for ( unsigned int r = 0; r < num_regions; ++r ) {
+            m_regions.push_back(new Region(m_wInfo, r, region_threads,
+                                           m_slots, m_brains));
         }
-        for ( int i = 0; i < wInfo.m_always_cooperate; ++i ) {
-            c_init.strategy = always_cooperate;
-            m_creatures.push_back(new Creature(c_init));
-            m_wInfo.m_starting_creatures++;
-        }
-        for ( int i = 0; i < wInfo.m_always_defect; ++i ) {
-            c_init.strategy = always_defect;
-            m_creatures.push_back(new Creature(c_init));
-            m_wInfo.m_starting_creatures++;
+    }
+    catch ( ... ) {
+        for ( std::size_t r = 0; r < m_regions.size(); ++r ) {
+            delete m_regions[r];
         }
-    } catch(...) {
+        throw;
+    }
 
-        //  Free allocated creatures if there was any problem
-        //  with construction
+    //  Populate regions with correct numbers of creatures, and index
+    //  their handles by ID
 
-        CreatureList::iterator itr_live_creature;
-        for ( itr_live_creature = m_creatures.begin();
-              itr_live_creature != m_creatures.end();
-              ++itr_live_creature ) {
-            delete *itr_live_creature;
-        }
+    Population creatures(&m_brains);
+    m_wInfo.m_starting_creatures += create_creatures(wInfo, creatures);
 
-        throw;                      // Re-throw exception to caller
+    const std::size_t total = creatures.size();
+    for ( std::size_t i = 0; i < total; ++i ) {
+        Region * region = m_regions[i * num_regions / total];
+        const CreatureID id = creatures.id(i);
+        region->add_creature(creatures, i);
+        const Population& region_creatures = region->creatures();
+        index_handle(id, region_creatures.handle(region_creatures.size() - 1));
     }
 }
 
 
 /*
- *  Destructor. Deletes all allocated creatures.
+ *  Destructor. Deletes all regions, which delete their creatures.
  */
 
 World::~World() {
 
     //  Assert that creature counts are consistent
 
-    assert((m_creatures.size() + m_dead_creatures.size()) == 
+    std::size_t num_live = 0;
+    std::size_t num_dead = 0;
+    for ( std::size_t r = 0; r < m_regions.size(); ++r ) {
+        num_live += m_regions[r]->creatures().size();
+        num_dead += m_regions[r]->dead_creatures().size();
+    }
+
+    assert((num_live + num_dead) ==
            (m_wInfo.m_starting_creatures + m_wInfo.m_born_creatures));
-    assert(m_dead_creatures.size() == m_wInfo.m_dead_creatures);
-    assert(m_creatures.size() == (m_wInfo.m_starting_creatures +
+    assert(num_dead == m_wInfo.m_dead_creatures);
+    assert(num_live == (m_wInfo.m_starting_creatures +
            m_wInfo.m_born_creatures - m_wInfo.m_dead_creatures));
+    assert(num_live == m_slots.size());
+    (void) num_live;
+    (void) num_dead;
 
 
-    //  Delete dynamically allocated creatures.
-
-    CreatureList::iterator itr_live_creature;
-    for ( itr_live_creature = m_creatures.begin();
-          itr_live_creature != m_creatures.end();
-          ++itr_live_creature ) {
-        delete *itr_live_creature;
-    }
+    //  Delete dynamically allocated regions.
 
-    CreatureList::iterator itr_dead_creature;
-    for ( itr_dead_creature = m_dead_creatures.begin();
-          itr_dead_creature != m_dead_creatures.end();
-          ++itr_dead_creature ) {
-        delete *itr_dead_creature;
+    for ( std::size_t r = 0; r < m_regions.size(); ++r ) {
+        delete m_regions[r];
     }
 }
 
@@ -163,64 +264,58 @@ Day World::day() const {
 /*
  *  Completes a world day.
  *
- *  Each creature (unless there is an odd number of creatures, in which case
- *  one of them sits out) is paired with a random other creature and a
- *  game is played between them. Each creature plays one game per day.
+ *  Within each region, each creature (unless there is an odd number of
+ *  creatures, in which case one of them sits out) is paired with a
+ *  random other creature and a game is played between them. Each
+ *  creature plays one game per day. Each creature then ages a day and
+ *  may die or reproduce, and finally some creatures may migrate to
+ *  other regions.
  *
- *  The randomizing is accomplished by random_shuffle()ing the list
- *  of creatures, and pairing up 0 with 1, 2 with 3, and so on.
+ *  The regions are advanced in three phases, as described in region.h,
+ *  with the IDs and handles for the day's newborns reserved between the
+ *  first two, and the handles of the day's dead freed after the second.
  */
 
 void World::advance_day() {
-    random_shuffle(m_creatures.begin(), m_creatures.end());
-
-    //  Play paired games
+    const bool deaths_enabled = (m_wInfo.m_disable_deaths != true);
+    const bool repro_day = (m_wInfo.m_disable_repro != true) &&
+                           (m_day % m_wInfo.m_repro_cycle_days) == 0;
+
+    RegionPhaseTask task(m_regions, m_day, deaths_enabled, repro_day);
+    m_pool.run(task, m_regions.size());
+
+    task.reserve_ids();
+    for ( std::size_t r = 0; r < m_regions.size(); ++r ) {
+        const HandleList& handles =
+            m_regions[r]->reserve_newborns();
+        for ( std::size_t i = 0; i < handles.size(); ++i ) {
+            index_handle(task.first_id(r) + i, handles[i]);
+        }
+    }
+    task.set_phase(RegionPhaseTask::commit_phase);
+    m_pool.run(task, m_regions.size());
 
-    CreatureList::iterator itr_c1;
-    CreatureList::iterator itr_c2;
-    for ( itr_c1 = m_creatures.begin(), itr_c2 = itr_c1 + 1;
-          itr_c1 != m_creatures.end() && itr_c1 != (m_creatures.end() - 1);
-          itr_c1 += 2, itr_c2 += 2 ) {
-        play_game(*itr_c1, *itr_c2);
-        ++m_games_played;
+    for ( std::size_t r = 0; r < m_regions.size(); ++r ) {
+        m_regions[r]->release_dead();
     }
 
-    //  Age each creature a day, checking for deaths and births
-    //  Note that we can't increment itr_creature within the
-    //  for loop, because we have to use std::vector.erase() to
-    //  get the next position when we remove a dead creature from
-    //  the list.
-
-    CreatureList newborns;
-    for ( CreatureList::iterator itr_creature = m_creatures.begin();
-          itr_creature != m_creatures.end(); /* empty expression */ ) {
-
-        Creature* creature = *itr_creature;
-        creature->age_day();
-
-        //  Check for deaths and reproductions
-
-        if ( (m_wInfo.m_disable_deaths != true) && creature->is_dead() ) {
-            m_dead_creatures.push_back(creature);
-            itr_creature = m_creatures.erase(itr_creature);
-            ++m_wInfo.m_dead_creatures;
-        } else if ( (m_wInfo.m_disable_repro != true) &&
-                    (m_day % m_wInfo.m_repro_cycle_days) == 0 ) {
-            Creature* new_creature = creature->reproduce();
-            if ( new_creature ) {
-                newborns.push_back(new_creature);
-                ++m_wInfo.m_born_creatures;
-            }
-            ++itr_creature;
-        } else {
-            ++itr_creature;
-        }
+    task.set_phase(RegionPhaseTask::admit_phase);
+    m_pool.run(task, m_regions.size());
+
+    //  Update world totals from the regions' running totals
+
+    m_wInfo.m_dead_creatures = 0;
+    m_wInfo.m_born_creatures = 0;
+    for ( std::size_t r = 0; r < m_regions.size(); ++r ) {
+        m_wInfo.m_dead_creatures += m_regions[r]->dead_count();
+        m_wInfo.m_born_creatures += m_regions[r]->born_creatures();
     }
 
-    //  Add any newborns to live creatures list
+    //  Check for convergence every so many days, if asked to
 
-    if ( newborns.empty() != true ) {
-        m_creatures.insert(m_creatures.end(), newborns.begin(), newborns.end());
+    const Day check_days = m_wInfo.m_converge_check_days;
+    if ( check_days > 0 && m_day % check_days == 0 ) {
+        check_convergence();
     }
 
     //  Increment world days
@@ -229,6 +324,111 @@ void World::advance_day() {
 }
 
 
+/*
+ *  Returns true if convergence checks are enabled and the world's
+ *  statistics have converged.
+ */
+
+bool World::converged() const {
+    return m_converged_day > 0;
+}
+
+
+/*
+ *  Returns the day on which the world's statistics converged, or zero
+ *  if they have not converged.
+ */
+
+Day World::converged_day() const {
+    return m_converged_day;
+}
+
+
+/*
+ *  Gives the share of the live population and the average resources of
+ *  each strategy, with zeroes for strategies with no live creatures, to
+ *  the convergence monitor, and records the current day if they have
+ *  converged for the first time.
+ */
+
+void World::check_convergence() {
+    const std::size_t num_strategies = always_defect + 1;
+    vector<double> sample(2 * num_strategies, 0.0);
+    std::size_t num_live = 0;
+    for ( std::size_t r = 0; r < m_regions.size(); ++r ) {
+        const Population& creatures = m_regions[r]->creatures();
+        for ( std::size_t i = 0; i < creatures.size(); ++i ) {
+            const Strategy strategy = creatures.strategy_value(i);
+            sample[strategy] += 1.0;
+            sample[num_strategies + strategy] += creatures.resources(i);
+        }
+        num_live += creatures.size();
+    }
+
+    for ( std::size_t s = 0; s < num_strategies; ++s ) {
+        if ( sample[s] > 0.0 ) {
+            sample[num_strategies + s] /= sample[s];
+            sample[s] /= num_live;
+        }
+    }
+
+    if ( m_convergence.add_sample(sample) && m_converged_day == 0 ) {
+        m_converged_day = m_day;
+    }
+}
+
+
+/*
+ *  Records the handle of the creature with the specified ID. IDs must
+ *  be recorded in increasing order.
+ */
+
+void World::index_handle(const CreatureID id, const CreatureHandle handle) {
+    if ( m_handles_by_id.empty() ) {
+        m_first_id = id;
+    }
+
+    const std::size_t index = id - m_first_id;
+    if ( index >= m_handles_by_id.size() ) {
+        m_handles_by_id.resize(index + 1, SlotMap::null_handle);
+    }
+    m_handles_by_id[index] = handle;
+}
+
+
+/*
+ *  Finds the live creature with the specified ID.
+ *
+ *  Arguments:
+ *    id -- the creature's ID
+ *    creatures -- set to the population holding the creature
+ *    row -- set to the creature's row in that population
+ *
+ *  Returns:
+ *    true if the creature was found, false if there is no live creature
+ *    with that ID.
+ */
+
+bool World::find_creature(const CreatureID id, const Population *& creatures,
+                          std::size_t& row) const {
+    if ( m_handles_by_id.empty() || id < m_first_id ||
+         static_cast<std::size_t>(id - m_first_id) >=
+                m_handles_by_id.size() ) {
+        return false;
+    }
+
+    const CreatureHandle handle = m_handles_by_id[id - m_first_id];
+    if ( !m_slots.contains(handle) ) {
+        return false;
+    }
+
+    const SlotLocation& location = m_slots.location(handle);
+    creatures = &m_regions[location.region]->creatures();
+    row = location.row;
+    return true;
+}
+
+
 /*
  *  Member function outputs summary statistics for the world.
  *
@@ -236,14 +436,48 @@ void World::advance_day() {
  */
 
 void World::output_world_stats(ostream& out) const {
+    unsigned long games_played = 0;
+    unsigned long migrants = 0;
+    unsigned long refusals = 0;
+    unsigned long unmatched = 0;
+    std::size_t unmatched_last_day = 0;
+    std::size_t num_live = 0;
+    for ( std::size_t r = 0; r < m_regions.size(); ++r ) {
+        games_played += m_regions[r]->games_played();
+        migrants += m_regions[r]->emigrants();
+        refusals += m_regions[r]->refusals();
+        unmatched += m_regions[r]->unmatched();
+        unmatched_last_day += m_regions[r]->unmatched_last_day();
+        num_live += m_regions[r]->creatures().size();
+    }
+
     out << "Summary world statistics:" << endl
         << "Days passed: " << m_day - 1 << endl
-        << "Games played: " << m_games_played << endl
+        << "Games played: " << games_played << endl
         << "Starting creatures: " << m_wInfo.m_starting_creatures << endl
-        << "Living creatures: " << m_creatures.size() << endl
+        << "Living creatures: " << num_live << endl
         << "Creatures born: " << m_wInfo.m_born_creatures << endl
-        << "Creatures died: " << m_wInfo.m_dead_creatures << endl
-        << endl;
+        << "Creatures died: " << m_wInfo.m_dead_creatures << endl;
+    if ( m_regions.size() > 1 ) {
+        out << "Regions: " << m_regions.size() << endl
+            << "Creatures migrated: " << migrants << endl;
+    }
+    if ( m_wInfo.m_converge_check_days > 0 ) {
+        if ( m_converged_day > 0 ) {
+            out << "Converged on day: " << m_converged_day << endl;
+        } else {
+            out << "Converged: no" << endl;
+        }
+    }
+    if ( m_wInfo.m_partner_choice ) {
+        const Day days = m_day > 1 ? m_day - 1 : 1;
+        out << "Partner refusals: " << refusals << endl
+            << "Unmatched creatures (last day): " << unmatched_last_day
+            << endl
+            << "Average unmatched creatures per day: "
+            << static_cast<double>(unmatched) / days << endl;
+    }
+    out << endl;
 }
 
 
@@ -255,17 +489,18 @@ void World::output_world_stats(ostream& out) const {
  */
 
 void World::output_summary_creature_stats(ostream& out) const {
-    CreatureList templist = m_creatures;
-    sort(templist.begin(), templist.end(), CompareCreatureByID());
-
     out << "Summary creature statistics:" << endl;
-    for ( CreatureList::const_iterator itr = templist.begin();
-          itr != templist.end(); ++itr ) {
-        const Creature* creature = *itr;
+    for ( std::size_t index = 0; index < m_handles_by_id.size(); ++index ) {
+        const Population * population;
+        std::size_t i;
+        if ( !find_creature(m_first_id + index, population, i) ) {
+            continue;
+        }
+        const Population& creatures = *population;
 
-        out << "Creature " << creature->id()
-            << ", strategy '" << creature->strategy()
-            << "', resources " << creature->resources()
+        out << "Creature " << creatures.id(i)
+            << ", strategy '" << creatures.strategy(i)
+            << "', resources " << creatures.resources(i)
             << endl;
     }
     out << endl;
@@ -280,106 +515,87 @@ void World::output_summary_creature_stats(ostream& out) const {
  */
 
 void World::output_full_creature_stats(ostream& out) const {
-    for ( CreatureList::const_iterator itr = m_creatures.begin();
-          itr != m_creatures.end(); ++itr ) {
-
-        const Creature* creature = *itr;
-
-        out << "=============\nCreature " << creature->id()
-            << "\n=============\n\n";
-
-        out << "Strategy : " << creature->strategy() << "\n";
-        out << "Age      : " << creature->age() << "\n";
-        out << "Resources: " << creature->resources() << "\n";
-        out << endl;
-
-        creature->detailed_memories(out);
+    for ( std::size_t r = 0; r < m_regions.size(); ++r ) {
+        const Population& creatures = m_regions[r]->creatures();
+        for ( std::size_t i = 0; i < creatures.size(); ++i ) {
+            output_creature(creatures, i, out);
+        }
     }
 }
 
 
 /*
- *  Resources statistics structure used by following method.
+ *  Member function outputs detailed statistics for the live creature
+ *  with the specified ID, found through its handle.
+ *
+ *  Arguments:
+ *    id -- the creature's ID
+ *    out -- reference to a ostream object to which to output
  *
- *  Note, this cannot be defined locally prior to C++11 as it
- *  is used within a template.
+ *  Returns:
+ *    true if the creature was found, false if there is no live creature
+ *    with that ID, in which case nothing is output.
  */
 
-namespace {
-    struct ResStat {
-        int num_creatures;
-        int max_res;
-        int min_res;
-        double avg_res;
-
-        ResStat() : num_creatures(0),
-                    max_res(std::numeric_limits<int>().min()),
-                    min_res(std::numeric_limits<int>().max()),
-                    avg_res(0) {}
-    };
+bool World::output_creature_stats(const CreatureID id, ostream& out) const {
+    const Population * creatures;
+    std::size_t row;
+    if ( !find_creature(id, creatures, row) ) {
+        return false;
+    }
+    output_creature(*creatures, row, out);
+    return true;
 }
 
 
 /*
- *  Member function outputs summary resources statistics for the
- *  strategies of all living currently in the world.
- *
- *  Arguments: reference to a ostream object to which to output.
+ *  Outputs detailed statistics for one creature.
  */
 
-void World::output_summary_resources_by_strategy(ostream& out) const {
-
-    typedef map<string, ResStat> MSR;
-    typedef vector<pair<double, string> > VPDS;
+void World::output_creature(const Population& creatures,
+                            const std::size_t row, ostream& out) const {
+    out << "=============\nCreature " << creatures.id(row)
+        << "\n=============\n\n";
 
-    MSR resources_map;
-    VPDS srtd_strgy;
+    out << "Strategy : " << creatures.strategy(row) << "\n";
+    out << "Age      : " << (m_day - 1) - creatures.birth_day(row) << "\n";
+    out << "Resources: " << creatures.resources(row) << "\n";
+    out << endl;
 
-    //  Summarize statistics by strategy into resources_map
+    creatures.detailed_memories(row, out);
+}
 
-    for ( CreatureList::const_iterator itr = m_creatures.begin();
-          itr != m_creatures.end(); ++itr ) {
-        const Creature* creature = *itr;
-        ResStat& stats = resources_map[creature->strategy()];
-        const int creat_res = creature->resources();
 
-        stats.num_creatures += 1;
-        stats.min_res = min(stats.min_res, creat_res);
-        stats.max_res = max(stats.max_res, creat_res);
-        stats.avg_res = (stats.avg_res * (stats.num_creatures - 1) +
-                         creat_res) / stats.num_creatures;
-    }
+/*
+ *  Number of strategies, for statistics kept by strategy
+ */
 
-    //  Sort strategies by average resources, low to high
+namespace {
+    const std::size_t c_num_strategies = always_defect + 1;
+}
 
-    for ( MSR::iterator itr = resources_map.begin();
-          itr != resources_map.end(); ++itr ) {
-        const string strategy = itr->first;
-        const ResStat& stats = itr->second;
-        srtd_strgy.push_back(make_pair(stats.avg_res, strategy));
-    }
-    sort(srtd_strgy.begin(), srtd_strgy.end());
 
+/*
+ *  Member function outputs summary resources statistics for the
+ *  strategies of all living currently in the world.
+ *
+ *  Arguments: reference to a ostream object to which to output.
+ */
 
-    //  Output summary resource statistcs from high to low, using
-    //  a reverse iterator
+void World::output_summary_resources_by_strategy(ostream& out) const {
 
-    int ranking = 1;
-    out << "Summary resource statistics by strategy:" << endl;
-    for ( VPDS::reverse_iterator itr = srtd_strgy.rbegin();
-            itr != srtd_strgy.rend(); ++itr ) {
-        const string strategy = itr->second;
-        const ResStat& stats = resources_map[strategy];
+    //  Summarize statistics by strategy, streaming through each
+    //  region's strategies and resources
 
-        out << ranking++ << ", "
-            << strategy << " (" << stats.num_creatures << "): "
-            << "max " << stats.max_res
-            << ", min " << stats.min_res
-            << ", sprd " << stats.max_res - stats.min_res
-            << ", avg " << stats.avg_res
-            << endl;
+    StrategyStatsList strategy_stats(c_num_strategies);
+    for ( std::size_t r = 0; r < m_regions.size(); ++r ) {
+        const Population& creatures = m_regions[r]->creatures();
+        for ( std::size_t i = 0; i < creatures.size(); ++i ) {
+            strategy_stats[creatures.strategy_value(i)].add(
+                    creatures.resources(i));
+        }
     }
-    out << endl;
+    output_resources_by_strategy(out, strategy_stats);
 }
 
 
@@ -395,72 +611,15 @@ void World::output_summary_dead_by_strategy(ostream& out) const {
         return;
     }
 
-    typedef map<string, int> MSI;
-
-    MSI strategy_map;
-
-    //  Summarize number of deaths by strategy into strategy_map
-
-    for ( CreatureList::const_iterator itr = m_dead_creatures.begin();
-          itr != m_dead_creatures.end(); ++itr ) {
-        const Creature* creature = *itr;
-        strategy_map[creature->strategy()]++;
-    }
-
-
-    //  Output summary death statistics
+    //  Summarize number of deaths by strategy from the tombstones
 
-    out << "Summary deaths by strategy:" << endl;
-    for ( MSI::const_iterator itr = strategy_map.begin();
-            itr != strategy_map.end(); ++itr ) {
-        const string strategy = itr->first;
-        const int number_dead = itr->second;
-        out << number_dead << " "
-            << strategy << " creature"
-            << (number_dead > 1 ? "s" : "") << " died."
-            << endl;
+    vector<double> strategy_counts(c_num_strategies, 0);
+    for ( std::size_t r = 0; r < m_regions.size(); ++r ) {
+        const TombstoneList& dead = m_regions[r]->dead_creatures();
+        for ( TombstoneList::const_iterator itr = dead.begin();
+              itr != dead.end(); ++itr ) {
+            ++strategy_counts[itr->strategy];
+        }
     }
-    out << endl;
-}
-
-
-/*
- *  Member function plays a game between two creatures.
- *
- *  Each creature is asked for a move, and told the ID of their
- *  opponent so that they can remember previous games with that
- *  opponent. The result of the game is calculated, and each
- *  creature is informed of the result so that they can update
- *  their memories.
- *
- *  Arguments: a pointer to each of the two creatures playing.
- */
-
-void World::play_game(Creature * creature1, Creature * creature2) {
-
-    //  Get the move from each of the two creatures
-
-    GameMove c1move = creature1->get_game_move(creature2->id());
-    GameMove c2move = creature2->get_game_move(creature1->id());
-
-    //  Populate GameInfo objects for each creature, and
-    //  populate with the game result. Simplify the opponent's move
-    //  each time, to avoid giving a creature an indication of its
-    //  opponent's internal state with regards to game-playing
-    //  strategy.
-
-    GameInfo c1info(creature2->id(),
-                    c1move,
-                    simplify_game_move(c2move),
-                    0);
-    GameInfo c2info(creature1->id(),
-                    c2move,
-                    simplify_game_move(c1move),
-                    0);
-    game_result(c1info, c2info);
-
-    //  Communicate results of the game to each creature
-
-    creature1->give_game_result(c1info);
-    creature2->give_game_result(c2info);
+    output_deaths_by_strategy(out, strategy_counts);
 }
@@ -15,18 +15,56 @@
  *     dilemma with each other; and to
  *   - provide statistics about the population and the iterations played.
  *
+ *  The world is divided into one or more geographical regions, each of
+ *  which is a Region with its own creatures and daily pairing, and
+ *  creatures may migrate between regions from day to day. The starting
+ *  population is split between the regions in order of strategy, so
+ *  each region starts with creatures of similar strategies. With a
+ *  single region, the world's threads share out the work within the
+ *  region. With several regions, the regions are the unit of
+ *  parallelism, and each is advanced by a single thread at a time.
+ *
+ *  The world owns a slot map (see slot_map.h) giving each live creature
+ *  a handle which stays the same while the creature moves between rows
+ *  and regions, and keeps each creature's handle in an array indexed
+ *  by its ID, so a creature can be found from its ID in constant time.
+ *  Creature IDs are given out in increasing order, so walking the array
+ *  visits the live creatures in order of ID without any sorting.
+ *
+ *  The world also owns the brain pool (see brain_pool.h) from which its
+ *  creatures take their Brains. The Brains of dead creatures are given
+ *  back to the pool as soon as they die, and are reused for newborns,
+ *  so a world whose births and deaths balance stops constructing Brains
+ *  once its population has levelled off. All that is kept of a dead
+ *  creature is a small fixed-size tombstone in its region.
+ *
+ *  If the WorldInfo structure asks for convergence checks, the share of
+ *  the population and the average resources of each strategy are given
+ *  to a ConvergenceMonitor (see convergence.h) every so many days, and
+ *  the first day on which they have converged is recorded, so that the
+ *  caller can stop advancing the world. Without convergence checks,
+ *  nothing is sampled.
+ *
  *  Public member functions:
  *    day() - returns the current world day.
  *
+ *    converged() - returns true if convergence checks are enabled and
+ *                  the world's statistics have converged.
+ *
+ *    converged_day() - returns the day on which the world's statistics
+ *                      converged, or zero if they have not.
+ *
  *    advance_day() - advances the world by one day, including playing all
  *                    that day's games, ageing each creature by one day,
- *                    and processing any creatures which died or were born
- *                    on that day.
+ *                    processing any creatures which died or were born
+ *                    on that day, and moving any creatures which migrate
+ *                    between regions. The work is shared out among the
+ *                    threads requested in the WorldInfo structure.
  *
  *    output_world_stats() - outputs summary statistics of the world,
  *                           including number of days passed, number of
  *                           games played, number of creatures that died
- *                           or were born, etc.
+ *                           or were born, the day of convergence, etc.
  *
  *    output_summary_creature_stats() - outputs summary statistics about
  *                           each individual creature, including its
@@ -37,6 +75,9 @@
  *                           individual creature, including a full list of
  *                           the details of the games it played.
  *
+ *    output_creature_stats() - outputs full statistics about the live
+ *                           creature with a specified ID, if there is one.
+ *
  *    output_summary_resources_by_strategy() - outputs summary statistics
  *                           for all creatures of each game-playing
  *                           strategy, including the minimum, maximum, and
@@ -55,10 +96,17 @@
 #ifndef PG_PRIDIL_WORLD_H
 #define PG_PRIDIL_WORLD_H
 
+#include <cstddef>
 #include <ostream>
 #include <vector>
 #include "pridil_common.h"
 #include "creature.h"
+#include "population.h"
+#include "slot_map.h"
+#include "brain_pool.h"
+#include "thread_pool.h"
+#include "region.h"
+#include "convergence.h"
 
 namespace pridil {
 
@@ -74,12 +122,16 @@ class World {
 
         Day day() const;
         void advance_day();
+        bool converged() const;
+        Day converged_day() const;
 
         //  Methods to output simulation results statistics
 
         void output_world_stats(std::ostream& out) const;
         void output_summary_creature_stats(std::ostream& out) const;
         void output_full_creature_stats(std::ostream& out) const;
+        bool output_creature_stats(const CreatureID id,
+                                   std::ostream& out) const;
         void output_summary_resources_by_strategy(std::ostream& out) const;
         void output_summary_dead_by_strategy(std::ostream& out) const;
 
@@ -89,13 +141,38 @@ class World {
 
         WorldInfo m_wInfo;
         Day m_day;
-        unsigned long m_games_played;
-        CreatureList m_creatures;
-        CreatureList m_dead_creatures;
+        ThreadPool m_pool;
+        SlotMap m_slots;
+        BrainPool m_brains;
+        std::vector<Region *> m_regions;
+
+        //  Each creature's handle, indexed by its ID less the ID of the
+        //  first creature, with null_handle for IDs given to creatures
+        //  outside the world
+
+        std::vector<CreatureHandle> m_handles_by_id;
+        CreatureID m_first_id;
+
+        //  Monitor of each strategy's share and average resources, and
+        //  the day on which they converged
+
+        ConvergenceMonitor m_convergence;
+        Day m_converged_day;
+
+        void index_handle(const CreatureID id, const CreatureHandle handle);
+        bool find_creature(const CreatureID id, const Population *& creatures,
+                           std::size_t& row) const;
+        void output_creature(const Population& creatures,
+                             const std::size_t row, std::ostream& out) const;
+        void check_convergence();
+
+        //  Parallel task used by advance_day() to run each phase
+        //  of the day in every region
 
-        //  Method to play a game between two creatures
+        class RegionPhaseTask;
 
-        void play_game(Creature * player1, Creature * player2);
+        World(const World&);                // Prevent copying
+        World& operator=(const World&);     // Prevent assignment
 };
 
 }       //  namespace pridil